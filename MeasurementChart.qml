@@ -0,0 +1,398 @@
+import QtQuick 2.15
+import QtCharts 2.15
+
+/**
+ * @brief Wykres pomiarów z prognozą, anomaliami i nałożonymi seriami.
+ *
+ * Wydzielony z main.qml, aby moduł QtCharts był ładowany dopiero przy pierwszym wyświetleniu
+ * wykresu (przez Loader). Dane są przekazywane wywołaniami funkcji z obsługi sygnałów MainWindow.
+ */
+ChartView {
+    id: chartView
+    antialiasing: true
+    title: "Pomiary w czasie"
+    titleFont.pixelSize: 16
+    legend.visible: true
+    legend.font.pixelSize: 12
+    backgroundColor: "transparent"
+    titleColor: textColor
+    margins.left: 20
+    margins.right: 20
+    margins.top: 20
+    margins.bottom: 20
+
+    /// @brief Kolor serii pomiarów.
+    property color accentColor: "#4CAF50"
+    /// @brief Kolor prognozy.
+    property color primaryColor: "#1976D2"
+    /// @brief Kolor tekstu.
+    property color textColor: "#424242"
+    /// @brief Nałożone serie według ID czujnika (LineSeries utworzone w chartView).
+    property var overlaySeries: ({})
+    /// @brief Osie Y nałożonych serii według kodu parametru.
+    property var overlayAxes: ({})
+    /// @brief Liczba nałożonych serii.
+    property int overlayCount: 0
+    /// @brief Kolory kolejnych nałożonych serii.
+    property var overlayColors: ["#FB8C00", "#8E24AA", "#00897B", "#6D4C41", "#3949AB", "#C0CA33"]
+    /// @brief Czy zakres osi czasu został ustawiony z danych.
+    property bool timeAxisFitted: false
+
+    /**
+     * @brief Rozszerza wspólną oś czasu tak, aby obejmowała podany znacznik czasu.
+     * @param timestamp Znacznik czasu w milisekundach.
+     */
+    function extendTimeAxis(timestamp) {
+        if (!timeAxisFitted) {
+            timeAxis.min = new Date(timestamp)
+            timeAxis.max = new Date(timestamp)
+            timeAxisFitted = true
+        }
+        if (timestamp < timeAxis.min.getTime()) {
+            timeAxis.min = new Date(timestamp)
+        }
+        if (timestamp > timeAxis.max.getTime()) {
+            timeAxis.max = new Date(timestamp)
+        }
+    }
+
+    /**
+     * @brief Wstawia lub zastępuje punkt serii (wyszukiwanie binarne po czasie) i rozszerza osie.
+     * @param series Seria liniowa.
+     * @param axis Oś Y serii (z właściwością fitted).
+     * @param point Pomiar z polami date i value.
+     */
+    function upsertPoint(series, axis, point) {
+        if (point.value === null || isNaN(point.value)) {
+            return
+        }
+        var timestamp = Date.parse(point.date)
+        var low = 0
+        var high = series.count
+        while (low < high) {
+            var middle = Math.floor((low + high) / 2)
+            if (series.at(middle).x < timestamp) {
+                low = middle + 1
+            } else {
+                high = middle
+            }
+        }
+
+        if (low < series.count && series.at(low).x === timestamp) {
+            var old = series.at(low)
+            series.replace(old.x, old.y, timestamp, point.value)
+        } else if (low === series.count) {
+            series.append(timestamp, point.value)
+        } else {
+            series.insert(low, timestamp, point.value)
+        }
+
+        if (!axis.fitted) {
+            axis.min = Math.max(0, point.value * 0.9)
+            axis.max = point.value * 1.1
+            axis.fitted = true
+        }
+        axis.min = Math.min(axis.min, Math.max(0, point.value * 0.9))
+        axis.max = Math.max(axis.max, point.value * 1.1)
+        extendTimeAxis(timestamp)
+    }
+
+    /**
+     * @brief Zastępuje główną serię pomiarów i dopasowuje osie.
+     * @param key Tytuł (klucz parametru).
+     * @param values Pomiary z polami date i value.
+     */
+    function setMeasurements(key, values) {
+        measurementSeries.clear()
+        anomalySeries.clear()
+        forecastSeries.clear()
+        title = "Pomiary parametru: " + key
+        valueAxis.fitted = false
+        timeAxisFitted = false
+
+        var minTime = Number.MAX_VALUE
+        var maxTime = 0
+        var minValue = Number.MAX_VALUE
+        var maxValue = Number.MIN_VALUE
+
+        for (var i = 0; i < values.length; i++) {
+            var point = values[i]
+            if (point.value !== null && !isNaN(point.value)) {
+                var timestamp = Date.parse(point.date)
+                measurementSeries.append(timestamp, point.value)
+
+                minTime = Math.min(minTime, timestamp)
+                maxTime = Math.max(maxTime, timestamp)
+                minValue = Math.min(minValue, point.value)
+                maxValue = Math.max(maxValue, point.value)
+            }
+        }
+
+        if (minTime !== Number.MAX_VALUE && maxTime !== 0) {
+            timeAxis.min = new Date(minTime)
+            timeAxis.max = new Date(maxTime)
+            timeAxisFitted = true
+
+            var valueRange = maxValue - minValue
+            valueAxis.min = Math.max(0, minValue - valueRange * 0.1)
+            valueAxis.max = maxValue + valueRange * 0.1
+            valueAxis.fitted = true
+        }
+
+        for (var sensorId in overlaySeries) {
+            var series = overlaySeries[sensorId]
+            if (series.count > 0) {
+                extendTimeAxis(series.at(0).x)
+                extendTimeAxis(series.at(series.count - 1).x)
+            }
+        }
+    }
+
+    /**
+     * @brief Wstawia lub zastępuje punkty głównej serii pomiarów.
+     * @param values Pomiary z polami date i value.
+     */
+    function upsertMeasurements(values) {
+        for (var i = 0; i < values.length; i++) {
+            upsertPoint(measurementSeries, valueAxis, values[i])
+        }
+    }
+
+    /**
+     * @brief Usuwa z początku serii punkty starsze niż podany znacznik czasu.
+     * @param series Seria liniowa (punkty posortowane po czasie).
+     * @param cutoff Znacznik czasu w milisekundach.
+     * @return true, jeśli usunięto jakikolwiek punkt.
+     */
+    function removePointsBefore(series, cutoff) {
+        var low = 0
+        var high = series.count
+        while (low < high) {
+            var middle = Math.floor((low + high) / 2)
+            if (series.at(middle).x < cutoff) {
+                low = middle + 1
+            } else {
+                high = middle
+            }
+        }
+        if (low === 0) {
+            return false
+        }
+        series.removePoints(0, low)
+        return true
+    }
+
+    /**
+     * @brief Przesuwa początek osi czasu na najwcześniejszy punkt pozostały w seriach.
+     */
+    function fitTimeAxisStart() {
+        var start = Number.MAX_VALUE
+        if (measurementSeries.count > 0) {
+            start = measurementSeries.at(0).x
+        }
+        for (var sensorId in overlaySeries) {
+            var series = overlaySeries[sensorId]
+            if (series.count > 0) {
+                start = Math.min(start, series.at(0).x)
+            }
+        }
+        if (start !== Number.MAX_VALUE && timeAxisFitted && start > timeAxis.min.getTime()) {
+            timeAxis.min = new Date(start)
+        }
+    }
+
+    /**
+     * @brief Usuwa z głównej serii pomiary starsze niż okno przechowywania.
+     * @param cutoff Znacznik czasu w milisekundach.
+     */
+    function trimMeasurements(cutoff) {
+        if (removePointsBefore(measurementSeries, cutoff)) {
+            fitTimeAxisStart()
+        }
+    }
+
+    /**
+     * @brief Usuwa z nałożonej serii pomiary starsze niż okno przechowywania.
+     * @param sensorId Identyfikator czujnika.
+     * @param cutoff Znacznik czasu w milisekundach.
+     */
+    function trimOverlay(sensorId, cutoff) {
+        var series = overlaySeries[sensorId]
+        if (series && removePointsBefore(series, cutoff)) {
+            fitTimeAxisStart()
+        }
+    }
+
+    /**
+     * @brief Zastępuje punkty anomalii.
+     * @param anomalies Anomalie z polami timestamp i value.
+     */
+    function setAnomalies(anomalies) {
+        anomalySeries.clear()
+        changeAnomalies(anomalies, [])
+    }
+
+    /**
+     * @brief Usuwa nieaktualne anomalie i dopisuje nowe (bez przerysowywania pozostałych).
+     * @param added Nowe anomalie z polami timestamp i value.
+     * @param removed Znaczniki czasu usuwanych anomalii.
+     */
+    function changeAnomalies(added, removed) {
+        var stale = {}
+        for (var i = 0; i < removed.length; i++) {
+            stale[removed[i]] = true
+        }
+        for (var j = anomalySeries.count - 1; j >= 0 && removed.length > 0; j--) {
+            if (stale[anomalySeries.at(j).x]) {
+                anomalySeries.remove(j)
+            }
+        }
+        for (var k = 0; k < added.length; k++) {
+            var anomaly = added[k]
+            if (anomaly.value !== null && !isNaN(anomaly.value)) {
+                anomalySeries.append(anomaly.timestamp, anomaly.value)
+            }
+        }
+    }
+
+    /**
+     * @brief Rysuje prognozę i rozszerza osie o jej zakres.
+     * @param values Punkty prognozy z polami timestamp i value.
+     */
+    function setForecast(values) {
+        forecastSeries.clear()
+        if (values.length === 0) {
+            return
+        }
+
+        for (var i = 0; i < values.length; i++) {
+            forecastSeries.append(values[i].timestamp, values[i].value)
+            valueAxis.max = Math.max(valueAxis.max, values[i].value * 1.1)
+        }
+        timeAxis.max = new Date(values[values.length - 1].timestamp)
+    }
+
+    /**
+     * @brief Tworzy nałożoną serię na wspólnej osi czasu i z osią Y parametru.
+     * @param sensorId Identyfikator czujnika.
+     * @param label Etykieta serii.
+     * @param paramCode Kod parametru (wspólna oś dla tego samego parametru).
+     * @param values Pomiary z polami date i value.
+     * @param separateAxis Czy seria dostaje własną oś Y.
+     */
+    function addOverlay(sensorId, label, paramCode, values, separateAxis) {
+        var axis = valueAxis
+        if (separateAxis) {
+            axis = overlayAxes[paramCode]
+            if (!axis) {
+                axis = Qt.createQmlObject('import QtCharts 2.15; ValueAxis { property bool fitted: false; '
+                                          + 'labelsFont.pixelSize: 12; gridVisible: false; tickCount: 5 }', chartView)
+                axis.titleText = paramCode
+                overlayAxes[paramCode] = axis
+            }
+        }
+
+        var series = chartView.createSeries(ChartView.SeriesTypeLine, label, timeAxis, axis)
+        series.color = overlayColors[overlayCount % overlayColors.length]
+        series.width = 2
+        if (axis !== valueAxis) {
+            axis.visible = true
+            axis.labelsColor = series.color
+        }
+        overlaySeries[sensorId] = series
+        overlayCount++
+
+        for (var i = 0; i < values.length; i++) {
+            upsertPoint(series, axis, values[i])
+        }
+    }
+
+    /**
+     * @brief Nanosi na nałożoną serię nowe i poprawione pomiary.
+     * @param sensorId Identyfikator czujnika.
+     * @param values Pomiary z polami date i value.
+     */
+    function updateOverlay(sensorId, values) {
+        var series = overlaySeries[sensorId]
+        if (!series) {
+            return
+        }
+        var axis = chartView.axisY(series)
+        for (var i = 0; i < values.length; i++) {
+            upsertPoint(series, axis, values[i])
+        }
+    }
+
+    /**
+     * @brief Usuwa nałożoną serię; nieużywana oś parametru jest ukrywana do ponownego użycia.
+     * @param sensorId Identyfikator czujnika.
+     */
+    function removeOverlay(sensorId) {
+        var series = overlaySeries[sensorId]
+        if (!series) {
+            return
+        }
+        var axis = chartView.axisY(series)
+        chartView.removeSeries(series)
+        delete overlaySeries[sensorId]
+        overlayCount--
+
+        if (axis === valueAxis) {
+            return
+        }
+        for (var other in overlaySeries) {
+            if (chartView.axisY(overlaySeries[other]) === axis) {
+                return
+            }
+        }
+        axis.visible = false
+        axis.fitted = false
+    }
+
+    LineSeries {
+        id: measurementSeries
+        name: "Pomiary"
+        color: accentColor
+        width: 2
+        axisX: DateTimeAxis {
+            id: timeAxis
+            format: "dd.MM HH:mm"
+            titleText: "Data i czas"
+            labelsFont.pixelSize: 12
+            labelsColor: textColor
+            gridLineColor: "#E0E0E0"
+            tickCount: 5
+        }
+        axisY: ValueAxis {
+            id: valueAxis
+            property bool fitted: false
+            titleText: "Wartość"
+            labelsFont.pixelSize: 12
+            labelsColor: textColor
+            gridLineColor: "#E0E0E0"
+            tickCount: 5
+        }
+    }
+
+    /// @brief Prognoza krótkoterminowa (Holt-Winters) jako druga seria.
+    LineSeries {
+        id: forecastSeries
+        name: "Prognoza"
+        color: primaryColor
+        width: 2
+        style: Qt.DashLine
+        axisX: timeAxis
+        axisY: valueAxis
+    }
+
+    /// @brief Punkty oznaczone jako anomalie (błędy czujnika, epizody zanieczyszczeń).
+    ScatterSeries {
+        id: anomalySeries
+        name: "Anomalie"
+        color: "#E53935"
+        borderColor: "white"
+        markerSize: 9
+        axisX: timeAxis
+        axisY: valueAxis
+    }
+}
@@ -0,0 +1,357 @@
+#include "anomalydetector.h"
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Zwraca medianę elementów bufora (bufor jest częściowo przestawiany).
+ * @param buffer Bufor wartości (niepusty).
+ * @return Mediana wartości.
+ */
+/**
+ * @brief Okno kroczące utrzymywane jako posortowany bufor.
+ *
+ * Wstawienie i usunięcie wartości kosztują jedno przesunięcie bufora, a mediana i mediana
+ * odchyleń bezwzględnych są odczytywane bez sortowania ani nth_element.
+ */
+class SortedWindow
+{
+public:
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę wartości.
+     * @param size Największa liczba wartości w oknie.
+     */
+    void reserve(int size) { values.reserve(size); }
+
+    /**
+     * @brief Zwraca liczbę wartości w oknie.
+     * @return Liczba wartości.
+     */
+    int size() const { return values.size(); }
+
+    /**
+     * @brief Dodaje wartość do okna.
+     * @param value Wartość (nie NaN).
+     */
+    void insert(double value)
+    {
+        values.insert(std::upper_bound(values.begin(), values.end(), value), value);
+    }
+
+    /**
+     * @brief Usuwa jedno wystąpienie wartości z okna.
+     * @param value Wartość dodana wcześniej przez insert().
+     */
+    void remove(double value)
+    {
+        auto it = std::lower_bound(values.begin(), values.end(), value);
+        if (it != values.end() && *it == value) values.erase(it);
+    }
+
+    /**
+     * @brief Zwraca medianę wartości okna.
+     * @return Mediana (okno niepuste).
+     */
+    double median() const
+    {
+        const int n = values.size();
+        if (n % 2 != 0) return values[n / 2];
+        return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+    }
+
+    /**
+     * @brief Zwraca medianę odchyleń bezwzględnych od podanej mediany (MAD).
+     *
+     * Odchylenia po obu stronach mediany tworzą dwa posortowane ciągi, więc wystarczy
+     * scalić je do środkowego elementu.
+     * @param median Mediana wartości okna.
+     * @return Mediana odchyleń bezwzględnych (okno niepuste).
+     */
+    double medianDeviation(double median) const
+    {
+        const int n = values.size();
+        int right = static_cast<int>(std::lower_bound(values.cbegin(), values.cend(), median) - values.cbegin());
+        int left = right - 1;
+        auto next = [&]() {
+            if (right >= n || (left >= 0 && median - values[left] <= values[right] - median)) {
+                return median - values[left--];
+            }
+            return values[right++] - median;
+        };
+        double lower = 0.0;
+        for (int rank = 0; rank < n / 2; ++rank) {
+            lower = next();
+        }
+        const double upper = next();
+        return n % 2 != 0 ? upper : (lower + upper) / 2.0;
+    }
+
+private:
+    QVector<double> values;
+};
+
+}
+
+/**
+ * @brief Uruchamia wszystkie metody detekcji na serii.
+ * @param series Seria pomiarowa posortowana rosnąco po czasie.
+ * @param settings Parametry detekcji.
+ * @return Lista oznaczonych punktów w kolejności czasowej.
+ */
+QVector<AnomalyDetector::Anomaly> AnomalyDetector::detect(const MeasurementSeries& series, const Settings& settings)
+{
+    return detectFrom(series, QVector<Anomaly>(), std::numeric_limits<qint64>::min(), settings);
+}
+
+/**
+ * @brief Ponownie wykrywa anomalie od pierwszego zmienionego punktu serii.
+ *
+ * Ocena punktu zależy od okna poprzednich punktów, a stała wartość także od początku serii
+ * identycznych wartości, więc przeliczany jest koniec serii od początku takiej serii
+ * obejmującej punkt przed zmianą. Jądra dostają dodatkowo okno (i jeden ważny punkt) przed nim.
+ * @param series Seria pomiarowa posortowana rosnąco po czasie.
+ * @param previous Poprzedni wynik detekcji dla tej serii.
+ * @param changedFrom Znacznik czasu pierwszego dopisanego lub poprawionego punktu.
+ * @param settings Parametry detekcji.
+ * @return Lista oznaczonych punktów w kolejności czasowej.
+ */
+QVector<AnomalyDetector::Anomaly> AnomalyDetector::detectFrom(const MeasurementSeries& series,
+                                                              const QVector<Anomaly>& previous,
+                                                              qint64 changedFrom, const Settings& settings)
+{
+    QVector<Anomaly> anomalies;
+    if (series.isEmpty()) return anomalies;
+
+    const int n = series.size();
+    const QVector<qint64>& timestamps = series.timestamps;
+    const QVector<double>& values = series.values;
+    int start = static_cast<int>(std::lower_bound(timestamps.cbegin(), timestamps.cend(), changedFrom)
+                                 - timestamps.cbegin());
+    // Stała wartość sprzed zmiany może się wydłużyć - przeliczamy ją od początku.
+    if (start > 0 && !std::isnan(values[start - 1])) {
+        const double value = values[start - 1];
+        while (start > 0 && !std::isnan(values[start - 1])
+               && std::abs(values[start - 1] - value) <= settings.flatLineEpsilon) {
+            --start;
+        }
+    }
+
+    // Wcześniejsze punkty nie zmieniły się; indeksy przesuwają się po usunięciu początku serii.
+    const qint64 startTime = start < n ? timestamps[start] : std::numeric_limits<qint64>::max();
+    for (const Anomaly& anomaly : previous) {
+        if (anomaly.timestamp >= startTime) break;
+        const int index = static_cast<int>(std::lower_bound(timestamps.cbegin(), timestamps.cend(), anomaly.timestamp)
+                                           - timestamps.cbegin());
+        if (index >= n || timestamps[index] != anomaly.timestamp) continue;
+        Anomaly kept = anomaly;
+        kept.index = index;
+        anomalies.append(kept);
+    }
+    if (start >= n) return anomalies;
+
+    int lo = std::max(0, start - settings.window - 1);
+    while (lo > 0 && std::isnan(values[lo])) --lo;
+    MeasurementSeries tail;
+    tail.key = series.key;
+    tail.timestamps = timestamps.mid(lo);
+    tail.values = values.mid(lo);
+
+    QVector<int> flags(tail.size(), 0);
+    detectZScore(tail.values, settings, flags);
+    detectMad(tail.values, settings, flags);
+    detectFlatLine(tail.values, settings, flags);
+    detectSpikes(tail, settings, flags);
+
+    for (int i = start - lo; i < flags.size(); ++i) {
+        if (flags[i] == 0) continue;
+        Anomaly anomaly;
+        anomaly.index = lo + i;
+        anomaly.timestamp = tail.timestamps[i];
+        anomaly.value = tail.values[i];
+        anomaly.flags = flags[i];
+        anomalies.append(anomaly);
+    }
+    return anomalies;
+}
+
+/**
+ * @brief Zwraca czytelną nazwę rodzajów anomalii.
+ * @param flags Suma flag Type.
+ * @return Nazwy rozdzielone przecinkami (np. "z-score, skok").
+ */
+QString AnomalyDetector::typeName(int flags)
+{
+    QStringList names;
+    if (flags & ZScore) names << "z-score";
+    if (flags & Mad) names << "MAD";
+    if (flags & FlatLine) names << "stała wartość";
+    if (flags & Spike) names << "skok";
+    return names.join(", ");
+}
+
+/**
+ * @brief Zamienia nazwę rodzaju anomalii na flagę.
+ * @param name Nazwa ("zscore", "mad", "flatline", "spike").
+ * @return Flaga Type lub 0 dla nieznanej nazwy.
+ */
+int AnomalyDetector::typeFromName(const QString& name)
+{
+    const QString lower = name.toLower();
+    if (lower == "zscore") return ZScore;
+    if (lower == "mad") return Mad;
+    if (lower == "flatline") return FlatLine;
+    if (lower == "spike") return Spike;
+    return 0;
+}
+
+/**
+ * @brief Oznacza punkty odbiegające od średniej kroczącej.
+ *
+ * Średnia i wariancja okna są liczone z sum prefiksowych, więc koszt na punkt jest stały.
+ * Pętle nie zawierają rozgałęzień zależnych od danych i są wektoryzowane przez kompilator.
+ * @param values Wartości serii (NaN dla braków).
+ * @param settings Parametry detekcji.
+ * @param flags Tablica flag do uzupełnienia.
+ */
+void AnomalyDetector::detectZScore(const QVector<double>& values, const Settings& settings, QVector<int>& flags)
+{
+    const int n = values.size();
+    const double* input = values.constData();
+
+    QVector<double> clean(n);
+    QVector<double> valid(n);
+    double* cleanData = clean.data();
+    double* validData = valid.data();
+    for (int i = 0; i < n; ++i) {
+        const bool ok = input[i] == input[i];
+        cleanData[i] = ok ? input[i] : 0.0;
+        validData[i] = ok ? 1.0 : 0.0;
+    }
+
+    QVector<double> sum(n + 1, 0.0);
+    QVector<double> sumSq(n + 1, 0.0);
+    QVector<double> count(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) {
+        sum[i + 1] = sum[i] + cleanData[i];
+        sumSq[i + 1] = sumSq[i] + cleanData[i] * cleanData[i];
+        count[i + 1] = count[i] + validData[i];
+    }
+
+    int* flagData = flags.data();
+    for (int i = 0; i < n; ++i) {
+        const int lo = std::max(0, i - settings.window);
+        const double windowCount = count[i] - count[lo];
+        const double mean = (sum[i] - sum[lo]) / std::max(windowCount, 1.0);
+        const double variance = (sumSq[i] - sumSq[lo]) / std::max(windowCount, 1.0) - mean * mean;
+        const double deviation = std::sqrt(std::max(variance, 0.0));
+        const bool enough = windowCount >= settings.minSamples && deviation > 0.0 && validData[i] > 0.0;
+        const double z = std::abs(cleanData[i] - mean) / (deviation > 0.0 ? deviation : 1.0);
+        flagData[i] |= (enough && z > settings.zThreshold) ? ZScore : 0;
+    }
+}
+
+/**
+ * @brief Oznacza punkty odbiegające od mediany kroczącej (odporne na wartości skrajne).
+ *
+ * Okno jest przesuwane o jeden punkt (jedno wstawienie i jedno usunięcie w posortowanym
+ * buforze) zamiast budowania go od nowa i wyznaczania mediany przez nth_element.
+ * @param values Wartości serii (NaN dla braków).
+ * @param settings Parametry detekcji.
+ * @param flags Tablica flag do uzupełnienia.
+ */
+void AnomalyDetector::detectMad(const QVector<double>& values, const Settings& settings, QVector<int>& flags)
+{
+    const int n = values.size();
+    SortedWindow window;
+    window.reserve(settings.window + 1);
+
+    for (int i = 0; i < n; ++i) {
+        // Okno obejmuje punkty [i - window, i).
+        if (i > 0 && !std::isnan(values[i - 1])) window.insert(values[i - 1]);
+        const int leaving = i - settings.window - 1;
+        if (leaving >= 0 && !std::isnan(values[leaving])) window.remove(values[leaving]);
+
+        const double current = values[i];
+        if (std::isnan(current) || window.size() < settings.minSamples) continue;
+
+        const double median = window.median();
+        const double mad = window.medianDeviation(median);
+        if (mad <= 0.0) continue;
+
+        const double modifiedZ = 0.6745 * std::abs(current - median) / mad;
+        if (modifiedZ > settings.madThreshold) {
+            flags[i] |= Mad;
+        }
+    }
+}
+
+/**
+ * @brief Oznacza serie identycznych wartości (zablokowany czujnik).
+ * @param values Wartości serii (NaN dla braków).
+ * @param settings Parametry detekcji.
+ * @param flags Tablica flag do uzupełnienia.
+ */
+void AnomalyDetector::detectFlatLine(const QVector<double>& values, const Settings& settings, QVector<int>& flags)
+{
+    const int n = values.size();
+    int runStart = 0;
+
+    for (int i = 1; i <= n; ++i) {
+        const bool continues = i < n
+                               && !std::isnan(values[i])
+                               && !std::isnan(values[runStart])
+                               && std::abs(values[i] - values[runStart]) <= settings.flatLineEpsilon;
+        if (continues) continue;
+
+        if (i - runStart >= settings.flatLineLength && !std::isnan(values[runStart])) {
+            for (int j = runStart; j < i; ++j) {
+                flags[j] |= FlatLine;
+            }
+        }
+        runStart = i;
+    }
+}
+
+/**
+ * @brief Oznacza gwałtowne zmiany wartości w przeliczeniu na godzinę.
+ *
+ * Za typową zmianę przyjmuje się medianę bezwzględnych zmian godzinowych w oknie poprzednich
+ * punktów, więc próg dostosowuje się do zmienności danego parametru, a ocena punktu nie zależy
+ * od danych dopisanych później.
+ * @param series Seria pomiarowa.
+ * @param settings Parametry detekcji.
+ * @param flags Tablica flag do uzupełnienia.
+ */
+void AnomalyDetector::detectSpikes(const MeasurementSeries& series, const Settings& settings, QVector<int>& flags)
+{
+    const int n = series.size();
+    QVector<double> rates(n, std::numeric_limits<double>::quiet_NaN());
+
+    int previous = -1;
+    for (int i = 0; i < n; ++i) {
+        if (std::isnan(series.values[i])) continue;
+        if (previous >= 0) {
+            const double hours = std::max((series.timestamps[i] - series.timestamps[previous]) / 3600000.0, 1.0);
+            rates[i] = std::abs(series.values[i] - series.values[previous]) / hours;
+        }
+        previous = i;
+    }
+
+    SortedWindow window;
+    window.reserve(settings.window + 1);
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && !std::isnan(rates[i - 1])) window.insert(rates[i - 1]);
+        const int leaving = i - settings.window - 1;
+        if (leaving >= 0 && !std::isnan(rates[leaving])) window.remove(rates[leaving]);
+        if (std::isnan(rates[i])) continue;
+
+        const double typicalRate = window.size() > 0 ? window.median() : 0.0;
+        const double threshold = std::max(settings.minSpikeRate, settings.spikeFactor * typicalRate);
+        if (rates[i] > threshold) {
+            flags[i] |= Spike;
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef ANOMALYDETECTOR_H
+#define ANOMALYDETECTOR_H
+
+#include <QString>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @brief Wykrywanie anomalii i skoków w seriach pomiarowych.
+ *
+ * Każda metoda wykrywania jest osobnym jądrem przechodzącym liniowo po ciągłych tablicach
+ * serii i ustawiającym bity w tablicy flag. Ocena punktu zależy tylko od okna poprzednich
+ * punktów (oraz od serii stałych wartości, do której należy), więc po dopisaniu lub
+ * poprawieniu danych wystarczy ponownie ocenić koniec serii od pierwszej zmiany (detectFrom).
+ */
+class AnomalyDetector
+{
+public:
+    /**
+     * @brief Rodzaje wykrywanych anomalii (flagi bitowe).
+     */
+    enum Type {
+        ZScore = 0x1,   ///< Odchylenie od średniej kroczącej (z-score).
+        Mad = 0x2,      ///< Odchylenie od mediany kroczącej (MAD).
+        FlatLine = 0x4, ///< Stała wartość przez wiele godzin (zablokowany czujnik).
+        Spike = 0x8     ///< Gwałtowna zmiana wartości w czasie.
+    };
+
+    /**
+     * @brief Parametry detekcji.
+     */
+    struct Settings {
+        /// @brief Długość okna kroczącego (liczba poprzednich punktów).
+        int window = 24;
+        /// @brief Minimalna liczba ważnych punktów w oknie.
+        int minSamples = 6;
+        /// @brief Próg |z| dla metody z-score.
+        double zThreshold = 3.0;
+        /// @brief Próg zmodyfikowanego z-score dla metody MAD.
+        double madThreshold = 3.5;
+        /// @brief Minimalna długość serii identycznych wartości.
+        int flatLineLength = 6;
+        /// @brief Tolerancja porównania wartości dla wykrywania stałej linii.
+        double flatLineEpsilon = 1e-9;
+        /// @brief Krotność typowej zmiany godzinowej uznawana za skok.
+        double spikeFactor = 6.0;
+        /// @brief Minimalna bezwzględna zmiana na godzinę uznawana za skok.
+        double minSpikeRate = 10.0;
+    };
+
+    /**
+     * @brief Pojedynczy oznaczony punkt serii.
+     */
+    struct Anomaly {
+        /// @brief Indeks punktu w serii.
+        int index = -1;
+        /// @brief Znacznik czasu w milisekundach od epoki.
+        qint64 timestamp = 0;
+        /// @brief Wartość pomiaru.
+        double value = 0.0;
+        /// @brief Suma flag Type opisujących anomalię.
+        int flags = 0;
+    };
+
+    /**
+     * @brief Uruchamia wszystkie metody detekcji na serii.
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     * @param settings Parametry detekcji.
+     * @return Lista oznaczonych punktów w kolejności czasowej.
+     */
+    static QVector<Anomaly> detect(const MeasurementSeries& series, const Settings& settings = Settings());
+
+    /**
+     * @brief Ponownie wykrywa anomalie od pierwszego zmienionego punktu serii.
+     *
+     * Anomalie sprzed zmiany są przejmowane z poprzedniego wyniku (bez punktów usuniętych z początku
+     * serii), a jądra przechodzą tylko po końcu serii wraz z oknem poprzednich punktów.
+     * Dla punktów od zmiany wynik jest taki sam jak dla detect() na całej serii.
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     * @param previous Poprzedni wynik detekcji dla tej serii.
+     * @param changedFrom Znacznik czasu pierwszego dopisanego lub poprawionego punktu.
+     * @param settings Parametry detekcji.
+     * @return Lista oznaczonych punktów w kolejności czasowej.
+     */
+    static QVector<Anomaly> detectFrom(const MeasurementSeries& series, const QVector<Anomaly>& previous,
+                                       qint64 changedFrom, const Settings& settings = Settings());
+
+    /**
+     * @brief Zwraca czytelną nazwę rodzajów anomalii.
+     * @param flags Suma flag Type.
+     * @return Nazwy rozdzielone przecinkami (np. "z-score, skok").
+     */
+    static QString typeName(int flags);
+
+    /**
+     * @brief Zamienia nazwę rodzaju anomalii na flagę.
+     * @param name Nazwa ("zscore", "mad", "flatline", "spike").
+     * @return Flaga Type lub 0 dla nieznanej nazwy.
+     */
+    static int typeFromName(const QString& name);
+
+private:
+    /**
+     * @brief Oznacza punkty odbiegające od średniej kroczącej.
+     * @param values Wartości serii (NaN dla braków).
+     * @param settings Parametry detekcji.
+     * @param flags Tablica flag do uzupełnienia.
+     */
+    static void detectZScore(const QVector<double>& values, const Settings& settings, QVector<int>& flags);
+
+    /**
+     * @brief Oznacza punkty odbiegające od mediany kroczącej (odporne na wartości skrajne).
+     * @param values Wartości serii (NaN dla braków).
+     * @param settings Parametry detekcji.
+     * @param flags Tablica flag do uzupełnienia.
+     */
+    static void detectMad(const QVector<double>& values, const Settings& settings, QVector<int>& flags);
+
+    /**
+     * @brief Oznacza serie identycznych wartości (zablokowany czujnik).
+     * @param values Wartości serii (NaN dla braków).
+     * @param settings Parametry detekcji.
+     * @param flags Tablica flag do uzupełnienia.
+     */
+    static void detectFlatLine(const QVector<double>& values, const Settings& settings, QVector<int>& flags);
+
+    /**
+     * @brief Oznacza gwałtowne zmiany wartości w przeliczeniu na godzinę.
+     * @param series Seria pomiarowa.
+     * @param settings Parametry detekcji.
+     * @param flags Tablica flag do uzupełnienia.
+     */
+    static void detectSpikes(const MeasurementSeries& series, const Settings& settings, QVector<int>& flags);
+};
+
+#endif // ANOMALYDETECTOR_H
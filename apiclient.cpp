@@ -0,0 +1,410 @@
+#include "apiclient.h"
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor wyniku (tworzony wyłącznie przez ApiClient).
+ * @param parent Wskaźnik na obiekt nadrzędny.
+ */
+ApiReply::ApiReply(QObject *parent)
+    : QObject(parent)
+{
+    hedgeTimer.setSingleShot(true);
+}
+
+/**
+ * @brief Zwraca kod błędu ostatecznego wyniku.
+ * @return QNetworkReply::NoError w przypadku sukcesu.
+ */
+QNetworkReply::NetworkError ApiReply::error() const
+{
+    return networkError;
+}
+
+/**
+ * @brief Zwraca opis błędu.
+ * @return Opis błędu lub pusty tekst.
+ */
+QString ApiReply::errorString() const
+{
+    return message;
+}
+
+/**
+ * @brief Zwraca treść odpowiedzi.
+ * @return Treść odpowiedzi (pusta w przypadku błędu).
+ */
+QByteArray ApiReply::readAll() const
+{
+    return body;
+}
+
+/**
+ * @brief Zwraca liczbę wykonanych prób (bez zapytań zabezpieczających).
+ * @return Liczba prób.
+ */
+int ApiReply::attempts() const
+{
+    return attempt;
+}
+
+/**
+ * @brief Sprawdza, czy wynik pochodzi z zapytania zabezpieczającego.
+ * @return True, jeśli szybciej odpowiedziało zapytanie zabezpieczające.
+ */
+bool ApiReply::wonByHedge() const
+{
+    return hedgeWon;
+}
+
+/**
+ * @brief Zwraca całkowity czas od wywołania ApiClient::get do wyniku.
+ * @return Czas w milisekundach.
+ */
+qint64 ApiReply::elapsedMs() const
+{
+    return timer.elapsed();
+}
+
+/**
+ * @brief Konstruktor klienta.
+ *
+ * Katalog stacji jest duży i pobierany rzadko, więc ma dłuższy limit czasu i nie jest
+ * dublowany zapytaniem zabezpieczającym; indeks jakości powietrza jest mały i ma najkrótszy limit.
+ * @param manager Menedżer sieciowy używany do wysyłania zapytań.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+ApiClient::ApiClient(QNetworkAccessManager* manager, QObject *parent)
+    : QObject(parent), manager(manager)
+{
+    clock.start();
+    policies[Stations].timeoutMs = 20000;
+    policies[Stations].hedge = false;
+    policies[Sensors].timeoutMs = 8000;
+    policies[Measurements].timeoutMs = 8000;
+    policies[AirQualityIndex].timeoutMs = 5000;
+    for (int i = 0; i < EndpointCount; ++i) {
+        callLatency[i] = LatencyTracker(1024);
+    }
+}
+
+/**
+ * @brief Wysyła zapytanie GET zgodnie z polityką punktu końcowego.
+ * @param request Zapytanie.
+ * @param endpoint Punkt końcowy API.
+ * @return Obiekt wyniku.
+ */
+ApiReply* ApiClient::get(const QNetworkRequest& request, Endpoint endpoint)
+{
+    ApiReply* reply = new ApiReply(this);
+    reply->request = request;
+    reply->endpoint = endpoint;
+    reply->timer.start();
+    connect(&reply->hedgeTimer, &QTimer::timeout, this, [this, reply]() { sendHedge(reply); });
+
+    counters[endpoint].requests++;
+    startAttempt(reply);
+    return reply;
+}
+
+/**
+ * @brief Zwraca politykę punktu końcowego.
+ * @param endpoint Punkt końcowy API.
+ * @return Polityka.
+ */
+ApiClient::Policy ApiClient::policy(Endpoint endpoint) const
+{
+    return policies[endpoint];
+}
+
+/**
+ * @brief Zmienia politykę punktu końcowego.
+ * @param endpoint Punkt końcowy API.
+ * @param policy Nowa polityka.
+ */
+void ApiClient::setPolicy(Endpoint endpoint, const Policy& policy)
+{
+    policies[endpoint] = policy;
+}
+
+/**
+ * @brief Zwraca statystyki punktu końcowego.
+ * @param endpoint Punkt końcowy API.
+ * @return Statystyki.
+ */
+ApiClient::Stats ApiClient::stats(Endpoint endpoint) const
+{
+    return counters[endpoint];
+}
+
+/**
+ * @brief Zwraca percentyl całkowitych czasów wywołań punktu końcowego.
+ * @param endpoint Punkt końcowy API.
+ * @param fraction Percentyl jako ułamek (0 ... 1).
+ * @return Czas w milisekundach.
+ */
+double ApiClient::latencyPercentile(Endpoint endpoint, double fraction) const
+{
+    return callLatency[endpoint].percentile(fraction);
+}
+
+/**
+ * @brief Zwraca stan wyłącznika.
+ * @return Bieżący stan.
+ */
+CircuitBreaker::State ApiClient::circuitState() const
+{
+    return breaker.state();
+}
+
+/**
+ * @brief Tworzy tekstowy raport statystyk wszystkich punktów końcowych.
+ * @return Raport (jedna linia na punkt końcowy).
+ */
+QString ApiClient::metricsReport() const
+{
+    static const char* names[EndpointCount] = { "stacje", "czujniki", "pomiary", "indeks" };
+
+    QStringList lines;
+    for (int i = 0; i < EndpointCount; ++i) {
+        const Stats& s = counters[i];
+        if (s.requests == 0) continue;
+        lines << QString("%1: %2 zapytań, %3 błędów, ponowienia %4, limity czasu %5, zabezpieczające %6 (skuteczne %7), "
+                         "odrzucone %8, p50 %9 ms, p95 %10 ms, p99 %11 ms")
+                     .arg(names[i]).arg(s.requests).arg(s.failed).arg(s.retries).arg(s.timeouts)
+                     .arg(s.hedges).arg(s.hedgeWins).arg(s.rejected)
+                     .arg(callLatency[i].percentile(0.5), 0, 'f', 0)
+                     .arg(callLatency[i].percentile(0.95), 0, 'f', 0)
+                     .arg(callLatency[i].percentile(0.99), 0, 'f', 0);
+    }
+    lines << QString("Wyłącznik: %1, otwarty %2 razy")
+                 .arg(breaker.state() == CircuitBreaker::Closed ? "zamknięty" : "otwarty")
+                 .arg(breaker.tripCount());
+    return lines.join("\n");
+}
+
+/**
+ * @brief Rozpoczyna kolejną próbę wywołania.
+ *
+ * Odrzucenie przez wyłącznik jest zgłaszane w kolejnym obiegu pętli zdarzeń, aby
+ * wywołujący zdążył połączyć się z sygnałem finished.
+ * @param reply Wywołanie.
+ */
+void ApiClient::startAttempt(ApiReply* reply)
+{
+    const Endpoint endpoint = static_cast<Endpoint>(reply->endpoint);
+    const bool allowed = breaker.allowRequest(clock.elapsed());
+    updateCircuitState();
+    if (!allowed) {
+        counters[endpoint].rejected++;
+        QMetaObject::invokeMethod(reply, [this, reply]() {
+            finish(reply, QNetworkReply::ServiceUnavailableError, "Circuit breaker open, request not sent", QByteArray());
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    reply->attempt++;
+    launch(reply, false);
+
+    const int delay = hedgeDelay(endpoint);
+    if (policies[endpoint].hedge && delay >= 0 && delay < policies[endpoint].timeoutMs) {
+        reply->hedgeTimer.start(delay);
+    }
+}
+
+/**
+ * @brief Wysyła zapytanie sieciowe w ramach bieżącej próby.
+ * @param reply Wywołanie.
+ * @param hedge True dla zapytania zabezpieczającego.
+ */
+void ApiClient::launch(ApiReply* reply, bool hedge)
+{
+    QNetworkReply* network = manager->get(reply->request);
+    network->setProperty("hedge", hedge);
+    network->setProperty("startedMs", reply->timer.elapsed());
+    reply->inFlight.append(network);
+
+    QTimer* timeout = new QTimer(network);
+    timeout->setSingleShot(true);
+    connect(timeout, &QTimer::timeout, network, [network]() {
+        network->setProperty("timedOut", true);
+        network->abort();
+    });
+    timeout->start(policies[reply->endpoint].timeoutMs);
+
+    connect(network, &QNetworkReply::finished, reply, [this, reply, network]() { onAttemptFinished(reply, network); });
+}
+
+/**
+ * @brief Wysyła zapytanie zabezpieczające, jeśli próba wciąż trwa i pozwala na to budżet.
+ *
+ * Budżet ogranicza zapytania zabezpieczające do HEDGE_BUDGET wszystkich wywołań, aby
+ * przy ogólnym spowolnieniu serwera nie zwielokrotniać jego obciążenia.
+ * @param reply Wywołanie.
+ */
+void ApiClient::sendHedge(ApiReply* reply)
+{
+    Stats& s = counters[reply->endpoint];
+    if (reply->done || reply->inFlight.size() != 1 || breaker.state() != CircuitBreaker::Closed) return;
+    if (s.hedges >= HEDGE_BUDGET * s.requests) return;
+
+    s.hedges++;
+    launch(reply, true);
+}
+
+/**
+ * @brief Obsługuje zakończenie zapytania sieciowego.
+ *
+ * Pierwsza udana odpowiedź kończy wywołanie. Błąd jednego z równoległych zapytań
+ * nie kończy wywołania, dopóki drugie trwa; po błędzie ostatniego zapytania próby
+ * błędy przejściowe są ponawiane po opóźnieniu.
+ * @param reply Wywołanie.
+ * @param network Zakończone zapytanie sieciowe.
+ */
+void ApiClient::onAttemptFinished(ApiReply* reply, QNetworkReply* network)
+{
+    reply->inFlight.removeOne(network);
+    network->deleteLater();
+    if (reply->done) return;
+
+    const Endpoint endpoint = static_cast<Endpoint>(reply->endpoint);
+    const bool timedOut = network->property("timedOut").toBool();
+    const bool hedge = network->property("hedge").toBool();
+    const int status = network->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QNetworkReply::NetworkError error = timedOut ? QNetworkReply::TimeoutError : network->error();
+
+    if (error == QNetworkReply::NoError) {
+        attemptLatency[endpoint].add(reply->timer.elapsed() - network->property("startedMs").toLongLong());
+        breaker.recordSuccess();
+        updateCircuitState();
+        if (hedge) counters[endpoint].hedgeWins++;
+        reply->hedgeWon = hedge;
+        finish(reply, QNetworkReply::NoError, QString(), network->readAll());
+        return;
+    }
+
+    const bool retryable = isRetryable(error, status);
+    if (retryable) {
+        breaker.recordFailure(clock.elapsed());
+    } else {
+        breaker.recordSuccess();
+    }
+    updateCircuitState();
+    if (timedOut) counters[endpoint].timeouts++;
+    if (!reply->inFlight.isEmpty()) return;
+
+    reply->hedgeTimer.stop();
+    if (retryable && reply->attempt < policies[endpoint].maxAttempts) {
+        counters[endpoint].retries++;
+        QTimer::singleShot(backoffDelay(endpoint, reply->attempt), reply, [this, reply]() { startAttempt(reply); });
+        return;
+    }
+
+    const QString message = timedOut ? QString("Request timed out after %1 ms").arg(policies[endpoint].timeoutMs)
+                                     : network->errorString();
+    finish(reply, error, message, QByteArray());
+}
+
+/**
+ * @brief Ustala wynik wywołania, przerywa pozostałe zapytania i emituje finished.
+ * @param reply Wywołanie.
+ * @param error Kod błędu.
+ * @param message Opis błędu.
+ * @param body Treść odpowiedzi.
+ */
+void ApiClient::finish(ApiReply* reply, QNetworkReply::NetworkError error, const QString& message, const QByteArray& body)
+{
+    if (reply->done) return;
+
+    reply->done = true;
+    reply->hedgeTimer.stop();
+    reply->networkError = error;
+    reply->message = message;
+    reply->body = body;
+
+    Stats& s = counters[reply->endpoint];
+    if (error == QNetworkReply::NoError) {
+        s.succeeded++;
+    } else {
+        s.failed++;
+    }
+    callLatency[reply->endpoint].add(reply->timer.elapsed());
+
+    const QList<QNetworkReply*> pending = reply->inFlight;
+    for (QNetworkReply* network : pending) {
+        network->abort();
+    }
+    emit reply->finished();
+}
+
+/**
+ * @brief Zwraca opóźnienie zapytania zabezpieczającego.
+ *
+ * Opóźnienie równe p95 udanych prób oznacza, że zabezpieczenie dotyczy mniej więcej
+ * co dwudziestego zapytania - tylko tych z ogona rozkładu.
+ * @param endpoint Punkt końcowy API.
+ * @return Opóźnienie w ms lub -1, jeśli brak wystarczających danych.
+ */
+int ApiClient::hedgeDelay(Endpoint endpoint) const
+{
+    if (attemptLatency[endpoint].count() < MIN_HEDGE_SAMPLES) return -1;
+    const int p95 = static_cast<int>(std::ceil(attemptLatency[endpoint].percentile(0.95)));
+    return std::max(policies[endpoint].minHedgeDelayMs, p95);
+}
+
+/**
+ * @brief Zwraca opóźnienie przed kolejną próbą (wykładnicze z losowym rozrzutem).
+ *
+ * Połowa opóźnienia jest stała, a połowa losowa, co rozprasza ponowienia wielu klientów
+ * po wspólnej awarii.
+ * @param endpoint Punkt końcowy API.
+ * @param attempt Numer zakończonej próby (od 1).
+ * @return Opóźnienie w ms.
+ */
+int ApiClient::backoffDelay(Endpoint endpoint, int attempt) const
+{
+    const Policy& p = policies[endpoint];
+    const qint64 exponential = std::min<qint64>(p.maxBackoffMs, qint64(p.backoffMs) << std::min(attempt - 1, 20));
+    const int half = static_cast<int>(exponential / 2);
+    return half + QRandomGenerator::global()->bounded(half + 1);
+}
+
+/**
+ * @brief Sprawdza, czy błąd uzasadnia ponowienie zapytania.
+ * @param error Kod błędu sieciowego.
+ * @param httpStatus Kod statusu HTTP (0, jeśli brak).
+ * @return True dla błędów przejściowych (limit czasu, połączenie, 5xx, 429).
+ */
+bool ApiClient::isRetryable(QNetworkReply::NetworkError error, int httpStatus)
+{
+    if (httpStatus == 429 || httpStatus >= 500) return true;
+
+    switch (error) {
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::InternalServerError:
+    case QNetworkReply::ServiceUnavailableError:
+    case QNetworkReply::UnknownServerError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Emituje circuitChanged, jeśli stan wyłącznika się zmienił.
+ */
+void ApiClient::updateCircuitState()
+{
+    const bool open = breaker.state() != CircuitBreaker::Closed;
+    if (open == circuitOpen) return;
+    circuitOpen = open;
+    emit circuitChanged(open);
+}
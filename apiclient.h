@@ -0,0 +1,322 @@
+#ifndef APICLIENT_H
+#define APICLIENT_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include "circuitbreaker.h"
+#include "latencytracker.h"
+
+class ApiClient;
+
+/**
+ * @brief Wynik zapytania wykonanego przez ApiClient.
+ *
+ * Udostępnia te same metody co QNetworkReply używane w obsłudze odpowiedzi (error,
+ * errorString, readAll), więc kod obsługi nie zależy od liczby prób i zapytań
+ * zabezpieczających wysłanych w tle. Sygnał finished jest emitowany dokładnie raz.
+ */
+class ApiReply : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Zwraca kod błędu ostatecznego wyniku.
+     * @return QNetworkReply::NoError w przypadku sukcesu.
+     */
+    QNetworkReply::NetworkError error() const;
+
+    /**
+     * @brief Zwraca opis błędu.
+     * @return Opis błędu lub pusty tekst.
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Zwraca treść odpowiedzi.
+     * @return Treść odpowiedzi (pusta w przypadku błędu).
+     */
+    QByteArray readAll() const;
+
+    /**
+     * @brief Zwraca liczbę wykonanych prób (bez zapytań zabezpieczających).
+     * @return Liczba prób.
+     */
+    int attempts() const;
+
+    /**
+     * @brief Sprawdza, czy wynik pochodzi z zapytania zabezpieczającego.
+     * @return True, jeśli szybciej odpowiedziało zapytanie zabezpieczające.
+     */
+    bool wonByHedge() const;
+
+    /**
+     * @brief Zwraca całkowity czas od wywołania ApiClient::get do wyniku.
+     * @return Czas w milisekundach.
+     */
+    qint64 elapsedMs() const;
+
+signals:
+    /**
+     * @brief Sygnał emitowany po ustaleniu ostatecznego wyniku.
+     */
+    void finished();
+
+private:
+    friend class ApiClient;
+
+    /**
+     * @brief Konstruktor wyniku (tworzony wyłącznie przez ApiClient).
+     * @param parent Wskaźnik na obiekt nadrzędny.
+     */
+    explicit ApiReply(QObject *parent);
+
+    /// @brief Wysyłane zapytanie.
+    QNetworkRequest request;
+    /// @brief Indeks punktu końcowego API (ApiClient::Endpoint).
+    int endpoint = 0;
+    /// @brief Zapytania w toku (podstawowe i zabezpieczające).
+    QList<QNetworkReply*> inFlight;
+    /// @brief Czas od rozpoczęcia.
+    QElapsedTimer timer;
+    /// @brief Licznik czasu wysłania zapytania zabezpieczającego.
+    QTimer hedgeTimer;
+    /// @brief Liczba wykonanych prób.
+    int attempt = 0;
+    /// @brief Czy wynik jest już ustalony.
+    bool done = false;
+    /// @brief Czy wynik pochodzi z zapytania zabezpieczającego.
+    bool hedgeWon = false;
+    /// @brief Kod błędu.
+    QNetworkReply::NetworkError networkError = QNetworkReply::NoError;
+    /// @brief Opis błędu.
+    QString message;
+    /// @brief Treść odpowiedzi.
+    QByteArray body;
+};
+
+/**
+ * @brief Odporna warstwa zapytań do API GIOŚ.
+ *
+ * Dla każdego punktu końcowego stosuje osobną politykę: limit czasu próby, ponawianie
+ * z wykładniczym wycofaniem i losowym rozrzutem oraz zapytanie zabezpieczające (hedging)
+ * wysyłane, gdy odpowiedź spóźnia się ponad bieżący p95 czasów odpowiedzi tego punktu.
+ * Wspólny wyłącznik (circuit breaker) przestaje odpytywać API, gdy większość zapytań
+ * kończy się błędem, i zwraca wtedy błąd natychmiast.
+ */
+class ApiClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Punkt końcowy API (określa politykę i statystyki).
+     */
+    enum Endpoint {
+        Stations,        ///< Katalog stacji.
+        Sensors,         ///< Czujniki stacji.
+        Measurements,    ///< Pomiary czujnika.
+        AirQualityIndex, ///< Indeks jakości powietrza.
+        EndpointCount    ///< Liczba punktów końcowych.
+    };
+    Q_ENUM(Endpoint)
+
+    /**
+     * @brief Polityka zapytań dla punktu końcowego.
+     */
+    struct Policy {
+        /// @brief Limit czasu jednej próby (ms).
+        int timeoutMs = 10000;
+        /// @brief Maksymalna liczba prób.
+        int maxAttempts = 3;
+        /// @brief Podstawowe opóźnienie ponowienia (ms), podwajane z każdą próbą.
+        int backoffMs = 500;
+        /// @brief Maksymalne opóźnienie ponowienia (ms).
+        int maxBackoffMs = 8000;
+        /// @brief Czy wysyłać zapytania zabezpieczające.
+        bool hedge = true;
+        /// @brief Minimalne opóźnienie zapytania zabezpieczającego (ms).
+        int minHedgeDelayMs = 100;
+    };
+
+    /**
+     * @brief Statystyki punktu końcowego.
+     */
+    struct Stats {
+        /// @brief Liczba wywołań get.
+        int requests = 0;
+        /// @brief Liczba wywołań zakończonych sukcesem.
+        int succeeded = 0;
+        /// @brief Liczba wywołań zakończonych błędem.
+        int failed = 0;
+        /// @brief Liczba ponowień.
+        int retries = 0;
+        /// @brief Liczba przekroczeń limitu czasu próby.
+        int timeouts = 0;
+        /// @brief Liczba wysłanych zapytań zabezpieczających.
+        int hedges = 0;
+        /// @brief Liczba wyników uzyskanych dzięki zapytaniom zabezpieczającym.
+        int hedgeWins = 0;
+        /// @brief Liczba zapytań odrzuconych przez otwarty wyłącznik.
+        int rejected = 0;
+    };
+
+    /// @brief Minimalna liczba próbek przed wysyłaniem zapytań zabezpieczających.
+    static constexpr int MIN_HEDGE_SAMPLES = 20;
+    /// @brief Maksymalny udział zapytań zabezpieczających we wszystkich wywołaniach.
+    static constexpr double HEDGE_BUDGET = 0.1;
+
+    /**
+     * @brief Konstruktor klienta.
+     * @param manager Menedżer sieciowy używany do wysyłania zapytań.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit ApiClient(QNetworkAccessManager* manager, QObject *parent = nullptr);
+
+    /**
+     * @brief Wysyła zapytanie GET zgodnie z polityką punktu końcowego.
+     *
+     * Wynik jest zawsze dostarczany asynchronicznie przez sygnał ApiReply::finished,
+     * także gdy wyłącznik odrzuca zapytanie. Wywołujący zwalnia wynik przez deleteLater.
+     * @param request Zapytanie.
+     * @param endpoint Punkt końcowy API.
+     * @return Obiekt wyniku.
+     */
+    ApiReply* get(const QNetworkRequest& request, Endpoint endpoint);
+
+    /**
+     * @brief Zwraca politykę punktu końcowego.
+     * @param endpoint Punkt końcowy API.
+     * @return Polityka.
+     */
+    Policy policy(Endpoint endpoint) const;
+
+    /**
+     * @brief Zmienia politykę punktu końcowego.
+     * @param endpoint Punkt końcowy API.
+     * @param policy Nowa polityka.
+     */
+    void setPolicy(Endpoint endpoint, const Policy& policy);
+
+    /**
+     * @brief Zwraca statystyki punktu końcowego.
+     * @param endpoint Punkt końcowy API.
+     * @return Statystyki.
+     */
+    Stats stats(Endpoint endpoint) const;
+
+    /**
+     * @brief Zwraca percentyl całkowitych czasów wywołań punktu końcowego.
+     * @param endpoint Punkt końcowy API.
+     * @param fraction Percentyl jako ułamek (0 ... 1).
+     * @return Czas w milisekundach.
+     */
+    double latencyPercentile(Endpoint endpoint, double fraction) const;
+
+    /**
+     * @brief Zwraca stan wyłącznika.
+     * @return Bieżący stan.
+     */
+    CircuitBreaker::State circuitState() const;
+
+    /**
+     * @brief Tworzy tekstowy raport statystyk wszystkich punktów końcowych.
+     * @return Raport (jedna linia na punkt końcowy).
+     */
+    QString metricsReport() const;
+
+signals:
+    /**
+     * @brief Sygnał emitowany przy zmianie stanu wyłącznika.
+     * @param open True, jeśli API jest chwilowo odcięte.
+     */
+    void circuitChanged(bool open);
+
+private:
+    /// @brief Menedżer sieciowy.
+    QNetworkAccessManager* manager;
+    /// @brief Polityki punktów końcowych.
+    Policy policies[EndpointCount];
+    /// @brief Statystyki punktów końcowych.
+    Stats counters[EndpointCount];
+    /// @brief Czasy udanych prób (podstawa opóźnienia zapytań zabezpieczających).
+    LatencyTracker attemptLatency[EndpointCount];
+    /// @brief Całkowite czasy wywołań (podstawa raportu p50/p95/p99).
+    LatencyTracker callLatency[EndpointCount];
+    /// @brief Wyłącznik wspólny dla całego API.
+    CircuitBreaker breaker;
+    /// @brief Zegar monotoniczny dla wyłącznika.
+    QElapsedTimer clock;
+    /// @brief Stan wyłącznika przy ostatnim sprawdzeniu (do emisji circuitChanged).
+    bool circuitOpen = false;
+
+    /**
+     * @brief Rozpoczyna kolejną próbę wywołania.
+     * @param reply Wywołanie.
+     */
+    void startAttempt(ApiReply* reply);
+
+    /**
+     * @brief Wysyła zapytanie sieciowe w ramach bieżącej próby.
+     * @param reply Wywołanie.
+     * @param hedge True dla zapytania zabezpieczającego.
+     */
+    void launch(ApiReply* reply, bool hedge);
+
+    /**
+     * @brief Wysyła zapytanie zabezpieczające, jeśli próba wciąż trwa i pozwala na to budżet.
+     * @param reply Wywołanie.
+     */
+    void sendHedge(ApiReply* reply);
+
+    /**
+     * @brief Obsługuje zakończenie zapytania sieciowego.
+     * @param reply Wywołanie.
+     * @param network Zakończone zapytanie sieciowe.
+     */
+    void onAttemptFinished(ApiReply* reply, QNetworkReply* network);
+
+    /**
+     * @brief Ustala wynik wywołania, przerywa pozostałe zapytania i emituje finished.
+     * @param reply Wywołanie.
+     * @param error Kod błędu.
+     * @param message Opis błędu.
+     * @param body Treść odpowiedzi.
+     */
+    void finish(ApiReply* reply, QNetworkReply::NetworkError error, const QString& message, const QByteArray& body);
+
+    /**
+     * @brief Zwraca opóźnienie zapytania zabezpieczającego.
+     * @param endpoint Punkt końcowy API.
+     * @return Opóźnienie w ms lub -1, jeśli brak wystarczających danych.
+     */
+    int hedgeDelay(Endpoint endpoint) const;
+
+    /**
+     * @brief Zwraca opóźnienie przed kolejną próbą (wykładnicze z losowym rozrzutem).
+     * @param endpoint Punkt końcowy API.
+     * @param attempt Numer zakończonej próby (od 1).
+     * @return Opóźnienie w ms.
+     */
+    int backoffDelay(Endpoint endpoint, int attempt) const;
+
+    /**
+     * @brief Sprawdza, czy błąd uzasadnia ponowienie zapytania.
+     * @param error Kod błędu sieciowego.
+     * @param httpStatus Kod statusu HTTP (0, jeśli brak).
+     * @return True dla błędów przejściowych (limit czasu, połączenie, 5xx, 429).
+     */
+    static bool isRetryable(QNetworkReply::NetworkError error, int httpStatus);
+
+    /**
+     * @brief Emituje circuitChanged, jeśli stan wyłącznika się zmienił.
+     */
+    void updateCircuitState();
+};
+
+#endif // APICLIENT_H
@@ -0,0 +1,1534 @@
+#include "benchmark.h"
+#include "stationlistmodel.h"
+#include "stationfilterproxymodel.h"
+#include "stationmapindex.h"
+#include "stationmapitem.h"
+#include "apiclient.h"
+#include "faultinjectingserver.h"
+#include "stationcatalog.h"
+#include "localingestor.h"
+#include "measurementseries.h"
+#include "historyarchive.h"
+#include "queryengine.h"
+#include "syntheticdata.h"
+#include "mainwindow.h"
+#include "localapiserver.h"
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QUrl>
+#include <QVariantList>
+#include <QVariantMap>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Zwraca percentyl z posortowanych czasów.
+ * @param sorted Posortowane czasy w mikrosekundach.
+ * @param fraction Percentyl jako ułamek (0 ... 1).
+ * @return Wartość percentyla.
+ */
+double Benchmark::percentile(const QVector<double>& sorted, double fraction)
+{
+    if (sorted.isEmpty()) return 0.0;
+    const int index = std::min<int>(sorted.size() - 1, static_cast<int>(fraction * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+/**
+ * @brief Mierzy opóźnienie wyszukiwania stacji w trakcie pisania.
+ *
+ * Każde naciśnięcie klawisza to zmiana tekstu filtra i odczyt pierwszych widocznych wierszy
+ * (tak jak robi to ListView). Ścieżka dawna odtwarza filtrowanie QJsonArray i budowanie
+ * QVariantList z pełną mapą stacji; nie obejmuje kosztu dopisywania do ListModel w QML,
+ * więc rzeczywista różnica jest większa od zmierzonej.
+ * @param stationCount Liczba stacji w syntetycznym katalogu.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runSearch(int stationCount)
+{
+    QTextStream out(stdout);
+    const int visibleRows = 20;
+    if (stationCount <= 0) {
+        out << "Liczba stacji musi być dodatnia\n";
+        return 1;
+    }
+
+    QJsonArray stations = SyntheticData::stations(stationCount);
+    QVector<StationRecord> catalog;
+    catalog.reserve(stations.size());
+    for (const QJsonValue& value : stations) {
+        catalog.append(StationRecord::fromJson(value.toObject()));
+    }
+
+    StationListModel model;
+    StationFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    QElapsedTimer timer;
+    timer.start();
+    model.setStations(catalog);
+    const double loadMs = timer.nsecsElapsed() / 1e6;
+
+    QStringList keystrokes;
+    for (int q = 0; q < 25; ++q) {
+        const QString city = catalog[(q * 7919) % catalog.size()].city;
+        for (int length = 1; length <= city.size(); ++length) keystrokes.append(city.left(length));
+        for (int length = city.size() - 1; length >= 0; --length) keystrokes.append(city.left(length));
+    }
+
+    int notifications = 0;
+    QObject::connect(&proxy, &QAbstractItemModel::rowsInserted, [&notifications]() { ++notifications; });
+    QObject::connect(&proxy, &QAbstractItemModel::rowsRemoved, [&notifications]() { ++notifications; });
+    QObject::connect(&proxy, &QAbstractItemModel::modelReset, [&notifications]() { ++notifications; });
+
+    QVector<double> modelTimes;
+    modelTimes.reserve(keystrokes.size());
+    for (const QString& text : keystrokes) {
+        timer.restart();
+        proxy.setFilterText(text);
+        const int rows = std::min(proxy.rowCount(), visibleRows);
+        for (int row = 0; row < rows; ++row) {
+            proxy.index(row, 0).data(Qt::DisplayRole);
+        }
+        modelTimes.append(timer.nsecsElapsed() / 1e3);
+    }
+
+    QVector<double> legacyTimes;
+    legacyTimes.reserve(keystrokes.size());
+    for (const QString& text : keystrokes) {
+        timer.restart();
+        const QString lower = text.toLower();
+        QVariantList stationsList;
+        for (const QJsonValue& value : stations) {
+            QJsonObject station = value.toObject();
+            if (!lower.isEmpty() && !station["city"].toObject()["name"].toString().toLower().contains(lower)) continue;
+
+            QVariantMap stationMap;
+            stationMap["display"] = QString("%1 - %2").arg(station["city"].toObject()["name"].toString(),
+                                                           station["stationName"].toString());
+            stationMap["stationId"] = station["id"].toInt();
+            stationMap["station"] = station.toVariantMap();
+            stationsList.append(stationMap);
+        }
+        legacyTimes.append(timer.nsecsElapsed() / 1e3);
+    }
+
+    std::sort(modelTimes.begin(), modelTimes.end());
+    std::sort(legacyTimes.begin(), legacyTimes.end());
+
+    out << "Wyszukiwanie stacji: " << stationCount << " stacji, " << keystrokes.size() << " naciśnięć klawiszy\n";
+    out << "Wczytanie katalogu do modelu: " << QString::number(loadMs, 'f', 2) << " ms\n";
+    out << "Model pośredniczący [us]: mediana " << QString::number(percentile(modelTimes, 0.5), 'f', 1)
+        << ", p95 " << QString::number(percentile(modelTimes, 0.95), 'f', 1)
+        << ", maks. " << QString::number(modelTimes.last(), 'f', 1)
+        << ", powiadomień o wierszach: " << notifications << "\n";
+    out << "Dawna QVariantList [us]: mediana " << QString::number(percentile(legacyTimes, 0.5), 'f', 1)
+        << ", p95 " << QString::number(percentile(legacyTimes, 0.95), 'f', 1)
+        << ", maks. " << QString::number(legacyTimes.last(), 'f', 1) << "\n";
+    out.flush();
+    return 0;
+}
+
+/**
+ * @brief Mierzy czas przygotowania klatki mapy stacji.
+ *
+ * Widok 1200x800 przesuwany jest po 60 klatek na każdym poziomie przybliżenia; klastrowanie
+ * jest wyłączane od poziomu StationMapItem::DETAIL_ZOOM, tak jak w elemencie mapy.
+ * @param stationCount Liczba stacji w syntetycznym katalogu.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runMap(int stationCount)
+{
+    QTextStream out(stdout);
+    if (stationCount <= 0) {
+        out << "Liczba stacji musi być dodatnia\n";
+        return 1;
+    }
+
+    QJsonArray stations = SyntheticData::stations(stationCount);
+    QVector<int> ids;
+    QVector<double> latitudes, longitudes;
+    for (const QJsonValue& value : stations) {
+        const StationRecord record = StationRecord::fromJson(value.toObject());
+        ids.append(record.id);
+        latitudes.append(record.latitude);
+        longitudes.append(record.longitude);
+    }
+
+    StationMapIndex index;
+    QElapsedTimer timer;
+    timer.start();
+    index.setStations(ids, latitudes, longitudes);
+    for (int i = 0; i < ids.size(); i += 3) {
+        index.setLevel(ids[i], i % 6);
+    }
+    const double buildMs = timer.nsecsElapsed() / 1e6;
+
+    const QRectF bounds = index.bounds();
+    const double clusterSize = 28.0;
+    out << "Mapa stacji: " << stationCount << " stacji, budowa indeksu " << QString::number(buildMs, 'f', 2) << " ms\n";
+
+    QVector<double> allTimes;
+    for (double zoom = 5.0; zoom <= 15.0; zoom += 1.0) {
+        StationMapIndex::Viewport viewport;
+        viewport.width = 1200.0;
+        viewport.height = 800.0;
+        viewport.scale = 256.0 * std::exp2(zoom);
+
+        QVector<double> times;
+        int markerTotal = 0;
+        int stationTotal = 0;
+        const int frames = 60;
+        for (int frame = 0; frame < frames; ++frame) {
+            const double t = static_cast<double>(frame) / (frames - 1);
+            viewport.centerX = bounds.left() + bounds.width() * t;
+            viewport.centerY = bounds.top() + bounds.height() * (0.5 + 0.4 * std::sin(6.28318530718 * t));
+
+            int visible = 0;
+            timer.restart();
+            const QVector<StationMapIndex::Marker> markers =
+                index.markers(viewport, zoom >= StationMapItem::DETAIL_ZOOM ? 0.0 : clusterSize, &visible);
+            times.append(timer.nsecsElapsed() / 1e3);
+            markerTotal += markers.size();
+            stationTotal += visible;
+        }
+
+        allTimes += times;
+        std::sort(times.begin(), times.end());
+        out << "  przybliżenie " << zoom << ": mediana " << QString::number(percentile(times, 0.5), 'f', 1)
+            << " us, p95 " << QString::number(percentile(times, 0.95), 'f', 1)
+            << " us, śr. stacji w widoku " << stationTotal / frames
+            << ", śr. znaczników " << markerTotal / frames << "\n";
+    }
+
+    std::sort(allTimes.begin(), allTimes.end());
+    out << "Wszystkie klatki: p95 " << QString::number(percentile(allTimes, 0.95), 'f', 1)
+        << " us, maks. " << QString::number(allTimes.last(), 'f', 1) << " us (budżet klatki 16667 us)\n";
+    out.flush();
+    return 0;
+}
+
+namespace {
+
+/**
+ * @brief Wynik serii zapytań sieciowych.
+ */
+struct NetworkRun {
+    /// @brief Całkowite czasy zapytań w milisekundach.
+    QVector<double> latencies;
+    /// @brief Liczba zapytań zakończonych błędem.
+    int failures = 0;
+};
+
+/**
+ * @brief Wykonuje serię zapytań z ograniczoną liczbą równoczesnych zapytań.
+ * @param count Liczba zapytań.
+ * @param concurrency Maksymalna liczba równoczesnych zapytań.
+ * @param issue Funkcja wysyłająca zapytanie o podanym numerze i zgłaszająca wynik przez wywołanie zwrotne.
+ * @return Czasy i liczba błędów.
+ */
+NetworkRun runRequests(int count, int concurrency,
+                       const std::function<void(int, const std::function<void(bool)>&)>& issue)
+{
+    NetworkRun run;
+    QEventLoop loop;
+    int started = 0;
+    int completed = 0;
+
+    std::function<void()> startNext = [&]() {
+        if (started >= count) return;
+        const int index = started++;
+        QElapsedTimer timer;
+        timer.start();
+        issue(index, [&, timer](bool ok) {
+            run.latencies.append(timer.elapsed());
+            run.failures += ok ? 0 : 1;
+            if (++completed == count) {
+                loop.quit();
+            } else {
+                startNext();
+            }
+        });
+    };
+
+    for (int i = 0; i < concurrency; ++i) {
+        startNext();
+    }
+    if (completed < count) loop.exec();
+    std::sort(run.latencies.begin(), run.latencies.end());
+    return run;
+}
+
+}
+
+/**
+ * @brief Porównuje opóźnienia zapytań bez zabezpieczeń i przez ApiClient podczas awarii API.
+ *
+ * Zapytanie bez zabezpieczeń nie ma limitu czasu, więc w aplikacji wisiałoby bez końca;
+ * w pomiarze jest przerywane po NAIVE_CAP_MS, co zaniża wynik wariantu bez zabezpieczeń.
+ * ApiClient zachowuje stan między fazami, tak jak w działającej aplikacji (p95 z fazy
+ * normalnej wyznacza opóźnienie zapytań zabezpieczających, a wyłącznik reaguje na awarię).
+ * @param requestCount Liczba zapytań w fazach normalnej pracy i spowolnienia.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runNetwork(int requestCount)
+{
+    QTextStream out(stdout);
+    if (requestCount <= 0) {
+        out << "Liczba zapytań musi być dodatnia\n";
+        return 1;
+    }
+
+    FaultInjectingServer server;
+    if (!server.listen()) {
+        out << "Nie można uruchomić lokalnego serwera testowego\n";
+        return 1;
+    }
+
+    const int NAIVE_CAP_MS = 5000;
+    const int CONCURRENCY = 8;
+
+    FaultInjectingServer::Profile normal;
+    FaultInjectingServer::Profile slowdown = normal;
+    slowdown.slowFraction = 0.1;
+    slowdown.errorFraction = 0.05;
+    slowdown.hangFraction = 0.02;
+    FaultInjectingServer::Profile outage = normal;
+    outage.hangFraction = 1.0;
+
+    struct Phase {
+        QString name;
+        FaultInjectingServer::Profile profile;
+        int count;
+    };
+    const QVector<Phase> phases = {
+        { "normalna praca", normal, requestCount },
+        { "spowolnienie (10% po 3 s, 5% błędów 503, 2% bez odpowiedzi)", slowdown, requestCount },
+        { "brak odpowiedzi", outage, std::min(requestCount, 40) }
+    };
+
+    QNetworkAccessManager naiveManager;
+    QNetworkAccessManager resilientManager;
+    ApiClient client(&resilientManager);
+    ApiClient::Policy policy = client.policy(ApiClient::Measurements);
+    policy.timeoutMs = 1500;
+    policy.backoffMs = 100;
+    policy.maxBackoffMs = 1000;
+    client.setPolicy(ApiClient::Measurements, policy);
+
+    auto requestFor = [&server](int index) {
+        return QNetworkRequest(QUrl(server.baseUrl() + "data/getData/" + QString::number(1000 + index % 50)));
+    };
+
+    out << "Lokalny serwer testowy: " << server.baseUrl() << ", " << CONCURRENCY << " równoczesnych zapytań\n";
+    for (const Phase& phase : phases) {
+        server.setProfile(phase.profile);
+
+        NetworkRun naive = runRequests(phase.count, CONCURRENCY, [&](int index, const std::function<void(bool)>& done) {
+            QNetworkReply* reply = naiveManager.get(requestFor(index));
+            QTimer::singleShot(NAIVE_CAP_MS, reply, [reply]() { reply->abort(); });
+            QObject::connect(reply, &QNetworkReply::finished, reply, [reply, done]() {
+                done(reply->error() == QNetworkReply::NoError);
+                reply->deleteLater();
+            });
+        });
+
+        NetworkRun resilient = runRequests(phase.count, CONCURRENCY, [&](int index, const std::function<void(bool)>& done) {
+            ApiReply* reply = client.get(requestFor(index), ApiClient::Measurements);
+            QObject::connect(reply, &ApiReply::finished, reply, [reply, done]() {
+                done(reply->error() == QNetworkReply::NoError);
+                reply->deleteLater();
+            });
+        });
+
+        auto print = [&out](const QString& label, const NetworkRun& run) {
+            out << "  " << label << ": p50 " << QString::number(percentile(run.latencies, 0.5), 'f', 0)
+                << " ms, p95 " << QString::number(percentile(run.latencies, 0.95), 'f', 0)
+                << " ms, p99 " << QString::number(percentile(run.latencies, 0.99), 'f', 0)
+                << " ms, maks. " << QString::number(run.latencies.last(), 'f', 0)
+                << " ms, błędy " << run.failures << "\n";
+        };
+        out << "Faza: " << phase.name << " (" << phase.count << " zapytań)\n";
+        print("bez zabezpieczeń", naive);
+        print("ApiClient", resilient);
+        out.flush();
+    }
+
+    out << "Statystyki ApiClient:\n" << client.metricsReport() << "\n";
+    out << "Zapytania bez zabezpieczeń przerywano po " << NAIVE_CAP_MS << " ms (w aplikacji czekałyby bez limitu)\n";
+    out.flush();
+    return 0;
+}
+
+/**
+ * @brief Zwraca pamięć rezydentną procesu.
+ *
+ * Przed odczytem zwalnia do systemu nieużywane strony sterty (glibc), aby pomiar
+ * obejmował tylko pamięć zajętą przez żywe obiekty.
+ * @return Rozmiar w bajtach lub -1, jeśli pomiar nie jest dostępny na tej platformie.
+ */
+qint64 Benchmark::residentMemory()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    for (const QByteArray& line : status.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Porównuje pamięć zajmowaną przez dawny katalog JSON i zwarty katalog stacji.
+ *
+ * Źródło katalogu trzymane jest jako bajty JSON; najpierw budowany jest zwarty katalog
+ * (wraz z rekordami dla modelu listy), potem na nim dawna reprezentacja, a różnice pamięci
+ * rezydentnej mierzone są po każdym etapie.
+ * @param source Liczba stacji syntetycznego katalogu lub ścieżka do zapisanej odpowiedzi station/findAll.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runCatalog(const QString& source)
+{
+    QTextStream out(stdout);
+    bool isCount = false;
+    const int stationCount = source.toInt(&isCount);
+
+    QJsonArray stations;
+    QString description;
+    if (isCount) {
+        if (stationCount <= 0) {
+            out << "Liczba stacji musi być dodatnia\n";
+            return 1;
+        }
+        stations = SyntheticData::stations(stationCount);
+        description = "syntetyczny";
+    } else {
+        QFile file(source);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out << "Nie można otworzyć pliku " << source << "\n";
+            return 1;
+        }
+        QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+        if (!document.isArray()) {
+            out << "Plik nie zawiera tablicy stacji w formacie API GIOŚ\n";
+            return 1;
+        }
+        stations = document.array();
+        description = "rzeczywisty (" + source + "), czujniki syntetyczne";
+    }
+
+    const QByteArray stationBytes = QJsonDocument(stations).toJson(QJsonDocument::Compact);
+    const QByteArray sensorBytes = QJsonDocument(SyntheticData::sensors(stations)).toJson(QJsonDocument::Compact);
+    stations = QJsonArray();
+    const qint64 baseline = residentMemory();
+
+    StationCatalog catalog;
+    QVector<StationRecord> records;
+    {
+        catalog.setStations(QJsonDocument::fromJson(stationBytes).array());
+        const QJsonArray sensors = QJsonDocument::fromJson(sensorBytes).array();
+        for (const QJsonValue& value : sensors) {
+            catalog.addSensor(value.toObject());
+        }
+        records = catalog.stationRecords();
+    }
+    const qint64 compact = residentMemory();
+
+    QJsonArray allStations = QJsonDocument::fromJson(stationBytes).array();
+    QMap<int, QJsonObject> stationsMap;
+    QVariantList displayStations;
+    for (const QJsonValue& value : allStations) {
+        QJsonObject station = value.toObject();
+        stationsMap[station["id"].toInt()] = station;
+
+        QVariantMap stationMap;
+        stationMap["display"] = QString("%1 - %2").arg(station["city"].toObject()["name"].toString(),
+                                                       station["stationName"].toString());
+        stationMap["stationId"] = station["id"].toInt();
+        stationMap["station"] = station.toVariantMap();
+        displayStations.append(stationMap);
+    }
+    QMap<int, QJsonObject> sensorsMap;
+    const QJsonArray sensors = QJsonDocument::fromJson(sensorBytes).array();
+    for (const QJsonValue& value : sensors) {
+        QJsonObject sensor = value.toObject();
+        sensorsMap[sensor["id"].toInt()] = sensor;
+    }
+    const qint64 legacy = residentMemory();
+
+    out << "Katalog " << description << ": " << catalog.stationCount() << " stacji, "
+        << catalog.sensorCount() << " czujników, " << catalog.internedStrings() << " napisów w puli\n";
+    if (baseline < 0) {
+        out << "Pomiar pamięci rezydentnej nie jest dostępny na tej platformie\n";
+        out.flush();
+        return 0;
+    }
+
+    const double compactMb = (compact - baseline) / 1048576.0;
+    const double legacyMb = (legacy - compact) / 1048576.0;
+    out << "Pamięć rezydentna bez katalogu: " << QString::number(baseline / 1048576.0, 'f', 1) << " MB\n";
+    out << "Dawny katalog (QJsonArray, mapy QJsonObject, lista QVariantMap): +"
+        << QString::number(legacyMb, 'f', 1) << " MB\n";
+    out << "Zwarty katalog (struktura tablic, pula napisów, rekordy modelu listy): +"
+        << QString::number(compactMb, 'f', 1) << " MB\n";
+    if (compactMb > 0.0) {
+        out << "Zmniejszenie: " << QString::number(legacyMb / compactMb, 'f', 1) << "x\n";
+    }
+    out << "(kontrola: " << allStations.size() << " / " << stationsMap.size() << " / "
+        << displayStations.size() << " / " << sensorsMap.size() << " / " << records.size() << ")\n";
+    out.flush();
+    return 0;
+}
+
+/**
+ * @brief Mierzy odbiór odczytów z czujników lokalnych przez UDP.
+ *
+ * Nadawca działa przez DURATION_S sekund; po jego zakończeniu pętla zdarzeń działa jeszcze
+ * chwilę, aby opróżnić bufor gniazda i kolejkę. Odczyty utracone w buforze jądra (przed
+ * kolejką) są liczone jako różnica między wysłanymi a odebranymi.
+ * @param rate Liczba odczytów na sekundę.
+ * @return Kod wyjścia (0 oznacza sukces, 1 przy utracie odczytów).
+ */
+int Benchmark::runIngest(int rate)
+{
+    QTextStream out(stdout);
+    if (rate < 2) {
+        out << "Liczba odczytów na sekundę musi wynosić co najmniej 2\n";
+        return 1;
+    }
+
+    const int DURATION_S = 10;
+    const int devices = rate / 2;
+    const qint64 datagrams = static_cast<qint64>(devices) * DURATION_S;
+
+    LocalIngestor ingestor;
+    if (!ingestor.listenUdp(0)) {
+        out << "Nie można otworzyć gniazda UDP\n";
+        return 1;
+    }
+    const quint16 port = ingestor.udpPort();
+
+    QHash<int, MeasurementSeries> series;
+    QObject::connect(&ingestor, &LocalIngestor::readingsReady, [&series](const QVector<LocalReading>& readings) {
+        QHash<int, MeasurementSeries> batches;
+        for (const LocalReading& reading : readings) {
+            MeasurementSeries& batch = batches[reading.deviceId * LocalIngestor::ParameterCount + reading.parameter];
+            batch.timestamps.append(reading.timestamp);
+            batch.values.append(reading.value);
+        }
+        for (auto it = batches.constBegin(); it != batches.constEnd(); ++it) {
+            MeasurementSeries& target = series[it.key()];
+            target.append(it.value());
+            target.keepLast(15 * 60 * 1000);
+        }
+    });
+
+    QElapsedTimer frameClock;
+    double maxLagMs = 0.0;
+    QTimer frameTimer;
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    frameTimer.setInterval(LocalIngestor::FRAME_INTERVAL_MS);
+    QObject::connect(&frameTimer, &QTimer::timeout, [&frameClock, &maxLagMs]() {
+        maxLagMs = std::max(maxLagMs, frameClock.nsecsElapsed() / 1e6 - LocalIngestor::FRAME_INTERVAL_MS);
+        frameClock.restart();
+    });
+
+    QThread* sender = QThread::create([port, devices, datagrams]() {
+        QUdpSocket socket;
+        QElapsedTimer clock;
+        clock.start();
+        const double intervalNs = 1e9 / devices;
+        for (qint64 i = 0; i < datagrams; ++i) {
+            const qint64 ahead = static_cast<qint64>(i * intervalNs) - clock.nsecsElapsed();
+            if (ahead > 1000000) QThread::usleep(static_cast<unsigned long>(ahead / 1000));
+
+            const int device = static_cast<int>(i % devices);
+            const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+            const QByteArray datagram = QByteArray::number(device) + ";PM10;" + QByteArray::number(timestamp) + ";"
+                                        + QByteArray::number(20.0 + device % 40) + "\n"
+                                        + QByteArray::number(device) + ";PM2.5;" + QByteArray::number(timestamp) + ";"
+                                        + QByteArray::number(12.0 + device % 25) + "\n";
+            socket.writeDatagram(datagram, QHostAddress::LocalHost, port);
+        }
+    });
+
+    out << "Odbiór lokalny: " << devices << " urządzeń, " << rate << " odczytów/s przez " << DURATION_S
+        << " s (port UDP " << port << ")\n";
+    out.flush();
+
+    QEventLoop loop;
+    QObject::connect(sender, &QThread::finished, &loop, [&loop]() {
+        QTimer::singleShot(500, &loop, &QEventLoop::quit);
+    });
+    frameClock.start();
+    frameTimer.start();
+    sender->start();
+    loop.exec();
+    frameTimer.stop();
+    sender->wait();
+    delete sender;
+    ingestor.stop();
+
+    const LocalIngestor::Stats stats = ingestor.stats();
+    const qint64 sent = datagrams * LocalIngestor::ParameterCount;
+    const qint64 lost = sent - stats.received;
+    out << "Wysłano " << sent << ", odebrano " << stats.received << ", przekazano " << stats.delivered
+        << " w " << stats.frames << " klatkach\n";
+    out << "Utracone: w kolejce " << stats.dropped << ", przed kolejką " << std::max<qint64>(0, lost - stats.dropped)
+        << ", błędne linie " << stats.parseErrors << "\n";
+    out << "Kolejka: maks. " << stats.maxQueueDepth << " z " << LocalIngestor::QUEUE_CAPACITY
+        << ", najdłuższa klatka " << QString::number(stats.maxFrameMs, 'f', 2)
+        << " ms, maks. opóźnienie pętli zdarzeń " << QString::number(maxLagMs, 'f', 2) << " ms\n";
+    out.flush();
+    return lost > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Mierzy przepustowość wczytywania całego archiwum lokalnej bazy danych.
+ *
+ * Przed pomiarami archiwum jest wczytywane raz, aby oba warianty czytały pliki z pamięci
+ * podręcznej systemu i porównanie dotyczyło parsowania, a nie stanu dysku.
+ * @param fileCount Liczba plików archiwum.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runArchive(int fileCount)
+{
+    QTextStream out(stdout);
+    if (fileCount <= 0) {
+        out << "Liczba plików musi być dodatnia\n";
+        return 1;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        out << "Nie można utworzyć katalogu tymczasowego\n";
+        return 1;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 bytes = SyntheticData::archive(directory.path(), fileCount);
+    if (bytes < 0) {
+        out << "Nie można zapisać syntetycznego archiwum\n";
+        return 1;
+    }
+    out << "Syntetyczne archiwum: " << fileCount << " plików, " << QString::number(bytes / 1048576.0, 'f', 1)
+        << " MB (wygenerowane w " << timer.elapsed() << " ms)\n";
+    out.flush();
+
+    HistoryArchive::load(directory.path());
+
+    QThreadPool serialPool;
+    serialPool.setMaxThreadCount(1);
+    auto report = [&out](const QString& label, const HistoryArchive& archive) {
+        const HistoryArchive::LoadStats stats = archive.loadStats();
+        const double seconds = stats.elapsedMs / 1000.0;
+        out << label << " (" << stats.threads << " wątków): " << QString::number(stats.elapsedMs, 'f', 0) << " ms, "
+            << QString::number(stats.files / seconds, 'f', 0) << " plików/s, "
+            << QString::number(stats.bytes / 1048576.0 / seconds, 'f', 1) << " MB/s"
+            << (stats.failed > 0 ? QString(", %1 błędnych plików").arg(stats.failed) : QString()) << "\n";
+        out.flush();
+    };
+
+    const HistoryArchive serial = HistoryArchive::load(directory.path(), &serialPool);
+    report("Jeden wątek", serial);
+    const HistoryArchive parallel = HistoryArchive::load(directory.path());
+    report("Wszystkie rdzenie", parallel);
+
+    if (parallel.loadStats().elapsedMs > 0.0) {
+        out << "Przyspieszenie: " << QString::number(serial.loadStats().elapsedMs / parallel.loadStats().elapsedMs, 'f', 1)
+            << "x\n";
+    }
+    out << "Zbiór danych: " << parallel.stations().size() << " stacji, " << parallel.seriesCount() << " serii, "
+        << parallel.pointCount() << " punktów, parametry: " << parallel.parameters().join(", ") << "\n";
+
+    timer.restart();
+    const HistoryArchive::Summary summary = parallel.summarize(-1, "PM10", std::numeric_limits<qint64>::min(),
+                                                               std::numeric_limits<qint64>::max());
+    const double summaryMs = timer.nsecsElapsed() / 1e6;
+    const qint64 dayAgo = QDateTime::currentMSecsSinceEpoch() - 24 * 3600 * 1000;
+    timer.restart();
+    const QVector<HistoryArchive::Point> recent = parallel.query(-1, QString(), dayAgo,
+                                                                 std::numeric_limits<qint64>::max());
+    const double queryMs = timer.nsecsElapsed() / 1e6;
+    out << "Średnia PM10 z całego archiwum: " << QString::number(summary.mean, 'f', 1) << " (" << summary.count
+        << " wartości z " << summary.series << " serii) w " << QString::number(summaryMs, 'f', 2) << " ms\n";
+    out << "Ostatnia doba, wszystkie parametry: " << recent.size() << " punktów w " << QString::number(queryMs, 'f', 2)
+        << " ms\n";
+
+    QueryEngine engine;
+    engine.setArchive(parallel);
+    QueryEngine::Query profile;
+    profile.paramCodes = QStringList{"PM10", "PM2.5"};
+    profile.grouping = QueryEngine::HourOfDay;
+    profile.percentiles = {0.5, 0.95};
+    const QueryEngine::Result computed = engine.runAsync({profile}).result().value(0);
+    timer.restart();
+    const QueryEngine::Result memoized = engine.runAsync({profile}).result().value(0);
+    const double memoizedMs = timer.nsecsElapsed() / 1e6;
+    out << "Profil dobowy PM10 i PM2.5 (średnia, p50, p95): " << computed.rows.size() << " wierszy, "
+        << computed.scannedPoints << " punktów w " << QString::number(computed.elapsedMs, 'f', 2)
+        << " ms, powtórzenie z pamięci w " << QString::number(memoizedMs, 'f', 3) << " ms"
+        << (memoized.cached ? "" : " (bez trafienia w pamięci!)") << "\n";
+    out << "(kontrola: " << serial.pointCount() << " / " << parallel.pointCount() << ")\n";
+    out.flush();
+    return serial.pointCount() == parallel.pointCount() ? 0 : 1;
+}
+
+namespace {
+
+/**
+ * @brief Przetwarza zdarzenia do spełnienia warunku lub upływu limitu czasu.
+ * @param done Warunek sprawdzany po każdej porcji zdarzeń.
+ * @param timeoutMs Limit czasu (ms).
+ * @return True, jeśli warunek został spełniony.
+ */
+bool waitUntil(const std::function<bool()>& done, int timeoutMs)
+{
+    if (done()) return true;
+    QEventLoop loop;
+    QTimer poll;
+    poll.setInterval(1);
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (done()) loop.quit();
+    });
+    QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+    poll.start();
+    loop.exec();
+    return done();
+}
+
+/**
+ * @brief Wyniki jednej wielkości katalogu w pomiarze skalowania.
+ */
+struct ScaleRow {
+    /// @brief Liczba stacji.
+    int stations = 0;
+    /// @brief Pobranie i wyświetlenie katalogu (ms).
+    double catalogMs = 0.0;
+    /// @brief p95 opóźnienia naciśnięcia klawisza podczas wyszukiwania (us).
+    double searchP95Us = 0.0;
+    /// @brief Mediana czasu od wyboru czujnika do danych wykresu (ms).
+    double chartMs = 0.0;
+    /// @brief Zapis serii do lokalnej bazy danych (ms).
+    double saveMs = 0.0;
+    /// @brief Odczyt serii historycznej i jej wyświetlenie (ms).
+    double loadMs = 0.0;
+    /// @brief Analiza bieżącej serii (ms).
+    double analysisMs = 0.0;
+    /// @brief Zapytanie analityczne bez pamięci wyników (ms).
+    double queryMs = 0.0;
+    /// @brief Pamięć rezydentna na końcu pomiaru (MB).
+    double memoryMb = 0.0;
+};
+
+/**
+ * @brief Jeden krok symulowanej sesji przeglądania stacji.
+ */
+struct SessionClick {
+    /// @brief Wybierana stacja.
+    int stationId = -1;
+    /// @brief Wybierany następnie czujnik stacji.
+    int sensorId = -1;
+    /// @brief Czas oglądania wykresu przed kolejnym wyborem (ms).
+    int thinkMs = 0;
+};
+
+/**
+ * @brief Przetwarza zdarzenia przez podany czas.
+ * @param milliseconds Czas (ms).
+ */
+void pause(int milliseconds)
+{
+    QEventLoop loop;
+    QTimer::singleShot(milliseconds, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+}
+
+/**
+ * @brief Mierzy skalowanie aplikacji dla syntetycznych katalogów rosnącej wielkości.
+ *
+ * Odpowiedzi z pomiarami są generowane przez serwer przed wyborem czujnika, a zamiennik API
+ * odpowiada bez opóźnienia, więc zmierzone czasy obejmują transfer lokalny, parsowanie
+ * i przetwarzanie w aplikacji. Etap wykresu kończy się na sygnale z danymi dla QML
+ * (bez renderowania wykresu).
+ * @param sizes Wielkości katalogów rozdzielone przecinkami.
+ * @param years Długość historii każdego czujnika w latach.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runScale(const QString& sizes, int years)
+{
+    QTextStream out(stdout);
+    QVector<int> stationCounts;
+    for (const QString& part : sizes.split(',', Qt::SkipEmptyParts)) {
+        const int count = part.trimmed().toInt();
+        if (count <= 0) {
+            out << "Nieprawidłowa wielkość katalogu: " << part << "\n";
+            return 1;
+        }
+        stationCounts.append(count);
+    }
+    if (stationCounts.isEmpty() || years <= 0) {
+        out << "Podaj wielkości katalogów (np. 1000,10000) i dodatnią liczbę lat historii\n";
+        return 1;
+    }
+
+    const int TIMEOUT_MS = 120000;
+    const int VISIBLE_ROWS = 20;
+    const int hours = years * 8760;
+    QStandardPaths::setTestModeEnabled(true);
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    out << "Dane lokalne: " << dataPath << ", historia czujnika: " << hours << " godzin\n";
+
+    QVector<ScaleRow> rows;
+    bool timedOut = false;
+    for (const int stationCount : stationCounts) {
+        QDir(dataPath).removeRecursively();
+        ScaleRow row;
+        row.stations = stationCount;
+        QElapsedTimer timer;
+
+        timer.start();
+        const QJsonArray stations = SyntheticData::stations(stationCount);
+        const QJsonArray sensors = SyntheticData::sensors(stations);
+        FaultInjectingServer server;
+        FaultInjectingServer::Profile immediate;
+        immediate.latencyMs = 0;
+        immediate.jitterMs = 0;
+        server.setProfile(immediate);
+        server.setDataset(stations, sensors, hours);
+        if (!server.listen()) {
+            out << "Nie można uruchomić lokalnego serwera testowego\n";
+            return 1;
+        }
+        out << "\n== " << stationCount << " stacji, " << sensors.size() << " czujników (generowanie "
+            << QString::number(timer.nsecsElapsed() / 1e6, 'f', 0) << " ms) ==\n";
+
+        const qint64 baseline = residentMemory();
+        MainWindow window(nullptr, true);
+        window.setApiBaseUrl(server.baseUrl());
+        window.setPrefetchEnabled(false);
+        StationFilterProxyModel* stationList = window.stationListModel();
+
+        timer.restart();
+        window.warmUp();
+        if (!waitUntil([&]() { return stationList->rowCount() == stationCount; }, TIMEOUT_MS)) {
+            out << "Katalog nie został wczytany w limicie czasu\n";
+            timedOut = true;
+            continue;
+        }
+        row.catalogMs = timer.nsecsElapsed() / 1e6;
+        const qint64 catalogMemory = residentMemory();
+        out << "Katalog (pobranie, parsowanie, model listy): " << QString::number(row.catalogMs, 'f', 1) << " ms";
+        if (baseline >= 0) {
+            out << ", pamięć +" << QString::number((catalogMemory - baseline) / 1048576.0, 'f', 1) << " MB";
+        }
+        out << "\n";
+
+        QStringList keystrokes;
+        for (int q = 0; q < 10; ++q) {
+            const QString city = stations[(q * 7919) % stations.size()].toObject()["city"].toObject()["name"].toString();
+            for (int length = 1; length <= city.size(); ++length) keystrokes.append(city.left(length));
+            for (int length = city.size() - 1; length >= 0; --length) keystrokes.append(city.left(length));
+        }
+        QVector<double> searchTimes;
+        searchTimes.reserve(keystrokes.size());
+        for (const QString& text : keystrokes) {
+            timer.restart();
+            window.searchStations(text);
+            const int visible = std::min(stationList->rowCount(), VISIBLE_ROWS);
+            for (int r = 0; r < visible; ++r) {
+                stationList->index(r, 0).data(Qt::DisplayRole);
+            }
+            searchTimes.append(timer.nsecsElapsed() / 1e3);
+        }
+        timer.restart();
+        window.showAllStations();
+        const double showAllUs = timer.nsecsElapsed() / 1e3;
+        std::sort(searchTimes.begin(), searchTimes.end());
+        row.searchP95Us = percentile(searchTimes, 0.95);
+        out << "Wyszukiwanie (" << searchTimes.size() << " naciśnięć): mediana "
+            << QString::number(percentile(searchTimes, 0.5), 'f', 1) << " us, p95 "
+            << QString::number(row.searchP95Us, 'f', 1) << " us, maks. "
+            << QString::number(searchTimes.last(), 'f', 1) << " us; wszystkie stacje "
+            << QString::number(showAllUs, 'f', 1) << " us\n";
+
+        const int stationId = stations[stationCount / 2].toObject()["id"].toInt();
+        const int sensorCount = 3 + stationId % 4;
+        for (int k = 0; k < sensorCount; ++k) {
+            server.prepareMeasurements(stationId * 10 + k);
+        }
+        timer.restart();
+        window.stationSelected(stationId);
+        if (!waitUntil([&]() { return window.sensorListModel()->rowCount() == sensorCount; }, TIMEOUT_MS)) {
+            out << "Lista czujników nie została wczytana w limicie czasu\n";
+            timedOut = true;
+            continue;
+        }
+        out << "Wybór stacji (czujniki): " << QString::number(timer.nsecsElapsed() / 1e6, 'f', 1) << " ms\n";
+
+        int points = 0;
+        bool chartReady = false;
+        QObject::connect(&window, &MainWindow::measurementsUpdateRequested, &window,
+                         [&](const QString& key, const QVariantList& values) {
+                             if (key != "Error" && !values.isEmpty()) {
+                                 points = values.size();
+                                 chartReady = true;
+                             }
+                         });
+        QVector<double> chartTimes;
+        int sensorId = -1;
+        for (int k = 0; k < sensorCount; ++k) {
+            sensorId = stationId * 10 + k;
+            chartReady = false;
+            timer.restart();
+            window.sensorSelected(sensorId);
+            if (!waitUntil([&]() { return chartReady; }, TIMEOUT_MS)) break;
+            chartTimes.append(timer.nsecsElapsed() / 1e6);
+        }
+        if (chartTimes.size() < sensorCount) {
+            out << "Pomiary czujnika " << sensorId << " nie zostały wczytane w limicie czasu\n";
+            timedOut = true;
+            continue;
+        }
+        std::sort(chartTimes.begin(), chartTimes.end());
+        row.chartMs = percentile(chartTimes, 0.5);
+        out << "Wybór czujnika do danych wykresu (" << points << " punktów): mediana "
+            << QString::number(row.chartMs, 'f', 1) << " ms, maks. "
+            << QString::number(chartTimes.last(), 'f', 1) << " ms\n";
+
+        timer.restart();
+        window.saveMeasurementsToDatabase();
+        row.saveMs = timer.nsecsElapsed() / 1e6;
+        timer.restart();
+        window.loadHistoricalMeasurements(sensorId);
+        row.loadMs = timer.nsecsElapsed() / 1e6;
+        out << "Lokalna baza danych: zapis " << QString::number(row.saveMs, 'f', 1) << " ms, odczyt z wyświetleniem "
+            << QString::number(row.loadMs, 'f', 1) << " ms\n";
+
+        timer.restart();
+        const QVariantMap analysis = window.analyzeMeasurements();
+        row.analysisMs = timer.nsecsElapsed() / 1e6;
+
+        bool archiveReady = false;
+        QObject::connect(&window, &MainWindow::archiveLoaded, &window, [&archiveReady]() { archiveReady = true; });
+        timer.restart();
+        window.loadArchive();
+        if (!waitUntil([&]() { return archiveReady; }, TIMEOUT_MS)) {
+            out << "Archiwum nie zostało wczytane w limicie czasu\n";
+            timedOut = true;
+            continue;
+        }
+        const double archiveMs = timer.nsecsElapsed() / 1e6;
+
+        QVariantMap query;
+        query["paramCodes"] = QStringList{"PM10", "PM2.5", "NO2", "O3"};
+        query["groupBy"] = "month";
+        query["aggregates"] = QStringList{"mean", "max", "p95"};
+        QHash<int, QVariantList> queryResults;
+        QObject::connect(&window, &MainWindow::queryResultsReady, &window,
+                         [&queryResults](int requestId, const QVariantList& results) {
+                             queryResults.insert(requestId, results);
+                         });
+        timer.restart();
+        const int coldRequest = window.runQuery(query);
+        if (!waitUntil([&]() { return queryResults.contains(coldRequest); }, TIMEOUT_MS)) {
+            out << "Zapytanie analityczne nie zostało wykonane w limicie czasu\n";
+            timedOut = true;
+            continue;
+        }
+        row.queryMs = timer.nsecsElapsed() / 1e6;
+        const QVariantMap cold = queryResults.value(coldRequest).value(0).toMap();
+        timer.restart();
+        const int memoRequest = window.runQuery(query);
+        waitUntil([&]() { return queryResults.contains(memoRequest); }, TIMEOUT_MS);
+        const double memoUs = timer.nsecsElapsed() / 1e3;
+        out << "Analizy: bieżąca seria " << QString::number(row.analysisMs, 'f', 1) << " ms ("
+            << analysis.value("count").toInt() << " wartości), archiwum " << QString::number(archiveMs, 'f', 1)
+            << " ms, profil miesięczny " << QString::number(row.queryMs, 'f', 1) << " ms ("
+            << cold.value("rows").toList().size() << " wierszy), z pamięci wyników "
+            << QString::number(memoUs, 'f', 1) << " us\n";
+
+        const qint64 finalMemory = residentMemory();
+        row.memoryMb = finalMemory >= 0 ? finalMemory / 1048576.0 : -1.0;
+        if (finalMemory >= 0) {
+            out << "Pamięć rezydentna: " << QString::number(row.memoryMb, 'f', 1) << " MB\n";
+        }
+        rows.append(row);
+        out.flush();
+    }
+    QDir(dataPath).removeRecursively();
+
+    out << "\nstacje | katalog ms | szukanie p95 us | wykres ms | zapis ms | odczyt ms | analiza ms | zapytanie ms | pamięć MB\n";
+    for (const ScaleRow& row : rows) {
+        out << row.stations << " | " << QString::number(row.catalogMs, 'f', 1)
+            << " | " << QString::number(row.searchP95Us, 'f', 1)
+            << " | " << QString::number(row.chartMs, 'f', 1)
+            << " | " << QString::number(row.saveMs, 'f', 1)
+            << " | " << QString::number(row.loadMs, 'f', 1)
+            << " | " << QString::number(row.analysisMs, 'f', 1)
+            << " | " << QString::number(row.queryMs, 'f', 1)
+            << " | " << (row.memoryMb >= 0.0 ? QString::number(row.memoryMb, 'f', 1) : QString("-")) << "\n";
+    }
+    out.flush();
+    return timedOut ? 1 : 0;
+}
+
+/**
+ * @brief Porównuje sesję przeglądania stacji bez wstępnego pobierania i z nim.
+ *
+ * Kolejna stacja sesji to z prawdopodobieństwem 40% sąsiad na liście, 25% jedna z najbliższych
+ * stacji, 20% stacja oglądana wcześniej, a w pozostałych przypadkach losowa. Czujnik PM10
+ * wybierany jest w 70% przypadków (jeśli stacja go ma), w pozostałych losowy czujnik stacji.
+ * Czujnik jest klikany zaraz po pojawieniu się listy czujników, a czas do wykresu mierzony
+ * od kliknięcia stacji do pierwszego wykresu z danymi z API. Dane lokalne trafiają do katalogu
+ * trybu testowego QStandardPaths, czyszczonego przed każdym przebiegiem.
+ * @param clicks Liczba wyborów stacji w sesji.
+ * @return Kod wyjścia (0 oznacza sukces).
+ */
+int Benchmark::runPrefetch(int clicks)
+{
+    QTextStream out(stdout);
+    if (clicks <= 0) {
+        out << "Podaj dodatnią liczbę wyborów stacji\n";
+        return 1;
+    }
+
+    const int STATION_COUNT = 250;
+    const int HISTORY_HOURS = 72;
+    const int TIMEOUT_MS = 10000;
+    const QJsonArray stations = SyntheticData::stations(STATION_COUNT);
+    const QJsonArray sensors = SyntheticData::sensors(stations);
+    QHash<int, QVector<QPair<int, QString>>> stationSensors;
+    for (const QJsonValue& value : sensors) {
+        const QJsonObject sensor = value.toObject();
+        stationSensors[sensor["stationId"].toInt()].append(
+            { sensor["id"].toInt(), sensor["param"].toObject()["paramCode"].toString() });
+    }
+
+    // Sesja jest budowana na takim samym katalogu i liście jak w MainWindow.
+    StationCatalog catalog;
+    catalog.setStations(stations);
+    StationListModel model;
+    model.setStations(catalog.stationRecords());
+    StationFilterProxyModel list;
+    list.setSourceModel(&model);
+
+    QRandomGenerator random(20240615);
+    QVector<SessionClick> session;
+    QVector<int> recent;
+    int current = list.stationIdAt(random.bounded(list.rowCount()));
+    for (int c = 0; c < clicks; ++c) {
+        if (c > 0) {
+            const double choice = random.generateDouble();
+            int next = -1;
+            if (choice < 0.40) {
+                const int offsets[] = { 1, -1, 2, -2 };
+                const int row = list.rowOf(current) + offsets[random.bounded(4)];
+                if (row >= 0) next = list.stationIdAt(row);
+            } else if (choice < 0.65) {
+                const QVector<int> nearest = catalog.nearestStations(current, 4);
+                if (!nearest.isEmpty()) next = nearest[random.bounded(nearest.size())];
+            } else if (choice < 0.85 && recent.size() > 1) {
+                next = recent[1 + random.bounded(std::min(static_cast<int>(recent.size()) - 1, 5))];
+            }
+            current = next >= 0 ? next : list.stationIdAt(random.bounded(list.rowCount()));
+        }
+        recent.removeAll(current);
+        recent.prepend(current);
+
+        const QVector<QPair<int, QString>>& candidates = stationSensors[current];
+        SessionClick click;
+        click.stationId = current;
+        click.sensorId = candidates[random.bounded(candidates.size())].first;
+        if (random.generateDouble() < 0.7) {
+            for (const auto& sensor : candidates) {
+                if (sensor.second == "PM10") click.sensorId = sensor.first;
+            }
+        }
+        click.thinkMs = 300 + random.bounded(500);
+        session.append(click);
+    }
+
+    QStandardPaths::setTestModeEnabled(true);
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    out << "Sesja: " << clicks << " wyborów stacji z " << STATION_COUNT << ", opóźnienie API 30-50 ms\n\n";
+    out << "tryb | trafienia | wykres mediana ms | wykres p95 ms | zapytania API | zapytania wstępne | kB wstępnie\n";
+
+    bool timedOut = false;
+    for (const bool prefetch : { false, true }) {
+        QDir(dataPath).removeRecursively();
+        FaultInjectingServer server;
+        FaultInjectingServer::Profile mobile;
+        mobile.latencyMs = 30;
+        mobile.jitterMs = 20;
+        server.setProfile(mobile);
+        server.setDataset(stations, sensors, HISTORY_HOURS);
+        if (!server.listen()) {
+            out << "Nie można uruchomić lokalnego serwera testowego\n";
+            return 1;
+        }
+
+        MainWindow window(nullptr, true);
+        window.setApiBaseUrl(server.baseUrl());
+        window.setAutoRefresh(false);
+        window.setPrefetchEnabled(prefetch);
+        window.warmUp();
+        if (!waitUntil([&]() { return window.stationListModel()->rowCount() == STATION_COUNT; }, TIMEOUT_MS)) {
+            out << "Katalog nie został wczytany w limicie czasu\n";
+            return 1;
+        }
+        const int catalogRequests = server.requestCount();
+
+        QVector<double> chartTimes;
+        QElapsedTimer timer;
+        for (const SessionClick& click : session) {
+            const int chartsBefore = window.prefetchStats().value("charts").toInt();
+            timer.start();
+            window.stationSelected(click.stationId);
+            if (!waitUntil([&]() { return window.sensorListModel()->rowOf(click.sensorId) >= 0; }, TIMEOUT_MS)) {
+                timedOut = true;
+                break;
+            }
+            window.sensorSelected(click.sensorId);
+            if (!waitUntil([&]() { return window.prefetchStats().value("charts").toInt() > chartsBefore; }, TIMEOUT_MS)) {
+                timedOut = true;
+                break;
+            }
+            chartTimes.append(timer.nsecsElapsed() / 1e6);
+            pause(click.thinkMs);
+        }
+        if (chartTimes.size() < session.size()) {
+            out << (prefetch ? "z wstępnym" : "bez wstępnego") << " | wykres nie pojawił się w limicie czasu\n";
+            continue;
+        }
+
+        std::sort(chartTimes.begin(), chartTimes.end());
+        const QVariantMap stats = window.prefetchStats();
+        const int lookups = stats.value("lookups").toInt();
+        out << (prefetch ? "z wstępnym" : "bez wstępnego")
+            << " | " << stats.value("hits").toInt() << "/" << lookups << " ("
+            << QString::number(100.0 * stats.value("hitRate").toDouble(), 'f', 1) << "%)"
+            << " | " << QString::number(percentile(chartTimes, 0.5), 'f', 1)
+            << " | " << QString::number(percentile(chartTimes, 0.95), 'f', 1)
+            << " | " << server.requestCount() - catalogRequests
+            << " | " << stats.value("requests").toInt()
+            << " | " << QString::number(stats.value("bytes").toLongLong() / 1024.0, 'f', 1) << "\n";
+        out.flush();
+    }
+    QDir(dataPath).removeRecursively();
+    return timedOut ? 1 : 0;
+}
+
+namespace {
+
+/**
+ * @brief Wyniki jednego klienta w pomiarze lokalnego API.
+ */
+struct ApiClientRun {
+    /// @brief Czasy zapytań (us).
+    QVector<double> latencies;
+    /// @brief Liczba odpowiedzi 304.
+    qint64 notModified = 0;
+    /// @brief Liczba odpowiedzi skompresowanych gzip.
+    qint64 gzipped = 0;
+    /// @brief Liczba zapytań zakończonych błędem (połączenie lub status inny niż 200 i 304).
+    qint64 failed = 0;
+    /// @brief Łączny rozmiar odebranych treści (bajty).
+    qint64 bytes = 0;
+};
+
+/**
+ * @brief Wysyła zapytanie GET przez blokujące połączenie keep-alive i odbiera pełną odpowiedź.
+ * @param socket Połączone gniazdo.
+ * @param target Ścieżka z parametrami zapytania.
+ * @param etag Znacznik wysyłany w If-None-Match (pusty, aby go pominąć).
+ * @param responseEtag Wskaźnik na znacznik ETag odpowiedzi (uzupełniany).
+ * @param gzipped Wskaźnik ustawiany na true dla treści skompresowanej.
+ * @param bodyBytes Wskaźnik na rozmiar treści (uzupełniany).
+ * @return Kod statusu HTTP lub -1 przy błędzie połączenia.
+ */
+int httpGet(QTcpSocket& socket, const QByteArray& target, const QByteArray& etag,
+            QByteArray* responseEtag, bool* gzipped, qint64* bodyBytes)
+{
+    const int TIMEOUT_MS = 5000;
+    QByteArray request = "GET " + target + " HTTP/1.1\r\nHost: 127.0.0.1\r\nAccept-Encoding: gzip\r\n";
+    if (!etag.isEmpty()) request += "If-None-Match: " + etag + "\r\n";
+    socket.write(request + "\r\n");
+
+    QByteArray data;
+    int end;
+    while ((end = data.indexOf("\r\n\r\n")) < 0) {
+        if (!socket.waitForReadyRead(TIMEOUT_MS)) return -1;
+        data += socket.readAll();
+    }
+    const QList<QByteArray> lines = data.left(end).split('\n');
+    const QList<QByteArray> statusLine = lines.first().trimmed().split(' ');
+    if (statusLine.size() < 2) return -1;
+    qint64 length = 0;
+    *gzipped = false;
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines[i].indexOf(':');
+        if (colon < 0) continue;
+        const QByteArray name = lines[i].left(colon).trimmed().toLower();
+        const QByteArray value = lines[i].mid(colon + 1).trimmed();
+        if (name == "content-length") {
+            length = value.toLongLong();
+        } else if (name == "etag") {
+            *responseEtag = value;
+        } else if (name == "content-encoding") {
+            *gzipped = value == "gzip";
+        }
+    }
+    while (data.size() - end - 4 < length) {
+        if (!socket.waitForReadyRead(TIMEOUT_MS)) return -1;
+        data += socket.readAll();
+    }
+    *bodyBytes = length;
+    return statusLine[1].toInt();
+}
+
+}
+
+/**
+ * @brief Mierzy przepustowość lokalnego API HTTP/JSON i jego wpływ na wątek interfejsu.
+ *
+ * Serwer dostaje syntetyczny katalog stacji, roczne serie części czujników (jak w pamięci
+ * podręcznej) i wczytane syntetyczne archiwum. CLIENTS wątków wysyła zapytania przez
+ * połączenia keep-alive z akceptacją gzip; połowa zapytań o znany już zasób zawiera
+ * If-None-Match. Wątek główny w tym czasie mierzy opóźnienie klatek i co PUBLISH_MS
+ * publikuje dopisany pomiar jednego czujnika, tak jak robi to MainWindow po odświeżeniu.
+ * @param requestCount Łączna liczba zapytań.
+ * @return Kod wyjścia (0 oznacza sukces, 1 przy błędach zapytań).
+ */
+int Benchmark::runLocalApi(int requestCount)
+{
+    QTextStream out(stdout);
+    if (requestCount <= 0) {
+        out << "Liczba zapytań musi być dodatnia\n";
+        return 1;
+    }
+
+    const int STATION_COUNT = 500;
+    const int SERIES_COUNT = 200;
+    const int HISTORY_HOURS = 365 * 24;
+    const int ARCHIVE_FILES = 400;
+    const int CLIENTS = 8;
+    const int FRAME_MS = 16;
+    const int PUBLISH_MS = 100;
+    const qint64 HOUR_MS = 3600 * 1000;
+
+    QTemporaryDir directory;
+    if (!directory.isValid() || SyntheticData::archive(directory.path(), ARCHIVE_FILES) < 0) {
+        out << "Nie można zapisać syntetycznego archiwum\n";
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QJsonArray stations = SyntheticData::stations(STATION_COUNT);
+    const QJsonArray sensors = SyntheticData::sensors(stations);
+    StationCatalog catalog;
+    catalog.setStations(stations);
+    const qint64 end = QDateTime::currentMSecsSinceEpoch() / HOUR_MS * HOUR_MS;
+
+    LocalApiServer server;
+    if (!server.listen(0)) {
+        out << "Nie można uruchomić lokalnego API\n";
+        return 1;
+    }
+    server.publishStations(catalog.stationRecords());
+    QVector<int> sensorIds;
+    QVector<int> sensorStations;
+    QVector<MeasurementSeries> cached;
+    for (int i = 0; i < sensors.size() && cached.size() < SERIES_COUNT; i += 2) {
+        const QJsonObject sensor = sensors[i].toObject();
+        const int sensorId = sensor["id"].toInt();
+        const int stationId = sensor["stationId"].toInt();
+        cached.append(SyntheticData::history(sensorId, sensor["param"].toObject()["paramCode"].toString(),
+                                             end, HISTORY_HOURS));
+        sensorIds.append(sensorId);
+        sensorStations.append(stationId);
+        server.publishSeries(stationId, sensorId, cached.last());
+    }
+    const HistoryArchive archive = HistoryArchive::load(directory.path());
+    server.publishArchive(archive);
+    out << "Lokalne API: " << STATION_COUNT << " stacji, " << cached.size() << " serii rocznych, archiwum "
+        << archive.seriesCount() << " serii (przygotowanie " << timer.elapsed() << " ms), " << server.baseUrl() << "\n";
+    out.flush();
+
+    // Zestaw zasobów odpowiada zapytaniom panelu lub skryptu odpytującego aplikację.
+    QVector<QByteArray> targets = { "/api/status", "/api/stations", "/api/latest" };
+    for (int i = 0; i < sensorIds.size(); i += 5) {
+        const QByteArray sensor = QByteArray::number(sensorIds[i]);
+        const QByteArray station = QByteArray::number(sensorStations[i]);
+        targets.append("/api/stations/" + station);
+        targets.append("/api/latest?station=" + station);
+        targets.append("/api/series?sensor=" + sensor + "&from=" + QByteArray::number(end - 7 * 24 * HOUR_MS));
+        targets.append("/api/aggregate?sensor=" + sensor + "&step=day");
+        targets.append("/api/aggregate?sensor=" + sensor + "&from=" + QByteArray::number(end - 48 * HOUR_MS)
+                       + "&step=hour");
+    }
+    for (const HistoryArchive::Entry* entry : archive.entries(-1, QString())) {
+        if (targets.size() % 3 == 0) {
+            targets.append("/api/series?station=" + QByteArray::number(entry->stationId) + "&param="
+                           + QUrl::toPercentEncoding(entry->series.key));
+        }
+    }
+
+    QVector<ApiClientRun> runs(CLIENTS);
+    QVector<QThread*> clients;
+    const quint16 port = server.port();
+    for (int c = 0; c < CLIENTS; ++c) {
+        const int count = requestCount / CLIENTS + (c < requestCount % CLIENTS ? 1 : 0);
+        ApiClientRun* run = &runs[c];
+        clients.append(QThread::create([run, count, c, port, targets]() {
+            QTcpSocket socket;
+            socket.connectToHost(QHostAddress::LocalHost, port);
+            if (!socket.waitForConnected(5000)) {
+                run->failed = count;
+                return;
+            }
+            QRandomGenerator random(1000 + c);
+            QHash<QByteArray, QByteArray> etags;
+            QElapsedTimer clock;
+            for (int i = 0; i < count; ++i) {
+                const QByteArray& target = targets[random.bounded(targets.size())];
+                const QByteArray etag = random.bounded(2) == 0 ? etags.value(target) : QByteArray();
+                QByteArray responseEtag;
+                bool gzipped = false;
+                qint64 bytes = 0;
+                clock.start();
+                const int status = httpGet(socket, target, etag, &responseEtag, &gzipped, &bytes);
+                run->latencies.append(clock.nsecsElapsed() / 1e3);
+                if (status < 0) {
+                    run->failed += count - i;
+                    return;
+                }
+                if (status == 304) {
+                    run->notModified++;
+                } else if (status != 200) {
+                    run->failed++;
+                }
+                if (!responseEtag.isEmpty()) etags.insert(target, responseEtag);
+                if (gzipped) run->gzipped++;
+                run->bytes += bytes;
+            }
+        }));
+    }
+
+    QElapsedTimer frameClock;
+    double maxLagMs = 0.0;
+    QTimer frameTimer;
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    frameTimer.setInterval(FRAME_MS);
+    QObject::connect(&frameTimer, &QTimer::timeout, [&frameClock, &maxLagMs]() {
+        maxLagMs = std::max(maxLagMs, frameClock.nsecsElapsed() / 1e6 - FRAME_MS);
+        frameClock.restart();
+    });
+    int publishes = 0;
+    QVector<double> publishTimes;
+    QTimer publishTimer;
+    publishTimer.setInterval(PUBLISH_MS);
+    QObject::connect(&publishTimer, &QTimer::timeout, [&]() {
+        const int index = publishes++ % cached.size();
+        MeasurementSeries& series = cached[index];
+        MeasurementSeries point;
+        point.key = series.key;
+        point.timestamps.append(series.timestamps.last() + HOUR_MS);
+        point.values.append(series.values.last());
+        QElapsedTimer publishClock;
+        publishClock.start();
+        series.append(point);
+        server.publishSeries(sensorStations[index], sensorIds[index], series);
+        publishTimes.append(publishClock.nsecsElapsed() / 1e3);
+    });
+
+    QEventLoop loop;
+    int finished = 0;
+    for (QThread* client : clients) {
+        QObject::connect(client, &QThread::finished, &loop, [&]() {
+            if (++finished == CLIENTS) loop.quit();
+        });
+    }
+    frameClock.start();
+    frameTimer.start();
+    publishTimer.start();
+    timer.restart();
+    for (QThread* client : clients) client->start();
+    loop.exec();
+    const double elapsedS = timer.nsecsElapsed() / 1e9;
+    frameTimer.stop();
+    publishTimer.stop();
+    for (QThread* client : clients) {
+        client->wait();
+        delete client;
+    }
+    server.stop();
+
+    ApiClientRun total;
+    for (const ApiClientRun& run : runs) {
+        total.latencies += run.latencies;
+        total.notModified += run.notModified;
+        total.gzipped += run.gzipped;
+        total.failed += run.failed;
+        total.bytes += run.bytes;
+    }
+    std::sort(total.latencies.begin(), total.latencies.end());
+    std::sort(publishTimes.begin(), publishTimes.end());
+    const qint64 completed = total.latencies.size();
+    const LocalApiServer::Stats stats = server.stats();
+
+    out << CLIENTS << " klientów, " << completed << " zapytań do " << targets.size() << " zasobów w "
+        << QString::number(elapsedS, 'f', 2) << " s: " << QString::number(completed / elapsedS, 'f', 0)
+        << " zapytań/s\n";
+    out << "Czas zapytania [us]: mediana " << QString::number(percentile(total.latencies, 0.5), 'f', 0)
+        << ", p95 " << QString::number(percentile(total.latencies, 0.95), 'f', 0)
+        << ", p99 " << QString::number(percentile(total.latencies, 0.99), 'f', 0)
+        << " (obsługa w serwerze: mediana " << QString::number(stats.medianUs, 'f', 0)
+        << ", p99 " << QString::number(stats.p99Us, 'f', 0) << ")\n";
+    out << "Odpowiedzi: 304 " << QString::number(100.0 * total.notModified / std::max<qint64>(1, completed), 'f', 1)
+        << "%, gzip " << QString::number(100.0 * total.gzipped / std::max<qint64>(1, completed), 'f', 1)
+        << "%, z gotowych odpowiedzi " << QString::number(100.0 * stats.cacheHits / std::max<qint64>(1, stats.requests), 'f', 1)
+        << "%, błędy " << total.failed << ", " << QString::number(total.bytes / 1048576.0, 'f', 1) << " MB treści\n";
+    out << "Wątek interfejsu: " << publishes << " publikacji (mediana "
+        << QString::number(percentile(publishTimes, 0.5), 'f', 1) << " us, maks. "
+        << QString::number(publishTimes.isEmpty() ? 0.0 : publishTimes.last(), 'f', 1)
+        << " us), maks. opóźnienie klatki " << QString::number(maxLagMs, 'f', 2) << " ms\n";
+    out.flush();
+    return total.failed > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Sprawdza okno przechowywania odczytów lokalnych przy odtwarzaniu starego nagrania.
+ *
+ * Nagranie zaczyna się dobę przed bieżącą chwilą, więc okno liczone od zegara systemowego
+ * usunęłoby je w całości. Nagranie jest odtwarzane przyspieszone do około 3 s, aby zapisy
+ * flushLocalReadings() przycinały wykres w trakcie odbioru. Po odtworzeniu każdy czujnik
+ * lokalny musi zachować ostatnie 15 minut nagrania, a lista wykresu - nie stracić punktów.
+ * @param minutes Długość nagrania w minutach (odczyt co sekundę).
+ * @return Kod wyjścia (0 oznacza sukces, 1 gdy okno nie zawiera oczekiwanych punktów).
+ */
+int Benchmark::runReplay(int minutes)
+{
+    QTextStream out(stdout);
+    if (minutes < 1) {
+        out << "Długość nagrania musi wynosić co najmniej 1 minutę\n";
+        return 1;
+    }
+
+    const int DEVICES = 4;
+    const int TIMEOUT_MS = 30000;
+    const int REPLAY_MS = 3000;
+    const qint64 RETENTION_MS = 15 * 60 * 1000;
+    const int points = minutes * 60;
+    const qint64 first = QDateTime::currentMSecsSinceEpoch() - 24 * 3600 * 1000LL - points * 1000LL;
+    const qint64 last = first + (points - 1) * 1000LL;
+    const int expected = static_cast<int>(std::min<qint64>(points, RETENTION_MS / 1000 + 1));
+
+    QTemporaryDir directory;
+    const QString path = directory.filePath("readings.txt");
+    QFile file(path);
+    if (!directory.isValid() || !file.open(QIODevice::WriteOnly)) {
+        out << "Nie można utworzyć pliku nagrania\n";
+        return 1;
+    }
+    for (int i = 0; i < points; ++i) {
+        for (int device = 0; device < DEVICES; ++device) {
+            file.write(QByteArray::number(device) + ";PM10;" + QByteArray::number(first + i * 1000LL) + ";"
+                       + QByteArray::number(20.0 + (i + device) % 30) + "\n");
+        }
+    }
+    file.close();
+
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+    MainWindow window(nullptr, true);
+    QVector<int> sensorIds;
+    QObject::connect(&window, &MainWindow::localSensorsUpdated, &window, [&sensorIds](const QVariantList& sensors) {
+        for (const QVariant& sensor : sensors) sensorIds.append(sensor.toMap().value("sensorId").toInt());
+    });
+    int shownCount = 0;
+    QString shownLast;
+    QObject::connect(&window, &MainWindow::measurementsUpdateRequested, &window,
+                     [&shownCount, &shownLast](const QString&, const QVariantList& values) {
+                         shownCount = values.size();
+                         shownLast = values.isEmpty() ? QString() : values.last().toMap().value("date").toString();
+                     });
+
+    out << "Odtwarzanie: " << DEVICES << " urządzeń, " << minutes << " min nagrania sprzed doby\n";
+    if (!window.replayLocalFile(path, points * 1000.0 / REPLAY_MS)) {
+        out << "Nie można odtworzyć nagrania\n";
+        return 1;
+    }
+    const QString lastDate = QDateTime::fromMSecsSinceEpoch(last).toString("yyyy-MM-dd HH:mm:ss");
+    const bool received = waitUntil([&]() {
+        if (sensorIds.size() < DEVICES) return false;
+        for (int sensorId : sensorIds) {
+            window.showLocalSensor(sensorId);
+            if (shownLast != lastDate) return false;
+        }
+        return true;
+    }, TIMEOUT_MS);
+    if (!received) {
+        out << "Nagranie nie zostało odebrane w limicie czasu\n";
+        return 1;
+    }
+
+    pause(1500);
+    const int analyzed = window.analyzeMeasurements().value("count").toInt();
+    out << "Lista wykresu po przycięciu: " << analyzed << " z oczekiwanych " << expected << " punktów\n";
+    bool ok = analyzed == expected;
+    for (int sensorId : sensorIds) {
+        window.showLocalSensor(sensorId);
+        out << "Czujnik " << sensorId << ": w pamięci " << shownCount << " z oczekiwanych " << expected << " punktów\n";
+        ok = ok && shownCount == expected;
+    }
+    out << (ok ? "Okno przechowywania zachowuje koniec nagrania\n" : "Okno przechowywania usunęło odtwarzane odczyty\n");
+    out.flush();
+    return ok ? 0 : 1;
+}
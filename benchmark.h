@@ -0,0 +1,145 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Pomiary wydajności uruchamiane z wiersza poleceń (bez interfejsu graficznego).
+ */
+class Benchmark
+{
+public:
+    /**
+     * @brief Mierzy opóźnienie wyszukiwania stacji w trakcie pisania.
+     *
+     * Generuje syntetyczny katalog stacji, symuluje wpisywanie i kasowanie nazw miejscowości
+     * znak po znaku i porównuje filtrowanie w modelu pośredniczącym z dawnym budowaniem
+     * listy QVariantList. Wyniki (mediana, p95, maksimum) wypisywane są na standardowe wyjście.
+     * @param stationCount Liczba stacji w syntetycznym katalogu.
+     * @return Kod wyjścia (0 oznacza sukces).
+     */
+    static int runSearch(int stationCount);
+
+    /**
+     * @brief Mierzy czas przygotowania klatki mapy stacji.
+     *
+     * Symuluje przesuwanie widoku na kolejnych poziomach przybliżenia i mierzy odrzucanie
+     * stacji poza widokiem wraz z klastrowaniem (praca wykonywana w każdej klatce).
+     * @param stationCount Liczba stacji w syntetycznym katalogu.
+     * @return Kod wyjścia (0 oznacza sukces).
+     */
+    static int runMap(int stationCount);
+
+    /**
+     * @brief Porównuje opóźnienia zapytań bez zabezpieczeń i przez ApiClient podczas awarii API.
+     *
+     * Uruchamia lokalny zamiennik API z wstrzykiwaniem awarii i dla trzech faz (normalna praca,
+     * spowolnienie, brak odpowiedzi) wysyła te same zapytania zwykłym QNetworkAccessManager
+     * oraz przez ApiClient. Wypisuje p50, p95, p99 i liczbę błędów dla obu wariantów.
+     * @param requestCount Liczba zapytań w fazach normalnej pracy i spowolnienia.
+     * @return Kod wyjścia (0 oznacza sukces).
+     */
+    static int runNetwork(int requestCount);
+
+    /**
+     * @brief Porównuje pamięć rezydentną dawnego katalogu JSON i zwartego katalogu stacji.
+     *
+     * Dawna reprezentacja to tablica QJsonArray, mapy QJsonObject stacji i czujników oraz lista
+     * QVariantMap do wyświetlania; zwarta to StationCatalog z rekordami modelu listy.
+     * @param source Liczba stacji syntetycznego katalogu lub ścieżka do zapisanej odpowiedzi station/findAll.
+     * @return Kod wyjścia (0 oznacza sukces).
+     */
+    static int runCatalog(const QString& source);
+
+    /**
+     * @brief Mierzy odbiór odczytów z czujników lokalnych przez UDP.
+     *
+     * Wątek nadawcy symuluje rate/2 urządzeń wysyłających co sekundę datagram z PM10 i PM2.5.
+     * Paczki z LocalIngestor są dopisywane do serii MeasurementSeries tak jak w MainWindow,
+     * a zegar klatek mierzy opóźnienie pętli zdarzeń. Wypisuje liczbę odebranych i utraconych
+     * odczytów, największe zapełnienie kolejki, najdłuższą klatkę i opóźnienie pętli zdarzeń.
+     * @param rate Liczba odczytów na sekundę.
+     * @return Kod wyjścia (0 oznacza sukces, 1 przy utracie odczytów).
+     */
+    static int runIngest(int rate);
+
+    /**
+     * @brief Mierzy przepustowość wczytywania całego archiwum lokalnej bazy danych.
+     *
+     * Generuje syntetyczne archiwum w katalogu tymczasowym i wczytuje je przez HistoryArchive
+     * jednym wątkiem oraz wszystkimi rdzeniami. Wypisuje czas, pliki/s i MB/s obu wariantów,
+     * czas zapytań obejmujących całe archiwum oraz powtórzenia zapytania z pamięci wyników.
+     * @param fileCount Liczba plików archiwum.
+     * @return Kod wyjścia (0 oznacza sukces).
+     */
+    static int runArchive(int fileCount);
+
+    /**
+     * @brief Mierzy skalowanie aplikacji dla syntetycznych katalogów rosnącej wielkości.
+     *
+     * Dla każdej wielkości uruchamia lokalny zamiennik API z katalogiem z SyntheticData
+     * i wieloletnimi historiami godzinowymi, a następnie przeprowadza przez MainWindow pobranie
+     * katalogu, wyszukiwanie, wybór stacji i czujników (aż do danych wykresu), zapis i odczyt
+     * lokalnej bazy danych oraz analizy. Dane lokalne trafiają do katalogu trybu testowego
+     * QStandardPaths, czyszczonego przed każdą wielkością. Wypisuje czasy etapów i pamięć
+     * rezydentną, a na końcu tabelę zbiorczą.
+     * @param sizes Wielkości katalogów rozdzielone przecinkami (np. 1000,10000,100000).
+     * @param years Długość historii każdego czujnika w latach.
+     * @return Kod wyjścia (0 oznacza sukces, 1 gdy któryś etap nie zakończył się w limicie czasu).
+     */
+    static int runScale(const QString& sizes, int years);
+
+    /**
+     * @brief Porównuje sesję przeglądania stacji bez wstępnego pobierania i z nim.
+     *
+     * Lokalny zamiennik API z syntetycznym katalogiem odpowiada z opóźnieniem sieci komórkowej.
+     * Ta sama, powtarzalna sesja (przejścia do sąsiadów na liście, najbliższych stacji, ostatnio
+     * oglądanych i losowych, z przerwami na oglądanie wykresu) jest odtwarzana przez dwa nowe
+     * obiekty MainWindow. Wypisuje odsetek trafień, medianę i p95 czasu od kliknięcia stacji
+     * do wykresu oraz liczbę zapytań i bajtów pobranych wstępnie.
+     * @param clicks Liczba wyborów stacji w sesji.
+     * @return Kod wyjścia (0 oznacza sukces, 1 gdy któryś wykres nie pojawił się w limicie czasu).
+     */
+    static int runPrefetch(int clicks);
+
+    /**
+     * @brief Mierzy przepustowość lokalnego API HTTP/JSON i jego wpływ na wątek interfejsu.
+     *
+     * Kilka wątków-klientów odpytuje przez połączenia keep-alive katalog, ostatnie wartości,
+     * serie i agregaty, a wątek główny publikuje w tym czasie zmiany serii i mierzy opóźnienie
+     * klatek. Wypisuje liczbę zapytań na sekundę, percentyle czasu zapytania, udział odpowiedzi
+     * 304 i gzip oraz koszt publikacji w wątku interfejsu.
+     * @param requestCount Łączna liczba zapytań.
+     * @return Kod wyjścia (0 oznacza sukces, 1 przy błędach zapytań).
+     */
+    static int runLocalApi(int requestCount);
+
+    /**
+     * @brief Sprawdza okno przechowywania odczytów lokalnych przy odtwarzaniu starego nagrania.
+     *
+     * Zapisuje nagranie kilku urządzeń sprzed doby (odczyt co sekundę), odtwarza je przez
+     * MainWindow w przyspieszeniu i sprawdza, czy seria w pamięci i lista wykresu każdego czujnika
+     * zawierają ostatnie 15 minut nagrania.
+     * @param minutes Długość nagrania w minutach.
+     * @return Kod wyjścia (0 oznacza sukces, 1 gdy okno nie zawiera oczekiwanych punktów).
+     */
+    static int runReplay(int minutes);
+
+private:
+    /**
+     * @brief Zwraca percentyl z posortowanych czasów.
+     * @param sorted Posortowane czasy w mikrosekundach.
+     * @param fraction Percentyl jako ułamek (0 ... 1).
+     * @return Wartość percentyla.
+     */
+    static double percentile(const QVector<double>& sorted, double fraction);
+
+    /**
+     * @brief Zwraca pamięć rezydentną procesu.
+     * @return Rozmiar w bajtach lub -1, jeśli pomiar nie jest dostępny na tej platformie.
+     */
+    static qint64 residentMemory();
+};
+
+#endif // BENCHMARK_H
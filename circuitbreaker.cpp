@@ -0,0 +1,124 @@
+#include "circuitbreaker.h"
+#include <algorithm>
+
+/**
+ * @brief Konstruktor wyłącznika.
+ * @param settings Ustawienia wyłącznika.
+ */
+CircuitBreaker::CircuitBreaker(const Settings& settings)
+    : settings(settings), openDuration(settings.openMs)
+{
+}
+
+/**
+ * @brief Sprawdza, czy zapytanie może zostać wysłane.
+ *
+ * Zapytanie próbne, które nie zakończyło się w czasie otwarcia, uznawane jest za utracone
+ * i zastępowane kolejnym.
+ * @param now Bieżący czas monotoniczny (ms).
+ * @return True, jeśli zapytanie może zostać wysłane.
+ */
+bool CircuitBreaker::allowRequest(qint64 now)
+{
+    switch (currentState) {
+    case Closed:
+        return true;
+    case Open:
+        if (now < openUntil) return false;
+        currentState = HalfOpen;
+        probeStarted = now;
+        return true;
+    case HalfOpen:
+        if (probeStarted >= 0 && now - probeStarted < openDuration) return false;
+        probeStarted = now;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Odnotowuje udane wywołanie.
+ */
+void CircuitBreaker::recordSuccess()
+{
+    consecutive = 0;
+    if (currentState == HalfOpen) {
+        currentState = Closed;
+        openDuration = settings.openMs;
+        probeStarted = -1;
+        outcomes.clear();
+        nextOutcome = 0;
+        failuresInWindow = 0;
+        return;
+    }
+    if (currentState == Closed) pushOutcome(false);
+}
+
+/**
+ * @brief Odnotowuje nieudane wywołanie.
+ * @param now Bieżący czas monotoniczny (ms).
+ */
+void CircuitBreaker::recordFailure(qint64 now)
+{
+    if (currentState == HalfOpen) {
+        openDuration = std::min(openDuration * 2, settings.maxOpenMs);
+        trip(now);
+        return;
+    }
+    if (currentState == Open) return;
+
+    consecutive++;
+    pushOutcome(true);
+    const bool ratioExceeded = outcomes.size() >= settings.minimumCalls
+                               && failuresInWindow >= settings.failureRatio * outcomes.size();
+    if (ratioExceeded || consecutive >= settings.consecutiveFailures) {
+        trip(now);
+    }
+}
+
+/**
+ * @brief Zwraca stan wyłącznika.
+ * @return Bieżący stan.
+ */
+CircuitBreaker::State CircuitBreaker::state() const
+{
+    return currentState;
+}
+
+/**
+ * @brief Zwraca liczbę otwarć wyłącznika.
+ * @return Liczba przejść do stanu otwartego.
+ */
+int CircuitBreaker::tripCount() const
+{
+    return trips;
+}
+
+/**
+ * @brief Dopisuje wynik do okna ostatnich wywołań.
+ * @param failed True dla błędu.
+ */
+void CircuitBreaker::pushOutcome(bool failed)
+{
+    if (outcomes.size() < settings.windowSize) {
+        outcomes.append(failed);
+    } else {
+        failuresInWindow -= outcomes[nextOutcome] ? 1 : 0;
+        outcomes[nextOutcome] = failed;
+        nextOutcome = (nextOutcome + 1) % settings.windowSize;
+    }
+    failuresInWindow += failed ? 1 : 0;
+}
+
+/**
+ * @brief Otwiera wyłącznik.
+ * @param now Bieżący czas monotoniczny (ms).
+ */
+void CircuitBreaker::trip(qint64 now)
+{
+    currentState = Open;
+    openUntil = now + openDuration;
+    probeStarted = -1;
+    consecutive = 0;
+    trips++;
+}
@@ -0,0 +1,119 @@
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Wyłącznik chroniący przed wysyłaniem zapytań do niedziałającego API.
+ *
+ * W stanie zamkniętym zapytania przechodzą, a wyniki trafiają do okna ostatnich wywołań.
+ * Gdy odsetek błędów w oknie lub liczba kolejnych błędów przekroczy próg, wyłącznik
+ * otwiera się i odrzuca zapytania bez kontaktu z serwerem. Po czasie oczekiwania
+ * przepuszcza jedno zapytanie próbne (stan półotwarty): sukces zamyka wyłącznik,
+ * błąd otwiera go ponownie na dwukrotnie dłuższy czas.
+ */
+class CircuitBreaker
+{
+public:
+    /**
+     * @brief Stan wyłącznika.
+     */
+    enum State {
+        Closed,   ///< Zapytania przechodzą normalnie.
+        Open,     ///< Zapytania są odrzucane.
+        HalfOpen  ///< Przechodzi tylko zapytanie próbne.
+    };
+
+    /**
+     * @brief Ustawienia wyłącznika.
+     */
+    struct Settings {
+        /// @brief Liczba ostatnich wywołań branych pod uwagę.
+        int windowSize = 20;
+        /// @brief Minimalna liczba wywołań w oknie przed oceną odsetka błędów.
+        int minimumCalls = 10;
+        /// @brief Odsetek błędów otwierający wyłącznik.
+        double failureRatio = 0.5;
+        /// @brief Liczba kolejnych błędów otwierająca wyłącznik.
+        int consecutiveFailures = 5;
+        /// @brief Początkowy czas otwarcia (ms).
+        qint64 openMs = 15 * 1000;
+        /// @brief Maksymalny czas otwarcia po kolejnych nieudanych próbach (ms).
+        qint64 maxOpenMs = 2 * 60 * 1000;
+    };
+
+    /**
+     * @brief Konstruktor wyłącznika.
+     * @param settings Ustawienia wyłącznika.
+     */
+    explicit CircuitBreaker(const Settings& settings = Settings());
+
+    /**
+     * @brief Sprawdza, czy zapytanie może zostać wysłane.
+     *
+     * Po upływie czasu otwarcia przechodzi w stan półotwarty i przepuszcza jedno zapytanie próbne.
+     * @param now Bieżący czas monotoniczny (ms).
+     * @return True, jeśli zapytanie może zostać wysłane.
+     */
+    bool allowRequest(qint64 now);
+
+    /**
+     * @brief Odnotowuje udane wywołanie.
+     */
+    void recordSuccess();
+
+    /**
+     * @brief Odnotowuje nieudane wywołanie.
+     * @param now Bieżący czas monotoniczny (ms).
+     */
+    void recordFailure(qint64 now);
+
+    /**
+     * @brief Zwraca stan wyłącznika.
+     * @return Bieżący stan.
+     */
+    State state() const;
+
+    /**
+     * @brief Zwraca liczbę otwarć wyłącznika.
+     * @return Liczba przejść do stanu otwartego.
+     */
+    int tripCount() const;
+
+private:
+    /// @brief Ustawienia wyłącznika.
+    Settings settings;
+    /// @brief Bieżący stan.
+    State currentState = Closed;
+    /// @brief Wyniki ostatnich wywołań (true = błąd) w buforze cyklicznym.
+    QVector<bool> outcomes;
+    /// @brief Pozycja następnego zapisu w buforze po jego zapełnieniu.
+    int nextOutcome = 0;
+    /// @brief Liczba błędów w oknie.
+    int failuresInWindow = 0;
+    /// @brief Liczba kolejnych błędów.
+    int consecutive = 0;
+    /// @brief Bieżący czas otwarcia (ms).
+    qint64 openDuration;
+    /// @brief Chwila, od której wyłącznik przepuszcza zapytanie próbne.
+    qint64 openUntil = 0;
+    /// @brief Chwila wysłania zapytania próbnego (-1, jeśli żadne nie trwa).
+    qint64 probeStarted = -1;
+    /// @brief Liczba otwarć wyłącznika.
+    int trips = 0;
+
+    /**
+     * @brief Dopisuje wynik do okna ostatnich wywołań.
+     * @param failed True dla błędu.
+     */
+    void pushOutcome(bool failed);
+
+    /**
+     * @brief Otwiera wyłącznik.
+     * @param now Bieżący czas monotoniczny (ms).
+     */
+    void trip(qint64 now);
+};
+
+#endif // CIRCUITBREAKER_H
@@ -0,0 +1,199 @@
+#include "correlationengine.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+/**
+ * @brief Zamienia nazwę metody na wartość wyliczenia.
+ * @param name Nazwa ("pearson" lub "spearman").
+ * @return Metoda korelacji (domyślnie Pearson).
+ */
+CorrelationEngine::Method CorrelationEngine::methodFromName(const QString& name)
+{
+    return name.toLower() == "spearman" ? Spearman : Pearson;
+}
+
+namespace {
+
+/// @brief Liczba niezależnych zestawów sum w pętli Pearsona (szerokość wektora AVX2 dla double).
+const int PEARSON_LANES = 4;
+
+}
+
+/**
+ * @brief Oblicza współczynnik Pearsona dla par obserwacji obecnych w obu seriach.
+ *
+ * Sumy są liczone w PEARSON_LANES niezależnych torach, a pary z brakiem danych są zerowane
+ * maską obecności zamiast rozgałęzień. Bez -ffast-math kompilator nie może zmienić kolejności
+ * dodawania w jednym łańcuchu sum, więc dopiero osobne tory pozwalają mu użyć instrukcji
+ * wektorowych; tory są sumowane po pętli.
+ * @param a Wskaźnik na pierwszą serię.
+ * @param b Wskaźnik na drugą serię.
+ * @param n Liczba elementów.
+ * @param overlap Opcjonalny wskaźnik na liczbę wspólnych obserwacji.
+ * @return Współczynnik korelacji lub NaN przy zbyt małej liczbie wspólnych obserwacji.
+ */
+double CorrelationEngine::pearson(const double* a, const double* b, int n, int* overlap)
+{
+    double laneCount[PEARSON_LANES] = {};
+    double laneA[PEARSON_LANES] = {};
+    double laneB[PEARSON_LANES] = {};
+    double laneAA[PEARSON_LANES] = {};
+    double laneBB[PEARSON_LANES] = {};
+    double laneAB[PEARSON_LANES] = {};
+
+    auto accumulate = [&](int lane, double av, double bv) {
+        // Porównanie NaN z samym sobą jest fałszywe; wybór wartości kompiluje się do maski bitowej.
+        const bool present = (av == av) & (bv == bv);
+        const double x = present ? av : 0.0;
+        const double y = present ? bv : 0.0;
+        laneCount[lane] += present ? 1.0 : 0.0;
+        laneA[lane] += x;
+        laneB[lane] += y;
+        laneAA[lane] += x * x;
+        laneBB[lane] += y * y;
+        laneAB[lane] += x * y;
+    };
+
+    int i = 0;
+    for (; i + PEARSON_LANES <= n; i += PEARSON_LANES) {
+        for (int lane = 0; lane < PEARSON_LANES; ++lane) {
+            accumulate(lane, a[i + lane], b[i + lane]);
+        }
+    }
+    for (; i < n; ++i) {
+        accumulate(0, a[i], b[i]);
+    }
+
+    double count = 0.0;
+    double sumA = 0.0;
+    double sumB = 0.0;
+    double sumAA = 0.0;
+    double sumBB = 0.0;
+    double sumAB = 0.0;
+    for (int lane = 0; lane < PEARSON_LANES; ++lane) {
+        count += laneCount[lane];
+        sumA += laneA[lane];
+        sumB += laneB[lane];
+        sumAA += laneAA[lane];
+        sumBB += laneBB[lane];
+        sumAB += laneAB[lane];
+    }
+
+    if (overlap) *overlap = static_cast<int>(count);
+    if (count < MIN_OVERLAP) return std::numeric_limits<double>::quiet_NaN();
+
+    const double covariance = sumAB - sumA * sumB / count;
+    const double varianceA = sumAA - sumA * sumA / count;
+    const double varianceB = sumBB - sumB * sumB / count;
+    if (varianceA <= 0.0 || varianceB <= 0.0) return std::numeric_limits<double>::quiet_NaN();
+
+    return std::clamp(covariance / std::sqrt(varianceA * varianceB), -1.0, 1.0);
+}
+
+/**
+ * @brief Zamienia wartości serii na rangi (średnie rangi dla remisów, NaN bez zmian).
+ *
+ * Rangi są liczone dla wszystkich obecnych wartości serii, a nie osobno dla każdej pary,
+ * co przy niewielkiej liczbie braków daje wynik bliski klasycznemu współczynnikowi Spearmana.
+ * @param values Wartości serii.
+ * @return Rangi wartości.
+ */
+QVector<double> CorrelationEngine::ranks(const QVector<double>& values)
+{
+    QVector<int> order;
+    order.reserve(values.size());
+    for (int i = 0; i < values.size(); ++i) {
+        if (!std::isnan(values[i])) order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&values](int x, int y) { return values[x] < values[y]; });
+
+    QVector<double> result(values.size(), std::numeric_limits<double>::quiet_NaN());
+    int i = 0;
+    while (i < order.size()) {
+        int j = i;
+        while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]]) ++j;
+        const double rank = (i + j) / 2.0 + 1.0;
+        for (int k = i; k <= j; ++k) {
+            result[order[k]] = rank;
+        }
+        i = j + 1;
+    }
+    return result;
+}
+
+/**
+ * @brief Oblicza macierz korelacji dla zestawu wyrównanych serii.
+ * @param columns Wartości serii na wspólnej siatce (NaN dla braków).
+ * @param method Metoda korelacji.
+ * @return Symetryczna macierz korelacji.
+ */
+CorrelationEngine::Result CorrelationEngine::correlationMatrix(const QVector<QVector<double>>& columns, Method method)
+{
+    Result result;
+    const int size = columns.size();
+    result.size = size;
+    result.coefficients.fill(std::numeric_limits<double>::quiet_NaN(), size * size);
+    result.overlaps.fill(0, size * size);
+    if (size == 0) return result;
+
+    QVector<QVector<double>> prepared = columns;
+    if (method == Spearman) {
+        QtConcurrent::blockingMap(prepared, [](QVector<double>& column) {
+            column = ranks(column);
+        });
+    }
+
+    const QVector<QVector<double>>& source = prepared;
+    QVector<int> rows(size);
+    std::iota(rows.begin(), rows.end(), 0);
+    double* coefficients = result.coefficients.data();
+    int* overlaps = result.overlaps.data();
+
+    QtConcurrent::blockingMap(rows, [&](int row) {
+        const QVector<double>& a = source[row];
+        for (int column = row; column < size; ++column) {
+            const QVector<double>& b = source[column];
+            int overlap = 0;
+            const double r = row == column
+                                 ? 1.0
+                                 : pearson(a.constData(), b.constData(), std::min(a.size(), b.size()), &overlap);
+            if (row == column) {
+                for (double value : a) overlap += std::isnan(value) ? 0 : 1;
+            }
+            coefficients[row * size + column] = r;
+            coefficients[column * size + row] = r;
+            overlaps[row * size + column] = overlap;
+            overlaps[column * size + row] = overlap;
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Oblicza korelację wzajemną dwóch serii dla przesunięć od -maxLag do maxLag.
+ * @param a Pierwsza seria.
+ * @param b Druga seria (tej samej długości).
+ * @param maxLag Maksymalne przesunięcie w krokach siatki.
+ * @return Współczynniki Pearsona dla kolejnych przesunięć (2 * maxLag + 1 wartości).
+ */
+QVector<double> CorrelationEngine::crossCorrelation(const QVector<double>& a, const QVector<double>& b, int maxLag)
+{
+    const int n = std::min(a.size(), b.size());
+    QVector<double> result;
+    result.reserve(2 * maxLag + 1);
+
+    for (int lag = -maxLag; lag <= maxLag; ++lag) {
+        const int length = n - std::abs(lag);
+        if (length < MIN_OVERLAP) {
+            result.append(std::numeric_limits<double>::quiet_NaN());
+            continue;
+        }
+        const double* x = a.constData() + (lag < 0 ? -lag : 0);
+        const double* y = b.constData() + (lag > 0 ? lag : 0);
+        result.append(pearson(x, y, length));
+    }
+    return result;
+}
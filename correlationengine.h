@@ -0,0 +1,85 @@
+#ifndef CORRELATIONENGINE_H
+#define CORRELATIONENGINE_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Obliczanie macierzy korelacji i korelacji wzajemnej z przesunięciem.
+ *
+ * Serie wejściowe muszą być wyrównane do wspólnej siatki czasu (patrz Resampler).
+ * Braki danych (NaN) są pomijane parami, a jądra sumujące działają na maskach zamiast
+ * rozgałęzień, więc kompilator może je zwektoryzować. Wiersze macierzy są liczone
+ * równolegle w puli wątków.
+ */
+class CorrelationEngine
+{
+public:
+    /**
+     * @brief Metoda korelacji.
+     */
+    enum Method {
+        Pearson, ///< Korelacja liniowa Pearsona.
+        Spearman ///< Korelacja rang Spearmana.
+    };
+
+    /**
+     * @brief Wynik obliczenia macierzy korelacji.
+     */
+    struct Result {
+        /// @brief Liczba serii (macierz ma wymiar size x size).
+        int size = 0;
+        /// @brief Współczynniki korelacji wierszami (NaN przy braku wspólnych danych).
+        QVector<double> coefficients;
+        /// @brief Liczba wspólnych obserwacji dla każdej pary.
+        QVector<int> overlaps;
+    };
+
+    /// @brief Minimalna liczba wspólnych obserwacji wymagana do obliczenia korelacji.
+    static const int MIN_OVERLAP = 3;
+
+    /**
+     * @brief Oblicza macierz korelacji dla zestawu wyrównanych serii.
+     * @param columns Wartości serii na wspólnej siatce (NaN dla braków).
+     * @param method Metoda korelacji.
+     * @return Symetryczna macierz korelacji.
+     */
+    static Result correlationMatrix(const QVector<QVector<double>>& columns, Method method);
+
+    /**
+     * @brief Oblicza korelację wzajemną dwóch serii dla przesunięć od -maxLag do maxLag.
+     *
+     * Dodatnie przesunięcie oznacza, że seria b opóźnia się względem serii a.
+     * @param a Pierwsza seria.
+     * @param b Druga seria (tej samej długości).
+     * @param maxLag Maksymalne przesunięcie w krokach siatki.
+     * @return Współczynniki Pearsona dla kolejnych przesunięć (2 * maxLag + 1 wartości).
+     */
+    static QVector<double> crossCorrelation(const QVector<double>& a, const QVector<double>& b, int maxLag);
+
+    /**
+     * @brief Oblicza współczynnik Pearsona dla par obserwacji obecnych w obu seriach.
+     * @param a Wskaźnik na pierwszą serię.
+     * @param b Wskaźnik na drugą serię.
+     * @param n Liczba elementów.
+     * @param overlap Opcjonalny wskaźnik na liczbę wspólnych obserwacji.
+     * @return Współczynnik korelacji lub NaN przy zbyt małej liczbie wspólnych obserwacji.
+     */
+    static double pearson(const double* a, const double* b, int n, int* overlap = nullptr);
+
+    /**
+     * @brief Zamienia wartości serii na rangi (średnie rangi dla remisów, NaN bez zmian).
+     * @param values Wartości serii.
+     * @return Rangi wartości.
+     */
+    static QVector<double> ranks(const QVector<double>& values);
+
+    /**
+     * @brief Zamienia nazwę metody na wartość wyliczenia.
+     * @param name Nazwa ("pearson" lub "spearman").
+     * @return Metoda korelacji (domyślnie Pearson).
+     */
+    static Method methodFromName(const QString& name);
+};
+
+#endif // CORRELATIONENGINE_H
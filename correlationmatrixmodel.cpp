@@ -0,0 +1,110 @@
+#include "correlationmatrixmodel.h"
+#include <cmath>
+
+/**
+ * @brief Konstruktor modelu.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+CorrelationMatrixModel::CorrelationMatrixModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+/**
+ * @brief Zwraca liczbę wierszy macierzy.
+ * @param parent Indeks rodzica (nieużywany).
+ * @return Liczba serii.
+ */
+int CorrelationMatrixModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : matrix.size;
+}
+
+/**
+ * @brief Zwraca liczbę kolumn macierzy.
+ * @param parent Indeks rodzica (nieużywany).
+ * @return Liczba serii.
+ */
+int CorrelationMatrixModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : matrix.size;
+}
+
+/**
+ * @brief Zwraca dane komórki dla podanej roli.
+ * @param index Indeks komórki.
+ * @param role Rola danych.
+ * @return Wartość komórki lub pusty QVariant.
+ */
+QVariant CorrelationMatrixModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= matrix.size || index.column() >= matrix.size) {
+        return QVariant();
+    }
+
+    const int cell = index.row() * matrix.size + index.column();
+    const double coefficient = matrix.coefficients[cell];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return std::isnan(coefficient) ? QString("-") : QString::number(coefficient, 'f', 2);
+    case CoefficientRole:
+        return coefficient;
+    case OverlapRole:
+        return matrix.overlaps[cell];
+    case RowLabelRole:
+        return seriesLabels.value(index.row());
+    case ColumnLabelRole:
+        return seriesLabels.value(index.column());
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Zwraca nazwy ról dostępne w QML.
+ * @return Mapa ról na nazwy.
+ */
+QHash<int, QByteArray> CorrelationMatrixModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractTableModel::roleNames();
+    roles[CoefficientRole] = "coefficient";
+    roles[OverlapRole] = "overlap";
+    roles[RowLabelRole] = "rowLabel";
+    roles[ColumnLabelRole] = "columnLabel";
+    return roles;
+}
+
+/**
+ * @brief Zastępuje zawartość modelu nową macierzą.
+ * @param labels Etykiety serii.
+ * @param result Wynik obliczenia macierzy korelacji.
+ * @param method Nazwa użytej metody.
+ */
+void CorrelationMatrixModel::setMatrix(const QStringList& labels, const CorrelationEngine::Result& result, const QString& method)
+{
+    beginResetModel();
+    seriesLabels = labels;
+    matrix = result;
+    methodName = method;
+    endResetModel();
+    emit labelsChanged();
+}
+
+/**
+ * @brief Zwraca etykiety serii.
+ * @return Lista etykiet.
+ */
+QStringList CorrelationMatrixModel::labels() const
+{
+    return seriesLabels;
+}
+
+/**
+ * @brief Zwraca nazwę metody użytej do obliczenia macierzy.
+ * @return Nazwa metody.
+ */
+QString CorrelationMatrixModel::method() const
+{
+    return methodName;
+}
@@ -0,0 +1,100 @@
+#ifndef CORRELATIONMATRIXMODEL_H
+#define CORRELATIONMATRIXMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include "correlationengine.h"
+
+/**
+ * @brief Model tabelaryczny udostępniający macierz korelacji w QML.
+ *
+ * Każda komórka odpowiada parze serii; etykiety wierszy i kolumn opisują czujnik
+ * (parametr i stacja). Model jest przeznaczony do wyświetlania w TableView.
+ */
+class CorrelationMatrixModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QStringList labels READ labels NOTIFY labelsChanged)
+    Q_PROPERTY(QString method READ method NOTIFY labelsChanged)
+
+public:
+    /**
+     * @brief Role danych komórki macierzy.
+     */
+    enum Roles {
+        CoefficientRole = Qt::UserRole + 1, ///< Współczynnik korelacji (NaN przy braku danych).
+        OverlapRole,                        ///< Liczba wspólnych obserwacji.
+        RowLabelRole,                       ///< Etykieta wiersza.
+        ColumnLabelRole                     ///< Etykieta kolumny.
+    };
+
+    /**
+     * @brief Konstruktor modelu.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit CorrelationMatrixModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca liczbę wierszy macierzy.
+     * @param parent Indeks rodzica (nieużywany).
+     * @return Liczba serii.
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Zwraca liczbę kolumn macierzy.
+     * @param parent Indeks rodzica (nieużywany).
+     * @return Liczba serii.
+     */
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Zwraca dane komórki dla podanej roli.
+     * @param index Indeks komórki.
+     * @param role Rola danych.
+     * @return Wartość komórki lub pusty QVariant.
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Zwraca nazwy ról dostępne w QML.
+     * @return Mapa ról na nazwy.
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Zastępuje zawartość modelu nową macierzą.
+     * @param labels Etykiety serii.
+     * @param result Wynik obliczenia macierzy korelacji.
+     * @param method Nazwa użytej metody.
+     */
+    void setMatrix(const QStringList& labels, const CorrelationEngine::Result& result, const QString& method);
+
+    /**
+     * @brief Zwraca etykiety serii.
+     * @return Lista etykiet.
+     */
+    QStringList labels() const;
+
+    /**
+     * @brief Zwraca nazwę metody użytej do obliczenia macierzy.
+     * @return Nazwa metody.
+     */
+    QString method() const;
+
+signals:
+    /**
+     * @brief Emitowany po zmianie etykiet lub metody.
+     */
+    void labelsChanged();
+
+private:
+    /// @brief Etykiety serii.
+    QStringList seriesLabels;
+    /// @brief Bieżąca macierz korelacji.
+    CorrelationEngine::Result matrix;
+    /// @brief Nazwa metody korelacji.
+    QString methodName;
+};
+
+#endif // CORRELATIONMATRIXMODEL_H
@@ -0,0 +1,285 @@
+#include "faultinjectingserver.h"
+#include "syntheticdata.h"
+#include <QDateTime>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <cmath>
+
+/**
+ * @brief Konstruktor serwera.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+FaultInjectingServer::FaultInjectingServer(QObject *parent)
+    : QObject(parent), random(1)
+{
+    connect(&server, &QTcpServer::newConnection, this, &FaultInjectingServer::onNewConnection);
+}
+
+/**
+ * @brief Uruchamia nasłuchiwanie na interfejsie lokalnym.
+ * @param port Numer portu (0 wybiera wolny port).
+ * @return True, jeśli serwer nasłuchuje.
+ */
+bool FaultInjectingServer::listen(quint16 port)
+{
+    return server.listen(QHostAddress::LocalHost, port);
+}
+
+/**
+ * @brief Zwraca adres bazowy API udostępnianego przez serwer.
+ * @return Adres w postaci http://127.0.0.1:port/pjp-api/rest/.
+ */
+QString FaultInjectingServer::baseUrl() const
+{
+    return QString("http://127.0.0.1:%1/pjp-api/rest/").arg(server.serverPort());
+}
+
+/**
+ * @brief Zwraca adres zamiennika geokodera Nominatim.
+ * @return Adres w postaci http://127.0.0.1:port/search.
+ */
+QString FaultInjectingServer::geocodeUrl() const
+{
+    return QString("http://127.0.0.1:%1/search").arg(server.serverPort());
+}
+
+/**
+ * @brief Zmienia profil awarii (dotyczy kolejnych zapytań).
+ * @param profile Nowy profil.
+ */
+void FaultInjectingServer::setProfile(const Profile& profile)
+{
+    faults = profile;
+}
+
+/**
+ * @brief Zastępuje wbudowane dane katalogiem stacji i czujników.
+ * @param stations Tablica stacji w formacie station/findAll.
+ * @param sensors Tablica czujników w formacie station/sensors.
+ * @param historyHours Długość historii pomiarów każdego czujnika (godziny).
+ */
+void FaultInjectingServer::setDataset(const QJsonArray& stations, const QJsonArray& sensors, int historyHours)
+{
+    datasetStations = QJsonDocument(stations).toJson(QJsonDocument::Compact);
+    datasetSensors.clear();
+    datasetParams.clear();
+    datasetMeasurements.clear();
+    datasetHours = historyHours;
+    for (const QJsonValue& value : sensors) {
+        const QJsonObject sensor = value.toObject();
+        datasetSensors[sensor["stationId"].toInt()].append(sensor);
+        datasetParams.insert(sensor["id"].toInt(), sensor["param"].toObject()["paramCode"].toString());
+    }
+}
+
+/**
+ * @brief Przygotowuje z góry odpowiedź z pomiarami czujnika zbioru danych.
+ * @param sensorId Identyfikator czujnika.
+ */
+void FaultInjectingServer::prepareMeasurements(int sensorId)
+{
+    if (!datasetParams.contains(sensorId) || datasetMeasurements.contains(sensorId)) return;
+
+    const qint64 HOUR_MS = 3600 * 1000;
+    const qint64 end = QDateTime::currentMSecsSinceEpoch() / HOUR_MS * HOUR_MS;
+    const MeasurementSeries series = SyntheticData::history(sensorId, datasetParams.value(sensorId), end, datasetHours);
+    datasetMeasurements.insert(sensorId, QJsonDocument(SyntheticData::measurementsResponse(series)).toJson(QJsonDocument::Compact));
+}
+
+/**
+ * @brief Zwraca liczbę odebranych zapytań.
+ * @return Liczba zapytań.
+ */
+int FaultInjectingServer::requestCount() const
+{
+    return requests;
+}
+
+/**
+ * @brief Obsługuje nowe połączenie.
+ */
+void FaultInjectingServer::onNewConnection()
+{
+    while (QTcpSocket* socket = server.nextPendingConnection()) {
+        buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+/**
+ * @brief Wydziela kompletne zapytania z danych połączenia i planuje odpowiedzi.
+ *
+ * Obsługiwane są wyłącznie zapytania bez treści (GET), więc koniec nagłówków kończy zapytanie.
+ * @param socket Połączenie.
+ */
+void FaultInjectingServer::onReadyRead(QTcpSocket* socket)
+{
+    QByteArray& buffer = buffers[socket];
+    buffer.append(socket->readAll());
+
+    int end;
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+        const QByteArray head = buffer.left(end);
+        buffer.remove(0, end + 4);
+
+        const QList<QByteArray> requestLine = head.left(head.indexOf("\r\n")).split(' ');
+        if (requestLine.size() < 2) {
+            socket->abort();
+            return;
+        }
+        requests++;
+        schedule(socket, QString::fromLatin1(requestLine[1]));
+    }
+}
+
+/**
+ * @brief Planuje odpowiedź na zapytanie zgodnie z profilem awarii.
+ * @param socket Połączenie.
+ * @param path Ścieżka zapytania.
+ */
+void FaultInjectingServer::schedule(QTcpSocket* socket, const QString& path)
+{
+    const double roll = random.generateDouble();
+    if (roll < faults.hangFraction) return;
+
+    int status = 200;
+    QByteArray body;
+    if (roll < faults.hangFraction + faults.errorFraction) {
+        status = 503;
+    } else {
+        body = responseBody(path, &status);
+    }
+
+    const bool slow = random.generateDouble() < faults.slowFraction;
+    const int delay = slow ? faults.slowLatencyMs
+                           : faults.latencyMs + static_cast<int>(random.bounded(faults.jitterMs + 1));
+    QTimer::singleShot(delay, socket, [socket, status, body]() { respond(socket, status, body); });
+}
+
+/**
+ * @brief Tworzy treść odpowiedzi dla ścieżki API.
+ * @param path Ścieżka zapytania.
+ * @param status Wskaźnik na kod statusu HTTP (uzupełniany).
+ * @return Treść odpowiedzi JSON.
+ */
+QByteArray FaultInjectingServer::responseBody(const QString& path, int* status)
+{
+    const int id = path.section('/', -1).toInt();
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime hour(now.date(), QTime(now.time().hour(), 0));
+
+    if (!datasetStations.isEmpty()) {
+        if (path.contains("station/findAll")) return datasetStations;
+        if (path.contains("station/sensors/")) return QJsonDocument(datasetSensors.value(id)).toJson(QJsonDocument::Compact);
+        if (path.contains("data/getData/") && datasetParams.contains(id)) {
+            prepareMeasurements(id);
+            return datasetMeasurements.value(id);
+        }
+    }
+
+    if (path.contains("station/findAll")) {
+        QJsonArray stations;
+        for (int i = 0; i < 20; ++i) {
+            QJsonObject commune;
+            commune["provinceName"] = "MAZOWIECKIE";
+            QJsonObject city;
+            city["id"] = i;
+            city["name"] = QString("Miasto %1").arg(i);
+            city["commune"] = commune;
+            QJsonObject station;
+            station["id"] = 100 + i;
+            station["stationName"] = QString("Stacja %1").arg(i);
+            station["gegrLat"] = QString::number(52.0 + i * 0.05, 'f', 6);
+            station["gegrLon"] = QString::number(21.0 + i * 0.05, 'f', 6);
+            station["addressStreet"] = "ul. Testowa";
+            station["city"] = city;
+            stations.append(station);
+        }
+        return QJsonDocument(stations).toJson(QJsonDocument::Compact);
+    }
+
+    if (path.contains("station/sensors/")) {
+        static const char* codes[] = { "PM10", "PM2.5", "NO2", "O3" };
+        QJsonArray sensors;
+        for (int i = 0; i < 4; ++i) {
+            QJsonObject param;
+            param["paramName"] = QString::fromLatin1(codes[i]);
+            param["paramFormula"] = QString::fromLatin1(codes[i]);
+            param["paramCode"] = QString::fromLatin1(codes[i]);
+            QJsonObject sensor;
+            sensor["id"] = id * 10 + i;
+            sensor["stationId"] = id;
+            sensor["param"] = param;
+            sensors.append(sensor);
+        }
+        return QJsonDocument(sensors).toJson(QJsonDocument::Compact);
+    }
+
+    if (path.contains("data/getData/")) {
+        QJsonArray values;
+        for (int i = 0; i < 72; ++i) {
+            QJsonObject value;
+            value["date"] = hour.addSecs(-3600 * i).toString("yyyy-MM-dd HH:mm:ss");
+            value["value"] = 20.0 + 10.0 * std::sin((id + i) * 0.26);
+            values.append(value);
+        }
+        QJsonObject measurements;
+        measurements["key"] = "PM10";
+        measurements["values"] = values;
+        return QJsonDocument(measurements).toJson(QJsonDocument::Compact);
+    }
+
+    if (path.contains("aqindex/getIndex/")) {
+        QJsonObject level;
+        level["id"] = 1;
+        level["indexLevelName"] = "Dobry";
+        QJsonObject index;
+        index["id"] = id;
+        index["stCalcDate"] = hour.toString("yyyy-MM-dd HH:mm:ss");
+        index["stIndexLevel"] = level;
+        return QJsonDocument(index).toJson(QJsonDocument::Compact);
+    }
+
+    if (path.startsWith("/search")) {
+        const QString query = QUrlQuery(QUrl(path).query()).queryItemValue("q", QUrl::FullyDecoded).toLower();
+        QJsonArray places;
+        if (!query.isEmpty() && !query.contains("nieznany")) {
+            const size_t hash = qHash(query.simplified());
+            QJsonObject place;
+            place["lat"] = QString::number(52.0 + (hash % 10000) / 10000.0, 'f', 6);
+            place["lon"] = QString::number(21.0 + (hash / 10000 % 10000) / 10000.0, 'f', 6);
+            place["display_name"] = query;
+            places.append(place);
+        }
+        return QJsonDocument(places).toJson(QJsonDocument::Compact);
+    }
+
+    *status = 404;
+    return QByteArray();
+}
+
+/**
+ * @brief Wysyła odpowiedź HTTP.
+ * @param socket Połączenie.
+ * @param status Kod statusu HTTP.
+ * @param body Treść odpowiedzi.
+ */
+void FaultInjectingServer::respond(QTcpSocket* socket, int status, const QByteArray& body)
+{
+    const char* reason = status == 200 ? "OK" : status == 404 ? "Not Found" : "Service Unavailable";
+    QByteArray response = QByteArray("HTTP/1.1 ") + QByteArray::number(status) + ' ' + reason + "\r\n"
+                          + "Content-Type: application/json\r\n"
+                          + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          + "Connection: keep-alive\r\n\r\n"
+                          + body;
+    socket->write(response);
+}
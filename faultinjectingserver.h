@@ -0,0 +1,156 @@
+#ifndef FAULTINJECTINGSERVER_H
+#define FAULTINJECTINGSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * @brief Lokalny zamiennik API GIOŚ z wstrzykiwaniem awarii.
+ *
+ * Minimalny serwer HTTP/1.1 (keep-alive, tylko GET) odpowiadający danymi w formacie
+ * API GIOŚ dla stacji, czujników, pomiarów i indeksu jakości powietrza oraz zamiennikiem
+ * geokodera Nominatim (/search, stałe współrzędne wyliczane z adresu). Profil awarii
+ * określa opóźnienie odpowiedzi, odsetek bardzo wolnych odpowiedzi, odsetek błędów 503
+ * oraz odsetek zapytań, na które serwer nigdy nie odpowiada. Zamiast kilku wbudowanych stacji
+ * serwer może udostępniać syntetyczny katalog dowolnej wielkości z wieloletnimi historiami.
+ */
+class FaultInjectingServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Profil awarii.
+     */
+    struct Profile {
+        /// @brief Podstawowe opóźnienie odpowiedzi (ms).
+        int latencyMs = 30;
+        /// @brief Maksymalne losowe wydłużenie opóźnienia (ms).
+        int jitterMs = 20;
+        /// @brief Odsetek bardzo wolnych odpowiedzi.
+        double slowFraction = 0.0;
+        /// @brief Opóźnienie bardzo wolnej odpowiedzi (ms).
+        int slowLatencyMs = 3000;
+        /// @brief Odsetek odpowiedzi z błędem 503.
+        double errorFraction = 0.0;
+        /// @brief Odsetek zapytań pozostawionych bez odpowiedzi.
+        double hangFraction = 0.0;
+    };
+
+    /**
+     * @brief Konstruktor serwera.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit FaultInjectingServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Uruchamia nasłuchiwanie na interfejsie lokalnym.
+     * @param port Numer portu (0 wybiera wolny port).
+     * @return True, jeśli serwer nasłuchuje.
+     */
+    bool listen(quint16 port = 0);
+
+    /**
+     * @brief Zwraca adres bazowy API udostępnianego przez serwer.
+     * @return Adres w postaci http://127.0.0.1:port/pjp-api/rest/.
+     */
+    QString baseUrl() const;
+
+    /**
+     * @brief Zwraca adres zamiennika geokodera Nominatim.
+     * @return Adres w postaci http://127.0.0.1:port/search.
+     */
+    QString geocodeUrl() const;
+
+    /**
+     * @brief Zmienia profil awarii (dotyczy kolejnych zapytań).
+     * @param profile Nowy profil.
+     */
+    void setProfile(const Profile& profile);
+
+    /**
+     * @brief Zastępuje wbudowane dane katalogiem stacji i czujników (np. z SyntheticData).
+     *
+     * Pomiary czujników są generowane przy pierwszym zapytaniu i zapamiętywane.
+     * @param stations Tablica stacji w formacie station/findAll.
+     * @param sensors Tablica czujników w formacie station/sensors.
+     * @param historyHours Długość historii pomiarów każdego czujnika (godziny).
+     */
+    void setDataset(const QJsonArray& stations, const QJsonArray& sensors, int historyHours);
+
+    /**
+     * @brief Przygotowuje z góry odpowiedź z pomiarami czujnika zbioru danych.
+     *
+     * Pozwala wyłączyć czas generowania historii z pomiaru ścieżki pobierania w aplikacji.
+     * @param sensorId Identyfikator czujnika.
+     */
+    void prepareMeasurements(int sensorId);
+
+    /**
+     * @brief Zwraca liczbę odebranych zapytań.
+     * @return Liczba zapytań.
+     */
+    int requestCount() const;
+
+private:
+    /// @brief Gniazdo nasłuchujące.
+    QTcpServer server;
+    /// @brief Bieżący profil awarii.
+    Profile faults;
+    /// @brief Generator losowy (stałe ziarno dla powtarzalności).
+    QRandomGenerator random;
+    /// @brief Nieprzetworzone dane odebrane z połączeń.
+    QHash<QTcpSocket*, QByteArray> buffers;
+    /// @brief Liczba odebranych zapytań.
+    int requests = 0;
+    /// @brief Odpowiedź station/findAll zbioru danych (pusta dla danych wbudowanych).
+    QByteArray datasetStations;
+    /// @brief Czujniki zbioru danych według stacji.
+    QHash<int, QJsonArray> datasetSensors;
+    /// @brief Kody parametrów czujników zbioru danych.
+    QHash<int, QString> datasetParams;
+    /// @brief Długość historii pomiarów zbioru danych (godziny).
+    int datasetHours = 0;
+    /// @brief Przygotowane odpowiedzi data/getData zbioru danych według czujnika.
+    QHash<int, QByteArray> datasetMeasurements;
+
+    /**
+     * @brief Obsługuje nowe połączenie.
+     */
+    void onNewConnection();
+
+    /**
+     * @brief Wydziela kompletne zapytania z danych połączenia i planuje odpowiedzi.
+     * @param socket Połączenie.
+     */
+    void onReadyRead(QTcpSocket* socket);
+
+    /**
+     * @brief Planuje odpowiedź na zapytanie zgodnie z profilem awarii.
+     * @param socket Połączenie.
+     * @param path Ścieżka zapytania.
+     */
+    void schedule(QTcpSocket* socket, const QString& path);
+
+    /**
+     * @brief Tworzy treść odpowiedzi dla ścieżki API.
+     * @param path Ścieżka zapytania.
+     * @param status Wskaźnik na kod statusu HTTP (uzupełniany).
+     * @return Treść odpowiedzi JSON.
+     */
+    QByteArray responseBody(const QString& path, int* status);
+
+    /**
+     * @brief Wysyła odpowiedź HTTP.
+     * @param socket Połączenie.
+     * @param status Kod statusu HTTP.
+     * @param body Treść odpowiedzi.
+     */
+    static void respond(QTcpSocket* socket, int status, const QByteArray& body);
+};
+
+#endif // FAULTINJECTINGSERVER_H
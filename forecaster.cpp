@@ -0,0 +1,246 @@
+#include "forecaster.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/// @brief Liczba milisekund w godzinie.
+const qint64 HOUR_MS = 3600000;
+
+/// @brief Siatka przeszukiwanych wartości alfa.
+const double ALPHA_GRID[] = {0.1, 0.2, 0.4, 0.6};
+/// @brief Siatka przeszukiwanych wartości beta.
+const double BETA_GRID[] = {0.01, 0.05, 0.1};
+/// @brief Siatka przeszukiwanych wartości gamma.
+const double GAMMA_GRID[] = {0.05, 0.15, 0.3};
+
+}
+
+/**
+ * @brief Zwraca indeks składnika sezonowego dla znacznika czasu.
+ * @param timestamp Znacznik czasu (ms od epoki).
+ * @return Godzina doby w zakresie 0-23.
+ */
+int Forecaster::seasonIndex(qint64 timestamp)
+{
+    return static_cast<int>((timestamp / HOUR_MS) % SEASON_LENGTH);
+}
+
+/**
+ * @brief Inicjalizuje poziom, trend i sezonowość na podstawie początku serii.
+ *
+ * Przy co najmniej dwóch pełnych dobach danych poziom i trend wyznaczane są ze średnich
+ * dobowych, a składniki sezonowe z odchyleń od średniej pierwszej doby. W przeciwnym razie
+ * model startuje od pierwszej wartości bez trendu i sezonowości.
+ * @param state Stan modelu.
+ * @param series Seria pomiarowa.
+ * @return Indeks pierwszego ważnego punktu serii lub -1, jeśli seria nie zawiera danych.
+ */
+int Forecaster::initialize(State& state, const MeasurementSeries& series)
+{
+    int first = -1;
+    for (int i = 0; i < series.size(); ++i) {
+        if (!std::isnan(series.values[i])) {
+            first = i;
+            break;
+        }
+    }
+    if (first < 0) return -1;
+
+    const qint64 start = series.timestamps[first];
+    double daySum[2] = {0.0, 0.0};
+    int dayCount[2] = {0, 0};
+    QVector<double> hourSum(SEASON_LENGTH, 0.0);
+    QVector<int> hourCount(SEASON_LENGTH, 0);
+
+    for (int i = first; i < series.size(); ++i) {
+        const qint64 offset = series.timestamps[i] - start;
+        if (offset >= 2 * SEASON_LENGTH * HOUR_MS) break;
+        const double value = series.values[i];
+        if (std::isnan(value)) continue;
+        const int day = static_cast<int>(offset / (SEASON_LENGTH * HOUR_MS));
+        daySum[day] += value;
+        dayCount[day]++;
+        if (day == 0) {
+            hourSum[seasonIndex(series.timestamps[i])] += value;
+            hourCount[seasonIndex(series.timestamps[i])]++;
+        }
+    }
+
+    state.season.fill(0.0, SEASON_LENGTH);
+    state.trend = 0.0;
+    state.level = series.values[first];
+
+    if (dayCount[0] > 0 && dayCount[1] > 0) {
+        const double firstMean = daySum[0] / dayCount[0];
+        const double secondMean = daySum[1] / dayCount[1];
+        state.level = firstMean;
+        state.trend = (secondMean - firstMean) / SEASON_LENGTH;
+        for (int h = 0; h < SEASON_LENGTH; ++h) {
+            state.season[h] = hourCount[h] > 0 ? hourSum[h] / hourCount[h] - firstMean : 0.0;
+        }
+    }
+
+    state.lastTimestamp = -1;
+    state.lastObservedTimestamp = -1;
+    state.squaredError = 0.0;
+    state.errorCount = 0;
+    state.initialized = true;
+    return first;
+}
+
+/**
+ * @brief Aktualizuje stan modelu nową wartością godzinową.
+ *
+ * Godziny pominięte od ostatniej aktualizacji przesuwają poziom zgodnie z trendem.
+ * Punkty nie nowsze niż ostatnio przetworzony są ignorowane.
+ * @param state Stan modelu.
+ * @param timestamp Znacznik czasu pomiaru (ms od epoki).
+ * @param value Wartość pomiaru (NaN dla braku danych).
+ */
+void Forecaster::update(State& state, qint64 timestamp, double value)
+{
+    if (!state.initialized) return;
+    if (state.lastTimestamp >= 0 && timestamp <= state.lastTimestamp) return;
+
+    const qint64 steps = state.lastTimestamp < 0
+                             ? 1
+                             : std::max<qint64>(1, (timestamp - state.lastTimestamp + HOUR_MS / 2) / HOUR_MS);
+    state.level += state.trend * (steps - 1);
+    state.lastTimestamp = timestamp;
+
+    if (std::isnan(value)) {
+        state.level += state.trend;
+        return;
+    }
+
+    state.lastObservedTimestamp = timestamp;
+    const Parameters& p = state.parameters;
+    const int index = seasonIndex(timestamp);
+    const double seasonal = state.season[index];
+    const double predicted = state.level + state.trend + seasonal;
+    state.squaredError += (value - predicted) * (value - predicted);
+    state.errorCount++;
+
+    const double previousLevel = state.level;
+    state.level = p.alpha * (value - seasonal) + (1.0 - p.alpha) * (state.level + state.trend);
+    state.trend = p.beta * (state.level - previousLevel) + (1.0 - p.beta) * state.trend;
+    state.season[index] = p.gamma * (value - state.level) + (1.0 - p.gamma) * seasonal;
+}
+
+/**
+ * @brief Uwzględnia w modelu tylko punkty serii nowsze niż ostatnio przetworzone.
+ * @param state Stan modelu.
+ * @param series Seria pomiarowa posortowana rosnąco po czasie.
+ * @return Liczba nowych punktów przekazanych do modelu.
+ */
+int Forecaster::updateWithSeries(State& state, const MeasurementSeries& series)
+{
+    const qint64* begin = series.timestamps.constData();
+    const qint64* end = begin + series.size();
+    const qint64* next = std::upper_bound(begin, end, state.lastTimestamp);
+
+    int added = 0;
+    for (const qint64* it = next; it != end; ++it) {
+        const int i = static_cast<int>(it - begin);
+        update(state, series.timestamps[i], series.values[i]);
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief Dopasowuje parametry modelu do całej serii (przeszukiwanie siatki).
+ * @param series Seria pomiarowa posortowana rosnąco po czasie.
+ * @return Stan modelu o najmniejszym średnim błędzie prognoz jednokrokowych.
+ */
+Forecaster::State Forecaster::fit(const MeasurementSeries& series)
+{
+    State best;
+    double bestError = std::numeric_limits<double>::max();
+
+    for (double alpha : ALPHA_GRID) {
+        for (double beta : BETA_GRID) {
+            for (double gamma : GAMMA_GRID) {
+                State candidate;
+                candidate.parameters.alpha = alpha;
+                candidate.parameters.beta = beta;
+                candidate.parameters.gamma = gamma;
+
+                const int first = initialize(candidate, series);
+                if (first < 0) return State();
+
+                for (int i = first; i < series.size(); ++i) {
+                    update(candidate, series.timestamps[i], series.values[i]);
+                }
+
+                const double error = candidate.squaredError / std::max(candidate.errorCount, 1);
+                if (error < bestError) {
+                    bestError = error;
+                    best = candidate;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Dopasowuje modele wszystkich czujników równolegle w puli wątków.
+ *
+ * Blokuje wątek wywołujący do zakończenia wszystkich dopasowań; interfejs uruchamia
+ * tę funkcję przez QtConcurrent::run.
+ * @param series Serie pomiarowe według ID czujnika.
+ * @return Stany modeli według ID czujnika.
+ */
+QHash<int, Forecaster::State> Forecaster::fitAll(const QHash<int, MeasurementSeries>& series)
+{
+    const QList<int> sensorIds = series.keys();
+    QVector<State> results(sensorIds.size());
+    QVector<int> jobs(sensorIds.size());
+    std::iota(jobs.begin(), jobs.end(), 0);
+
+    QtConcurrent::blockingMap(jobs, [&](int job) {
+        results[job] = fit(*series.constFind(sensorIds[job]));
+    });
+
+    QHash<int, State> states;
+    states.reserve(sensorIds.size());
+    for (int i = 0; i < sensorIds.size(); ++i) {
+        if (results[i].initialized) {
+            states.insert(sensorIds[i], results[i]);
+        }
+    }
+    return states;
+}
+
+/**
+ * @brief Wyznacza prognozę na kolejne godziny od ostatniej poprawnej obserwacji.
+ *
+ * Godziny bez danych na końcu serii przesuwają w update() poziom o trend, więc prognoza
+ * liczona od ostatniej obserwacji cofa to przesunięcie i nie zostawia luki na wykresie.
+ * Wartości prognozy nie schodzą poniżej zera (stężenia zanieczyszczeń).
+ * @param state Stan modelu.
+ * @param horizon Liczba godzin prognozy.
+ * @return Seria z prognozowanymi wartościami (pusta, jeśli model nie jest gotowy).
+ */
+MeasurementSeries Forecaster::forecast(const State& state, int horizon)
+{
+    MeasurementSeries result;
+    if (!state.initialized || state.lastObservedTimestamp < 0) return result;
+
+    const qint64 anchor = state.lastObservedTimestamp;
+    const qint64 missing = (state.lastTimestamp - anchor + HOUR_MS / 2) / HOUR_MS;
+    result.timestamps.reserve(horizon);
+    result.values.reserve(horizon);
+    for (int h = 1; h <= horizon; ++h) {
+        const qint64 timestamp = anchor + h * HOUR_MS;
+        const double value = state.level + (h - missing) * state.trend + state.season[seasonIndex(timestamp)];
+        result.timestamps.append(timestamp);
+        result.values.append(std::max(0.0, value));
+    }
+    return result;
+}
@@ -0,0 +1,114 @@
+#ifndef FORECASTER_H
+#define FORECASTER_H
+
+#include <QHash>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @brief Krótkoterminowa prognoza pomiarów metodą Holta-Wintersa.
+ *
+ * Model addytywny z trendem i sezonowością dobową (24 godziny). Stan modelu jest
+ * aktualizowany przyrostowo przy każdej nowej wartości godzinowej, a pełne dopasowanie
+ * parametrów wykonywane jest wsadowo i równolegle dla wszystkich czujników.
+ */
+class Forecaster
+{
+public:
+    /// @brief Długość sezonu w godzinach (sezonowość dobowa).
+    static const int SEASON_LENGTH = 24;
+
+    /**
+     * @brief Parametry wygładzania wykładniczego.
+     */
+    struct Parameters {
+        /// @brief Współczynnik wygładzania poziomu.
+        double alpha = 0.3;
+        /// @brief Współczynnik wygładzania trendu.
+        double beta = 0.05;
+        /// @brief Współczynnik wygładzania składnika sezonowego.
+        double gamma = 0.2;
+    };
+
+    /**
+     * @brief Stan modelu jednego czujnika.
+     */
+    struct State {
+        /// @brief Parametry modelu.
+        Parameters parameters;
+        /// @brief Bieżący poziom.
+        double level = 0.0;
+        /// @brief Bieżący trend (zmiana na godzinę).
+        double trend = 0.0;
+        /// @brief Składniki sezonowe według godziny doby.
+        QVector<double> season = QVector<double>(SEASON_LENGTH, 0.0);
+        /// @brief Znacznik czasu ostatniej uwzględnionej godziny (ms od epoki).
+        qint64 lastTimestamp = -1;
+        /// @brief Znacznik czasu ostatniej godziny z poprawną wartością (ms od epoki).
+        qint64 lastObservedTimestamp = -1;
+        /// @brief Suma kwadratów błędów prognoz jednokrokowych.
+        double squaredError = 0.0;
+        /// @brief Liczba prognoz jednokrokowych uwzględnionych w błędzie.
+        int errorCount = 0;
+        /// @brief Czy model został zainicjalizowany.
+        bool initialized = false;
+    };
+
+    /**
+     * @brief Aktualizuje stan modelu nową wartością godzinową.
+     * @param state Stan modelu.
+     * @param timestamp Znacznik czasu pomiaru (ms od epoki).
+     * @param value Wartość pomiaru (NaN dla braku danych).
+     */
+    static void update(State& state, qint64 timestamp, double value);
+
+    /**
+     * @brief Uwzględnia w modelu tylko punkty serii nowsze niż ostatnio przetworzone.
+     * @param state Stan modelu.
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     * @return Liczba nowych punktów przekazanych do modelu.
+     */
+    static int updateWithSeries(State& state, const MeasurementSeries& series);
+
+    /**
+     * @brief Dopasowuje parametry modelu do całej serii (przeszukiwanie siatki).
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     * @return Stan modelu o najmniejszym błędzie prognoz jednokrokowych.
+     */
+    static State fit(const MeasurementSeries& series);
+
+    /**
+     * @brief Dopasowuje modele wszystkich czujników równolegle w puli wątków.
+     *
+     * Blokuje wątek wywołujący do zakończenia wszystkich dopasowań.
+     * @param series Serie pomiarowe według ID czujnika.
+     * @return Stany modeli według ID czujnika.
+     */
+    static QHash<int, State> fitAll(const QHash<int, MeasurementSeries>& series);
+
+    /**
+     * @brief Wyznacza prognozę na kolejne godziny od ostatniej poprawnej obserwacji.
+     * @param state Stan modelu.
+     * @param horizon Liczba godzin prognozy.
+     * @return Seria z prognozowanymi wartościami (pusta, jeśli model nie jest gotowy).
+     */
+    static MeasurementSeries forecast(const State& state, int horizon);
+
+private:
+    /**
+     * @brief Inicjalizuje poziom, trend i sezonowość na podstawie początku serii.
+     * @param state Stan modelu.
+     * @param series Seria pomiarowa.
+     * @return Indeks pierwszego punktu, od którego należy kontynuować aktualizację.
+     */
+    static int initialize(State& state, const MeasurementSeries& series);
+
+    /**
+     * @brief Zwraca indeks składnika sezonowego dla znacznika czasu.
+     * @param timestamp Znacznik czasu (ms od epoki).
+     * @return Godzina doby w zakresie 0-23.
+     */
+    static int seasonIndex(qint64 timestamp);
+};
+
+#endif // FORECASTER_H
@@ -0,0 +1,294 @@
+#include "historyarchive.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Wczytuje wszystkie pliki archiwum z katalogu.
+ * @param directory Katalog lokalnej bazy danych.
+ * @param pool Pula wątków parsujących.
+ * @return Wczytane archiwum.
+ */
+HistoryArchive HistoryArchive::load(const QString& directory, QThreadPool* pool)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QDir dir(directory);
+    const QRegularExpression measurementPattern("^measurements_station(\\d+)_sensor(\\d+)\\.jsonl?$");
+    const QRegularExpression airQualityPattern("^airquality_station(\\d+)\\.json$");
+
+    QMap<QString, Task> unique;
+    for (const QString& name : dir.entryList({"measurements_station*_sensor*.json*", "airquality_station*.json"}, QDir::Files)) {
+        Task task;
+        QRegularExpressionMatch match = measurementPattern.match(name);
+        if (match.hasMatch()) {
+            task.sensorId = match.captured(2).toInt();
+        } else {
+            match = airQualityPattern.match(name);
+            if (!match.hasMatch()) continue;
+        }
+        task.stationId = match.captured(1).toInt();
+        const QString path = dir.filePath(name);
+        task.basePath = path.left(path.lastIndexOf('.'));
+        unique.insert(task.basePath, task);
+    }
+    const QVector<Task> tasks(unique.cbegin(), unique.cend());
+
+    const QList<Parsed> results = QtConcurrent::blockingMapped(pool, tasks, &HistoryArchive::parse);
+
+    HistoryArchive archive;
+    LoadStats& loaded = archive.loaded;
+    loaded.threads = pool->maxThreadCount();
+    for (const Parsed& result : results) {
+        loaded.files += result.files;
+        loaded.bytes += result.bytes;
+        loaded.failed += result.failed;
+        if (result.airQuality.stationId >= 0) {
+            archive.airQualityByStation.insert(result.airQuality.stationId, result.airQuality);
+        } else if (!result.entry.series.isEmpty()) {
+            archive.series.append(result.entry);
+        }
+    }
+
+    std::sort(archive.series.begin(), archive.series.end(), [](const Entry& a, const Entry& b) {
+        if (a.stationId != b.stationId) return a.stationId < b.stationId;
+        if (a.series.key != b.series.key) return a.series.key < b.series.key;
+        return a.sensorId < b.sensorId;
+    });
+    for (int i = 0; i < archive.series.size(); ++i) {
+        const Entry& entry = archive.series[i];
+        archive.byStation[entry.stationId][entry.series.key].append(i);
+        archive.byParameter[entry.series.key].append(i);
+        archive.points += entry.series.size();
+    }
+
+    loaded.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return archive;
+}
+
+/**
+ * @brief Zwraca statystyki wczytywania archiwum.
+ * @return Statystyki.
+ */
+HistoryArchive::LoadStats HistoryArchive::loadStats() const
+{
+    return loaded;
+}
+
+/**
+ * @brief Zwraca liczbę serii w archiwum.
+ * @return Liczba serii (czujników).
+ */
+int HistoryArchive::seriesCount() const
+{
+    return series.size();
+}
+
+/**
+ * @brief Zwraca łączną liczbę punktów wszystkich serii.
+ * @return Liczba punktów.
+ */
+qint64 HistoryArchive::pointCount() const
+{
+    return points;
+}
+
+/**
+ * @brief Zwraca stacje obecne w archiwum.
+ * @return Identyfikatory stacji rosnąco.
+ */
+QVector<int> HistoryArchive::stations() const
+{
+    QVector<int> result;
+    result.reserve(byStation.size());
+    for (auto it = byStation.constBegin(); it != byStation.constEnd(); ++it) {
+        result.append(it.key());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * @brief Zwraca kody parametrów obecne w archiwum.
+ * @return Kody parametrów alfabetycznie.
+ */
+QStringList HistoryArchive::parameters() const
+{
+    QStringList result = byParameter.keys();
+    result.sort();
+    return result;
+}
+
+/**
+ * @brief Zwraca serie pasujące do stacji i parametru.
+ * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+ * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+ * @return Wskaźniki do serii archiwum.
+ */
+QVector<const HistoryArchive::Entry*> HistoryArchive::entries(int stationId, const QString& paramCode) const
+{
+    QVector<const Entry*> result;
+    if (stationId < 0 && paramCode.isEmpty()) {
+        result.reserve(series.size());
+        for (const Entry& entry : series) result.append(&entry);
+        return result;
+    }
+
+    QVector<int> indices;
+    if (stationId < 0) {
+        indices = byParameter.value(paramCode);
+    } else if (!paramCode.isEmpty()) {
+        indices = byStation.value(stationId).value(paramCode);
+    } else {
+        const QHash<QString, QVector<int>> parameters = byStation.value(stationId);
+        for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it) {
+            indices += it.value();
+        }
+        std::sort(indices.begin(), indices.end());
+    }
+
+    result.reserve(indices.size());
+    for (int index : indices) result.append(&series[index]);
+    return result;
+}
+
+/**
+ * @brief Zwraca punkty z zakresu czasu dla stacji i parametru.
+ * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+ * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+ * @param from Początek zakresu (ms od epoki, włącznie).
+ * @param to Koniec zakresu (ms od epoki, włącznie).
+ * @return Punkty bez braków danych.
+ */
+QVector<HistoryArchive::Point> HistoryArchive::query(int stationId, const QString& paramCode, qint64 from, qint64 to) const
+{
+    QVector<Point> result;
+    for (const Entry* entry : entries(stationId, paramCode)) {
+        const QPair<int, int> bounds = range(*entry, from, to);
+        for (int i = bounds.first; i < bounds.second; ++i) {
+            const double value = entry->series.values[i];
+            if (std::isnan(value)) continue;
+            result.append({entry->stationId, entry->sensorId, entry->series.timestamps[i], value});
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Liczy statystyki wartości z zakresu czasu bez kopiowania punktów.
+ * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+ * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+ * @param from Początek zakresu (ms od epoki, włącznie).
+ * @param to Koniec zakresu (ms od epoki, włącznie).
+ * @return Statystyki.
+ */
+HistoryArchive::Summary HistoryArchive::summarize(int stationId, const QString& paramCode, qint64 from, qint64 to) const
+{
+    Summary summary;
+    summary.min = std::numeric_limits<double>::infinity();
+    summary.max = -std::numeric_limits<double>::infinity();
+    double sum = 0.0;
+
+    for (const Entry* entry : entries(stationId, paramCode)) {
+        const QPair<int, int> bounds = range(*entry, from, to);
+        const qint64 before = summary.count;
+        for (int i = bounds.first; i < bounds.second; ++i) {
+            const double value = entry->series.values[i];
+            if (std::isnan(value)) continue;
+            sum += value;
+            summary.min = std::min(summary.min, value);
+            summary.max = std::max(summary.max, value);
+            summary.count++;
+        }
+        if (summary.count > before) summary.series++;
+    }
+
+    if (summary.count == 0) {
+        summary.mean = summary.min = summary.max = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        summary.mean = sum / summary.count;
+    }
+    return summary;
+}
+
+/**
+ * @brief Zwraca zapisany indeks jakości powietrza stacji.
+ * @param stationId Identyfikator stacji.
+ * @return Indeks (ze stationId = -1, jeśli stacja nie ma zapisu).
+ */
+HistoryArchive::AirQualityEntry HistoryArchive::airQuality(int stationId) const
+{
+    return airQualityByStation.value(stationId);
+}
+
+/**
+ * @brief Parsuje pliki zadania (wywoływana w puli wątków).
+ * @param task Zadanie.
+ * @return Wynik parsowania.
+ */
+HistoryArchive::Parsed HistoryArchive::parse(const Task& task)
+{
+    Parsed result;
+
+    if (task.sensorId < 0) {
+        QFile file(task.basePath + ".json");
+        if (!file.open(QIODevice::ReadOnly)) {
+            result.failed = 1;
+            return result;
+        }
+        const QByteArray data = file.readAll();
+        result.files = 1;
+        result.bytes = data.size();
+
+        const QJsonObject airQuality = QJsonDocument::fromJson(data).object().value("airQuality").toObject();
+        if (airQuality.isEmpty()) {
+            result.failed = 1;
+            return result;
+        }
+        const QJsonObject level = airQuality.value("stIndexLevel").toObject();
+        result.airQuality.stationId = task.stationId;
+        result.airQuality.calcTimestamp = MeasurementSeries::parseTimestamp(airQuality.value("stCalcDate").toString());
+        result.airQuality.indexLevel = level.value("id").toInt(-1);
+        result.airQuality.indexLevelName = level.value("indexLevelName").toString();
+        return result;
+    }
+
+    const QFileInfo snapshot(task.basePath + ".json");
+    const QFileInfo journal(task.basePath + ".jsonl");
+    for (const QFileInfo& info : {snapshot, journal}) {
+        if (!info.exists()) continue;
+        result.files++;
+        result.bytes += info.size();
+    }
+
+    result.entry.stationId = task.stationId;
+    result.entry.sensorId = task.sensorId;
+    result.entry.series = MeasurementSeries::readStored(snapshot.filePath(), journal.filePath());
+    if (result.entry.series.isEmpty()) result.failed = result.files;
+    return result;
+}
+
+/**
+ * @brief Zwraca zakres indeksów serii należących do przedziału czasu.
+ * @param entry Seria archiwum.
+ * @param from Początek zakresu (włącznie).
+ * @param to Koniec zakresu (włącznie).
+ * @return Para (pierwszy indeks, indeks za ostatnim).
+ */
+QPair<int, int> HistoryArchive::range(const Entry& entry, qint64 from, qint64 to)
+{
+    const QVector<qint64>& timestamps = entry.series.timestamps;
+    const int first = static_cast<int>(std::lower_bound(timestamps.cbegin(), timestamps.cend(), from) - timestamps.cbegin());
+    const int last = static_cast<int>(std::upper_bound(timestamps.cbegin(), timestamps.cend(), to) - timestamps.cbegin());
+    return qMakePair(first, std::max(first, last));
+}
@@ -0,0 +1,230 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @brief Całe archiwum lokalnej bazy danych wczytane do pamięci.
+ *
+ * Wczytuje równolegle wszystkie pliki pomiarów (wraz z dziennikami) i indeksów jakości
+ * powietrza z katalogu danych aplikacji. Serie są indeksowane według stacji i kodu parametru,
+ * a w obrębie serii według czasu (posortowane znaczniki czasu), więc zapytania mogą obejmować
+ * wiele stacji i czujników naraz.
+ */
+class HistoryArchive
+{
+public:
+    /**
+     * @brief Seria pomiarowa jednego czujnika z archiwum.
+     */
+    struct Entry {
+        /// @brief Identyfikator stacji.
+        int stationId = -1;
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Seria pomiarowa (klucz serii to kod parametru).
+        MeasurementSeries series;
+    };
+
+    /**
+     * @brief Ostatni zapisany indeks jakości powietrza stacji.
+     */
+    struct AirQualityEntry {
+        /// @brief Identyfikator stacji (-1, jeśli brak zapisu).
+        int stationId = -1;
+        /// @brief Czas obliczenia indeksu (ms od epoki) lub -1.
+        qint64 calcTimestamp = -1;
+        /// @brief Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły) lub -1.
+        int indexLevel = -1;
+        /// @brief Nazwa poziomu indeksu.
+        QString indexLevelName;
+    };
+
+    /**
+     * @brief Pojedynczy punkt wyniku zapytania.
+     */
+    struct Point {
+        /// @brief Identyfikator stacji.
+        int stationId = -1;
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Znacznik czasu w milisekundach od epoki.
+        qint64 timestamp = 0;
+        /// @brief Wartość pomiaru.
+        double value = 0.0;
+    };
+
+    /**
+     * @brief Statystyki wartości w zakresie zapytania.
+     */
+    struct Summary {
+        /// @brief Liczba wartości (bez braków danych).
+        qint64 count = 0;
+        /// @brief Liczba serii, z których pochodzą wartości.
+        int series = 0;
+        /// @brief Średnia (NaN, jeśli brak wartości).
+        double mean = 0.0;
+        /// @brief Minimum.
+        double min = 0.0;
+        /// @brief Maksimum.
+        double max = 0.0;
+    };
+
+    /**
+     * @brief Statystyki wczytywania archiwum.
+     */
+    struct LoadStats {
+        /// @brief Liczba wczytanych plików (pliki główne, dzienniki, indeksy).
+        int files = 0;
+        /// @brief Łączny rozmiar wczytanych plików w bajtach.
+        qint64 bytes = 0;
+        /// @brief Liczba plików pustych lub uszkodzonych.
+        int failed = 0;
+        /// @brief Liczba wątków użytych do parsowania.
+        int threads = 0;
+        /// @brief Czas wczytywania (przeglądanie katalogu, parsowanie, indeksowanie) w ms.
+        double elapsedMs = 0.0;
+    };
+
+    /**
+     * @brief Wczytuje wszystkie pliki archiwum z katalogu.
+     *
+     * Katalog jest przeglądany w wątku wywołującym, każdy plik (lub para plik główny - dziennik)
+     * jest parsowany jako osobne zadanie w puli wątków, a indeksy budowane są na końcu.
+     * @param directory Katalog lokalnej bazy danych.
+     * @param pool Pula wątków parsujących (domyślnie globalna, czyli wszystkie rdzenie).
+     * @return Wczytane archiwum.
+     */
+    static HistoryArchive load(const QString& directory, QThreadPool* pool = QThreadPool::globalInstance());
+
+    /**
+     * @brief Zwraca statystyki wczytywania archiwum.
+     * @return Statystyki.
+     */
+    LoadStats loadStats() const;
+
+    /**
+     * @brief Zwraca liczbę serii w archiwum.
+     * @return Liczba serii (czujników).
+     */
+    int seriesCount() const;
+
+    /**
+     * @brief Zwraca łączną liczbę punktów wszystkich serii.
+     * @return Liczba punktów.
+     */
+    qint64 pointCount() const;
+
+    /**
+     * @brief Zwraca stacje obecne w archiwum.
+     * @return Identyfikatory stacji rosnąco.
+     */
+    QVector<int> stations() const;
+
+    /**
+     * @brief Zwraca kody parametrów obecne w archiwum.
+     * @return Kody parametrów alfabetycznie.
+     */
+    QStringList parameters() const;
+
+    /**
+     * @brief Zwraca serie pasujące do stacji i parametru.
+     * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+     * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+     * @return Wskaźniki do serii archiwum (ważne, dopóki archiwum istnieje).
+     */
+    QVector<const Entry*> entries(int stationId, const QString& paramCode) const;
+
+    /**
+     * @brief Zwraca punkty z zakresu czasu dla stacji i parametru.
+     * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+     * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+     * @param from Początek zakresu (ms od epoki, włącznie).
+     * @param to Koniec zakresu (ms od epoki, włącznie).
+     * @return Punkty bez braków danych, uporządkowane według serii, a w serii według czasu.
+     */
+    QVector<Point> query(int stationId, const QString& paramCode, qint64 from, qint64 to) const;
+
+    /**
+     * @brief Liczy statystyki wartości z zakresu czasu bez kopiowania punktów.
+     * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+     * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+     * @param from Początek zakresu (ms od epoki, włącznie).
+     * @param to Koniec zakresu (ms od epoki, włącznie).
+     * @return Statystyki.
+     */
+    Summary summarize(int stationId, const QString& paramCode, qint64 from, qint64 to) const;
+
+    /**
+     * @brief Zwraca zapisany indeks jakości powietrza stacji.
+     * @param stationId Identyfikator stacji.
+     * @return Indeks (ze stationId = -1, jeśli stacja nie ma zapisu).
+     */
+    AirQualityEntry airQuality(int stationId) const;
+
+private:
+    /**
+     * @brief Zadanie parsowania jednego pliku lub pary plik główny - dziennik.
+     */
+    struct Task {
+        /// @brief Identyfikator stacji.
+        int stationId = -1;
+        /// @brief Identyfikator czujnika (-1 dla indeksu jakości powietrza).
+        int sensorId = -1;
+        /// @brief Ścieżka bez rozszerzenia.
+        QString basePath;
+    };
+
+    /**
+     * @brief Wynik parsowania zadania.
+     */
+    struct Parsed {
+        /// @brief Seria pomiarowa (dla zadań pomiarów).
+        Entry entry;
+        /// @brief Indeks jakości powietrza (dla zadań indeksu).
+        AirQualityEntry airQuality;
+        /// @brief Liczba wczytanych plików.
+        int files = 0;
+        /// @brief Rozmiar wczytanych plików w bajtach.
+        qint64 bytes = 0;
+        /// @brief Liczba plików pustych lub uszkodzonych.
+        int failed = 0;
+    };
+
+    /// @brief Serie posortowane według stacji, parametru i czujnika.
+    QVector<Entry> series;
+    /// @brief Indeks: stacja -> kod parametru -> pozycje w series.
+    QHash<int, QHash<QString, QVector<int>>> byStation;
+    /// @brief Indeks: kod parametru -> pozycje w series.
+    QHash<QString, QVector<int>> byParameter;
+    /// @brief Indeksy jakości powietrza według stacji.
+    QHash<int, AirQualityEntry> airQualityByStation;
+    /// @brief Łączna liczba punktów.
+    qint64 points = 0;
+    /// @brief Statystyki wczytywania.
+    LoadStats loaded;
+
+    /**
+     * @brief Parsuje pliki zadania (wywoływana w puli wątków).
+     * @param task Zadanie.
+     * @return Wynik parsowania.
+     */
+    static Parsed parse(const Task& task);
+
+    /**
+     * @brief Zwraca zakres indeksów serii należących do przedziału czasu.
+     * @param entry Seria archiwum.
+     * @param from Początek zakresu (włącznie).
+     * @param to Koniec zakresu (włącznie).
+     * @return Para (pierwszy indeks, indeks za ostatnim).
+     */
+    static QPair<int, int> range(const Entry& entry, qint64 from, qint64 to);
+};
+
+#endif // HISTORYARCHIVE_H
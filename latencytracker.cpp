@@ -0,0 +1,62 @@
+#include "latencytracker.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Konstruktor okna.
+ * @param capacity Maksymalna liczba przechowywanych próbek.
+ */
+LatencyTracker::LatencyTracker(int capacity)
+    : capacity(std::max(1, capacity))
+{
+    samples.reserve(this->capacity);
+}
+
+/**
+ * @brief Dodaje próbkę, zastępując najstarszą po zapełnieniu okna.
+ * @param milliseconds Czas odpowiedzi w milisekundach.
+ */
+void LatencyTracker::add(double milliseconds)
+{
+    if (samples.size() < capacity) {
+        samples.append(milliseconds);
+        return;
+    }
+    samples[next] = milliseconds;
+    next = (next + 1) % capacity;
+}
+
+/**
+ * @brief Zwraca percentyl z próbek w oknie (interpolacja liniowa między sąsiednimi rangami).
+ * @param fraction Percentyl jako ułamek (0 ... 1).
+ * @return Wartość percentyla lub 0, jeśli okno jest puste.
+ */
+double LatencyTracker::percentile(double fraction) const
+{
+    if (samples.isEmpty()) return 0.0;
+
+    QVector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const double position = std::clamp(fraction, 0.0, 1.0) * (sorted.size() - 1);
+    const int lower = static_cast<int>(std::floor(position));
+    const int upper = std::min(lower + 1, static_cast<int>(sorted.size()) - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - lower);
+}
+
+/**
+ * @brief Zwraca liczbę próbek w oknie.
+ * @return Liczba próbek.
+ */
+int LatencyTracker::count() const
+{
+    return samples.size();
+}
+
+/**
+ * @brief Usuwa wszystkie próbki.
+ */
+void LatencyTracker::clear()
+{
+    samples.clear();
+    next = 0;
+}
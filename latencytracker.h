@@ -0,0 +1,54 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <QVector>
+
+/**
+ * @brief Okno ostatnich czasów odpowiedzi z obliczaniem percentyli.
+ *
+ * Przechowuje co najwyżej capacity ostatnich próbek w buforze cyklicznym, więc
+ * percentyle odzwierciedlają bieżący stan serwera, a nie całą historię.
+ */
+class LatencyTracker
+{
+public:
+    /**
+     * @brief Konstruktor okna.
+     * @param capacity Maksymalna liczba przechowywanych próbek.
+     */
+    explicit LatencyTracker(int capacity = 256);
+
+    /**
+     * @brief Dodaje próbkę, zastępując najstarszą po zapełnieniu okna.
+     * @param milliseconds Czas odpowiedzi w milisekundach.
+     */
+    void add(double milliseconds);
+
+    /**
+     * @brief Zwraca percentyl z próbek w oknie.
+     * @param fraction Percentyl jako ułamek (0 ... 1).
+     * @return Wartość percentyla lub 0, jeśli okno jest puste.
+     */
+    double percentile(double fraction) const;
+
+    /**
+     * @brief Zwraca liczbę próbek w oknie.
+     * @return Liczba próbek.
+     */
+    int count() const;
+
+    /**
+     * @brief Usuwa wszystkie próbki.
+     */
+    void clear();
+
+private:
+    /// @brief Bufor cykliczny próbek.
+    QVector<double> samples;
+    /// @brief Maksymalna liczba próbek.
+    int capacity;
+    /// @brief Pozycja, na której zostanie zapisana następna próbka po zapełnieniu okna.
+    int next = 0;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,851 @@
+#include "localapiserver.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// @brief Maksymalny rozmiar nagłówków jednego zapytania (bajty).
+const int MAX_HEADER_BYTES = 16 * 1024;
+/// @brief Długość godzinowego przedziału agregacji (ms).
+const qint64 HOUR_MS = 3600 * 1000;
+/// @brief Długość dobowego przedziału agregacji (ms, doby UTC).
+const qint64 DAY_MS = 24 * HOUR_MS;
+
+/**
+ * @brief Zwraca opis kodu statusu HTTP.
+ * @param status Kod statusu.
+ * @return Opis.
+ */
+const char* reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    default: return "Internal Server Error";
+    }
+}
+
+/**
+ * @brief Oblicza sumę kontrolną CRC-32 (wielomian gzip).
+ * @param data Dane.
+ * @return Suma kontrolna.
+ */
+quint32 crc32(const QByteArray& data)
+{
+    static const QVector<quint32> table = []() {
+        QVector<quint32> values(256);
+        for (quint32 n = 0; n < 256; ++n) {
+            quint32 c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+        return values;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (const char byte : data) {
+        crc = table[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Dopisuje liczbę 32-bitową w kolejności little-endian.
+ * @param target Bufor.
+ * @param value Liczba.
+ */
+void appendLittleEndian(QByteArray& target, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) target.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @brief Zamienia liczbę na wartość JSON (NaN jako null).
+ * @param value Liczba.
+ * @return Wartość JSON.
+ */
+QJsonValue number(double value)
+{
+    return std::isnan(value) ? QJsonValue() : QJsonValue(value);
+}
+
+/**
+ * @brief Odczytuje parametr czasu zapytania.
+ * @param query Parametry zapytania.
+ * @param name Nazwa parametru.
+ * @param fallback Wartość domyślna.
+ * @param ok Wskaźnik ustawiany na false przy niepoprawnej wartości.
+ * @return Czas w ms od epoki.
+ */
+qint64 timeParameter(const QUrlQuery& query, const QString& name, qint64 fallback, bool* ok)
+{
+    if (!query.hasQueryItem(name)) return fallback;
+    bool parsed = false;
+    const qint64 value = query.queryItemValue(name).toLongLong(&parsed);
+    if (!parsed) *ok = false;
+    return value;
+}
+
+/**
+ * @brief Zamienia rekord stacji na obiekt JSON.
+ * @param station Rekord stacji.
+ * @return Obiekt JSON.
+ */
+QJsonObject stationJson(const StationRecord& station)
+{
+    QJsonObject result;
+    result["id"] = station.id;
+    result["name"] = station.name;
+    result["city"] = station.city;
+    result["street"] = station.street;
+    result["province"] = station.province;
+    result["lat"] = station.latitude;
+    result["lon"] = station.longitude;
+    return result;
+}
+
+/**
+ * @brief Zwraca treść odpowiedzi z błędem.
+ * @param message Opis błędu.
+ * @return Treść JSON.
+ */
+QByteArray errorBody(const QString& message)
+{
+    QJsonObject error;
+    error["error"] = message;
+    return QJsonDocument(error).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief Zwraca ostatnią ważną wartość serii.
+ * @param series Seria posortowana rosnąco po czasie.
+ * @param timestamp Wskaźnik na znacznik czasu wartości (uzupełniany, -1 przy braku).
+ * @return Wartość lub NaN.
+ */
+double latestValue(const MeasurementSeries& series, qint64* timestamp)
+{
+    for (int i = series.size() - 1; i >= 0; --i) {
+        if (!std::isnan(series.values[i])) {
+            *timestamp = series.timestamps[i];
+            return series.values[i];
+        }
+    }
+    *timestamp = -1;
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+}
+
+/**
+ * @brief Konstruktor serwera.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+LocalApiServer::LocalApiServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/**
+ * @brief Destruktor - zatrzymuje wątek serwera.
+ */
+LocalApiServer::~LocalApiServer()
+{
+    stop();
+}
+
+/**
+ * @brief Uruchamia nasłuchiwanie na interfejsie lokalnym w osobnym wątku.
+ *
+ * Gniazdo nasłuchujące i wszystkie połączenia żyją w wątku serverThread, więc odbiór,
+ * obliczanie i wysyłanie odpowiedzi nie korzystają z pętli zdarzeń wątku interfejsu.
+ * @param port Numer portu (0 wybiera wolny port).
+ * @return True, jeśli serwer nasłuchuje.
+ */
+bool LocalApiServer::listen(quint16 port)
+{
+    if (serverThread) return false;
+
+    serverThread = new QThread(this);
+    server = new QTcpServer;
+    server->moveToThread(serverThread);
+    connect(serverThread, &QThread::finished, server, &QObject::deleteLater);
+    serverThread->start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(server, [this, port, &listening]() {
+        listening = server->listen(QHostAddress::LocalHost, port);
+        if (!listening) return;
+        boundPort = server->serverPort();
+        connect(server, &QTcpServer::newConnection, server, [this]() { onNewConnection(); });
+    }, Qt::BlockingQueuedConnection);
+
+    if (!listening) {
+        qDebug() << "Failed to start local API on port" << port;
+        stop();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Zatrzymuje serwer i zamyka połączenia.
+ */
+void LocalApiServer::stop()
+{
+    if (!serverThread) return;
+    serverThread->quit();
+    serverThread->wait();
+    delete serverThread;
+    serverThread = nullptr;
+    server = nullptr;
+    boundPort = 0;
+    buffers.clear();
+    responses.clear();
+}
+
+/**
+ * @brief Sprawdza, czy serwer nasłuchuje.
+ * @return True, jeśli serwer działa.
+ */
+bool LocalApiServer::isListening() const
+{
+    return serverThread && boundPort != 0;
+}
+
+/**
+ * @brief Zwraca port serwera.
+ * @return Numer portu lub 0, jeśli serwer nie nasłuchuje.
+ */
+quint16 LocalApiServer::port() const
+{
+    return boundPort;
+}
+
+/**
+ * @brief Zwraca adres bazowy serwera.
+ * @return Adres w postaci http://127.0.0.1:port lub pusty napis.
+ */
+QString LocalApiServer::baseUrl() const
+{
+    return isListening() ? QString("http://127.0.0.1:%1").arg(boundPort) : QString();
+}
+
+/**
+ * @brief Publikuje katalog stacji.
+ * @param stations Rekordy stacji.
+ */
+void LocalApiServer::publishStations(const QVector<StationRecord>& stations)
+{
+    QMutexLocker lock(&publishMutex);
+    pending.hasStations = true;
+    pending.stations = stations;
+    ++publishedVersion;
+}
+
+/**
+ * @brief Publikuje serię czujnika z pamięci podręcznej.
+ *
+ * Seria trafia do listy zmian jako współdzielony wskaźnik; kopia danych serii jest
+ * współdzielona niejawnie, więc publikacja nie kopiuje punktów ani innych serii.
+ * @param stationId Identyfikator stacji czujnika (-1, jeśli nieznana).
+ * @param sensorId Identyfikator czujnika.
+ * @param series Seria posortowana rosnąco po czasie (klucz serii to kod parametru).
+ */
+void LocalApiServer::publishSeries(int stationId, int sensorId, const MeasurementSeries& series)
+{
+    auto entry = QSharedPointer<CachedSeries>::create();
+    entry->stationId = stationId;
+    entry->series = series;
+
+    QMutexLocker lock(&publishMutex);
+    pending.series.insert(sensorId, entry);
+    ++publishedVersion;
+}
+
+/**
+ * @brief Publikuje indeks jakości powietrza stacji.
+ * @param stationId Identyfikator stacji.
+ * @param index Obiekt JSON indeksu w formacie API GIOŚ.
+ */
+void LocalApiServer::publishAirQuality(int stationId, const QJsonObject& index)
+{
+    QMutexLocker lock(&publishMutex);
+    pending.airQuality.insert(stationId, index);
+    ++publishedVersion;
+}
+
+/**
+ * @brief Publikuje archiwum lokalnej bazy danych.
+ * @param archive Wczytane archiwum.
+ */
+void LocalApiServer::publishArchive(const HistoryArchive& archive)
+{
+    QMutexLocker lock(&publishMutex);
+    pending.hasArchive = true;
+    pending.archive = archive;
+    ++publishedVersion;
+}
+
+/**
+ * @brief Zwraca statystyki serwera.
+ * @return Statystyki.
+ */
+LocalApiServer::Stats LocalApiServer::stats() const
+{
+    Stats result;
+    result.requests = requests.load();
+    result.notModified = notModified.load();
+    result.compressed = compressed.load();
+    result.errors = errors.load();
+    result.cacheHits = cacheHits.load();
+    result.bytesSent = bytesSent.load();
+    QMutexLocker lock(&latencyMutex);
+    result.medianUs = latencies.percentile(0.5);
+    result.p99Us = latencies.percentile(0.99);
+    return result;
+}
+
+/**
+ * @brief Kompresuje dane do formatu gzip (RFC 1952).
+ *
+ * qCompress zwraca rozmiar danych i strumień zlib; surowy strumień deflate spomiędzy
+ * nagłówka i sumy Adler-32 zlib jest opakowywany nagłówkiem i stopką gzip, więc nie jest
+ * potrzebna osobna biblioteka kompresji.
+ * @param data Dane.
+ * @return Dane w formacie gzip.
+ */
+QByteArray LocalApiServer::gzip(const QByteArray& data)
+{
+    const QByteArray zlib = qCompress(data, 6);
+    if (zlib.size() < 10) return QByteArray();
+
+    static const char header[] = { '\x1f', '\x8b', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xff' };
+    QByteArray result;
+    result.reserve(zlib.size() + 8);
+    result.append(header, sizeof(header));
+    result.append(zlib.constData() + 6, zlib.size() - 10);
+    appendLittleEndian(result, crc32(data));
+    appendLittleEndian(result, static_cast<quint32>(data.size()));
+    return result;
+}
+
+/**
+ * @brief Obsługuje nowe połączenia (wątek serwera).
+ */
+void LocalApiServer::onNewConnection()
+{
+    while (QTcpSocket* socket = server->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, [this, socket]() {
+            buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+/**
+ * @brief Wydziela kompletne zapytania z danych połączenia i odpowiada na nie (wątek serwera).
+ *
+ * Obsługiwane są wyłącznie zapytania bez treści (GET); zapytanie z inną metodą dostaje 405
+ * i połączenie jest zamykane, bo jego treść nie jest odczytywana.
+ * @param socket Połączenie.
+ */
+void LocalApiServer::onReadyRead(QTcpSocket* socket)
+{
+    QByteArray& buffer = buffers[socket];
+    buffer.append(socket->readAll());
+
+    int end;
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+        QElapsedTimer timer;
+        timer.start();
+        const QList<QByteArray> lines = buffer.left(end).split('\n');
+        buffer.remove(0, end + 4);
+
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 3) {
+            socket->abort();
+            return;
+        }
+        QByteArray ifNoneMatch;
+        bool acceptsGzip = false;
+        bool close = requestLine[2] == "HTTP/1.0";
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines[i].indexOf(':');
+            if (colon < 0) continue;
+            const QByteArray name = lines[i].left(colon).trimmed().toLower();
+            const QByteArray value = lines[i].mid(colon + 1).trimmed();
+            if (name == "if-none-match") {
+                ifNoneMatch = value;
+            } else if (name == "accept-encoding") {
+                acceptsGzip = value.toLower().contains("gzip");
+            } else if (name == "connection") {
+                close = value.toLower() == "close";
+            }
+        }
+        requests++;
+
+        if (requestLine[0] != "GET") {
+            Response rejected;
+            rejected.status = 405;
+            rejected.body = errorBody("Obsługiwane są tylko zapytania GET");
+            respond(socket, rejected, false, false, true);
+            return;
+        }
+
+        const Response& response = responseFor(requestLine[1]);
+        const bool sendGzip = acceptsGzip && !response.gzipped.isEmpty();
+        const QByteArray& etag = sendGzip ? response.gzipEtag : response.etag;
+        bool matches = false;
+        if (response.status == 200 && !ifNoneMatch.isEmpty()) {
+            for (const QByteArray& tag : ifNoneMatch.split(',')) {
+                const QByteArray trimmed = tag.trimmed();
+                if (trimmed == "*" || trimmed == etag || trimmed == "W/" + etag) matches = true;
+            }
+        }
+        respond(socket, response, matches, sendGzip, close);
+        {
+            QMutexLocker lock(&latencyMutex);
+            latencies.add(timer.nsecsElapsed() / 1e3);
+        }
+        if (close) return;
+    }
+
+    if (buffer.size() > MAX_HEADER_BYTES) {
+        socket->abort();
+    }
+}
+
+/**
+ * @brief Przenosi opublikowane zmiany do danych wątku serwera i aktualizuje wersje części.
+ *
+ * Pod blokadą przejmowana jest tylko lista zmian; indeksowanie katalogu i porównanie serii
+ * odbywają się już w wątku serwera.
+ */
+void LocalApiServer::applyPending()
+{
+    if (publishedVersion.load() == appliedVersion) return;
+
+    Pending changes;
+    {
+        QMutexLocker lock(&publishMutex);
+        std::swap(changes, pending);
+        appliedVersion = publishedVersion.load();
+    }
+    const quint64 version = appliedVersion;
+
+    if (changes.hasStations) {
+        current.stations = changes.stations;
+        current.stationRows.clear();
+        current.stationRows.reserve(current.stations.size());
+        for (int i = 0; i < current.stations.size(); ++i) {
+            current.stationRows.insert(current.stations[i].id, i);
+        }
+        current.stationsVersion = version;
+    }
+    if (changes.hasArchive) {
+        current.archive = changes.archive;
+        current.archiveVersion = version;
+    }
+    for (auto it = changes.series.constBegin(); it != changes.series.constEnd(); ++it) {
+        const SeriesPointer previous = current.series.value(it.key());
+        const SeriesPointer& next = it.value();
+        if (!previous || previous->stationId != next->stationId || previous->series.key != next->series.key) {
+            current.seriesSetVersion = version;
+            if (previous) current.stationSeriesVersions.insert(previous->stationId, version);
+        }
+        current.series.insert(it.key(), next);
+        current.sensorVersions.insert(it.key(), version);
+        current.stationSeriesVersions.insert(next->stationId, version);
+        current.seriesVersion = version;
+    }
+    for (auto it = changes.airQuality.constBegin(); it != changes.airQuality.constEnd(); ++it) {
+        current.airQuality.insert(it.key(), it.value());
+        current.airQualityVersions.insert(it.key(), version);
+        current.airQualityVersion = version;
+    }
+}
+
+/**
+ * @brief Zwraca bieżące wersje części danych.
+ * @param dependencies Części danych.
+ * @return Wersje w kolejności pól Dependencies (0 dla części nieużywanych).
+ */
+LocalApiServer::Stamp LocalApiServer::stampOf(const Dependencies& dependencies) const
+{
+    return Stamp{
+        dependencies.stations ? current.stationsVersion : 0,
+        dependencies.archive ? current.archiveVersion : 0,
+        dependencies.seriesSet ? current.seriesSetVersion : 0,
+        dependencies.allSeries ? current.seriesVersion : 0,
+        dependencies.allAirQuality ? current.airQualityVersion : 0,
+        dependencies.sensorId >= 0 ? current.sensorVersions.value(dependencies.sensorId) : 0,
+        dependencies.stationSeries >= 0 ? current.stationSeriesVersions.value(dependencies.stationSeries) : 0,
+        dependencies.stationAirQuality >= 0 ? current.airQualityVersions.value(dependencies.stationAirQuality) : 0
+    };
+}
+
+/**
+ * @brief Zwraca odpowiedź na zapytanie (z pamięci gotowych odpowiedzi lub obliczoną).
+ *
+ * Gotowa odpowiedź jest aktualna, dopóki nie zmieni się żadna z części danych, z których
+ * powstała. Odpowiedź obliczona ponownie z tą samą treścią zachowuje ETag i skompresowaną
+ * treść, więc klienci z poprzednim znacznikiem nadal dostają 304.
+ * @param target Ścieżka z parametrami zapytania.
+ * @return Odpowiedź (ważna do następnego wywołania).
+ */
+const LocalApiServer::Response& LocalApiServer::responseFor(const QByteArray& target)
+{
+    applyPending();
+
+    auto it = responses.find(target);
+    if (it != responses.end() && stampOf(it->dependencies) == it->stamp) {
+        cacheHits++;
+        return *it;
+    }
+
+    const QUrl url(QString::fromUtf8(target));
+    Response response;
+    response.body = route(url.path(), QUrlQuery(url), &response.status, &response.dependencies);
+    response.stamp = stampOf(response.dependencies);
+    const QByteArray digest = QCryptographicHash::hash(response.body, QCryptographicHash::Md5).toHex();
+    response.etag = '"' + digest + '"';
+    if (response.status == 200 && response.body.size() >= GZIP_MIN_BYTES) {
+        response.gzipEtag = '"' + digest + "-gz\"";
+        response.gzipped = (it != responses.end() && it->etag == response.etag && !it->gzipped.isEmpty())
+                           ? it->gzipped : gzip(response.body);
+    }
+
+    if (it == responses.end() && responses.size() >= MAX_CACHED_RESPONSES) {
+        responses.clear();
+    }
+    Response& stored = responses[target];
+    stored = response;
+    return stored;
+}
+
+/**
+ * @brief Oblicza treść odpowiedzi dla ścieżki.
+ * @param path Ścieżka.
+ * @param query Parametry zapytania.
+ * @param status Wskaźnik na kod statusu HTTP (uzupełniany).
+ * @param dependencies Wskaźnik na części danych użyte do odpowiedzi (uzupełniany).
+ * @return Treść JSON.
+ */
+QByteArray LocalApiServer::route(const QString& path, const QUrlQuery& query, int* status,
+                                 Dependencies* dependencies) const
+{
+    const QString STATION_PREFIX = "/api/stations/";
+
+    if (path == "/api/status") {
+        dependencies->stations = true;
+        dependencies->archive = true;
+        dependencies->allSeries = true;
+        dependencies->allAirQuality = true;
+        QJsonObject result;
+        result["version"] = static_cast<qint64>(appliedVersion);
+        result["stations"] = current.stations.size();
+        result["cachedSeries"] = current.series.size();
+        result["archiveSeries"] = current.archive.seriesCount();
+        result["airQuality"] = current.airQuality.size();
+        return QJsonDocument(result).toJson(QJsonDocument::Compact);
+    }
+
+    if (path == "/api/stations") {
+        dependencies->stations = true;
+        QJsonArray stations;
+        for (const StationRecord& station : current.stations) stations.append(stationJson(station));
+        return QJsonDocument(stations).toJson(QJsonDocument::Compact);
+    }
+
+    if (path.startsWith(STATION_PREFIX)) {
+        bool ok = false;
+        const int stationId = path.mid(STATION_PREFIX.size()).toInt(&ok);
+        dependencies->stations = true;
+        dependencies->archive = true;
+        dependencies->seriesSet = true;
+        dependencies->stationAirQuality = stationId;
+        const int row = current.stationRows.value(stationId, -1);
+        if (!ok || row < 0) {
+            *status = 404;
+            return errorBody("Nieznana stacja");
+        }
+
+        QMap<QString, QJsonObject> parameters;
+        for (const HistoryArchive::Entry* entry : current.archive.entries(stationId, QString())) {
+            QJsonObject parameter;
+            parameter["sensorId"] = entry->sensorId;
+            parameter["paramCode"] = entry->series.key;
+            parameter["source"] = "archive";
+            parameters.insert(entry->series.key, parameter);
+        }
+        for (auto it = current.series.constBegin(); it != current.series.constEnd(); ++it) {
+            const CachedSeries& cached = *it.value();
+            if (cached.stationId != stationId || cached.series.key.isEmpty()) continue;
+            QJsonObject parameter;
+            parameter["sensorId"] = it.key();
+            parameter["paramCode"] = cached.series.key;
+            parameter["source"] = "cache";
+            parameters.insert(cached.series.key, parameter);
+        }
+        QJsonArray parameterArray;
+        for (const QJsonObject& parameter : parameters) parameterArray.append(parameter);
+
+        QJsonObject result = stationJson(current.stations[row]);
+        result["parameters"] = parameterArray;
+        if (current.airQuality.contains(stationId)) {
+            result["airQuality"] = current.airQuality.value(stationId);
+        } else {
+            const HistoryArchive::AirQualityEntry stored = current.archive.airQuality(stationId);
+            if (stored.stationId >= 0) {
+                QJsonObject airQuality;
+                airQuality["calcTimestamp"] = stored.calcTimestamp;
+                airQuality["indexLevel"] = stored.indexLevel;
+                airQuality["indexLevelName"] = stored.indexLevelName;
+                result["airQuality"] = airQuality;
+            }
+        }
+        return QJsonDocument(result).toJson(QJsonDocument::Compact);
+    }
+
+    if (path == "/api/latest") {
+        const int stationId = query.hasQueryItem("station") ? query.queryItemValue("station").toInt() : -1;
+        dependencies->archive = true;
+        if (stationId >= 0) {
+            dependencies->seriesSet = true;
+            dependencies->stationSeries = stationId;
+        } else {
+            dependencies->allSeries = true;
+        }
+        QMap<QPair<int, int>, QJsonObject> latest;
+        auto add = [&latest](int station, int sensorId, const MeasurementSeries& series, const char* source) {
+            qint64 timestamp = -1;
+            const double value = latestValue(series, &timestamp);
+            if (timestamp < 0) return;
+            QJsonObject item;
+            item["stationId"] = station;
+            item["sensorId"] = sensorId;
+            item["paramCode"] = series.key;
+            item["timestamp"] = timestamp;
+            item["value"] = value;
+            item["source"] = source;
+            latest.insert({ station, sensorId }, item);
+        };
+        for (const HistoryArchive::Entry* entry : current.archive.entries(stationId, QString())) {
+            if (!current.series.contains(entry->sensorId)) add(entry->stationId, entry->sensorId, entry->series, "archive");
+        }
+        for (auto it = current.series.constBegin(); it != current.series.constEnd(); ++it) {
+            const CachedSeries& cached = *it.value();
+            if (stationId < 0 || cached.stationId == stationId) add(cached.stationId, it.key(), cached.series, "cache");
+        }
+        QJsonArray items;
+        for (const QJsonObject& item : latest) items.append(item);
+        return QJsonDocument(items).toJson(QJsonDocument::Compact);
+    }
+
+    if (path == "/api/series" || path == "/api/aggregate") {
+        bool ok = true;
+        const qint64 from = timeParameter(query, "from", std::numeric_limits<qint64>::min(), &ok);
+        const qint64 to = timeParameter(query, "to", std::numeric_limits<qint64>::max(), &ok);
+        const QString step = query.hasQueryItem("step") ? query.queryItemValue("step") : QString("none");
+        const qint64 stepMs = step == "hour" ? HOUR_MS : step == "day" ? DAY_MS : 0;
+        if (!ok || from > to || (step != "none" && stepMs == 0)) {
+            *status = 400;
+            return errorBody("Niepoprawne parametry from, to lub step");
+        }
+        if (!query.hasQueryItem("sensor") && !(query.hasQueryItem("station") && query.hasQueryItem("param"))) {
+            *status = 400;
+            return errorBody("Wymagany parametr sensor albo station i param");
+        }
+
+        int sensorId = -1;
+        int stationId = -1;
+        const MeasurementSeries series = seriesFor(query, &sensorId, &stationId, dependencies);
+        if (sensorId < 0) {
+            *status = 404;
+            return errorBody("Brak danych czujnika");
+        }
+        const int first = std::lower_bound(series.timestamps.begin(), series.timestamps.end(), from)
+                          - series.timestamps.begin();
+        const int last = std::upper_bound(series.timestamps.begin(), series.timestamps.end(), to)
+                         - series.timestamps.begin();
+
+        QJsonObject result;
+        result["sensorId"] = sensorId;
+        result["stationId"] = stationId;
+        result["paramCode"] = series.key;
+        if (path == "/api/series") {
+            QJsonArray timestamps;
+            QJsonArray values;
+            for (int i = first; i < last; ++i) {
+                timestamps.append(series.timestamps[i]);
+                values.append(number(series.values[i]));
+            }
+            result["count"] = last - first;
+            result["timestamps"] = timestamps;
+            result["values"] = values;
+            return QJsonDocument(result).toJson(QJsonDocument::Compact);
+        }
+
+        struct Bucket {
+            qint64 start = 0;
+            int count = 0;
+            double sum = 0.0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+        };
+        auto bucketJson = [](const Bucket& bucket) {
+            QJsonObject item;
+            item["count"] = bucket.count;
+            item["mean"] = bucket.count > 0 ? QJsonValue(bucket.sum / bucket.count) : QJsonValue();
+            item["min"] = bucket.count > 0 ? QJsonValue(bucket.min) : QJsonValue();
+            item["max"] = bucket.count > 0 ? QJsonValue(bucket.max) : QJsonValue();
+            return item;
+        };
+        Bucket total;
+        Bucket bucket;
+        QJsonArray buckets;
+        for (int i = first; i < last; ++i) {
+            const double value = series.values[i];
+            if (std::isnan(value)) continue;
+            if (stepMs > 0) {
+                const qint64 start = series.timestamps[i] - ((series.timestamps[i] % stepMs) + stepMs) % stepMs;
+                if (bucket.count > 0 && start != bucket.start) {
+                    QJsonObject item = bucketJson(bucket);
+                    item["start"] = bucket.start;
+                    buckets.append(item);
+                    bucket = Bucket();
+                }
+                bucket.start = start;
+                bucket.count++;
+                bucket.sum += value;
+                bucket.min = std::min(bucket.min, value);
+                bucket.max = std::max(bucket.max, value);
+            }
+            total.count++;
+            total.sum += value;
+            total.min = std::min(total.min, value);
+            total.max = std::max(total.max, value);
+        }
+        if (bucket.count > 0) {
+            QJsonObject item = bucketJson(bucket);
+            item["start"] = bucket.start;
+            buckets.append(item);
+        }
+
+        const QJsonObject summary = bucketJson(total);
+        for (auto it = summary.constBegin(); it != summary.constEnd(); ++it) result.insert(it.key(), it.value());
+        result["step"] = step;
+        if (stepMs > 0) result["buckets"] = buckets;
+        return QJsonDocument(result).toJson(QJsonDocument::Compact);
+    }
+
+    *status = 404;
+    return errorBody("Nieznany punkt końcowy");
+}
+
+/**
+ * @brief Zwraca serię czujnika połączoną z pamięci podręcznej i archiwum.
+ *
+ * Czujnik wskazany przez stację i parametr jest szukany najpierw w pamięci podręcznej,
+ * a potem w archiwum. Wartości z pamięci podręcznej mają pierwszeństwo przed zapisanymi.
+ * @param query Parametry zapytania (sensor albo station i param).
+ * @param sensorId Wskaźnik na identyfikator znalezionego czujnika (uzupełniany, -1 przy braku).
+ * @param stationId Wskaźnik na identyfikator stacji czujnika (uzupełniany).
+ * @param dependencies Wskaźnik na części danych użyte do odpowiedzi (uzupełniany).
+ * @return Seria (pusta, jeśli czujnik nie ma danych).
+ */
+MeasurementSeries LocalApiServer::seriesFor(const QUrlQuery& query, int* sensorId, int* stationId,
+                                            Dependencies* dependencies) const
+{
+    *sensorId = -1;
+    *stationId = -1;
+    dependencies->archive = true;
+    QVector<const HistoryArchive::Entry*> stored;
+    if (query.hasQueryItem("sensor")) {
+        *sensorId = query.queryItemValue("sensor").toInt();
+        const SeriesPointer cached = current.series.value(*sensorId);
+        if (cached) *stationId = cached->stationId;
+        stored = current.archive.entries(*stationId, QString());
+    } else {
+        // Czujnik stacji i parametru może się zmienić po dodaniu serii innego czujnika.
+        dependencies->seriesSet = true;
+        *stationId = query.queryItemValue("station").toInt();
+        const QString paramCode = query.queryItemValue("param");
+        for (auto it = current.series.constBegin(); it != current.series.constEnd(); ++it) {
+            if (it.value()->stationId == *stationId && it.value()->series.key == paramCode) {
+                *sensorId = it.key();
+                break;
+            }
+        }
+        stored = current.archive.entries(*stationId, paramCode);
+        if (*sensorId < 0 && !stored.isEmpty()) *sensorId = stored.first()->sensorId;
+    }
+    dependencies->sensorId = *sensorId;
+
+    MeasurementSeries archived;
+    const SeriesPointer cached = current.series.value(*sensorId);
+    bool found = !cached.isNull();
+    for (const HistoryArchive::Entry* entry : stored) {
+        if (entry->sensorId != *sensorId) continue;
+        archived = entry->series;
+        *stationId = entry->stationId;
+        found = true;
+        break;
+    }
+    if (!found) {
+        *sensorId = -1;
+        return MeasurementSeries();
+    }
+    if (!cached) return archived;
+    if (archived.isEmpty()) return cached->series;
+    return MeasurementSeries::merged(archived, cached->series);
+}
+
+/**
+ * @brief Wysyła odpowiedź HTTP.
+ * @param socket Połączenie.
+ * @param response Odpowiedź.
+ * @param unchanged True, aby wysłać 304 bez treści.
+ * @param gzipped True, aby wysłać treść skompresowaną.
+ * @param close True, aby zamknąć połączenie po wysłaniu.
+ */
+void LocalApiServer::respond(QTcpSocket* socket, const Response& response, bool unchanged, bool gzipped, bool close)
+{
+    const int status = unchanged ? 304 : response.status;
+    const QByteArray body = unchanged ? QByteArray() : gzipped ? response.gzipped : response.body;
+
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+    if (response.status == 200) {
+        head += "ETag: " + (gzipped ? response.gzipEtag : response.etag)
+                + "\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n";
+    }
+    if (!unchanged) {
+        head += "Content-Type: application/json; charset=utf-8\r\n";
+        if (gzipped) head += "Content-Encoding: gzip\r\n";
+    }
+    head += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    head += close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+    socket->write(head + body);
+
+    bytesSent += body.size();
+    if (unchanged) notModified++;
+    if (gzipped && !unchanged) compressed++;
+    if (response.status >= 400) errors++;
+    if (close) socket->disconnectFromHost();
+}
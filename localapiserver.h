@@ -0,0 +1,369 @@
+#ifndef LOCALAPISERVER_H
+#define LOCALAPISERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QUrlQuery>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include "measurementseries.h"
+#include "historyarchive.h"
+#include "stationlistmodel.h"
+#include "latencytracker.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @brief Lokalny serwer HTTP/JSON udostępniający dane już pobrane i zapisane przez aplikację.
+ *
+ * Serwer działa we własnym wątku, więc obsługa zapytań nie zajmuje wątku interfejsu. Wątek
+ * interfejsu jedynie publikuje zmiany danych (katalog stacji, serie z pamięci podręcznej,
+ * indeksy jakości powietrza, archiwum lokalnej bazy danych) - publikacja dopisuje współdzielony
+ * wskaźnik do listy zmian pod krótką blokadą, a wątek serwera przenosi zmiany do własnej kopii
+ * danych, więc koszt publikacji nie zależy od liczby czujników.
+ *
+ * Punkty końcowe (tylko GET, wszystkie czasy w ms od epoki):
+ * - /api/status - liczności opublikowanych danych,
+ * - /api/stations - katalog stacji,
+ * - /api/stations/{id} - stacja, jej parametry z danymi i ostatni indeks jakości powietrza,
+ * - /api/latest[?station=id] - ostatnie ważne wartości czujników,
+ * - /api/series?sensor=id|station=id&param=kod[&from=&to=] - seria z zakresu czasu,
+ * - /api/aggregate?sensor=id|station=id&param=kod[&from=&to=&step=none|hour|day] - statystyki.
+ *
+ * Odpowiedzi mają znacznik ETag (zapytanie z pasującym If-None-Match dostaje 304) i są
+ * kompresowane gzip, jeśli klient to akceptuje; treść skompresowana ma osobny znacznik.
+ * Każda gotowa odpowiedź pamięta wersje części danych, z których powstała (katalog, archiwum,
+ * seria czujnika, serie stacji, indeks stacji), i jest obliczana ponownie dopiero po zmianie
+ * jednej z nich - publikacja serii jednego czujnika nie unieważnia np. katalogu stacji.
+ */
+class LocalApiServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Statystyki serwera.
+     */
+    struct Stats {
+        /// @brief Liczba obsłużonych zapytań.
+        qint64 requests = 0;
+        /// @brief Liczba odpowiedzi 304 (dane klienta aktualne).
+        qint64 notModified = 0;
+        /// @brief Liczba odpowiedzi skompresowanych gzip.
+        qint64 compressed = 0;
+        /// @brief Liczba odpowiedzi z błędem (4xx).
+        qint64 errors = 0;
+        /// @brief Liczba odpowiedzi wziętych z pamięci gotowych odpowiedzi.
+        qint64 cacheHits = 0;
+        /// @brief Łączny rozmiar wysłanych treści (bajty).
+        qint64 bytesSent = 0;
+        /// @brief Mediana czasu obsługi zapytania w wątku serwera (us).
+        double medianUs = 0.0;
+        /// @brief 99. percentyl czasu obsługi zapytania w wątku serwera (us).
+        double p99Us = 0.0;
+    };
+
+    /// @brief Minimalny rozmiar treści, od którego odpowiedź jest kompresowana (bajty).
+    static constexpr int GZIP_MIN_BYTES = 512;
+    /// @brief Maksymalna liczba przechowywanych gotowych odpowiedzi.
+    static constexpr int MAX_CACHED_RESPONSES = 2048;
+
+    /**
+     * @brief Konstruktor serwera.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit LocalApiServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor - zatrzymuje wątek serwera.
+     */
+    ~LocalApiServer();
+
+    /**
+     * @brief Uruchamia nasłuchiwanie na interfejsie lokalnym w osobnym wątku.
+     * @param port Numer portu (0 wybiera wolny port).
+     * @return True, jeśli serwer nasłuchuje.
+     */
+    bool listen(quint16 port = 0);
+
+    /**
+     * @brief Zatrzymuje serwer i zamyka połączenia.
+     */
+    void stop();
+
+    /**
+     * @brief Sprawdza, czy serwer nasłuchuje.
+     * @return True, jeśli serwer działa.
+     */
+    bool isListening() const;
+
+    /**
+     * @brief Zwraca port serwera.
+     * @return Numer portu lub 0, jeśli serwer nie nasłuchuje.
+     */
+    quint16 port() const;
+
+    /**
+     * @brief Zwraca adres bazowy serwera.
+     * @return Adres w postaci http://127.0.0.1:port lub pusty napis.
+     */
+    QString baseUrl() const;
+
+    /**
+     * @brief Publikuje katalog stacji.
+     * @param stations Rekordy stacji.
+     */
+    void publishStations(const QVector<StationRecord>& stations);
+
+    /**
+     * @brief Publikuje serię czujnika z pamięci podręcznej.
+     * @param stationId Identyfikator stacji czujnika (-1, jeśli nieznana).
+     * @param sensorId Identyfikator czujnika.
+     * @param series Seria posortowana rosnąco po czasie (klucz serii to kod parametru).
+     */
+    void publishSeries(int stationId, int sensorId, const MeasurementSeries& series);
+
+    /**
+     * @brief Publikuje indeks jakości powietrza stacji.
+     * @param stationId Identyfikator stacji.
+     * @param index Obiekt JSON indeksu w formacie API GIOŚ.
+     */
+    void publishAirQuality(int stationId, const QJsonObject& index);
+
+    /**
+     * @brief Publikuje archiwum lokalnej bazy danych.
+     * @param archive Wczytane archiwum.
+     */
+    void publishArchive(const HistoryArchive& archive);
+
+    /**
+     * @brief Zwraca statystyki serwera.
+     * @return Statystyki.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Kompresuje dane do formatu gzip (RFC 1952).
+     * @param data Dane.
+     * @return Dane w formacie gzip.
+     */
+    static QByteArray gzip(const QByteArray& data);
+
+private:
+    /**
+     * @brief Seria czujnika z pamięci podręcznej.
+     */
+    struct CachedSeries {
+        /// @brief Identyfikator stacji.
+        int stationId = -1;
+        /// @brief Seria pomiarowa.
+        MeasurementSeries series;
+    };
+
+    /// @brief Niezmienna seria współdzielona przez wątek publikujący i wątek serwera.
+    using SeriesPointer = QSharedPointer<const CachedSeries>;
+
+    /**
+     * @brief Zmiany opublikowane od ostatniego przejęcia przez wątek serwera.
+     */
+    struct Pending {
+        /// @brief Czy opublikowano katalog stacji.
+        bool hasStations = false;
+        /// @brief Katalog stacji.
+        QVector<StationRecord> stations;
+        /// @brief Czy opublikowano archiwum.
+        bool hasArchive = false;
+        /// @brief Archiwum lokalnej bazy danych.
+        HistoryArchive archive;
+        /// @brief Zmienione serie według ID czujnika.
+        QHash<int, SeriesPointer> series;
+        /// @brief Zmienione indeksy jakości powietrza według ID stacji.
+        QHash<int, QJsonObject> airQuality;
+    };
+
+    /**
+     * @brief Dane wątku serwera z wersjami ich części.
+     *
+     * Wersja części to numer publikacji, w której się ostatnio zmieniła (0 - nigdy).
+     */
+    struct Snapshot {
+        /// @brief Katalog stacji.
+        QVector<StationRecord> stations;
+        /// @brief Mapa ID stacji na indeks w stations.
+        QHash<int, int> stationRows;
+        /// @brief Serie z pamięci podręcznej według ID czujnika.
+        QHash<int, SeriesPointer> series;
+        /// @brief Indeksy jakości powietrza według ID stacji.
+        QHash<int, QJsonObject> airQuality;
+        /// @brief Archiwum lokalnej bazy danych.
+        HistoryArchive archive;
+        /// @brief Wersja katalogu stacji.
+        quint64 stationsVersion = 0;
+        /// @brief Wersja archiwum.
+        quint64 archiveVersion = 0;
+        /// @brief Wersja zbioru serii (nowy czujnik, zmiana stacji lub parametru czujnika).
+        quint64 seriesSetVersion = 0;
+        /// @brief Wersja dowolnej serii.
+        quint64 seriesVersion = 0;
+        /// @brief Wersja dowolnego indeksu jakości powietrza.
+        quint64 airQualityVersion = 0;
+        /// @brief Wersje serii według ID czujnika.
+        QHash<int, quint64> sensorVersions;
+        /// @brief Wersje serii czujników stacji według ID stacji.
+        QHash<int, quint64> stationSeriesVersions;
+        /// @brief Wersje indeksów jakości powietrza według ID stacji.
+        QHash<int, quint64> airQualityVersions;
+    };
+
+    /**
+     * @brief Części danych, od których zależy odpowiedź (uzupełniane przez route()).
+     */
+    struct Dependencies {
+        /// @brief Katalog stacji.
+        bool stations = false;
+        /// @brief Archiwum.
+        bool archive = false;
+        /// @brief Zbiór serii (czujniki, ich stacje i parametry).
+        bool seriesSet = false;
+        /// @brief Wszystkie serie.
+        bool allSeries = false;
+        /// @brief Wszystkie indeksy jakości powietrza.
+        bool allAirQuality = false;
+        /// @brief Seria czujnika (-1, jeśli żadna).
+        int sensorId = -1;
+        /// @brief Serie czujników stacji (-1, jeśli żadna).
+        int stationSeries = -1;
+        /// @brief Indeks jakości powietrza stacji (-1, jeśli żaden).
+        int stationAirQuality = -1;
+    };
+
+    /// @brief Wersje części danych, od których zależy odpowiedź (w kolejności pól Dependencies).
+    using Stamp = std::array<quint64, 8>;
+
+    /**
+     * @brief Gotowa odpowiedź na zapytanie.
+     */
+    struct Response {
+        /// @brief Części danych, z których powstała odpowiedź.
+        Dependencies dependencies;
+        /// @brief Wersje tych części w chwili obliczenia.
+        Stamp stamp{};
+        /// @brief Kod statusu HTTP.
+        int status = 200;
+        /// @brief Treść JSON.
+        QByteArray body;
+        /// @brief Treść skompresowana gzip (pusta dla małych odpowiedzi).
+        QByteArray gzipped;
+        /// @brief Znacznik ETag treści nieskompresowanej (w cudzysłowie).
+        QByteArray etag;
+        /// @brief Znacznik ETag treści skompresowanej (z przyrostkiem -gz).
+        QByteArray gzipEtag;
+    };
+
+    /// @brief Blokada listy opublikowanych zmian.
+    mutable QMutex publishMutex;
+    /// @brief Zmiany opublikowane od ostatniego przejęcia (zapis w wątku publikującym).
+    Pending pending;
+    /// @brief Numer ostatniej publikacji.
+    std::atomic<quint64> publishedVersion{0};
+
+    /// @brief Wątek serwera.
+    QThread* serverThread = nullptr;
+    /// @brief Gniazdo nasłuchujące (żyje w wątku serverThread).
+    QTcpServer* server = nullptr;
+    /// @brief Port gniazda nasłuchującego.
+    quint16 boundPort = 0;
+    /// @brief Dane używane przez wątek serwera.
+    Snapshot current;
+    /// @brief Numer ostatniej publikacji przeniesionej do current.
+    quint64 appliedVersion = 0;
+    /// @brief Gotowe odpowiedzi według ścieżki z parametrami (wątek serwera).
+    QHash<QByteArray, Response> responses;
+    /// @brief Nieprzetworzone dane odebrane z połączeń (wątek serwera).
+    QHash<QTcpSocket*, QByteArray> buffers;
+
+    /// @brief Liczba obsłużonych zapytań.
+    std::atomic<qint64> requests{0};
+    /// @brief Liczba odpowiedzi 304.
+    std::atomic<qint64> notModified{0};
+    /// @brief Liczba odpowiedzi skompresowanych.
+    std::atomic<qint64> compressed{0};
+    /// @brief Liczba odpowiedzi z błędem.
+    std::atomic<qint64> errors{0};
+    /// @brief Liczba odpowiedzi z pamięci gotowych odpowiedzi.
+    std::atomic<qint64> cacheHits{0};
+    /// @brief Łączny rozmiar wysłanych treści.
+    std::atomic<qint64> bytesSent{0};
+    /// @brief Blokada okna czasów obsługi.
+    mutable QMutex latencyMutex;
+    /// @brief Czasy obsługi zapytań (us).
+    LatencyTracker latencies{4096};
+
+    /**
+     * @brief Obsługuje nowe połączenia (wątek serwera).
+     */
+    void onNewConnection();
+
+    /**
+     * @brief Wydziela kompletne zapytania z danych połączenia i odpowiada na nie (wątek serwera).
+     * @param socket Połączenie.
+     */
+    void onReadyRead(QTcpSocket* socket);
+
+    /**
+     * @brief Przenosi opublikowane zmiany do danych wątku serwera i aktualizuje wersje części.
+     */
+    void applyPending();
+
+    /**
+     * @brief Zwraca bieżące wersje części danych.
+     * @param dependencies Części danych.
+     * @return Wersje w kolejności pól Dependencies (0 dla części nieużywanych).
+     */
+    Stamp stampOf(const Dependencies& dependencies) const;
+
+    /**
+     * @brief Zwraca odpowiedź na zapytanie (z pamięci gotowych odpowiedzi lub obliczoną).
+     * @param target Ścieżka z parametrami zapytania.
+     * @return Odpowiedź.
+     */
+    const Response& responseFor(const QByteArray& target);
+
+    /**
+     * @brief Oblicza treść odpowiedzi dla ścieżki.
+     * @param path Ścieżka.
+     * @param query Parametry zapytania.
+     * @param status Wskaźnik na kod statusu HTTP (uzupełniany).
+     * @param dependencies Wskaźnik na części danych użyte do odpowiedzi (uzupełniany).
+     * @return Treść JSON.
+     */
+    QByteArray route(const QString& path, const QUrlQuery& query, int* status, Dependencies* dependencies) const;
+
+    /**
+     * @brief Zwraca serię czujnika połączoną z pamięci podręcznej i archiwum.
+     * @param query Parametry zapytania (sensor albo station i param).
+     * @param sensorId Wskaźnik na identyfikator znalezionego czujnika (uzupełniany).
+     * @param stationId Wskaźnik na identyfikator stacji czujnika (uzupełniany).
+     * @param dependencies Wskaźnik na części danych użyte do odpowiedzi (uzupełniany).
+     * @return Seria (pusta, jeśli czujnik nie ma danych).
+     */
+    MeasurementSeries seriesFor(const QUrlQuery& query, int* sensorId, int* stationId, Dependencies* dependencies) const;
+
+    /**
+     * @brief Wysyła odpowiedź HTTP.
+     * @param socket Połączenie.
+     * @param response Odpowiedź.
+     * @param unchanged True, aby wysłać 304 bez treści.
+     * @param gzipped True, aby wysłać treść skompresowaną.
+     * @param close True, aby zamknąć połączenie po wysłaniu.
+     */
+    void respond(QTcpSocket* socket, const Response& response, bool unchanged, bool gzipped, bool close);
+};
+
+#endif // LOCALAPISERVER_H
@@ -0,0 +1,312 @@
+#include "localingestor.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <algorithm>
+
+/**
+ * @brief Konstruktor.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+LocalIngestor::LocalIngestor(QObject *parent)
+    : QObject(parent), queue(QUEUE_CAPACITY)
+{
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    frameTimer.setInterval(FRAME_INTERVAL_MS);
+    connect(&frameTimer, &QTimer::timeout, this, &LocalIngestor::drain);
+}
+
+/**
+ * @brief Destruktor; zatrzymuje wątki odbioru.
+ */
+LocalIngestor::~LocalIngestor()
+{
+    stop();
+}
+
+/**
+ * @brief Uruchamia odbiór datagramów UDP w osobnym wątku.
+ *
+ * Gniazdo jest tworzone i wiązane w wątku odbioru, a jego bufor systemowy powiększany,
+ * aby krótkie opóźnienia wątku nie powodowały utraty datagramów w jądrze.
+ * @param port Numer portu UDP.
+ * @return True, jeśli gniazdo zostało związane z portem.
+ */
+bool LocalIngestor::listenUdp(quint16 port)
+{
+    if (udpThread) return false;
+
+    stopping = false;
+    udpThread = new QThread(this);
+    socket = new QUdpSocket;
+    socket->moveToThread(udpThread);
+    connect(udpThread, &QThread::finished, socket, &QObject::deleteLater);
+    udpThread->start();
+
+    bool bound = false;
+    QMetaObject::invokeMethod(socket, [this, port, &bound]() {
+        bound = socket->bind(QHostAddress::Any, port);
+        if (!bound) return;
+        boundPort = socket->localPort();
+        socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 8 * 1024 * 1024);
+        connect(socket, &QUdpSocket::readyRead, socket, [this]() { readDatagrams(); });
+    }, Qt::BlockingQueuedConnection);
+
+    if (!bound) {
+        qDebug() << "Failed to bind UDP port" << port;
+        udpThread->quit();
+        udpThread->wait();
+        delete udpThread;
+        udpThread = nullptr;
+        socket = nullptr;
+        return false;
+    }
+    frameTimer.start();
+    return true;
+}
+
+/**
+ * @brief Zwraca port, na którym odbierane są datagramy.
+ * @return Numer portu lub 0.
+ */
+quint16 LocalIngestor::udpPort() const
+{
+    return udpThread ? boundPort : 0;
+}
+
+/**
+ * @brief Odtwarza zapisany plik odczytów w osobnym wątku.
+ * @param path Ścieżka do pliku (jedna linia na odczyt).
+ * @param speed Przyspieszenie odtwarzania.
+ * @return True, jeśli plik został otwarty.
+ */
+bool LocalIngestor::replayFile(const QString& path, double speed)
+{
+    if (replayThread && replayThread->isRunning()) return false;
+    if (!QFile::exists(path)) {
+        qDebug() << "Replay file does not exist:" << path;
+        return false;
+    }
+
+    if (replayThread) {
+        delete replayThread;
+        replayThread = nullptr;
+    }
+    stopping = false;
+    replayThread = QThread::create([this, path, speed]() { replay(path, speed); });
+    replayThread->start();
+    frameTimer.start();
+    return true;
+}
+
+/**
+ * @brief Zatrzymuje wszystkie źródła i opróżnia kolejkę.
+ */
+void LocalIngestor::stop()
+{
+    stopping = true;
+    if (udpThread) {
+        udpThread->quit();
+        udpThread->wait();
+        delete udpThread;
+        udpThread = nullptr;
+        socket = nullptr;
+    }
+    if (replayThread) {
+        replayThread->wait();
+        delete replayThread;
+        replayThread = nullptr;
+    }
+    drain();
+    frameTimer.stop();
+}
+
+/**
+ * @brief Zwraca statystyki odbioru.
+ * @return Statystyki.
+ */
+LocalIngestor::Stats LocalIngestor::stats() const
+{
+    Stats result = consumer;
+    result.received = received.load();
+    result.parseErrors = parseErrors.load();
+    result.dropped = dropped.load();
+    return result;
+}
+
+/**
+ * @brief Zwraca bieżące zapełnienie kolejki.
+ * @return Przybliżona liczba odczytów w kolejce.
+ */
+int LocalIngestor::queueDepth() const
+{
+    return queue.sizeApprox();
+}
+
+/**
+ * @brief Parsuje linię w formacie "urządzenie;parametr;czas_ms;wartość".
+ * @param line Linia tekstu.
+ * @param reading Odczyt uzupełniany po poprawnym sparsowaniu.
+ * @return True, jeśli linia jest poprawna.
+ */
+bool LocalIngestor::parseLine(const QByteArray& line, LocalReading* reading)
+{
+    const QList<QByteArray> fields = line.trimmed().split(';');
+    if (fields.size() != 4) return false;
+
+    bool deviceOk = false;
+    bool valueOk = false;
+    LocalReading result;
+    result.deviceId = fields[0].toInt(&deviceOk);
+    result.value = fields[3].toDouble(&valueOk);
+    if (!deviceOk || !valueOk || result.deviceId < 0) return false;
+
+    const QByteArray code = fields[1].trimmed().toUpper();
+    if (code == "PM10") {
+        result.parameter = Pm10;
+    } else if (code == "PM2.5" || code == "PM25") {
+        result.parameter = Pm25;
+    } else {
+        return false;
+    }
+
+    result.timestamp = fields[2].trimmed().toLongLong();
+    if (result.timestamp <= 0) result.timestamp = QDateTime::currentMSecsSinceEpoch();
+    if (reading) *reading = result;
+    return true;
+}
+
+/**
+ * @brief Zwraca kod parametru.
+ * @param parameter Parametr (LocalIngestor::Parameter).
+ * @return Kod parametru (np. PM10).
+ */
+QString LocalIngestor::parameterCode(int parameter)
+{
+    return parameter == Pm25 ? QString("PM2.5") : QString("PM10");
+}
+
+/**
+ * @brief Odczytuje oczekujące datagramy (wątek udpThread).
+ */
+void LocalIngestor::readDatagrams()
+{
+    while (socket->hasPendingDatagrams()) {
+        const qint64 size = socket->pendingDatagramSize();
+        datagram.resize(static_cast<int>(std::max<qint64>(size, 0)));
+        const qint64 read = socket->readDatagram(datagram.data(), datagram.size());
+        if (read > 0) {
+            datagram.resize(static_cast<int>(read));
+            ingest(datagram);
+        }
+    }
+}
+
+/**
+ * @brief Parsuje linie datagramu i wstawia odczyty do kolejki.
+ * @param data Jedna lub więcej linii.
+ */
+void LocalIngestor::ingest(const QByteArray& data)
+{
+    int start = 0;
+    while (start < data.size()) {
+        int end = data.indexOf('\n', start);
+        if (end < 0) end = data.size();
+        const QByteArray line = data.mid(start, end - start);
+        start = end + 1;
+        if (line.trimmed().isEmpty()) continue;
+
+        LocalReading reading;
+        if (parseLine(line, &reading)) {
+            push(reading, false);
+        } else {
+            parseErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Wstawia odczyt do kolejki.
+ * @param reading Odczyt.
+ * @param wait True, aby czekać na miejsce w kolejce zamiast odrzucać odczyt.
+ * @return True, jeśli odczyt trafił do kolejki.
+ */
+bool LocalIngestor::push(const LocalReading& reading, bool wait)
+{
+    while (!queue.tryPush(reading)) {
+        if (!wait || stopping.load(std::memory_order_relaxed)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        QThread::usleep(200);
+    }
+    received.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Pętla odtwarzania pliku (wątek replayThread).
+ * @param path Ścieżka do pliku.
+ * @param speed Przyspieszenie odtwarzania (<= 0 bez przerw).
+ */
+void LocalIngestor::replay(const QString& path, double speed)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Failed to open replay file:" << path;
+        return;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 firstTimestamp = -1;
+    while (!file.atEnd() && !stopping.load(std::memory_order_relaxed)) {
+        const QByteArray line = file.readLine();
+        if (line.trimmed().isEmpty() || line.startsWith('#')) continue;
+
+        LocalReading reading;
+        if (!parseLine(line, &reading)) {
+            parseErrors.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        if (speed > 0.0) {
+            if (firstTimestamp < 0) firstTimestamp = reading.timestamp;
+            const qint64 due = static_cast<qint64>((reading.timestamp - firstTimestamp) / speed);
+            const qint64 ahead = due - clock.elapsed();
+            if (ahead > 1) QThread::msleep(static_cast<unsigned long>(ahead));
+        }
+        push(reading, true);
+    }
+}
+
+/**
+ * @brief Opróżnia kolejkę i emituje paczkę odczytów (wątek interfejsu).
+ *
+ * Pobieranych jest najwyżej tyle odczytów, ile było w kolejce na początku klatki, aby
+ * ciągły napływ nie wydłużał obsługi klatki; czas obejmuje obsługę paczki przez odbiorców.
+ */
+void LocalIngestor::drain()
+{
+    const int depth = queue.sizeApprox();
+    if (depth == 0) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    consumer.maxQueueDepth = std::max(consumer.maxQueueDepth, depth);
+
+    QVector<LocalReading> readings;
+    readings.reserve(depth);
+    LocalReading reading;
+    for (int i = 0; i < depth && queue.tryPop(reading); ++i) {
+        readings.append(reading);
+    }
+    if (readings.isEmpty()) return;
+
+    consumer.delivered += readings.size();
+    consumer.frames++;
+    emit readingsReady(readings);
+    consumer.maxFrameMs = std::max(consumer.maxFrameMs, timer.nsecsElapsed() / 1e6);
+}
@@ -0,0 +1,211 @@
+#ifndef LOCALINGESTOR_H
+#define LOCALINGESTOR_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QVector>
+#include <atomic>
+#include "ringbuffer.h"
+
+/**
+ * @brief Pojedynczy odczyt z własnego czujnika pyłu.
+ */
+struct LocalReading
+{
+    /// @brief Znacznik czasu w milisekundach od epoki.
+    qint64 timestamp = 0;
+    /// @brief Identyfikator urządzenia.
+    qint32 deviceId = 0;
+    /// @brief Parametr (LocalIngestor::Parameter).
+    qint32 parameter = 0;
+    /// @brief Zmierzona wartość (µg/m³).
+    double value = 0.0;
+};
+
+/**
+ * @brief Odbiór odczytów z własnych czujników (UDP lub odtwarzany plik) z wysoką częstotliwością.
+ *
+ * Wątki odbioru (gniazdo UDP, odtwarzanie pliku) parsują linie "urządzenie;parametr;czas_ms;wartość"
+ * i wstawiają odczyty do kolejki bez blokad. Wątek interfejsu opróżnia kolejkę raz na klatkę
+ * (FRAME_INTERVAL_MS) i emituje jedną paczkę odczytów, więc liczba aktualizacji interfejsu
+ * nie zależy od liczby urządzeń ani częstotliwości odczytów.
+ */
+class LocalIngestor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Parametry mierzone przez własne czujniki.
+     */
+    enum Parameter {
+        Pm10 = 0,      ///< Pył zawieszony PM10.
+        Pm25 = 1,      ///< Pył zawieszony PM2.5.
+        ParameterCount ///< Liczba parametrów.
+    };
+
+    /**
+     * @brief Statystyki odbioru.
+     */
+    struct Stats {
+        /// @brief Liczba odebranych (poprawnie sparsowanych) odczytów.
+        qint64 received = 0;
+        /// @brief Liczba odrzuconych linii (błędny format).
+        qint64 parseErrors = 0;
+        /// @brief Liczba odczytów utraconych z powodu pełnej kolejki (tylko UDP).
+        qint64 dropped = 0;
+        /// @brief Liczba odczytów przekazanych do interfejsu.
+        qint64 delivered = 0;
+        /// @brief Liczba klatek, w których przekazano odczyty.
+        qint64 frames = 0;
+        /// @brief Największe zaobserwowane zapełnienie kolejki.
+        int maxQueueDepth = 0;
+        /// @brief Najdłuższy czas obsługi jednej klatki w wątku interfejsu (ms).
+        double maxFrameMs = 0.0;
+    };
+
+    /// @brief Pojemność kolejki odczytów.
+    static constexpr int QUEUE_CAPACITY = 65536;
+    /// @brief Odstęp opróżniania kolejki (częstotliwość odświeżania ekranu, ms).
+    static constexpr int FRAME_INTERVAL_MS = 16;
+
+    /**
+     * @brief Konstruktor.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit LocalIngestor(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor; zatrzymuje wątki odbioru.
+     */
+    ~LocalIngestor() override;
+
+    /**
+     * @brief Uruchamia odbiór datagramów UDP w osobnym wątku.
+     * @param port Numer portu UDP.
+     * @return True, jeśli gniazdo zostało związane z portem.
+     */
+    bool listenUdp(quint16 port);
+
+    /**
+     * @brief Zwraca port, na którym odbierane są datagramy.
+     * @return Numer portu (przydzielony przez system, gdy listenUdp() wywołano z 0) lub 0.
+     */
+    quint16 udpPort() const;
+
+    /**
+     * @brief Odtwarza zapisany plik odczytów w osobnym wątku.
+     *
+     * Odstępy między odczytami odtwarzane są według ich znaczników czasu podzielonych przez
+     * speed; speed <= 0 odtwarza plik bez przerw. Przy pełnej kolejce wątek czeka, więc żaden
+     * odczyt z pliku nie jest tracony.
+     * @param path Ścieżka do pliku (jedna linia na odczyt).
+     * @param speed Przyspieszenie odtwarzania.
+     * @return True, jeśli plik został otwarty.
+     */
+    bool replayFile(const QString& path, double speed);
+
+    /**
+     * @brief Zatrzymuje wszystkie źródła i opróżnia kolejkę.
+     */
+    void stop();
+
+    /**
+     * @brief Zwraca statystyki odbioru.
+     * @return Statystyki.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Zwraca bieżące zapełnienie kolejki.
+     * @return Przybliżona liczba odczytów w kolejce.
+     */
+    int queueDepth() const;
+
+    /**
+     * @brief Parsuje linię w formacie "urządzenie;parametr;czas_ms;wartość".
+     *
+     * Parametr to PM10 lub PM2.5; pusty lub zerowy czas oznacza chwilę odbioru.
+     * @param line Linia tekstu.
+     * @param reading Odczyt uzupełniany po poprawnym sparsowaniu.
+     * @return True, jeśli linia jest poprawna.
+     */
+    static bool parseLine(const QByteArray& line, LocalReading* reading);
+
+    /**
+     * @brief Zwraca kod parametru.
+     * @param parameter Parametr (LocalIngestor::Parameter).
+     * @return Kod parametru (np. PM10).
+     */
+    static QString parameterCode(int parameter);
+
+signals:
+    /**
+     * @brief Emitowany raz na klatkę z odczytami zebranymi od poprzedniej klatki.
+     * @param readings Odczyty w kolejności odbioru.
+     */
+    void readingsReady(const QVector<LocalReading>& readings);
+
+private:
+    /// @brief Kolejka odczytów (wielu producentów, konsument w wątku interfejsu).
+    RingBuffer<LocalReading> queue;
+    /// @brief Wątek odbioru UDP.
+    QThread* udpThread = nullptr;
+    /// @brief Gniazdo UDP (żyje w wątku udpThread).
+    QUdpSocket* socket = nullptr;
+    /// @brief Port związanego gniazda UDP.
+    quint16 boundPort = 0;
+    /// @brief Bufor datagramu (używany tylko w wątku udpThread).
+    QByteArray datagram;
+    /// @brief Wątek odtwarzania pliku.
+    QThread* replayThread = nullptr;
+    /// @brief Żądanie zatrzymania wątków odbioru.
+    std::atomic<bool> stopping{false};
+    /// @brief Liczba odebranych odczytów.
+    std::atomic<qint64> received{0};
+    /// @brief Liczba odrzuconych linii.
+    std::atomic<qint64> parseErrors{0};
+    /// @brief Liczba odczytów utraconych przy pełnej kolejce.
+    std::atomic<qint64> dropped{0};
+    /// @brief Statystyki po stronie konsumenta.
+    Stats consumer;
+    /// @brief Zegar klatek opróżniający kolejkę.
+    QTimer frameTimer;
+
+    /**
+     * @brief Odczytuje oczekujące datagramy (wątek udpThread).
+     */
+    void readDatagrams();
+
+    /**
+     * @brief Parsuje linie datagramu i wstawia odczyty do kolejki.
+     * @param data Jedna lub więcej linii.
+     */
+    void ingest(const QByteArray& data);
+
+    /**
+     * @brief Wstawia odczyt do kolejki.
+     * @param reading Odczyt.
+     * @param wait True, aby czekać na miejsce w kolejce zamiast odrzucać odczyt.
+     * @return True, jeśli odczyt trafił do kolejki.
+     */
+    bool push(const LocalReading& reading, bool wait);
+
+    /**
+     * @brief Pętla odtwarzania pliku (wątek replayThread).
+     * @param path Ścieżka do pliku.
+     * @param speed Przyspieszenie odtwarzania (<= 0 bez przerw).
+     */
+    void replay(const QString& path, double speed);
+
+    /**
+     * @brief Opróżnia kolejkę i emituje paczkę odczytów (wątek interfejsu).
+     */
+    void drain();
+};
+
+#endif // LOCALINGESTOR_H
@@ -1,7 +1,18 @@
 #include <QApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QQmlEngine>
+#include <QCommandLineParser>
 #include "mainwindow.h"
+#include "benchmark.h"
+#include "stationmapitem.h"
+#include "faultinjectingserver.h"
+#include "syntheticdata.h"
+#include "startuptrace.h"
+#include <QQuickWindow>
+#include <QTimer>
+#include <QTextStream>
+#include <QDebug>
 
 /**
  * @brief Główna funkcja aplikacji.
@@ -13,18 +24,168 @@
  */
 int main(int argc, char *argv[])
 {
+    /// Początek pomiaru czasu uruchamiania.
+    StartupTrace::start();
+
     /// Inicjalizacja aplikacji Qt z obsługą argumentów wiersza poleceń.
     QApplication app(argc, argv);
 
+    /// Opcje wiersza poleceń (tryby pomiaru wydajności uruchamiane bez interfejsu).
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption benchmarkSearchOption("benchmark-search",
+                                             "Mierzy opóźnienie wyszukiwania stacji dla katalogu o podanej liczbie stacji.",
+                                             "liczba");
+    parser.addOption(benchmarkSearchOption);
+    QCommandLineOption benchmarkMapOption("benchmark-map",
+                                          "Mierzy czas przygotowania klatki mapy stacji podczas przesuwania i przybliżania.",
+                                          "liczba");
+    parser.addOption(benchmarkMapOption);
+    QCommandLineOption benchmarkNetworkOption("benchmark-network",
+                                              "Porównuje opóźnienia zapytań z zabezpieczeniami i bez nich wobec lokalnego serwera z awariami.",
+                                              "liczba");
+    parser.addOption(benchmarkNetworkOption);
+    QCommandLineOption benchmarkCatalogOption("benchmark-catalog",
+                                              "Porównuje pamięć dawnego i zwartego katalogu stacji (liczba stacji lub plik odpowiedzi station/findAll).",
+                                              "liczba|plik");
+    parser.addOption(benchmarkCatalogOption);
+    QCommandLineOption benchmarkIngestOption("benchmark-ingest",
+                                             "Mierzy odbiór odczytów z czujników lokalnych przez UDP przy podanej liczbie odczytów na sekundę.",
+                                             "liczba");
+    parser.addOption(benchmarkIngestOption);
+    QCommandLineOption benchmarkArchiveOption("benchmark-archive",
+                                              "Mierzy przepustowość wczytywania archiwum lokalnej bazy danych (pliki/s, MB/s) dla podanej liczby plików.",
+                                              "liczba");
+    parser.addOption(benchmarkArchiveOption);
+    QCommandLineOption benchmarkPrefetchOption("benchmark-prefetch",
+                                               "Porównuje odsetek trafień i czas od kliknięcia stacji do wykresu bez wstępnego pobierania i z nim dla podanej liczby wyborów stacji.",
+                                               "liczba");
+    parser.addOption(benchmarkPrefetchOption);
+    QCommandLineOption benchmarkLocalApiOption("benchmark-local-api",
+                                               "Mierzy przepustowość lokalnego API HTTP/JSON (zapytania/s, percentyle, udział 304 i gzip) i opóźnienie wątku interfejsu dla podanej liczby zapytań.",
+                                               "liczba");
+    parser.addOption(benchmarkLocalApiOption);
+    QCommandLineOption benchmarkReplayOption("benchmark-replay",
+                                             "Odtwarza nagranie odczytów lokalnych sprzed doby o podanej długości w minutach i sprawdza okno przechowywania.",
+                                             "minuty");
+    parser.addOption(benchmarkReplayOption);
+    QCommandLineOption scaleTestOption("scale-test",
+                                       "Mierzy czasy i pamięć aplikacji dla syntetycznych katalogów o podanych wielkościach (np. 1000,10000,100000).",
+                                       "wielkości");
+    parser.addOption(scaleTestOption);
+    QCommandLineOption scaleYearsOption("scale-years",
+                                        "Długość syntetycznej historii każdego czujnika w latach (dla --scale-test i --stand-in-stations, domyślnie 2).",
+                                        "lata", "2");
+    parser.addOption(scaleYearsOption);
+    QCommandLineOption ingestUdpOption("ingest-udp",
+                                       "Odbiera odczyty z czujników lokalnych (urządzenie;parametr;czas_ms;wartość) na podanym porcie UDP.",
+                                       "port");
+    parser.addOption(ingestUdpOption);
+    QCommandLineOption ingestFileOption("ingest-file",
+                                        "Odtwarza plik z zapisanymi odczytami czujników lokalnych w tempie rzeczywistym.",
+                                        "plik");
+    parser.addOption(ingestFileOption);
+    QCommandLineOption localApiOption("local-api",
+                                      "Udostępnia dane z pamięci podręcznej i lokalnej bazy danych przez HTTP/JSON na 127.0.0.1 i podanym porcie.",
+                                      "port");
+    parser.addOption(localApiOption);
+    QCommandLineOption deferredInitOption("deferred-init",
+                                          "Pokazuje listę stacji z pamięci podręcznej, a wykres i zapytania do API uruchamia po pierwszej klatce.");
+    parser.addOption(deferredInitOption);
+    QCommandLineOption traceStartupOption("trace-startup",
+                                          "Wypisuje czasy kolejnych etapów uruchamiania (od utworzenia procesu).");
+    parser.addOption(traceStartupOption);
+    QCommandLineOption standInOption("stand-in-server",
+                                     "Uruchamia lokalny zamiennik API GIOŚ i geokodera Nominatim (np. dla testapi --batch).",
+                                     "port");
+    parser.addOption(standInOption);
+    QCommandLineOption standInStationsOption("stand-in-stations",
+                                             "Lokalny zamiennik API udostępnia syntetyczny katalog o podanej liczbie stacji z wieloletnimi historiami.",
+                                             "liczba");
+    parser.addOption(standInStationsOption);
+    parser.process(app);
+    StartupTrace::setPrinting(parser.isSet(traceStartupOption));
+    const bool deferredStartup = parser.isSet(deferredInitOption);
+
+    if (parser.isSet(benchmarkSearchOption)) {
+        return Benchmark::runSearch(parser.value(benchmarkSearchOption).toInt());
+    }
+    if (parser.isSet(benchmarkMapOption)) {
+        return Benchmark::runMap(parser.value(benchmarkMapOption).toInt());
+    }
+    if (parser.isSet(benchmarkNetworkOption)) {
+        return Benchmark::runNetwork(parser.value(benchmarkNetworkOption).toInt());
+    }
+    if (parser.isSet(benchmarkCatalogOption)) {
+        return Benchmark::runCatalog(parser.value(benchmarkCatalogOption));
+    }
+    if (parser.isSet(benchmarkIngestOption)) {
+        return Benchmark::runIngest(parser.value(benchmarkIngestOption).toInt());
+    }
+    if (parser.isSet(benchmarkArchiveOption)) {
+        return Benchmark::runArchive(parser.value(benchmarkArchiveOption).toInt());
+    }
+    if (parser.isSet(benchmarkPrefetchOption)) {
+        return Benchmark::runPrefetch(parser.value(benchmarkPrefetchOption).toInt());
+    }
+    if (parser.isSet(benchmarkLocalApiOption)) {
+        return Benchmark::runLocalApi(parser.value(benchmarkLocalApiOption).toInt());
+    }
+    if (parser.isSet(benchmarkReplayOption)) {
+        return Benchmark::runReplay(parser.value(benchmarkReplayOption).toInt());
+    }
+    if (parser.isSet(scaleTestOption)) {
+        return Benchmark::runScale(parser.value(scaleTestOption), parser.value(scaleYearsOption).toInt());
+    }
+    if (parser.isSet(standInOption)) {
+        FaultInjectingServer server;
+        if (parser.isSet(standInStationsOption)) {
+            const QJsonArray stations = SyntheticData::stations(parser.value(standInStationsOption).toInt());
+            server.setDataset(stations, SyntheticData::sensors(stations), parser.value(scaleYearsOption).toInt() * 8760);
+        }
+        if (!server.listen(static_cast<quint16>(parser.value(standInOption).toUInt()))) {
+            QTextStream(stdout) << "Nie można uruchomić serwera na porcie " << parser.value(standInOption) << "\n";
+            return 1;
+        }
+        QTextStream(stdout) << "API GIOŚ: " << server.baseUrl() << "\nGeokodowanie: " << server.geocodeUrl() << "\n";
+        return app.exec();
+    }
+
+    /// Rejestracja warstwy mapy stacji jako typu QML.
+    qmlRegisterType<StationMapItem>("MonitorJakosci", 1, 0, "StationMap");
+
     /// Silnik QML do ładowania i renderowania interfejsu użytkownika.
     QQmlApplicationEngine engine;
 
     /// Obiekt backendu zarządzający logiką aplikacji.
-    MainWindow mainWindow;
+    MainWindow mainWindow(nullptr, deferredStartup);
+
+    /// Tryb odroczonej inicjalizacji (wykres tworzony przy pierwszym użyciu).
+    engine.rootContext()->setContextProperty("deferredStartup", deferredStartup);
 
     /// Rejestracja obiektu MainWindow w kontekście QML, umożliwia dostęp z QML.
     engine.rootContext()->setContextProperty("mainWindow", &mainWindow);
 
+    /// Rejestracja modelu macierzy korelacji w kontekście QML.
+    engine.rootContext()->setContextProperty("correlationModel", mainWindow.correlationMatrixModel());
+
+    /// Rejestracja modeli listy stacji i czujników w kontekście QML.
+    engine.rootContext()->setContextProperty("stationListModel", mainWindow.stationListModel());
+    engine.rootContext()->setContextProperty("sensorListModel", mainWindow.sensorListModel());
+
+    /// Uruchomienie odbioru odczytów z czujników lokalnych, jeśli podano źródło.
+    if (parser.isSet(ingestUdpOption) && !mainWindow.startLocalIngestion(parser.value(ingestUdpOption).toInt())) {
+        qDebug() << "Failed to start local ingestion on UDP port" << parser.value(ingestUdpOption);
+    }
+    if (parser.isSet(ingestFileOption) && !mainWindow.replayLocalFile(parser.value(ingestFileOption))) {
+        qDebug() << "Failed to replay local readings file" << parser.value(ingestFileOption);
+    }
+
+    /// Uruchomienie lokalnego API HTTP/JSON, jeśli podano port.
+    if (parser.isSet(localApiOption) && !mainWindow.startLocalApi(parser.value(localApiOption).toInt())) {
+        qDebug() << "Failed to start local API on port" << parser.value(localApiOption);
+    }
+
     /// URL do głównego pliku QML w zasobach.
     const QUrl url(QStringLiteral("qrc:/main.qml"));
 
@@ -41,6 +202,17 @@ int main(int argc, char *argv[])
     /// Sprawdzenie, czy załadowano obiekty QML; w razie błędu zwraca -1.
     if (engine.rootObjects().isEmpty())
         return -1;
+    StartupTrace::mark("engine loaded");
+
+    /// Pierwsza klatka okna; w trybie odroczonym dopiero po niej startują zapytania i odczyt danych lokalnych.
+    if (QQuickWindow* window = qobject_cast<QQuickWindow*>(engine.rootObjects().first())) {
+        QObject::connect(window, &QQuickWindow::frameSwapped, &mainWindow, [&mainWindow, deferredStartup]() {
+            StartupTrace::mark("first frame");
+            if (deferredStartup) {
+                QTimer::singleShot(0, &mainWindow, &MainWindow::warmUp);
+            }
+        }, Qt::SingleShotConnection);
+    }
 
     /// Uruchomienie pętli zdarzeń aplikacji Qt.
     return app.exec();
@@ -1,7 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
-import QtCharts 2.15
+import MonitorJakosci 1.0
 
 /**
  * @brief Główny komponent interfejsu użytkownika aplikacji.
@@ -27,6 +27,14 @@ ApplicationWindow {
     property bool usingHistoricalData: false
     /// @brief Czy pokazywać panel analizy danych.
     property bool showAnalysis: false
+    /// @brief Tekst wyników analizy pomiarów.
+    property string analysisText: ""
+    /// @brief Ostatni stan odbioru odczytów z czujników lokalnych.
+    property string localIngestionStatus: ""
+    /// @brief Podsumowania czujników wybranej stacji (karty przeglądu stacji).
+    property var dashboardCards: []
+    /// @brief Stan budowy przeglądu stacji.
+    property string dashboardStatus: ""
 
     /// @brief Główny kolor interfejsu (niebieski).
     property color primaryColor: "#1976D2"
@@ -39,6 +47,44 @@ ApplicationWindow {
     /// @brief Kolor obramowania.
     property color borderColor: "#E0E0E0"
 
+    /**
+     * @brief Zwraca wykres pomiarów, tworząc go przy pierwszym użyciu.
+     * @return Obiekt MeasurementChart.
+     */
+    function measurementChart() {
+        chartLoader.active = true
+        return chartLoader.item
+    }
+
+    /**
+     * @brief Wybiera czujnik (z listy rozwijanej lub karty przeglądu stacji).
+     * @param sensorId Identyfikator czujnika.
+     */
+    function selectSensor(sensorId) {
+        sensorsComboBox.currentIndex = sensorListModel.rowOf(sensorId)
+        localSensorsComboBox.currentIndex = -1
+        currentSensor = sensorId
+        watchSensorCheckBox.checked = mainWindow.isSensorWatched(sensorId)
+        mainWindow.sensorSelected(sensorId)
+    }
+
+    /**
+     * @brief Wybiera stację z listy lub mapy i resetuje stan widoku.
+     * @param stationId Identyfikator stacji.
+     */
+    function selectStation(stationId) {
+        stationsList.currentIndex = stationListModel.rowOf(stationId)
+        currentStation = mainWindow.stationData(stationId)
+        currentSensor = null
+        sensorsComboBox.currentIndex = -1
+        watchSensorCheckBox.checked = false
+        mainWindow.stationSelected(stationId)
+        usingHistoricalData = false
+        historicalDataSwitch.checked = false
+        showAnalysis = false
+        analysisText = ""
+    }
+
     /**
      * @brief Główny układ pionowy interfejsu.
      *
@@ -103,6 +149,7 @@ ApplicationWindow {
                             color: "white"
                             font.pixelSize: 14
                             background: Item {}
+                            onTextChanged: mainWindow.searchStations(text)
                             onAccepted: mainWindow.searchStations(text)
                         }
 
@@ -144,7 +191,28 @@ ApplicationWindow {
                         border.width: 1
                         radius: 4
                     }
-                    onClicked: mainWindow.showAllStations()
+                    onClicked: {
+                        searchField.text = ""
+                        mainWindow.showAllStations()
+                    }
+                }
+
+                /// @brief Przycisk otwierający mapę stacji.
+                Button {
+                    text: "Mapa"
+                    flat: true
+                    contentItem: Text {
+                        text: parent.text
+                        color: "white"
+                        font.pixelSize: 14
+                    }
+                    background: Rectangle {
+                        color: "transparent"
+                        border.color: "white"
+                        border.width: 1
+                        radius: 4
+                    }
+                    onClicked: mapPopup.open()
                 }
             }
         }
@@ -256,16 +324,139 @@ ApplicationWindow {
                             Layout.preferredWidth: 200
                             Layout.preferredHeight: 36
                             font.pixelSize: 12
-                            model: ListModel {
-                                id: sensorsModel
-                                ListElement { display: "Wybierz czujnik..."; sensorId: 0 }
-                            }
+                            model: sensorListModel
                             textRole: "display"
-                            onCurrentIndexChanged: {
-                                if (currentIndex > 0 && model.count > currentIndex) {
-                                    var sensorId = model.get(currentIndex).sensorId;
-                                    currentSensor = sensorId;
-                                    mainWindow.sensorSelected(sensorId);
+                            valueRole: "sensorId"
+                            currentIndex: -1
+                            displayText: currentIndex < 0 ? "Wybierz czujnik..." : currentText
+                            onActivated: selectSensor(currentValue)
+                        }
+
+                        /// @brief Dodanie wybranego czujnika do listy odświeżanej w tle.
+                        CheckBox {
+                            id: watchSensorCheckBox
+                            text: "Obserwuj"
+                            font.pixelSize: 12
+                            enabled: sensorsComboBox.currentIndex >= 0
+                            onToggled: mainWindow.setSensorWatched(currentSensor, checked)
+                        }
+                    }
+                }
+
+                /// @brief Przegląd stacji: karta z wartością, trendem i wykresem miniaturowym dla każdego czujnika.
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: 118
+                    color: lightBgColor
+                    radius: 8
+                    border.color: borderColor
+                    border.width: 1
+                    visible: currentStation !== null
+
+                    ColumnLayout {
+                        anchors.fill: parent
+                        anchors.margins: 8
+                        spacing: 4
+
+                        RowLayout {
+                            spacing: 12
+                            Label {
+                                text: "Przegląd stacji"
+                                font.pixelSize: 14
+                                font.bold: true
+                                color: textColor
+                            }
+                            Label {
+                                text: dashboardStatus
+                                font.pixelSize: 11
+                                color: textColor
+                            }
+                        }
+
+                        ListView {
+                            Layout.fillWidth: true
+                            Layout.fillHeight: true
+                            orientation: ListView.Horizontal
+                            spacing: 8
+                            clip: true
+                            model: dashboardCards
+
+                            delegate: Rectangle {
+                                width: 150
+                                height: ListView.view.height
+                                radius: 6
+                                color: modelData.sensorId === currentSensor ? Qt.lighter(primaryColor, 1.9) : "#F9F9F9"
+                                border.color: borderColor
+
+                                ColumnLayout {
+                                    anchors.fill: parent
+                                    anchors.margins: 6
+                                    spacing: 0
+
+                                    Label {
+                                        Layout.fillWidth: true
+                                        text: modelData.paramCode + (modelData.trendName === "rośnie" ? "  ↑"
+                                              : modelData.trendName === "maleje" ? "  ↓"
+                                              : modelData.trendName === "stabilnie" ? "  →" : "")
+                                        font.pixelSize: 12
+                                        font.bold: true
+                                        color: textColor
+                                        elide: Text.ElideRight
+                                    }
+                                    Label {
+                                        text: modelData.error ? modelData.error
+                                              : (modelData.latest === null ? "-" : modelData.latest.toFixed(1) + " (" + modelData.latestDate + ")")
+                                                + (modelData.warning ? "  [" + modelData.warning + ", dane lokalne]" : "")
+                                        font.pixelSize: 11
+                                        color: textColor
+                                    }
+                                    Label {
+                                        visible: !modelData.error
+                                        text: "śr. " + (modelData.mean === null ? "-" : modelData.mean.toFixed(1))
+                                              + "  min " + (modelData.min === null ? "-" : modelData.min.toFixed(1))
+                                              + "  maks. " + (modelData.max === null ? "-" : modelData.max.toFixed(1))
+                                        font.pixelSize: 10
+                                        color: textColor
+                                    }
+
+                                    /// @brief Wykres miniaturowy ostatnich godzin.
+                                    Canvas {
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+                                        property var values: modelData.sparkline
+                                        onValuesChanged: requestPaint()
+                                        onPaint: {
+                                            var ctx = getContext("2d")
+                                            ctx.clearRect(0, 0, width, height)
+                                            if (!values || values.length < 2) return
+                                            var low = Infinity, high = -Infinity
+                                            for (var i = 0; i < values.length; i++) {
+                                                if (values[i] === null) continue
+                                                low = Math.min(low, values[i])
+                                                high = Math.max(high, values[i])
+                                            }
+                                            if (low === Infinity) return
+                                            var span = high > low ? high - low : 1
+                                            ctx.strokeStyle = modelData.anomalies > 0 ? "#E53935" : primaryColor
+                                            ctx.lineWidth = 1.5
+                                            ctx.beginPath()
+                                            var drawing = false
+                                            for (var j = 0; j < values.length; j++) {
+                                                if (values[j] === null) { drawing = false; continue }
+                                                var x = j * width / (values.length - 1)
+                                                var y = height - 2 - (values[j] - low) / span * (height - 4)
+                                                if (drawing) ctx.lineTo(x, y); else ctx.moveTo(x, y)
+                                                drawing = true
+                                            }
+                                            ctx.stroke()
+                                        }
+                                    }
+                                }
+
+                                MouseArea {
+                                    anchors.fill: parent
+                                    enabled: !modelData.error
+                                    onClicked: selectSensor(modelData.sensorId)
                                 }
                             }
                         }
@@ -299,7 +490,7 @@ ApplicationWindow {
                             id: saveMeasurementsButton
                             text: "Zapisz pomiary"
                             font.pixelSize: 12
-                            enabled: sensorsComboBox.currentIndex > 0 && !usingHistoricalData
+                            enabled: sensorsComboBox.currentIndex >= 0 && !usingHistoricalData
                             onClicked: {
                                 mainWindow.saveMeasurementsToDatabase();
                                 saveDataToast.visible = true;
@@ -320,8 +511,108 @@ ApplicationWindow {
                             }
                         }
 
+                        /// @brief Przycisk otwierający macierz korelacji czujników stacji.
+                        Button {
+                            text: "Korelacje"
+                            font.pixelSize: 12
+                            enabled: currentStation !== null
+                            onClicked: {
+                                mainWindow.computeStationCorrelation(currentStation.id, correlationMethodComboBox.currentText.toLowerCase())
+                                correlationPopup.open()
+                            }
+                        }
+
+                        /// @brief Przycisk tworzący raport zgodności z normami UE.
+                        Button {
+                            text: "Raport norm"
+                            font.pixelSize: 12
+                            onClicked: {
+                                complianceStatusLabel.text = "Obliczanie..."
+                                complianceModel.clear()
+                                mainWindow.generateComplianceReport()
+                                compliancePopup.open()
+                            }
+                        }
+
+                        /// @brief Przycisk wczytujący całe archiwum lokalnej bazy danych.
+                        Button {
+                            text: "Archiwum"
+                            font.pixelSize: 12
+                            onClicked: {
+                                archiveStatusLabel.text = "Wczytywanie archiwum..."
+                                mainWindow.loadArchive()
+                            }
+                        }
+
+                        /// @brief Stan archiwum (historia bieżącej stacji w podpowiedzi).
+                        Label {
+                            id: archiveStatusLabel
+                            visible: text !== ""
+                            font.pixelSize: 11
+                            color: textColor
+
+                            MouseArea {
+                                id: archiveStatusArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                            }
+
+                            ToolTip.visible: archiveStatusArea.containsMouse && currentStation !== null
+                            ToolTip.text: archiveStatusArea.containsMouse && currentStation !== null
+                                          ? mainWindow.archiveStationSummary(currentStation.id) : ""
+                        }
+
                         Item { Layout.fillWidth: true }
 
+                        /// @brief Ostrzeżenie o niedostępności API (statystyki zapytań w podpowiedzi).
+                        Label {
+                            id: apiStatusLabel
+                            visible: text !== ""
+                            font.pixelSize: 11
+                            color: "red"
+
+                            MouseArea {
+                                id: apiStatusArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                            }
+
+                            ToolTip.visible: apiStatusArea.containsMouse
+                            ToolTip.text: apiStatusArea.containsMouse ? mainWindow.networkMetrics() : ""
+                        }
+
+                        /// @brief Stan odświeżania w tle (liczniki aktualizacji interfejsu w podpowiedzi).
+                        Label {
+                            id: pollingStatusLabel
+                            font.pixelSize: 11
+                            color: textColor
+
+                            MouseArea {
+                                id: pollingStatusArea
+                                anchors.fill: parent
+                                hoverEnabled: true
+                            }
+
+                            ToolTip.visible: pollingStatusArea.containsMouse
+                            ToolTip.text: pollingStatusArea.containsMouse ? mainWindow.uiUpdateMetrics() : ""
+                        }
+
+                        /// @brief Przełącznik odświeżania danych w tle.
+                        Switch {
+                            text: "Auto-odświeżanie"
+                            font.pixelSize: 12
+                            checked: true
+                            onToggled: mainWindow.setAutoRefresh(checked)
+                        }
+
+                        /// @brief Przełącznik wstępnego pobierania danych prawdopodobnie wybieranych stacji.
+                        Switch {
+                            text: "Wstępne pobieranie"
+                            font.pixelSize: 12
+                            checked: true
+                            onToggled: mainWindow.setPrefetchEnabled(checked)
+                        }
+
                         /// @brief Przełącznik danych historycznych.
                         Switch {
                             id: historicalDataSwitch
@@ -364,11 +655,103 @@ ApplicationWindow {
 
                             Item { Layout.fillWidth: true }
 
+                            /// @brief Pokrycie siatki czasu danymi po wyrównaniu serii.
+                            Label {
+                                id: coverageLabel
+                                font.pixelSize: 12
+                                color: textColor
+                            }
+
+                            /// @brief Wybór polityki wypełniania luk na siatce godzinowej.
+                            ComboBox {
+                                id: gapPolicyComboBox
+                                Layout.preferredWidth: 170
+                                font.pixelSize: 12
+                                model: ["Luki: bez wypełniania", "Luki: interpolacja", "Luki: przeniesienie"]
+                                enabled: sensorsComboBox.currentIndex >= 0 && !usingHistoricalData
+                                onActivated: {
+                                    var result = mainWindow.resampleMeasurements("hour", ["null", "linear", "carry"][currentIndex], 3)
+                                    coverageLabel.text = result.error ? result.error : "Pokrycie: " + result.coverage + "%"
+                                    mainWindow.setForecastHorizon([6, 12, 24][forecastHorizonComboBox.currentIndex])
+                                }
+                            }
+
+                            /// @brief Wybór horyzontu prognozy.
+                            ComboBox {
+                                id: forecastHorizonComboBox
+                                Layout.preferredWidth: 140
+                                font.pixelSize: 12
+                                model: ["Prognoza 6 h", "Prognoza 12 h", "Prognoza 24 h"]
+                                currentIndex: 2
+                                enabled: sensorsComboBox.currentIndex >= 0
+                                onActivated: mainWindow.setForecastHorizon([6, 12, 24][currentIndex])
+                            }
+
+                            /// @brief Wybór czujnika lokalnego (odczyty odbierane przez UDP lub z pliku).
+                            ComboBox {
+                                id: localSensorsComboBox
+                                Layout.preferredWidth: 200
+                                font.pixelSize: 12
+                                visible: count > 0
+                                model: ListModel { id: localSensorsModel }
+                                textRole: "label"
+                                valueRole: "sensorId"
+                                currentIndex: -1
+                                displayText: currentIndex < 0 ? "Czujnik lokalny..." : currentText
+                                onActivated: {
+                                    sensorsComboBox.currentIndex = -1
+                                    currentSensor = null
+                                    mainWindow.showLocalSensor(currentValue)
+                                }
+                            }
+
+                            /// @brief Stan odbioru odczytów lokalnych (szczegóły w podpowiedzi).
+                            Label {
+                                id: localIngestionLabel
+                                visible: localSensorsComboBox.visible
+                                text: "Odbiór lokalny"
+                                font.pixelSize: 11
+                                color: textColor
+
+                                MouseArea {
+                                    id: localIngestionArea
+                                    anchors.fill: parent
+                                    hoverEnabled: true
+                                }
+
+                                ToolTip.visible: localIngestionArea.containsMouse
+                                ToolTip.text: localIngestionStatus
+                            }
+
+                            /// @brief Nałożenie wybranego czujnika na wykres (porównanie serii).
+                            Button {
+                                text: "Nałóż na wykres"
+                                font.pixelSize: 12
+                                enabled: sensorsComboBox.currentIndex >= 0
+                                onClicked: mainWindow.addOverlaySensor(sensorsComboBox.currentValue)
+                            }
+
+                            /// @brief Zdjęcie wszystkich nałożonych serii.
+                            Button {
+                                text: "Wyczyść porównanie"
+                                font.pixelSize: 12
+                                enabled: chartLoader.item !== null && chartLoader.item.overlayCount > 0
+                                onClicked: mainWindow.clearOverlaySensors()
+                            }
+
+                            /// @brief Czy nakładane serie dostają własną oś Y (wspólną dla tego samego parametru).
+                            CheckBox {
+                                id: separateAxesCheckBox
+                                text: "Osobne osie Y"
+                                font.pixelSize: 12
+                                checked: true
+                            }
+
                             /// @brief Przycisk pokazywania/ukrywania analizy.
                             Button {
                                 text: showAnalysis ? "Ukryj analizę" : "Pokaż analizę"
                                 font.pixelSize: 12
-                                enabled: sensorsComboBox.currentIndex > 0
+                                enabled: sensorsComboBox.currentIndex >= 0
                                 onClicked: {
                                     if (!showAnalysis) {
                                         mainWindow.analyzeMeasurements();
@@ -378,90 +761,80 @@ ApplicationWindow {
                             }
                         }
 
-                        /// @brief Wykres wyświetlający pomiary w czasie.
-                        ChartView {
-                            id: chartView
+                        /// @brief Wykres wyświetlający pomiary w czasie (tworzony przy pierwszym wyświetleniu danych).
+                        Loader {
+                            id: chartLoader
                             Layout.fillWidth: true
                             Layout.fillHeight: true
-                            antialiasing: true
-                            title: "Pomiary w czasie"
-                            titleFont.pixelSize: 16
-                            legend.visible: true
-                            legend.font.pixelSize: 12
-                            backgroundColor: "transparent"
-                            titleColor: textColor
-                            margins.left: 20
-                            margins.right: 20
-                            margins.top: 20
-                            margins.bottom: 20
-
-                            LineSeries {
-                                id: measurementSeries
-                                name: "Pomiary"
-                                color: accentColor
-                                width: 2
-                                axisX: DateTimeAxis {
-                                    id: timeAxis
-                                    format: "dd.MM HH:mm"
-                                    titleText: "Data i czas"
-                                    labelsFont.pixelSize: 12
-                                    labelsColor: textColor
-                                    gridLineColor: "#E0E0E0"
-                                    tickCount: 5
-                                }
-                                axisY: ValueAxis {
-                                    id: valueAxis
-                                    titleText: "Wartość"
-                                    labelsFont.pixelSize: 12
-                                    labelsColor: textColor
-                                    gridLineColor: "#E0E0E0"
-                                    tickCount: 5
+                            active: !deferredStartup
+                            sourceComponent: Component {
+                                MeasurementChart {
+                                    accentColor: root.accentColor
+                                    primaryColor: root.primaryColor
+                                    textColor: root.textColor
                                 }
                             }
                         }
+
+                        /// @brief Zachęta widoczna do czasu utworzenia wykresu.
+                        Label {
+                            Layout.fillWidth: true
+                            Layout.fillHeight: true
+                            visible: !chartLoader.active
+                            text: "Wybierz stację i czujnik, aby zobaczyć wykres pomiarów"
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                            font.pixelSize: 14
+                            color: textColor
+                        }
                     }
                 }
 
-                /// @brief Panel wyników analizy pomiarów.
-                Rectangle {
+                /// @brief Panel wyników analizy pomiarów (tworzony przy pierwszym otwarciu).
+                Loader {
                     Layout.fillWidth: true
                     Layout.preferredHeight: showAnalysis ? 80 : 0
-                    color: "#F9F9F9"
-                    radius: 4
-                    border.color: borderColor
-                    border.width: 1
+                    active: showAnalysis
                     visible: showAnalysis
-                    clip: true
 
                     Behavior on Layout.preferredHeight {
                         NumberAnimation { duration: 200 }
                     }
 
-                    RowLayout {
-                        anchors.fill: parent
-                        anchors.margins: 8
-                        spacing: 16
+                    sourceComponent: Component {
+                        Rectangle {
+                            color: "#F9F9F9"
+                            radius: 4
+                            border.color: borderColor
+                            border.width: 1
+                            clip: true
 
-                        ColumnLayout {
-                            spacing: 4
-                            Label {
-                                text: "Wyniki analizy"
-                                font.pixelSize: 14
-                                font.bold: true
-                                color: textColor
-                            }
+                            RowLayout {
+                                anchors.fill: parent
+                                anchors.margins: 8
+                                spacing: 16
+
+                                ColumnLayout {
+                                    spacing: 4
+                                    Label {
+                                        text: "Wyniki analizy"
+                                        font.pixelSize: 14
+                                        font.bold: true
+                                        color: textColor
+                                    }
 
-                            /// @brief Etykieta z wynikami analizy.
-                            Label {
-                                id: analysisLabel
-                                text: ""
-                                font.pixelSize: 12
-                                color: textColor
-                                wrapMode: Text.WordWrap
+                                    /// @brief Etykieta z wynikami analizy.
+                                    Label {
+                                        text: analysisText
+                                        font.pixelSize: 12
+                                        color: textColor
+                                        wrapMode: Text.WordWrap
+                                    }
+                                }
+
+                                Item { Layout.fillWidth: true }
                             }
                         }
-
-                        Item { Layout.fillWidth: true }
                     }
                 }
             }
@@ -501,9 +874,7 @@ ApplicationWindow {
                         clip: true
                         spacing: 4
 
-                        model: ListModel {
-                            id: stationsModel
-                        }
+                        model: stationListModel
 
                         delegate: Rectangle {
                             width: ListView.view.width
@@ -538,16 +909,7 @@ ApplicationWindow {
                             MouseArea {
                                 anchors.fill: parent
                                 cursorShape: Qt.PointingHandCursor
-                                onClicked: {
-                                    stationsList.currentIndex = index
-                                    currentStation = model.station
-                                    currentSensor = null
-                                    mainWindow.stationSelected(model.stationId)
-                                    usingHistoricalData = false
-                                    historicalDataSwitch.checked = false
-                                    showAnalysis = false
-                                    analysisLabel.text = ""
-                                }
+                                onClicked: selectStation(model.stationId)
                             }
                         }
 
@@ -560,6 +922,324 @@ ApplicationWindow {
         }
     }
 
+    /**
+     * @brief Okno z mapą stacji pokolorowanych według indeksu jakości powietrza.
+     *
+     * Mapa pokazuje stacje z bieżącego wyniku wyszukiwania. Przy małym przybliżeniu bliskie
+     * stacje łączone są w klastry w kolorze najgorszego znanego indeksu; kliknięcie klastra
+     * przybliża widok, a kliknięcie stacji wybiera ją tak jak na liście.
+     */
+    Popup {
+        id: mapPopup
+        anchors.centerIn: parent
+        width: root.width - 80
+        height: root.height - 80
+        modal: true
+        padding: 16
+
+        onOpened: mainWindow.setVisibleStations(stationMap.visibleStationIds())
+        onClosed: mainWindow.setVisibleStations([])
+
+        background: Rectangle {
+            color: lightBgColor
+            radius: 8
+            border.color: borderColor
+        }
+
+        ColumnLayout {
+            anchors.fill: parent
+            spacing: 8
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: 12
+
+                Label {
+                    text: "Mapa stacji"
+                    font.pixelSize: 16
+                    font.bold: true
+                    color: textColor
+                }
+
+                /// @brief Liczba stacji i znaczników w widoku.
+                Label {
+                    Layout.fillWidth: true
+                    text: "Stacje w widoku: " + stationMap.visibleStationCount + ", znaczniki: " + stationMap.markerCount
+                    font.pixelSize: 12
+                    color: textColor
+                }
+
+                /// @brief Legenda poziomów indeksu.
+                Repeater {
+                    model: ["Bardzo dobry", "Dobry", "Umiarkowany", "Dostateczny", "Zły", "Bardzo zły", "Brak indeksu"]
+
+                    RowLayout {
+                        spacing: 4
+
+                        Rectangle {
+                            width: 12
+                            height: 12
+                            radius: 6
+                            color: stationMap.levelColor(index < 6 ? index : -1)
+                        }
+
+                        Label {
+                            text: modelData
+                            font.pixelSize: 11
+                            color: textColor
+                        }
+                    }
+                }
+
+                Button {
+                    text: "Dopasuj"
+                    font.pixelSize: 12
+                    onClicked: stationMap.fitToStations()
+                }
+
+                Button {
+                    text: "Zamknij"
+                    font.pixelSize: 12
+                    onClicked: mapPopup.close()
+                }
+            }
+
+            Rectangle {
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                color: "#ECEFF1"
+                radius: 4
+                border.color: borderColor
+
+                /// @brief Warstwa stacji (element grafu sceny).
+                StationMap {
+                    id: stationMap
+                    anchors.fill: parent
+                    model: stationListModel
+                    selectedStationId: currentStation !== null ? currentStation.id : -1
+                    onStationClicked: function(stationId) {
+                        selectStation(stationId)
+                        mapPopup.close()
+                    }
+                    onViewportSettled: {
+                        if (mapPopup.opened) {
+                            mainWindow.setVisibleStations(visibleStationIds())
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Okno z macierzą korelacji czujników.
+     *
+     * Komórki są kolorowane według współczynnika: czerwony dla korelacji dodatniej,
+     * niebieski dla ujemnej. Etykiety wierszy i kolumn odpowiadają numerom w legendzie.
+     */
+    Popup {
+        id: correlationPopup
+        anchors.centerIn: parent
+        width: Math.min(root.width - 80, 760)
+        height: Math.min(root.height - 80, 560)
+        modal: true
+        padding: 16
+
+        background: Rectangle {
+            color: lightBgColor
+            radius: 8
+            border.color: borderColor
+        }
+
+        ColumnLayout {
+            anchors.fill: parent
+            spacing: 8
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: 12
+
+                Label {
+                    text: "Macierz korelacji"
+                    font.pixelSize: 16
+                    font.bold: true
+                    color: textColor
+                }
+
+                /// @brief Stan obliczeń macierzy.
+                Label {
+                    id: correlationStatusLabel
+                    Layout.fillWidth: true
+                    font.pixelSize: 12
+                    color: textColor
+                    elide: Text.ElideRight
+                }
+
+                /// @brief Wybór metody korelacji.
+                ComboBox {
+                    id: correlationMethodComboBox
+                    Layout.preferredWidth: 130
+                    font.pixelSize: 12
+                    model: ["Pearson", "Spearman"]
+                    onActivated: {
+                        if (currentStation !== null) {
+                            mainWindow.computeStationCorrelation(currentStation.id, currentText.toLowerCase())
+                        }
+                    }
+                }
+
+                Button {
+                    text: "Zamknij"
+                    font.pixelSize: 12
+                    onClicked: correlationPopup.close()
+                }
+            }
+
+            RowLayout {
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                spacing: 12
+
+                /// @brief Legenda z numerami i opisami serii.
+                ListView {
+                    Layout.preferredWidth: 220
+                    Layout.fillHeight: true
+                    clip: true
+                    model: correlationModel.labels
+                    delegate: Label {
+                        width: ListView.view.width
+                        text: (index + 1) + ". " + modelData
+                        font.pixelSize: 11
+                        color: textColor
+                        elide: Text.ElideRight
+                    }
+                }
+
+                /// @brief Tabela współczynników korelacji.
+                TableView {
+                    id: correlationTable
+                    Layout.fillWidth: true
+                    Layout.fillHeight: true
+                    clip: true
+                    model: correlationModel
+                    columnSpacing: 2
+                    rowSpacing: 2
+
+                    delegate: Rectangle {
+                        implicitWidth: 48
+                        implicitHeight: 32
+                        color: isNaN(coefficient) ? "#EEEEEE"
+                                                  : coefficient >= 0 ? Qt.rgba(0.9, 0.22, 0.21, Math.abs(coefficient))
+                                                                     : Qt.rgba(0.12, 0.47, 0.82, Math.abs(coefficient))
+
+                        Text {
+                            anchors.centerIn: parent
+                            text: display
+                            font.pixelSize: 11
+                            color: !isNaN(coefficient) && Math.abs(coefficient) > 0.6 ? "white" : textColor
+                        }
+
+                        ToolTip.visible: cellArea.containsMouse
+                        ToolTip.text: (row + 1) + ". " + rowLabel + "\n" + (column + 1) + ". " + columnLabel
+                                      + "\nWspólne obserwacje: " + overlap
+
+                        MouseArea {
+                            id: cellArea
+                            anchors.fill: parent
+                            hoverEnabled: true
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Okno z rocznym raportem przekroczeń norm UE.
+     *
+     * Każdy wiersz opisuje jeden rok dla jednego czujnika: liczbę dni z przekroczeniem
+     * w stosunku do liczby dopuszczalnej, wartość maksymalną i średnią.
+     */
+    Popup {
+        id: compliancePopup
+        anchors.centerIn: parent
+        width: Math.min(root.width - 80, 860)
+        height: Math.min(root.height - 80, 560)
+        modal: true
+        padding: 16
+
+        background: Rectangle {
+            color: lightBgColor
+            radius: 8
+            border.color: borderColor
+        }
+
+        ColumnLayout {
+            anchors.fill: parent
+            spacing: 8
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: 12
+
+                Label {
+                    text: "Raport zgodności z normami UE"
+                    font.pixelSize: 16
+                    font.bold: true
+                    color: textColor
+                }
+
+                Label {
+                    id: complianceStatusLabel
+                    Layout.fillWidth: true
+                    font.pixelSize: 12
+                    color: textColor
+                }
+
+                Button {
+                    text: "Zamknij"
+                    font.pixelSize: 12
+                    onClicked: compliancePopup.close()
+                }
+            }
+
+            /// @brief Lista wierszy raportu.
+            ListView {
+                Layout.fillWidth: true
+                Layout.fillHeight: true
+                clip: true
+                spacing: 2
+                model: ListModel {
+                    id: complianceModel
+                }
+
+                delegate: Rectangle {
+                    width: ListView.view.width
+                    height: 28
+                    radius: 4
+                    color: model.compliant ? "#E8F5E9" : "#FFEBEE"
+
+                    Label {
+                        anchors.fill: parent
+                        anchors.leftMargin: 8
+                        verticalAlignment: Text.AlignVCenter
+                        font.pixelSize: 12
+                        color: textColor
+                        elide: Text.ElideRight
+                        text: model.station + " | " + model.paramCode + " (" + model.metric + " > " + model.threshold + ") | "
+                              + model.year + ": " + model.exceedanceDays + "/" + model.allowedDays + " dni"
+                              + " | maks. " + model.maxValue + ", śr. " + model.meanValue
+                              + " | dni ważne: " + model.validDays
+                    }
+                }
+
+                ScrollBar.vertical: ScrollBar {
+                    policy: ScrollBar.AsNeeded
+                }
+            }
+        }
+    }
+
     /// @brief Powiadomienie o zapisaniu danych (toast).
     Rectangle {
         id: saveDataToast
@@ -601,69 +1281,138 @@ ApplicationWindow {
     Connections {
         target: mainWindow
 
-        /// @brief Aktualizuje listę stacji w interfejsie.
-        function onStationsUpdateRequested(stations) {
-            stationsModel.clear()
-            for (var i = 0; i < stations.length; i++) {
-                stationsModel.append(stations[i])
-            }
-        }
-
         /// @brief Aktualizuje informacje o stacji.
         function onStationInfoUpdateRequested(info) {
             stationInfo.text = info
         }
 
-        /// @brief Aktualizuje listę czujników.
-        function onSensorsUpdateRequested(sensors) {
-            sensorsModel.clear()
-            sensorsModel.append({display: "Wybierz czujnik...", sensorId: 0})
+        /// @brief Aktualizuje stan odświeżania w tle.
+        function onPollingStatusUpdated(status) {
+            pollingStatusLabel.text = status
+        }
+
+        /// @brief Dodaje nowe czujniki lokalne do listy wyboru.
+        function onLocalSensorsUpdated(sensors) {
             for (var i = 0; i < sensors.length; i++) {
-                sensorsModel.append(sensors[i])
+                localSensorsModel.append({ "sensorId": sensors[i].sensorId, "label": sensors[i].label })
             }
-            sensorsComboBox.currentIndex = 0
-            currentSensor = null
-            showAnalysis = false
-            analysisLabel.text = ""
+        }
+
+        /// @brief Wyświetla stan odbioru odczytów lokalnych.
+        function onLocalIngestionStatusUpdated(status) {
+            localIngestionStatus = status
+        }
+
+        /// @brief Wyświetla ostrzeżenie, gdy API przestaje odpowiadać.
+        function onApiStatusUpdated(status) {
+            apiStatusLabel.text = status
+        }
+
+        /// @brief Przekazuje poziom indeksu stacji do mapy.
+        function onStationLevelUpdated(stationId, level) {
+            stationMap.setStationLevel(stationId, level)
         }
 
         /// @brief Aktualizuje wykres pomiarów.
         function onMeasurementsUpdateRequested(key, values) {
-            measurementSeries.clear()
-            chartView.title = "Pomiary parametru: " + key
+            coverageLabel.text = ""
             showAnalysis = false
-            analysisLabel.text = ""
+            analysisText = ""
+            measurementChart().setMeasurements(key, values)
+        }
 
-            if (values.length === 0) {
-                return
-            }
+        /// @brief Dopisuje do wykresu nowsze pomiary bez przerysowywania całej serii.
+        function onMeasurementsAppended(title, values) {
+            var chart = measurementChart()
+            chart.title = "Pomiary parametru: " + title
+            chart.upsertMeasurements(values)
+        }
 
-            var minTime = Number.MAX_VALUE
-            var maxTime = 0
-            var minValue = Number.MAX_VALUE
-            var maxValue = Number.MIN_VALUE
-
-            for (var i = 0; i < values.length; i++) {
-                var point = values[i]
-                if (point.value !== null && !isNaN(point.value)) {
-                    var timestamp = Date.parse(point.date)
-                    measurementSeries.append(timestamp, point.value)
-
-                    minTime = Math.min(minTime, timestamp)
-                    maxTime = Math.max(maxTime, timestamp)
-                    minValue = Math.min(minValue, point.value)
-                    maxValue = Math.max(maxValue, point.value)
-                }
+        /// @brief Nanosi na wykres poprawione wartości już wyświetlonych godzin.
+        function onMeasurementsCorrected(values) {
+            measurementChart().upsertMeasurements(values)
+        }
+
+        /// @brief Usuwa z wykresu pomiary lokalne starsze niż okno przechowywania.
+        function onMeasurementsTrimmed(cutoff) {
+            measurementChart().trimMeasurements(cutoff)
+        }
+
+        /// @brief Zaznacza na wykresie punkty uznane za anomalie.
+        function onAnomaliesUpdateRequested(anomalies) {
+            measurementChart().setAnomalies(anomalies)
+        }
+
+        /// @brief Usuwa z wykresu nieaktualne anomalie i dopisuje nowe (bez przerysowywania pozostałych).
+        function onAnomaliesChanged(added, removed) {
+            measurementChart().changeAnomalies(added, removed)
+        }
+
+        /// @brief Rysuje prognozę i rozszerza osie o jej zakres.
+        function onForecastUpdateRequested(values) {
+            measurementChart().setForecast(values)
+        }
+
+        /// @brief Tworzy nałożoną serię na wspólnej osi czasu i z osią Y parametru.
+        function onOverlaySeriesAdded(sensorId, label, paramCode, values) {
+            measurementChart().addOverlay(sensorId, label, paramCode, values, separateAxesCheckBox.checked)
+        }
+
+        /// @brief Nanosi na nałożoną serię nowe i poprawione pomiary.
+        function onOverlaySeriesUpdated(sensorId, values) {
+            measurementChart().updateOverlay(sensorId, values)
+        }
+
+        /// @brief Usuwa z nałożonej serii pomiary lokalne starsze niż okno przechowywania.
+        function onOverlaySeriesTrimmed(sensorId, cutoff) {
+            measurementChart().trimOverlay(sensorId, cutoff)
+        }
+
+        /// @brief Usuwa nałożoną serię; nieużywana oś parametru jest ukrywana do ponownego użycia.
+        function onOverlaySeriesRemoved(sensorId) {
+            measurementChart().removeOverlay(sensorId)
+        }
+
+        /// @brief Aktualizuje stan obliczeń macierzy korelacji.
+        function onCorrelationUpdateRequested(status) {
+            correlationStatusLabel.text = status
+        }
+
+        /// @brief Wypełnia raport zgodności z normami.
+        function onComplianceReportUpdateRequested(rows) {
+            complianceModel.clear()
+            for (var i = 0; i < rows.length; i++) {
+                complianceModel.append(rows[i])
             }
+            complianceStatusLabel.text = rows.length === 0 ? "Brak danych dla PM10, PM2.5 i O3"
+                                                           : "Wierszy: " + rows.length
+        }
 
-            if (minTime !== Number.MAX_VALUE && maxTime !== 0) {
-                timeAxis.min = new Date(minTime)
-                timeAxis.max = new Date(maxTime)
+        /// @brief Czyści przegląd stacji po wyborze nowej stacji.
+        function onDashboardReset(stationId, sensorCount) {
+            dashboardCards = []
+            dashboardStatus = sensorCount > 0 ? "Pobieranie " + sensorCount + " czujników..." : "Pobieranie listy czujników..."
+        }
 
-                var valueRange = maxValue - minValue
-                valueAxis.min = Math.max(0, minValue - valueRange * 0.1)
-                valueAxis.max = maxValue + valueRange * 0.1
+        /// @brief Dodaje lub odświeża kartę czujnika w przeglądzie stacji.
+        function onDashboardSensorUpdated(summary) {
+            var cards = dashboardCards.slice()
+            var index = cards.findIndex(function(card) { return card.sensorId === summary.sensorId })
+            if (index >= 0) {
+                cards[index] = summary
+            } else {
+                cards.push(summary)
             }
+            cards.sort(function(a, b) { return a.paramCode.localeCompare(b.paramCode) })
+            dashboardCards = cards
+            dashboardStatus = summary.ready >= summary.total
+                    ? "Gotowe: " + summary.total + " czujników w " + summary.elapsedMs + " ms"
+                    : summary.ready + " z " + summary.total + " czujników"
+        }
+
+        /// @brief Pokazuje stan wczytanego archiwum.
+        function onArchiveLoaded(status) {
+            archiveStatusLabel.text = status
         }
 
         /// @brief Aktualizuje indeks jakości powietrza.
@@ -702,13 +1451,14 @@ ApplicationWindow {
         /// @brief Aktualizuje wyniki analizy pomiarów.
         function onAnalysisUpdateRequested(analysis) {
             if (analysis.error) {
-                analysisLabel.text = analysis.error
+                analysisText = analysis.error
             } else {
-                analysisLabel.text = `Średnia: ${analysis.average}\n` +
+                analysisText = `Średnia: ${analysis.average}\n` +
                                      `Mediana: ${analysis.median}\n` +
                                      `Min: ${analysis.min}\n` +
                                      `Max: ${analysis.max}\n` +
-                                     `Liczba pomiarów: ${analysis.count}`
+                                     `Liczba pomiarów: ${analysis.count}\n` +
+                                     `Anomalie: ${analysis.anomalies}`
             }
         }
     }
@@ -1,28 +1,185 @@
 #include "mainwindow.h"
+#include "startuptrace.h"
 #include <QDebug>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <QtConcurrent>
+#include <QRegularExpression>
+#include <QUrl>
 
 /**
  * @brief Konstruktor klasy MainWindow.
  *
- * Inicjalizuje menedżera sieciowego i pobiera dane o stacjach z API.
+ * Inicjalizuje menedżera sieciowego i pobiera dane o stacjach z API. W trybie odroczonym
+ * lista stacji jest wypełniana z pamięci podręcznej, a reszta czeka na warmUp().
  * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ * @param deferredStartup True, aby odłożyć wczytanie danych lokalnych i zapytania do API.
  */
-MainWindow::MainWindow(QObject *parent)
+MainWindow::MainWindow(QObject *parent, bool deferredStartup)
     : QObject(parent)
 {
     networkManager = new QNetworkAccessManager(this);
+    api = new ApiClient(networkManager, this);
+    connect(api, &ApiClient::circuitChanged, this, [this](bool open) {
+        qDebug() << "API circuit breaker" << (open ? "opened" : "closed");
+        emit apiStatusUpdated(open ? QString("API nie odpowiada - ponowna próba za chwilę") : QString());
+    });
+    correlationModel = new CorrelationMatrixModel(this);
+    stationModel = new StationListModel(this);
+    stationProxy = new StationFilterProxyModel(this);
+    stationProxy->setSourceModel(stationModel);
+    sensorModel = new SensorListModel(this);
+    correlationWatcher = new QFutureWatcher<CorrelationEngine::Result>(this);
+    connect(correlationWatcher, &QFutureWatcher<CorrelationEngine::Result>::finished, this, [this]() {
+        correlationModel->setMatrix(correlationLabels, correlationWatcher->result(), correlationMethod);
+        emit correlationUpdateRequested(QString("Macierz %1x%1 gotowa").arg(correlationLabels.size()));
+    });
+    scheduler = new PollingScheduler(this);
+    connect(scheduler, &PollingScheduler::fetchRequested, this, [this](PollingScheduler::Kind kind, int id) {
+        if (kind == PollingScheduler::Measurements) {
+            fetchMeasurements(id, true);
+        } else {
+            fetchAirQualityIndex(id, true);
+        }
+    });
+    connect(scheduler, &PollingScheduler::statusChanged, this, [this](int issued, int tracked) {
+        emit pollingStatusUpdated(QString("Odświeżanie w tle: %1 zapytań, %2 śledzonych").arg(issued).arg(tracked));
+    });
+    prefetcher = new Prefetcher(this);
+    connect(prefetcher, &Prefetcher::prefetchRequested, this, [this](Prefetcher::Kind kind, int id) {
+        if (kind == Prefetcher::Sensors) {
+            fetchSensors(id, true);
+        } else if (kind == Prefetcher::Measurements) {
+            fetchMeasurements(id, true, true);
+        } else {
+            fetchAirQualityIndex(id, true, true);
+        }
+    });
+    complianceWatcher = new QFutureWatcher<QVector<RegulatoryMetrics::SensorReport>>(this);
+    connect(complianceWatcher, &QFutureWatcher<QVector<RegulatoryMetrics::SensorReport>>::finished, this, [this]() {
+        emit complianceReportUpdateRequested(complianceRows(complianceWatcher->result()));
+    });
+    forecastRefreshWatcher = new QFutureWatcher<QHash<int, Forecaster::State>>(this);
+    connect(forecastRefreshWatcher, &QFutureWatcher<QHash<int, Forecaster::State>>::finished, this, [this]() {
+        const QHash<int, Forecaster::State> states = forecastRefreshWatcher->result();
+        for (auto it = states.constBegin(); it != states.constEnd(); ++it) {
+            Forecaster::State state = it.value();
+            Forecaster::updateWithSeries(state, seriesCache.value(it.key()));
+            forecastStates.insert(it.key(), state);
+        }
+        emitCurrentForecast();
+    });
+    archiveWatcher = new QFutureWatcher<HistoryArchive>(this);
+    connect(archiveWatcher, &QFutureWatcher<HistoryArchive>::finished, this, [this]() {
+        archive = archiveWatcher->result();
+        archiveReady = true;
+        queryEngine.setArchive(archive);
+        if (localApi) localApi->publishArchive(archive);
+        const HistoryArchive::LoadStats stats = archive.loadStats();
+        emit archiveLoaded(QString("Archiwum: %1 plików (%2 MB) w %3 ms, %4 serii, %5 punktów, %6 stacji")
+                               .arg(stats.files)
+                               .arg(stats.bytes / 1048576.0, 0, 'f', 1)
+                               .arg(stats.elapsedMs, 0, 'f', 0)
+                               .arg(archive.seriesCount())
+                               .arg(archive.pointCount())
+                               .arg(archive.stations().size()));
+    });
+    ingestor = new LocalIngestor(this);
+    connect(ingestor, &LocalIngestor::readingsReady, this, &MainWindow::onLocalReadings);
+    localStoragePool.setMaxThreadCount(1);
+    localFlushTimer = new QTimer(this);
+    localFlushTimer->setInterval(LOCAL_FLUSH_MS);
+    connect(localFlushTimer, &QTimer::timeout, this, &MainWindow::flushLocalReadings);
+    if (deferredStartup) {
+        loadCachedStations();
+    } else {
+        warmUp();
+    }
+}
+
+/**
+ * @brief Wczytuje listę obserwowanych czujników i pobiera katalog stacji z API.
+ */
+void MainWindow::warmUp()
+{
+    loadWatchList();
+    loadPrefetchProfile();
     fetchStations();
 }
 
+/**
+ * @brief Zmienia adres bazowy API.
+ * @param url Adres bazowy zakończony ukośnikiem.
+ */
+void MainWindow::setApiBaseUrl(const QString& url)
+{
+    apiBaseUrl = url;
+}
+
+/**
+ * @brief Wypełnia katalog i listę stacji z pamięci podręcznej (bez zapytania do API).
+ * @return True, jeśli wczytano stacje.
+ */
+bool MainWindow::loadCachedStations()
+{
+    QString filePath = getStationsCachePath();
+    if (!QFile::exists(filePath)) return false;
+
+    QJsonDocument jsonDoc = loadJsonFromFile(filePath);
+    if (!jsonDoc.isArray() || jsonDoc.array().isEmpty()) return false;
+
+    catalog.setStations(jsonDoc.array());
+    countUiUpdate("stationListModel", stationModel->setStations(catalog.stationRecords()));
+    if (localApi) localApi->publishStations(catalog.stationRecords());
+    StartupTrace::mark("catalog ready");
+    return true;
+}
+
 /**
  * @brief Destruktor klasy MainWindow.
  *
- * Zwalnia zasoby (menedżer sieciowy zwalniany automatycznie jako dziecko QObject).
+ * Zatrzymuje odbiór odczytów lokalnych i czeka na zapis pozostałych; pozostałe zasoby
+ * (np. menedżer sieciowy) są zwalniane automatycznie jako dzieci QObject.
  */
 MainWindow::~MainWindow()
 {
+    ingestor->stop();
+    ingestor->disconnect(this);
+    flushLocalReadings();
+    localStoragePool.waitForDone();
+    savePrefetchProfile();
+}
+
+/**
+ * @brief Zwraca model macierzy korelacji udostępniany w QML.
+ * @return Wskaźnik na model (własność obiektu MainWindow).
+ */
+CorrelationMatrixModel* MainWindow::correlationMatrixModel() const
+{
+    return correlationModel;
+}
+
+/**
+ * @brief Zwraca przefiltrowany model listy stacji udostępniany w QML.
+ * @return Wskaźnik na model pośredniczący (własność obiektu MainWindow).
+ */
+StationFilterProxyModel* MainWindow::stationListModel() const
+{
+    return stationProxy;
+}
+
+/**
+ * @brief Zwraca model listy czujników wybranej stacji udostępniany w QML.
+ * @return Wskaźnik na model (własność obiektu MainWindow).
+ */
+SensorListModel* MainWindow::sensorListModel() const
+{
+    return sensorModel;
 }
 
 /**
@@ -30,42 +187,57 @@ MainWindow::~MainWindow()
  */
 void MainWindow::fetchStations()
 {
-    QNetworkRequest request((QUrl(API_BASE_URL + API_STATIONS_ENDPOINT)));
-    QNetworkReply* reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &MainWindow::onStationsReceived);
+    QNetworkRequest request((QUrl(apiBaseUrl + API_STATIONS_ENDPOINT)));
+    ApiReply* reply = api->get(request, ApiClient::Stations);
+    connect(reply, &ApiReply::finished, this, &MainWindow::onStationsReceived);
 }
 
 /**
  * @brief Pobiera dane o czujnikach dla danej stacji z API.
  * @param stationId Identyfikator stacji.
+ * @param prefetch True dla zapytania wstępnego (bez zmiany listy czujników w interfejsie).
  */
-void MainWindow::fetchSensors(int stationId)
+void MainWindow::fetchSensors(int stationId, bool prefetch)
 {
-    QNetworkRequest request((QUrl(API_BASE_URL + API_SENSORS_ENDPOINT + QString::number(stationId))));
-    QNetworkReply* reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &MainWindow::onSensorsReceived);
+    QNetworkRequest request((QUrl(apiBaseUrl + API_SENSORS_ENDPOINT + QString::number(stationId))));
+    ApiReply* reply = api->get(request, ApiClient::Sensors);
+    reply->setProperty("stationId", stationId);
+    reply->setProperty("prefetch", prefetch);
+    connect(reply, &ApiReply::finished, this, &MainWindow::onSensorsReceived);
 }
 
 /**
  * @brief Pobiera pomiary dla danego czujnika z API.
  * @param sensorId Identyfikator czujnika.
+ * @param background True dla zapytania z harmonogramu odświeżania w tle.
+ * @param prefetch True dla zapytania wstępnego.
  */
-void MainWindow::fetchMeasurements(int sensorId)
+void MainWindow::fetchMeasurements(int sensorId, bool background, bool prefetch)
 {
-    QNetworkRequest request((QUrl(API_BASE_URL + API_MEASUREMENTS_ENDPOINT + QString::number(sensorId))));
-    QNetworkReply* reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &MainWindow::onMeasurementsReceived);
+    QNetworkRequest request((QUrl(apiBaseUrl + API_MEASUREMENTS_ENDPOINT + QString::number(sensorId))));
+    ApiReply* reply = api->get(request, ApiClient::Measurements);
+    reply->setProperty("sensorId", sensorId);
+    reply->setProperty("background", background);
+    reply->setProperty("prefetch", prefetch);
+    scheduler->noteRequested(PollingScheduler::Measurements, sensorId);
+    connect(reply, &ApiReply::finished, this, &MainWindow::onMeasurementsReceived);
 }
 
 /**
  * @brief Pobiera indeks jakości powietrza dla danej stacji z API.
  * @param stationId Identyfikator stacji.
+ * @param background True dla zapytania z harmonogramu odświeżania w tle.
+ * @param prefetch True dla zapytania wstępnego.
  */
-void MainWindow::fetchAirQualityIndex(int stationId)
+void MainWindow::fetchAirQualityIndex(int stationId, bool background, bool prefetch)
 {
-    QNetworkRequest request((QUrl(API_BASE_URL + API_AIR_QUALITY_ENDPOINT + QString::number(stationId))));
-    QNetworkReply* reply = networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &MainWindow::onAirQualityIndexReceived);
+    QNetworkRequest request((QUrl(apiBaseUrl + API_AIR_QUALITY_ENDPOINT + QString::number(stationId))));
+    ApiReply* reply = api->get(request, ApiClient::AirQualityIndex);
+    reply->setProperty("stationId", stationId);
+    reply->setProperty("background", background);
+    reply->setProperty("prefetch", prefetch);
+    scheduler->noteRequested(PollingScheduler::AirQualityIndex, stationId);
+    connect(reply, &ApiReply::finished, this, &MainWindow::onAirQualityIndexReceived);
 }
 
 /**
@@ -73,7 +245,7 @@ void MainWindow::fetchAirQualityIndex(int stationId)
  */
 void MainWindow::onStationsReceived()
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    ApiReply* reply = qobject_cast<ApiReply*>(sender());
     if (!reply) return;
 
     if (reply->error() == QNetworkReply::NoError) {
@@ -83,18 +255,14 @@ void MainWindow::onStationsReceived()
             if (jsonDoc.isNull() || !jsonDoc.isArray()) {
                 throw std::runtime_error("Invalid JSON array for stations");
             }
-            allStations = jsonDoc.array();
-
-            for (const QJsonValue& value : allStations) {
-                QJsonObject station = value.toObject();
-                int id = station["id"].toInt();
-                stationsMap[id] = station;
-            }
-
-            displayStations(allStations);
+            catalog.setStations(jsonDoc.array());
+            countUiUpdate("stationListModel", stationModel->setStations(catalog.stationRecords()));
+            if (localApi) localApi->publishStations(catalog.stationRecords());
+            StartupTrace::mark("catalog ready");
+            StartupTrace::mark("catalog from network");
+            saveJsonToFile(getStationsCachePath(), jsonDoc);
         } catch (const std::exception& e) {
             qDebug() << "Exception while parsing stations JSON:" << e.what();
-            emit stationsUpdateRequested(QVariantList());
         }
     } else {
         qDebug() << "Error fetching stations:" << reply->errorString();
@@ -107,9 +275,11 @@ void MainWindow::onStationsReceived()
  */
 void MainWindow::onSensorsReceived()
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    ApiReply* reply = qobject_cast<ApiReply*>(sender());
     if (!reply) return;
 
+    const int stationId = reply->property("stationId").toInt();
+    const bool prefetch = reply->property("prefetch").toBool();
     if (reply->error() == QNetworkReply::NoError) {
         QByteArray response = reply->readAll();
         try {
@@ -119,31 +289,38 @@ void MainWindow::onSensorsReceived()
             }
             QJsonArray sensors = jsonDoc.array();
 
-            QVariantList sensorsList;
+            QVector<SensorRecord> records;
+            records.reserve(sensors.size());
 
+            QVector<int> dashboardSensors;
+            QVector<QPair<int, QString>> prefetchSensors;
             for (const QJsonValue& value : sensors) {
                 QJsonObject sensor = value.toObject();
-                int id = sensor["id"].toInt();
-                QString parameterName = sensor["param"].toObject()["paramName"].toString();
-                QString parameterFormula = sensor["param"].toObject()["paramFormula"].toString();
-                QString text = QString("%1 (%2)").arg(parameterName, parameterFormula);
-
-                QVariantMap sensorMap;
-                sensorMap["display"] = text;
-                sensorMap["sensorId"] = id;
-                sensorsList.append(sensorMap);
-
-                sensorsMap[id] = sensor;
+                catalog.addSensor(sensor);
+                records.append(catalog.sensorRecord(sensor["id"].toInt()));
+                prefetchSensors.append({ sensor["id"].toInt(), records.last().paramCode });
+                if (sensor["stationId"].toInt() == dashboardStationId) dashboardSensors.append(sensor["id"].toInt());
             }
+            prefetcher->noteSensors(stationId, prefetchSensors);
+            prefetcher->reportFetched(Prefetcher::Sensors, stationId, response.size(), prefetch);
 
-            emit sensorsUpdateRequested(sensorsList);
+            // Odpowiedź wstępna lub spóźniona dla poprzednio wybranej stacji nie zmienia listy czujników.
+            if (stationId == currentStationId) {
+                countUiUpdate("sensorListModel", sensorModel->setSensors(records));
+            }
+            startDashboard(dashboardSensors);
         } catch (const std::exception& e) {
             qDebug() << "Exception while parsing sensors JSON:" << e.what();
-            emit sensorsUpdateRequested(QVariantList());
+            prefetcher->reportFailure(Prefetcher::Sensors, stationId, prefetch);
+            if (stationId == currentStationId) {
+                countUiUpdate("sensorListModel", sensorModel->setSensors(QVector<SensorRecord>()));
+            }
         }
     } else {
         qDebug() << "Error fetching sensors:" << reply->errorString();
+        prefetcher->reportFailure(Prefetcher::Sensors, stationId, prefetch);
     }
+    resolvePendingCorrelationStation(stationId);
     reply->deleteLater();
 }
 
@@ -152,7 +329,7 @@ void MainWindow::onSensorsReceived()
  */
 void MainWindow::onMeasurementsReceived()
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    ApiReply* reply = qobject_cast<ApiReply*>(sender());
     if (!reply) return;
 
     if (reply->error() == QNetworkReply::NoError) {
@@ -167,30 +344,62 @@ void MainWindow::onMeasurementsReceived()
             QString key = measurements["key"].toString();
             QJsonArray values = measurements["values"].toArray();
 
-            QVariantList valuesList;
-
-            for (const QJsonValue& value : values) {
-                QJsonObject measurement = value.toObject();
-                QString dateStr = measurement["date"].toString();
-                QVariant valueVariant = measurement["value"].toVariant();
-
-                QVariantMap point;
-                point["date"] = dateStr;
-                point["value"] = valueVariant.isNull() ? QVariant() : valueVariant.toDouble();
-                valuesList.append(point);
+            int sensorId = reply->property("sensorId").toInt();
+            SyncEngine::Delta delta = syncMeasurements(sensorId, MeasurementSeries::fromJsonArray(key, values));
+            prefetcher->reportFetched(Prefetcher::Measurements, sensorId, response.size(),
+                                      reply->property("prefetch").toBool());
+            bool advanced = scheduler->reportResult(PollingScheduler::Measurements, sensorId,
+                                                    seriesCache[sensorId].newestValidTimestamp());
+            if (!delta.isEmpty()) {
+                detectAnomalies(sensorId, delta.changed().timestamps.first());
+                updateForecast(sensorId);
+            }
+            resolvePendingCorrelation(sensorId);
+            dashboardRequests.remove(sensorId);
+            dashboardErrors.remove(sensorId);
+            updateDashboard(sensorId);
+            if (overlaySensors.contains(sensorId) && !delta.isEmpty()) {
+                emit overlaySeriesUpdated(sensorId, seriesToVariantList(delta.changed()));
+                countUiUpdate("overlaySeriesUpdated", delta.added.size() + delta.corrected.size());
             }
 
-            currentMeasurementKey = key;
-            currentMeasurements = valuesList;
+            bool background = reply->property("background").toBool();
+            if (sensorId != currentSensorId || (background && (!advanced || usingHistoricalData))) {
+                reply->deleteLater();
+                return;
+            }
 
+            if (chartSensorId == sensorId) {
+                showDelta(sensorId, delta);
+            } else {
+                showSeries(sensorId, seriesCache[sensorId].key);
+            }
+            noteChartShown(sensorId);
             emit historicalDataAvailableChanged(hasHistoricalData(currentStationId, currentSensorId));
-            emit measurementsUpdateRequested(key, valuesList);
         } catch (const std::exception& e) {
             qDebug() << "Exception while parsing measurements JSON:" << e.what();
-            emit measurementsUpdateRequested("Error", QVariantList());
+            int sensorId = reply->property("sensorId").toInt();
+            scheduler->reportFailure(PollingScheduler::Measurements, sensorId);
+            prefetcher->reportFailure(Prefetcher::Measurements, sensorId, reply->property("prefetch").toBool());
+            resolvePendingCorrelation(sensorId);
+            if (dashboardRequests.remove(sensorId)) dashboardErrors.insert(sensorId, "Błędne dane z API");
+            updateDashboard(sensorId);
+            if (!reply->property("background").toBool() && sensorId == currentSensorId) {
+                emit measurementsUpdateRequested("Error", QVariantList());
+                shownAnomalies.clear();
+            }
         }
     } else {
         qDebug() << "Error fetching measurements:" << reply->errorString();
+        int sensorId = reply->property("sensorId").toInt();
+        scheduler->reportFailure(PollingScheduler::Measurements, sensorId);
+        prefetcher->reportFailure(Prefetcher::Measurements, sensorId, reply->property("prefetch").toBool());
+        resolvePendingCorrelation(sensorId);
+        if (dashboardRequests.remove(sensorId)) dashboardErrors.insert(sensorId, "Brak połączenia z API");
+        updateDashboard(sensorId);
+        if (!reply->property("background").toBool() && sensorId == chartSensorId && sensorId == currentSensorId) {
+            emit measurementsAppended(seriesCache[sensorId].key + " (dane lokalne, brak połączenia z API)", QVariantList());
+        }
     }
     reply->deleteLater();
 }
@@ -200,7 +409,7 @@ void MainWindow::onMeasurementsReceived()
  */
 void MainWindow::onAirQualityIndexReceived()
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    ApiReply* reply = qobject_cast<ApiReply*>(sender());
     if (!reply) return;
 
     if (reply->error() == QNetworkReply::NoError) {
@@ -212,55 +421,122 @@ void MainWindow::onAirQualityIndexReceived()
             }
             QJsonObject airQuality = jsonDoc.object();
 
-            currentAirQuality = airQuality;
-
-            QString indexLevelName = airQuality["stIndexLevel"].toObject()["indexLevelName"].toString();
-            QString calcDate = airQuality["stCalcDate"].toString();
-
-            QString text = QString("Indeks jakości powietrza: %1 (dane z: %2)")
-                               .arg(indexLevelName)
-                               .arg(QDateTime::fromString(calcDate, Qt::ISODate).toString("dd.MM.yyyy HH:mm"));
-
-            QString color;
-            if (indexLevelName == "Bardzo dobry" || indexLevelName == "Dobry") {
-                color = "green";
-            } else if (indexLevelName == "Umiarkowany") {
-                color = "orange";
-            } else {
-                color = "red";
+            int stationId = reply->property("stationId").toInt();
+            int level = airQuality["stIndexLevel"].toObject()["id"].toInt(-1);
+            emit stationLevelUpdated(stationId, level);
+            airQualityCache.insert(stationId, airQuality);
+            if (localApi) localApi->publishAirQuality(stationId, airQuality);
+            prefetcher->reportFetched(Prefetcher::AirQualityIndex, stationId, response.size(),
+                                      reply->property("prefetch").toBool());
+
+            bool advanced = scheduler->reportResult(PollingScheduler::AirQualityIndex, stationId,
+                                                    MeasurementSeries::parseTimestamp(airQuality["stCalcDate"].toString()));
+            bool background = reply->property("background").toBool();
+            if (stationId == currentStationId && !(background && (!advanced || usingHistoricalData))) {
+                showAirQuality(airQuality);
             }
-
-            emit historicalDataAvailableChanged(hasHistoricalData(currentStationId));
-            emit airQualityUpdateRequested(text, color);
         } catch (const std::exception& e) {
             qDebug() << "Exception while parsing air quality JSON:" << e.what();
-            emit airQualityUpdateRequested("Błąd ładowania danych", "red");
+            scheduler->reportFailure(PollingScheduler::AirQualityIndex, reply->property("stationId").toInt());
+            prefetcher->reportFailure(Prefetcher::AirQualityIndex, reply->property("stationId").toInt(),
+                                      reply->property("prefetch").toBool());
+            if (!reply->property("background").toBool()) {
+                emit airQualityUpdateRequested("Błąd ładowania danych", "red");
+            }
         }
     } else {
         qDebug() << "Error fetching air quality index:" << reply->errorString();
+        scheduler->reportFailure(PollingScheduler::AirQualityIndex, reply->property("stationId").toInt());
+        prefetcher->reportFailure(Prefetcher::AirQualityIndex, reply->property("stationId").toInt(),
+                                  reply->property("prefetch").toBool());
     }
     reply->deleteLater();
 }
 
+/**
+ * @brief Wyświetla indeks jakości powietrza bieżącej stacji.
+ * @param airQuality Obiekt JSON indeksu w formacie API.
+ */
+void MainWindow::showAirQuality(const QJsonObject& airQuality)
+{
+    currentAirQuality = airQuality;
+
+    QString indexLevelName = airQuality["stIndexLevel"].toObject()["indexLevelName"].toString();
+    QString calcDate = airQuality["stCalcDate"].toString();
+
+    QString text = QString("Indeks jakości powietrza: %1 (dane z: %2)")
+                       .arg(indexLevelName)
+                       .arg(QDateTime::fromString(calcDate, Qt::ISODate).toString("dd.MM.yyyy HH:mm"));
+
+    QString color;
+    if (indexLevelName == "Bardzo dobry" || indexLevelName == "Dobry") {
+        color = "green";
+    } else if (indexLevelName == "Umiarkowany") {
+        color = "orange";
+    } else {
+        color = "red";
+    }
+
+    emit historicalDataAvailableChanged(hasHistoricalData(currentStationId));
+    emit airQualityUpdateRequested(text, color);
+}
+
 /**
  * @brief Obsługuje wybór stacji przez użytkownika.
  * @param stationId Identyfikator wybranej stacji.
  */
 void MainWindow::stationSelected(int stationId)
 {
-    if (!stationsMap.contains(stationId)) return;
+    if (!catalog.containsStation(stationId)) return;
 
     currentStationId = stationId;
+    usingHistoricalData = false;
+    chartSensorId = -1;
+    scheduler->setSelected(PollingScheduler::AirQualityIndex, stationId);
+    scheduler->setSelected(PollingScheduler::Measurements, -1);
 
-    QJsonObject station = stationsMap[stationId];
-    QString info = generateStationInfo(station);
+    QString info = generateStationInfo(stationId);
     emit stationInfoUpdateRequested(info);
-    fetchSensors(stationId);
-    fetchAirQualityIndex(stationId);
+    prefetcher->noteStationSelected(stationId);
+
+    // Dane pobrane niedawno (wstępnie lub przy poprzedniej wizycie) są pokazywane bez zapytania.
+    const QVector<int> stationSensors = catalog.sensorsOfStation(stationId);
+    if (prefetcher->consume(Prefetcher::Sensors, stationId) && !stationSensors.isEmpty()) {
+        QVector<SensorRecord> records;
+        records.reserve(stationSensors.size());
+        for (int sensorId : stationSensors) records.append(catalog.sensorRecord(sensorId));
+        countUiUpdate("sensorListModel", sensorModel->setSensors(records));
+    } else {
+        fetchSensors(stationId);
+    }
+    if (prefetcher->consume(Prefetcher::AirQualityIndex, stationId) && airQualityCache.contains(stationId)) {
+        showAirQuality(airQualityCache.value(stationId));
+    } else {
+        fetchAirQualityIndex(stationId);
+    }
+    updatePrefetchContext(stationId);
+
+    dashboardStationId = stationId;
+    dashboardRequests.clear();
+    dashboardReady.clear();
+    dashboardErrors.clear();
+    dashboardTimer.start();
+    emit dashboardReset(stationId, stationSensors.size());
+    startDashboard(stationSensors);
 
     emit historicalDataAvailableChanged(hasHistoricalData(stationId));
 }
 
+/**
+ * @brief Zwraca podstawowe dane stacji (pola jak w roli station modelu listy).
+ * @param stationId Identyfikator stacji.
+ * @return Mapa z danymi stacji lub pusta mapa.
+ */
+QVariantMap MainWindow::stationData(int stationId) const
+{
+    return stationModel->stationMap(stationModel->rowOf(stationId));
+}
+
 /**
  * @brief Obsługuje wybór czujnika przez użytkownika.
  * @param sensorId Identyfikator wybranego czujnika.
@@ -269,7 +545,34 @@ void MainWindow::sensorSelected(int sensorId)
 {
     if (sensorId > 0) {
         currentSensorId = sensorId;
-        fetchMeasurements(sensorId);
+        scheduler->setSelected(PollingScheduler::Measurements, sensorId);
+        prefetcher->noteSensorSelected(catalog.sensorParamCode(sensorId));
+        chartClock.start();
+        chartClockSensor = sensorId;
+        const bool fresh = prefetcher->consume(Prefetcher::Measurements, sensorId);
+
+        MeasurementSeries stored = loadStoredSeries(currentStationId, sensorId);
+        seriesCache[sensorId] = MeasurementSeries::merged(stored, seriesCache.value(sensorId));
+        publishSeries(currentStationId, sensorId);
+        if (seriesCache[sensorId].isEmpty()) {
+            seriesCache.remove(sensorId);
+            chartSensorId = -1;
+        } else if (fresh && !dashboardRequests.contains(sensorId)) {
+            // Seria w pamięci jest aktualna (pobrana wstępnie lub niedawno) - bez ponownego zapytania.
+            detectAnomalies(sensorId);
+            updateForecast(sensorId);
+            showSeries(sensorId, seriesCache[sensorId].key);
+            noteChartShown(sensorId);
+            emit historicalDataAvailableChanged(hasHistoricalData(currentStationId, sensorId));
+            return;
+        } else {
+            detectAnomalies(sensorId);
+            updateForecast(sensorId);
+            showSeries(sensorId, seriesCache[sensorId].key + " (dane lokalne, aktualizacja...)");
+        }
+        if (!dashboardRequests.contains(sensorId)) {
+            fetchMeasurements(sensorId);
+        }
 
         emit historicalDataAvailableChanged(hasHistoricalData(currentStationId, sensorId));
     }
@@ -277,25 +580,14 @@ void MainWindow::sensorSelected(int sensorId)
 
 /**
  * @brief Filtruje stacje na podstawie tekstu wyszukiwania.
+ *
+ * Filtrowanie odbywa się w modelu pośredniczącym, który emituje wyłącznie zmiany wierszy.
  * @param searchText Tekst wyszukiwania (nazwa miejscowości).
  */
 void MainWindow::searchStations(const QString& searchText)
 {
-    if (searchText.isEmpty()) {
-        displayStations(allStations);
-        return;
-    }
-
-    QJsonArray filteredStations;
-    for (const QJsonValue& value : allStations) {
-        QJsonObject station = value.toObject();
-        QString cityName = station["city"].toObject()["name"].toString().toLower();
-        if (cityName.contains(searchText.toLower())) {
-            filteredStations.append(station);
-        }
-    }
-
-    displayStations(filteredStations);
+    prefetcher->noteUserActivity();
+    stationProxy->setFilterText(searchText);
 }
 
 /**
@@ -303,54 +595,28 @@ void MainWindow::searchStations(const QString& searchText)
  */
 void MainWindow::showAllStations()
 {
-    displayStations(allStations);
-}
-
-/**
- * @brief Przygotowuje listę stacji do wyświetlenia w interfejsie.
- * @param stations Tablica JSON z danymi stacji.
- */
-void MainWindow::displayStations(const QJsonArray& stations)
-{
-    QVariantList stationsList;
-
-    for (const QJsonValue& value : stations) {
-        QJsonObject station = value.toObject();
-        int id = station["id"].toInt();
-        QString stationName = station["stationName"].toString();
-        QString cityName = station["city"].toObject()["name"].toString();
-
-        QString displayText = QString("%1 - %2").arg(cityName, stationName);
-
-        QVariantMap stationMap;
-        stationMap["display"] = displayText;
-        stationMap["stationId"] = id;
-        stationMap["station"] = station.toVariantMap();
-        stationsList.append(stationMap);
-    }
-
-    emit stationsUpdateRequested(stationsList);
+    stationProxy->setFilterText(QString());
 }
 
 /**
  * @brief Generuje informacje o stacji w formacie HTML.
- * @param station Obiekt JSON z danymi stacji.
+ * @param stationId Identyfikator stacji w katalogu.
  * @return Tekst HTML z informacjami o stacji.
  */
-QString MainWindow::generateStationInfo(const QJsonObject& station)
+QString MainWindow::generateStationInfo(int stationId)
 {
-    QString stationName = station["stationName"].toString();
-    QJsonObject city = station["city"].toObject();
-    QString cityName = city["name"].toString();
-    QString street = station["addressStreet"].toString();
+    const int row = catalog.stationRow(stationId);
+    StationRecord station = catalog.stationRecord(row);
+    QString stationName = station.name;
+    QString cityName = station.city;
+    QString street = station.street;
 
-    QJsonObject commune = city["commune"].toObject();
-    QString communeName = commune["communeName"].toString();
-    QString districtName = commune["districtName"].toString();
-    QString provinceName = commune["provinceName"].toString();
+    QString communeName = catalog.commune(row);
+    QString districtName = catalog.district(row);
+    QString provinceName = station.province;
 
-    double lat = station["gegrLat"].toString().toDouble();
-    double lon = station["gegrLon"].toString().toDouble();
+    double lat = station.latitude;
+    double lon = station.longitude;
 
     QString info = QString("<h3>%1</h3>").arg(stationName) +
                    QString("<p><b>Miasto:</b> %1</p>").arg(cityName) +
@@ -399,6 +665,20 @@ QString MainWindow::getMeasurementsFilePath(int stationId, int sensorId)
         .arg(sensorId);
 }
 
+/**
+ * @brief Generuje ścieżkę do dziennika przyrostowych zmian pomiarów.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ * @return Ścieżka do pliku JSON Lines z dopisywanymi pomiarami.
+ */
+QString MainWindow::getMeasurementsJournalPath(int stationId, int sensorId)
+{
+    return QString("%1/measurements_station%2_sensor%3.jsonl")
+    .arg(getDatabasePath())
+        .arg(stationId)
+        .arg(sensorId);
+}
+
 /**
  * @brief Generuje ścieżkę do pliku z indeksem jakości powietrza.
  * @param stationId Identyfikator stacji.
@@ -411,6 +691,15 @@ QString MainWindow::getAirQualityFilePath(int stationId)
         .arg(stationId);
 }
 
+/**
+ * @brief Zwraca ścieżkę do pamięci podręcznej katalogu stacji.
+ * @return Ścieżka do pliku JSON z ostatnią odpowiedzią station/findAll.
+ */
+QString MainWindow::getStationsCachePath()
+{
+    return getDatabasePath() + "/stations.json";
+}
+
 /**
  * @brief Zapisuje dokument JSON do pliku.
  * @param filePath Ścieżka do pliku.
@@ -463,6 +752,9 @@ QJsonDocument MainWindow::loadJsonFromFile(const QString& filePath)
 
 /**
  * @brief Zapisuje bieżące pomiary do lokalnej bazy danych.
+ *
+ * Pomiary są już dopisywane do dziennika przy każdej synchronizacji; zapis ręczny scala
+ * historię, dziennik i bieżącą serię w jeden plik główny.
  */
 void MainWindow::saveMeasurementsToDatabase()
 {
@@ -471,30 +763,93 @@ void MainWindow::saveMeasurementsToDatabase()
         return;
     }
 
+    MeasurementSeries series = MeasurementSeries::merged(loadStoredSeries(currentStationId, currentSensorId),
+                                                         MeasurementSeries::fromVariantList(currentMeasurementKey, currentMeasurements));
+    if (writeMeasurementsSnapshot(currentStationId, currentSensorId, series)) {
+        queryEngine.addPoints(currentStationId, currentSensorId, catalog.sensorParamCode(currentSensorId), series);
+        emit historicalDataAvailableChanged(true);
+    }
+}
+
+/**
+ * @brief Zapisuje pełną serię do pliku głównego i usuwa dziennik czujnika.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ * @param series Pełna seria (historia wraz z dziennikiem).
+ * @return True, jeśli zapis się powiódł.
+ */
+bool MainWindow::writeMeasurementsSnapshot(int stationId, int sensorId, const MeasurementSeries& series)
+{
     QJsonObject data;
-    data["stationId"] = currentStationId;
-    data["sensorId"] = currentSensorId;
-    data["key"] = currentMeasurementKey;
+    data["stationId"] = stationId;
+    data["sensorId"] = sensorId;
+    data["key"] = series.key;
     data["saveDate"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
     QJsonArray measurementsArray;
-    for (const QVariant& measurement : currentMeasurements) {
+    for (const QVariant& measurement : seriesToVariantList(series)) {
         QVariantMap map = measurement.toMap();
         QJsonObject obj;
         obj["date"] = map["date"].toString();
-        obj["value"] = map["value"].toDouble();
+        obj["value"] = map["value"].isNull() ? QJsonValue() : QJsonValue(map["value"].toDouble());
         measurementsArray.append(obj);
     }
 
     data["measurements"] = measurementsArray;
 
     QJsonDocument jsonDoc(data);
-    QString filePath = getMeasurementsFilePath(currentStationId, currentSensorId);
+    QString filePath = getMeasurementsFilePath(stationId, sensorId);
 
-    if (saveJsonToFile(filePath, jsonDoc)) {
-        qDebug() << "Measurements saved to:" << filePath;
-        emit historicalDataAvailableChanged(true);
+    if (!saveJsonToFile(filePath, jsonDoc)) return false;
+    qDebug() << "Measurements saved to:" << filePath;
+    QFile::remove(getMeasurementsJournalPath(stationId, sensorId));
+    return true;
+}
+
+/**
+ * @brief Dopisuje punkty do dziennika pomiarów czujnika.
+ *
+ * Dziennik jest scalany z plikiem głównym, gdy przekroczy JOURNAL_COMPACT_BYTES i połowę
+ * rozmiaru pliku głównego. Plik główny rośnie wtedy między scaleniami co najmniej o połowę,
+ * więc łączny koszt przepisywania historii jest liniowy względem liczby zapisanych punktów
+ * (a nie kwadratowy, jak przy scalaniu po stałym rozmiarze dziennika).
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ * @param points Dopisywane punkty.
+ * @return True, jeśli zapis się powiódł.
+ */
+bool MainWindow::appendMeasurementsToDatabase(int stationId, int sensorId, const MeasurementSeries& points)
+{
+    QString filePath = getMeasurementsJournalPath(stationId, sensorId);
+    try {
+        QFile file(filePath);
+        const bool created = !file.exists();
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            throw std::runtime_error("Failed to open file for appending: " + filePath.toStdString());
+        }
+
+        QByteArray lines;
+        if (created) {
+            QJsonObject header;
+            header["key"] = points.key;
+            lines += QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n';
+        }
+        for (const QVariant& measurement : seriesToVariantList(points)) {
+            lines += QJsonDocument(QJsonObject::fromVariantMap(measurement.toMap())).toJson(QJsonDocument::Compact) + '\n';
+        }
+        file.write(lines);
+        file.close();
+    } catch (const std::exception& e) {
+        qDebug() << "Exception while appending measurements:" << e.what();
+        return false;
+    }
+
+    syncPointsWritten += points.size();
+    const qint64 snapshotSize = QFileInfo(getMeasurementsFilePath(stationId, sensorId)).size();
+    if (QFileInfo(filePath).size() > std::max(JOURNAL_COMPACT_BYTES, snapshotSize / 2)) {
+        writeMeasurementsSnapshot(stationId, sensorId, loadStoredSeries(stationId, sensorId));
     }
+    return true;
 }
 
 /**
@@ -533,8 +888,8 @@ bool MainWindow::hasHistoricalData(int stationId, int sensorId)
         QFile file(getAirQualityFilePath(stationId));
         return file.exists();
     } else {
-        QFile file(getMeasurementsFilePath(stationId, sensorId));
-        return file.exists();
+        return QFile::exists(getMeasurementsFilePath(stationId, sensorId))
+               || QFile::exists(getMeasurementsJournalPath(stationId, sensorId));
     }
 }
 
@@ -549,24 +904,12 @@ void MainWindow::loadHistoricalMeasurements(int sensorId)
         return;
     }
 
-    QString filePath = getMeasurementsFilePath(currentStationId, sensorId);
-    QJsonDocument doc = loadJsonFromFile(filePath);
-
-    if (doc.isObject()) {
-        QJsonObject data = doc.object();
-        QString key = data["key"].toString();
-        QJsonArray measurements = data["measurements"].toArray();
-
-        QVariantList valuesList;
-        for (const QJsonValue& value : measurements) {
-            QJsonObject measurement = value.toObject();
-            QVariantMap point;
-            point["date"] = measurement["date"].toString();
-            point["value"] = measurement["value"].toDouble();
-            valuesList.append(point);
-        }
-
-        emit measurementsUpdateRequested(key + " (dane historyczne)", valuesList);
+    MeasurementSeries series = loadStoredSeries(currentStationId, sensorId);
+    if (!series.isEmpty()) {
+        chartSensorId = -1;
+        emit measurementsUpdateRequested(series.key + " (dane historyczne)", seriesToVariantList(series));
+        countUiUpdate("measurementsUpdateRequested", series.size());
+        showAnomalies(sensorId, AnomalyDetector::detect(series), false);
     }
 }
 
@@ -611,6 +954,7 @@ void MainWindow::loadHistoricalAirQuality(int stationId)
  */
 void MainWindow::toggleDataSource(bool useHistorical)
 {
+    usingHistoricalData = useHistorical;
     if (useHistorical) {
         if (currentSensorId > 0) {
             loadHistoricalMeasurements(currentSensorId);
@@ -620,6 +964,9 @@ void MainWindow::toggleDataSource(bool useHistorical)
         }
     } else {
         if (currentSensorId > 0) {
+            if (seriesCache.contains(currentSensorId)) {
+                showSeries(currentSensorId, seriesCache[currentSensorId].key + " (aktualizacja...)");
+            }
             fetchMeasurements(currentSensorId);
         }
         if (currentStationId > 0) {
@@ -679,7 +1026,1664 @@ QVariantMap MainWindow::analyzeMeasurements()
     analysis["min"] = QString::number(minValue, 'f', 2);
     analysis["max"] = QString::number(maxValue, 'f', 2);
     analysis["count"] = count;
+    analysis["anomalies"] = anomaliesMap.value(currentSensorId).size();
 
     emit analysisUpdateRequested(analysis);
     return analysis;
 }
+
+/**
+ * @brief Wykonuje w tle zapytanie analityczne po zapisanej historii czujników.
+ * @param query Zapytanie.
+ * @return Identyfikator żądania.
+ */
+int MainWindow::runQuery(const QVariantMap& query)
+{
+    return runQueries({query});
+}
+
+/**
+ * @brief Wykonuje w tle listę zapytań analitycznych.
+ *
+ * Przy pierwszym zapytaniu w tle wczytywane jest archiwum; do tego czasu wyniki obejmują
+ * tylko punkty zapisane w bieżącej sesji (complete = false). Wyniki są przekazywane
+ * sygnałem queryResultsReady().
+ * @param queries Zapytania w formacie runQuery().
+ * @return Identyfikator żądania.
+ */
+int MainWindow::runQueries(const QVariantList& queries)
+{
+    const bool complete = archiveReady;
+    if (!archiveReady) loadArchive();
+
+    QVector<QueryEngine::Query> engineQueries;
+    engineQueries.reserve(queries.size());
+    for (const QVariant& query : queries) {
+        engineQueries.append(toEngineQuery(query.toMap()));
+    }
+
+    const int requestId = ++queryRequests;
+    auto* watcher = new QFutureWatcher<QVector<QueryEngine::Result>>(this);
+    connect(watcher, &QFutureWatcher<QVector<QueryEngine::Result>>::finished, this,
+            [this, watcher, requestId, queries, engineQueries, complete]() {
+        watcher->deleteLater();
+        const QVector<QueryEngine::Result> results = watcher->result();
+        QVariantList list;
+        list.reserve(results.size());
+        for (int i = 0; i < results.size(); ++i) {
+            QStringList aggregates = queries[i].toMap().value("aggregates").toStringList();
+            if (aggregates.isEmpty()) aggregates = QStringList{"mean", "max", "count"};
+            QVariantMap map = queryResultMap(results[i], aggregates, engineQueries[i].grouping);
+            map["complete"] = complete;
+            list.append(map);
+        }
+        emit queryResultsReady(requestId, list);
+    });
+    watcher->setFuture(queryEngine.runAsync(engineQueries));
+    return requestId;
+}
+
+/**
+ * @brief Zamienia zapytanie z QML na zapytanie silnika.
+ * @param query Mapa w formacie runQuery().
+ * @return Zapytanie silnika.
+ */
+QueryEngine::Query MainWindow::toEngineQuery(const QVariantMap& query)
+{
+    QueryEngine::Query result;
+    for (const QVariant& id : query.value("stationIds").toList()) result.stationIds.append(id.toInt());
+    for (const QVariant& id : query.value("sensorIds").toList()) result.sensorIds.append(id.toInt());
+    result.paramCodes = query.value("paramCodes").toStringList();
+    if (query.contains("from")) result.from = static_cast<qint64>(query.value("from").toDouble());
+    if (query.contains("to")) result.to = static_cast<qint64>(query.value("to").toDouble());
+    result.grouping = QueryEngine::groupingFromName(query.value("groupBy").toString());
+
+    static const QRegularExpression percentilePattern("^p(\\d{1,2}(\\.\\d+)?)$");
+    for (const QString& aggregate : query.value("aggregates").toStringList()) {
+        QRegularExpressionMatch match = percentilePattern.match(aggregate);
+        if (match.hasMatch()) result.percentiles.append(match.captured(1).toDouble() / 100.0);
+    }
+    return result;
+}
+
+/**
+ * @brief Zamienia wynik zapytania na mapę dla QML.
+ * @param result Wynik silnika.
+ * @param aggregates Żądane agregaty.
+ * @param grouping Grupowanie (do opisu grup).
+ * @return Mapa w formacie runQuery().
+ */
+QVariantMap MainWindow::queryResultMap(const QueryEngine::Result& result, const QStringList& aggregates,
+                                       QueryEngine::Grouping grouping) const
+{
+    static const QStringList weekdays = {"poniedziałek", "wtorek", "środa", "czwartek", "piątek", "sobota", "niedziela"};
+    static const QStringList months = {"styczeń", "luty", "marzec", "kwiecień", "maj", "czerwiec", "lipiec",
+                                       "sierpień", "wrzesień", "październik", "listopad", "grudzień"};
+    static const QRegularExpression percentilePattern("^p(\\d{1,2}(\\.\\d+)?)$");
+
+    QVariantList rows;
+    rows.reserve(result.rows.size());
+    for (const QueryEngine::Row& row : result.rows) {
+        QVariantMap map;
+        map["paramCode"] = row.paramCode;
+        map["group"] = row.group;
+        switch (grouping) {
+        case QueryEngine::HourOfDay: map["groupLabel"] = QString("%1:00").arg(row.group, 2, 10, QChar('0')); break;
+        case QueryEngine::Weekday: map["groupLabel"] = weekdays.value(row.group); break;
+        case QueryEngine::Month: map["groupLabel"] = months.value(row.group - 1); break;
+        default: map["groupLabel"] = QString(); break;
+        }
+
+        int percentile = 0;
+        for (const QString& aggregate : aggregates) {
+            if (aggregate == "mean") map["mean"] = row.mean;
+            else if (aggregate == "min") map["min"] = row.min;
+            else if (aggregate == "max") map["max"] = row.max;
+            else if (aggregate == "count") map["count"] = row.count;
+            else if (percentilePattern.match(aggregate).hasMatch() && percentile < row.percentiles.size()) {
+                map[aggregate] = row.percentiles[percentile++];
+            }
+        }
+        rows.append(map);
+    }
+
+    QVariantMap map;
+    map["rows"] = rows;
+    map["series"] = result.series;
+    map["scannedPoints"] = result.scannedPoints;
+    map["elapsedMs"] = result.elapsedMs;
+    map["cached"] = result.cached;
+    return map;
+}
+
+/**
+ * @brief Pobiera równolegle pomiary czujników przeglądu stacji.
+ *
+ * Zapytania wysyłane są jednocześnie, więc przegląd całej stacji jest gotowy po czasie
+ * zbliżonym do jednego zapytania. Odpowiedź dla czujnika wybranego w międzyczasie
+ * przez użytkownika trafia też na wykres (sensorSelected nie powtarza zapytania).
+ * @param sensorIds Czujniki stacji przeglądu.
+ */
+void MainWindow::startDashboard(const QVector<int>& sensorIds)
+{
+    for (int sensorId : sensorIds) {
+        if (dashboardRequests.contains(sensorId) || dashboardReady.contains(sensorId)) continue;
+        if (seriesCache.contains(sensorId) && prefetcher->isFresh(Prefetcher::Measurements, sensorId)) {
+            updateDashboard(sensorId);
+            continue;
+        }
+        dashboardRequests.insert(sensorId);
+        if (seriesCache.contains(sensorId)) updateDashboard(sensorId);
+        fetchMeasurements(sensorId);
+    }
+}
+
+/**
+ * @brief Uruchamia w puli wątków obliczenie podsumowania czujnika przeglądu stacji.
+ *
+ * Wynik obliczenia uruchomionego dla starszej wersji serii lub dla poprzednio wybranej
+ * stacji jest pomijany.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::updateDashboard(int sensorId)
+{
+    if (dashboardStationId < 0 || catalog.sensorStation(sensorId) != dashboardStationId) return;
+
+    const int version = ++dashboardVersions[sensorId];
+    if (!seriesCache.contains(sensorId)) {
+        if (dashboardRequests.contains(sensorId)) return;
+        StationDashboard::Summary empty;
+        empty.sensorId = sensorId;
+        empty.paramCode = catalog.sensorParamCode(sensorId);
+        dashboardReady.insert(sensorId);
+        emit dashboardSensorUpdated(dashboardSummaryMap(empty));
+        return;
+    }
+
+    const int stationId = dashboardStationId;
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    auto* watcher = new QFutureWatcher<StationDashboard::Summary>(this);
+    connect(watcher, &QFutureWatcher<StationDashboard::Summary>::finished, this, [this, watcher, stationId, sensorId, version]() {
+        watcher->deleteLater();
+        if (stationId != dashboardStationId || dashboardVersions.value(sensorId) != version) return;
+        const StationDashboard::Summary summary = watcher->result();
+        if (!dashboardRequests.contains(sensorId)) dashboardReady.insert(sensorId);
+        emit dashboardSensorUpdated(dashboardSummaryMap(summary));
+        countUiUpdate("dashboardSensorUpdated", summary.sparkline.size());
+    });
+    watcher->setFuture(QtConcurrent::run([sensorId, series]() {
+        return StationDashboard::summarize(sensorId, series);
+    }));
+}
+
+/**
+ * @brief Zamienia podsumowanie czujnika na mapę dla interfejsu.
+ * @param summary Podsumowanie czujnika.
+ * @return Mapa w formacie sygnału dashboardSensorUpdated.
+ */
+QVariantMap MainWindow::dashboardSummaryMap(const StationDashboard::Summary& summary)
+{
+    auto number = [](double value) { return std::isnan(value) ? QVariant() : QVariant(value); };
+
+    QVariantMap map;
+    map["sensorId"] = summary.sensorId;
+    map["paramCode"] = summary.paramCode.isEmpty() ? catalog.sensorParamCode(summary.sensorId) : summary.paramCode;
+    map["paramName"] = catalog.sensorRecord(summary.sensorId).paramName;
+    map["count"] = summary.count;
+    map["latest"] = number(summary.latest);
+    map["latestDate"] = summary.latestTimestamp < 0 ? QString()
+                        : QDateTime::fromMSecsSinceEpoch(summary.latestTimestamp).toString("dd.MM HH:mm");
+    map["mean"] = number(summary.mean);
+    map["min"] = number(summary.min);
+    map["max"] = number(summary.max);
+    map["trend"] = number(summary.trendPerHour);
+    map["trendName"] = StationDashboard::trendName(summary);
+    QVariantList sparkline;
+    sparkline.reserve(summary.sparkline.size());
+    for (double value : summary.sparkline) sparkline.append(number(value));
+    map["sparkline"] = sparkline;
+    map["anomalies"] = summary.anomalies;
+    const QString error = dashboardErrors.value(summary.sensorId);
+    if (summary.count == 0) {
+        map["error"] = error.isEmpty() ? QString("Brak danych") : error;
+    } else if (!error.isEmpty()) {
+        map["warning"] = error;
+    }
+
+    map["ready"] = dashboardReady.size();
+    map["total"] = catalog.sensorsOfStation(dashboardStationId).size();
+    map["elapsedMs"] = dashboardTimer.elapsed();
+    return map;
+}
+
+/**
+ * @brief Uruchamia w tle detekcję anomalii dla serii czujnika zapisanej w pamięci podręcznej.
+ *
+ * Przeliczany jest tylko koniec serii od pierwszego zmienionego punktu (AnomalyDetector::detectFrom),
+ * a wcześniejsze anomalie są przejmowane z anomaliesMap. Dla czujnika jest co najwyżej jedno zadanie;
+ * zmiany zgłoszone w jego trakcie są łączone w jedną kolejną detekcję. Po zakończeniu anomalie
+ * wyświetlanej serii są odświeżane różnicowo.
+ * @param sensorId Identyfikator czujnika.
+ * @param changedFrom Znacznik czasu pierwszego zmienionego punktu (domyślnie cała seria).
+ */
+void MainWindow::detectAnomalies(int sensorId, qint64 changedFrom)
+{
+    if (!seriesCache.contains(sensorId)) return;
+
+    if (anomalyJobs.contains(sensorId)) {
+        auto it = anomalyRescans.find(sensorId);
+        if (it == anomalyRescans.end()) {
+            anomalyRescans.insert(sensorId, changedFrom);
+        } else {
+            it.value() = std::min(it.value(), changedFrom);
+        }
+        return;
+    }
+    // Bez poprzedniego wyniku nie ma czego przejąć - detekcja całej serii.
+    if (!anomaliesMap.contains(sensorId)) changedFrom = std::numeric_limits<qint64>::min();
+
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    const QVector<AnomalyDetector::Anomaly> previous = anomaliesMap.value(sensorId);
+    auto* watcher = new QFutureWatcher<QVector<AnomalyDetector::Anomaly>>(this);
+    anomalyJobs.insert(sensorId, watcher);
+    connect(watcher, &QFutureWatcher<QVector<AnomalyDetector::Anomaly>>::finished, this, [this, watcher, sensorId]() {
+        watcher->deleteLater();
+        anomalyJobs.remove(sensorId);
+        if (seriesCache.contains(sensorId)) {
+            anomaliesMap[sensorId] = watcher->result();
+            if (sensorId == chartSensorId) showAnomalies(sensorId, anomaliesMap.value(sensorId), true);
+        }
+        if (anomalyRescans.contains(sensorId)) detectAnomalies(sensorId, anomalyRescans.take(sensorId));
+    });
+    watcher->setFuture(QtConcurrent::run([series, previous, changedFrom]() {
+        return AnomalyDetector::detectFrom(series, previous, changedFrom);
+    }));
+}
+
+/**
+ * @brief Zamienia anomalie na listę do wyświetlenia w interfejsie.
+ * @param sensorId Identyfikator czujnika.
+ * @param anomalies Lista anomalii.
+ * @return Lista map z polami timestamp, date, value, type, sensorId i stationId.
+ */
+QVariantList MainWindow::anomaliesToVariantList(int sensorId, const QVector<AnomalyDetector::Anomaly>& anomalies)
+{
+    int stationId = catalog.sensorStation(sensorId);
+
+    QVariantList list;
+    for (const AnomalyDetector::Anomaly& anomaly : anomalies) {
+        QVariantMap point;
+        point["timestamp"] = static_cast<double>(anomaly.timestamp);
+        point["date"] = QDateTime::fromMSecsSinceEpoch(anomaly.timestamp).toString("dd.MM.yyyy HH:mm");
+        point["value"] = std::isnan(anomaly.value) ? QVariant() : QVariant(anomaly.value);
+        point["type"] = AnomalyDetector::typeName(anomaly.flags);
+        point["sensorId"] = sensorId;
+        point["stationId"] = stationId;
+        list.append(point);
+    }
+    return list;
+}
+
+/**
+ * @brief Zwraca anomalie wykryte we wszystkich pobranych seriach.
+ * @param type Rodzaj anomalii ("zscore", "mad", "flatline", "spike"); pusty dla wszystkich.
+ * @param stationId Identyfikator stacji do zawężenia wyników (domyślnie -1 dla wszystkich stacji).
+ * @return Lista anomalii posortowana malejąco po czasie.
+ */
+QVariantList MainWindow::queryAnomalies(const QString& type, int stationId)
+{
+    int mask = type.isEmpty() ? ~0 : AnomalyDetector::typeFromName(type);
+    QVector<QPair<qint64, QVariant>> matches;
+
+    for (auto it = anomaliesMap.constBegin(); it != anomaliesMap.constEnd(); ++it) {
+        int sensorStationId = catalog.sensorStation(it.key());
+        if (stationId >= 0 && sensorStationId != stationId) continue;
+
+        QVector<AnomalyDetector::Anomaly> filtered;
+        for (const AnomalyDetector::Anomaly& anomaly : it.value()) {
+            if (anomaly.flags & mask) filtered.append(anomaly);
+        }
+
+        QVariantList points = anomaliesToVariantList(it.key(), filtered);
+        for (int i = 0; i < points.size(); ++i) {
+            QVariantMap point = points[i].toMap();
+            point["key"] = seriesCache.value(it.key()).key;
+            matches.append(qMakePair(filtered[i].timestamp, QVariant(point)));
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const QPair<qint64, QVariant>& a, const QPair<qint64, QVariant>& b) {
+        return a.first > b.first;
+    });
+
+    QVariantList result;
+    for (const auto& match : matches) {
+        result.append(match.second);
+    }
+    return result;
+}
+
+/**
+ * @brief Aktualizuje przyrostowo model prognozy czujnika nowymi punktami serii.
+ *
+ * Przy pierwszym pobraniu danych model jest dopasowywany do całej serii w puli wątków
+ * (przeszukiwanie siatki), a po dopasowaniu uzupełniany o punkty dopisane w międzyczasie.
+ * Później model uwzględnia wyłącznie godziny nowsze niż ostatnio przetworzona.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::updateForecast(int sensorId)
+{
+    if (!seriesCache.contains(sensorId)) return;
+
+    auto it = forecastStates.find(sensorId);
+    if (it != forecastStates.end()) {
+        Forecaster::updateWithSeries(it.value(), seriesCache[sensorId]);
+        return;
+    }
+    if (forecastFits.contains(sensorId)) return;
+
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    auto* watcher = new QFutureWatcher<Forecaster::State>(this);
+    forecastFits.insert(sensorId, watcher);
+    connect(watcher, &QFutureWatcher<Forecaster::State>::finished, this, [this, watcher, sensorId]() {
+        watcher->deleteLater();
+        forecastFits.remove(sensorId);
+        Forecaster::State state = watcher->result();
+        if (!state.initialized || forecastStates.contains(sensorId)) return;
+        Forecaster::updateWithSeries(state, seriesCache.value(sensorId));
+        forecastStates.insert(sensorId, state);
+        if (sensorId == currentSensorId) emitCurrentForecast();
+    });
+    watcher->setFuture(QtConcurrent::run([series]() {
+        return Forecaster::fit(series);
+    }));
+}
+
+/**
+ * @brief Emituje prognozę dla bieżącego czujnika.
+ *
+ * Pierwszym punktem listy jest ostatni pomiar, aby prognoza łączyła się z serią na wykresie.
+ */
+void MainWindow::emitCurrentForecast()
+{
+    QVariantList values;
+    if (forecastStates.contains(currentSensorId)) {
+        const MeasurementSeries& series = seriesCache[currentSensorId];
+        for (int i = series.size() - 1; i >= 0; --i) {
+            if (std::isnan(series.values[i])) continue;
+            QVariantMap anchor;
+            anchor["timestamp"] = static_cast<double>(series.timestamps[i]);
+            anchor["value"] = series.values[i];
+            values.append(anchor);
+            break;
+        }
+
+        MeasurementSeries forecast = Forecaster::forecast(forecastStates[currentSensorId], forecastHorizon);
+        for (int i = 0; i < forecast.size(); ++i) {
+            QVariantMap point;
+            point["timestamp"] = static_cast<double>(forecast.timestamps[i]);
+            point["value"] = forecast.values[i];
+            values.append(point);
+        }
+    }
+    emit forecastUpdateRequested(values);
+}
+
+/**
+ * @brief Ustawia horyzont prognozy i odświeża prognozę bieżącego czujnika.
+ * @param hours Liczba godzin prognozy (6-24).
+ */
+void MainWindow::setForecastHorizon(int hours)
+{
+    forecastHorizon = std::clamp(hours, 6, 24);
+    emitCurrentForecast();
+}
+
+/**
+ * @brief Ponownie dopasowuje modele prognoz wszystkich pobranych czujników (równolegle, w tle).
+ *
+ * Modele są podmieniane po zakończeniu dopasowania i uzupełniane o punkty dopisane w międzyczasie.
+ */
+void MainWindow::refreshForecasts()
+{
+    if (forecastRefreshWatcher->isRunning()) return;
+    const QHash<int, MeasurementSeries> series = seriesCache;
+    forecastRefreshWatcher->setFuture(QtConcurrent::run([series]() {
+        return Forecaster::fitAll(series);
+    }));
+}
+
+/**
+ * @brief Zamienia typowaną serię na listę punktów w formacie interfejsu.
+ * @param series Seria pomiarowa.
+ * @return Lista map z polami "date" i "value" (null dla braków).
+ */
+QVariantList MainWindow::seriesToVariantList(const MeasurementSeries& series)
+{
+    QVariantList list;
+    list.reserve(series.size());
+    for (int i = 0; i < series.size(); ++i) {
+        QVariantMap point;
+        point["date"] = QDateTime::fromMSecsSinceEpoch(series.timestamps[i]).toString("yyyy-MM-dd HH:mm:ss");
+        point["value"] = std::isnan(series.values[i]) ? QVariant() : QVariant(series.values[i]);
+        list.append(point);
+    }
+    return list;
+}
+
+/**
+ * @brief Wczytuje zapisaną historię pomiarów czujnika z lokalnej bazy danych.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ * @return Seria pomiarowa (pusta, jeśli brak zapisanych danych).
+ */
+MeasurementSeries MainWindow::loadStoredSeries(int stationId, int sensorId)
+{
+    if (stationId < 0) return MeasurementSeries();
+    return MeasurementSeries::readStored(getMeasurementsFilePath(stationId, sensorId), getMeasurementsJournalPath(stationId, sensorId));
+}
+
+/**
+ * @brief Wyświetla całą połączoną serię czujnika wraz z anomaliami i prognozą.
+ * @param sensorId Identyfikator czujnika.
+ * @param title Tytuł wykresu (klucz parametru z ewentualnym opisem źródła).
+ */
+void MainWindow::showSeries(int sensorId, const QString& title)
+{
+    const MeasurementSeries& series = seriesCache[sensorId];
+    currentMeasurementKey = series.key;
+    currentMeasurements = seriesToVariantList(series);
+    chartSensorId = sensorId;
+
+    emit measurementsUpdateRequested(title, currentMeasurements);
+    countUiUpdate("measurementsUpdateRequested", series.size());
+    if (!series.isEmpty()) StartupTrace::mark("first chart");
+    showAnomalies(sensorId, anomaliesMap.value(sensorId), false);
+    emitCurrentForecast();
+}
+
+/**
+ * @brief Przekazuje do wykresu wyłącznie nowe i poprawione punkty serii.
+ *
+ * Bez zmian wysyłany jest tylko tytuł (zdejmuje opis "aktualizacja..."). Anomalie
+ * (jako zmiany względem wyświetlonych) i prognoza są emitowane ponownie, gdy seria się zmieniła.
+ * @param sensorId Identyfikator czujnika.
+ * @param delta Zmiany wydzielone z odpowiedzi API.
+ */
+void MainWindow::showDelta(int sensorId, const SyncEngine::Delta& delta)
+{
+    const MeasurementSeries& series = seriesCache[sensorId];
+    QVariantList added = seriesToVariantList(delta.added);
+    currentMeasurementKey = series.key;
+    upsertCurrentMeasurements(added);
+    if (!delta.corrected.isEmpty()) {
+        QVariantList corrected = seriesToVariantList(delta.corrected);
+        upsertCurrentMeasurements(corrected);
+        emit measurementsCorrected(corrected);
+        countUiUpdate("measurementsCorrected", corrected.size());
+    }
+    emit measurementsAppended(series.key, added);
+    countUiUpdate("measurementsAppended", added.size());
+
+    if (delta.isEmpty()) return;
+    showAnomalies(sensorId, anomaliesMap.value(sensorId), true);
+    emitCurrentForecast();
+}
+
+/**
+ * @brief Wstawia punkty do listy bieżących pomiarów lub zastępuje punkty o tej samej dacie.
+ *
+ * Lista jest posortowana po dacie w formacie "yyyy-MM-dd HH:mm:ss", więc miejsce punktu
+ * wyznacza wyszukiwanie binarne; punkty nowsze od ostatniego są dopisywane na końcu.
+ * @param points Punkty w formacie interfejsu.
+ */
+void MainWindow::upsertCurrentMeasurements(const QVariantList& points)
+{
+    for (const QVariant& point : points) {
+        const QString date = point.toMap().value("date").toString();
+        if (currentMeasurements.isEmpty() || currentMeasurements.last().toMap().value("date").toString() < date) {
+            currentMeasurements.append(point);
+            continue;
+        }
+        auto it = std::lower_bound(currentMeasurements.begin(), currentMeasurements.end(), date,
+                                   [](const QVariant& existing, const QString& value) {
+                                       return existing.toMap().value("date").toString() < value;
+                                   });
+        if (it != currentMeasurements.end() && it->toMap().value("date").toString() == date) {
+            *it = point;
+        } else {
+            currentMeasurements.insert(it, point);
+        }
+    }
+}
+
+/**
+ * @brief Odtwarza listę bieżących pomiarów z serii czujnika lokalnego i przycina wykres do jej początku.
+ *
+ * Seria w seriesCache jest scalana po znaczniku czasu (MeasurementSeries::append) i przycinana
+ * do okna przechowywania, więc paczki urządzeń odebrane w innej kolejności ani zmiana czasu
+ * (daty lokalne nie są wtedy monotoniczne) nie psują kolejności listy. Wykres jest przycinany
+ * według znacznika czasu początku serii.
+ * @param sensorId Identyfikator czujnika lokalnego.
+ */
+void MainWindow::refreshLocalMeasurements(int sensorId)
+{
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    currentMeasurements = seriesToVariantList(series);
+    if (series.isEmpty()) return;
+    emit measurementsTrimmed(series.timestamps.first());
+    countUiUpdate("measurementsTrimmed", 1);
+}
+
+/**
+ * @brief Przekazuje anomalie serii wyświetlanej na wykresie.
+ *
+ * Przy aktualizacji przyrostowej emitowane są tylko anomalie nowe i usunięte względem
+ * ostatnio wyświetlonych; w przeciwnym razie cała lista zastępuje punkty anomalii na wykresie.
+ * @param sensorId Identyfikator czujnika.
+ * @param anomalies Aktualne anomalie serii (rosnąco po czasie).
+ * @param incremental True, jeśli wykres pokazuje już anomalie z shownAnomalies.
+ */
+void MainWindow::showAnomalies(int sensorId, const QVector<AnomalyDetector::Anomaly>& anomalies, bool incremental)
+{
+    if (!incremental) {
+        shownAnomalies = anomalies;
+        emit anomaliesUpdateRequested(anomaliesToVariantList(sensorId, anomalies));
+        countUiUpdate("anomaliesUpdateRequested", anomalies.size());
+        return;
+    }
+
+    auto same = [](const AnomalyDetector::Anomaly& a, const AnomalyDetector::Anomaly& b) {
+        return a.timestamp == b.timestamp && a.flags == b.flags
+               && (a.value == b.value || (std::isnan(a.value) && std::isnan(b.value)));
+    };
+    QVector<AnomalyDetector::Anomaly> added;
+    QVariantList removed;
+    int i = 0;
+    int j = 0;
+    while (i < shownAnomalies.size() || j < anomalies.size()) {
+        if (j >= anomalies.size() || (i < shownAnomalies.size() && shownAnomalies[i].timestamp < anomalies[j].timestamp)) {
+            removed.append(static_cast<double>(shownAnomalies[i++].timestamp));
+        } else if (i >= shownAnomalies.size() || anomalies[j].timestamp < shownAnomalies[i].timestamp) {
+            added.append(anomalies[j++]);
+        } else {
+            if (!same(shownAnomalies[i], anomalies[j])) {
+                removed.append(static_cast<double>(shownAnomalies[i].timestamp));
+                added.append(anomalies[j]);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    shownAnomalies = anomalies;
+    if (added.isEmpty() && removed.isEmpty()) return;
+
+    emit anomaliesChanged(anomaliesToVariantList(sensorId, added), removed);
+    countUiUpdate("anomaliesChanged", added.size() + removed.size());
+}
+
+/**
+ * @brief Wydziela zmiany z odpowiedzi API, dopisuje je do serii w pamięci i do dziennika na dysku.
+ *
+ * Przy pierwszej odpowiedzi dla czujnika stan synchronizacji jest inicjowany zapisaną historią,
+ * więc punkty zapisane w poprzednich uruchomieniach nie są zapisywane ponownie.
+ * @param sensorId Identyfikator czujnika.
+ * @param live Seria z odpowiedzi API.
+ * @return Punkty nowe i poprawione.
+ */
+SyncEngine::Delta MainWindow::syncMeasurements(int sensorId, const MeasurementSeries& live)
+{
+    const int stationId = stationOfSensor(sensorId);
+    if (!sync.isPrimed(sensorId)) {
+        MeasurementSeries stored = loadStoredSeries(stationId, sensorId);
+        sync.prime(sensorId, stored);
+        seriesCache[sensorId] = MeasurementSeries::merged(stored, seriesCache.value(sensorId));
+        publishSeries(stationId, sensorId);
+    }
+
+    SyncEngine::Delta delta = sync.apply(sensorId, live);
+    if (delta.isEmpty()) {
+        if (seriesCache[sensorId].key.isEmpty()) seriesCache[sensorId].key = live.key;
+        return delta;
+    }
+
+    MeasurementSeries changed = delta.changed();
+    seriesCache[sensorId] = MeasurementSeries::merged(seriesCache.value(sensorId), changed);
+    publishSeries(stationId, sensorId);
+    if (stationId >= 0) {
+        appendMeasurementsToDatabase(stationId, sensorId, changed);
+        queryEngine.addPoints(stationId, sensorId, catalog.sensorParamCode(sensorId), changed);
+    }
+    return delta;
+}
+
+/**
+ * @brief Zwraca stację czujnika (z listy czujników lub z nazw zapisanych plików).
+ *
+ * Czujniki obserwowane mogą należeć do stacji, których lista czujników nie była w tej sesji
+ * pobierana; wtedy stacja jest odczytywana z nazwy istniejącego pliku pomiarów.
+ * @param sensorId Identyfikator czujnika.
+ * @return Identyfikator stacji lub -1, jeśli nieznany.
+ */
+int MainWindow::stationOfSensor(int sensorId)
+{
+    if (catalog.containsSensor(sensorId)) {
+        return catalog.sensorStation(sensorId);
+    }
+    auto it = sensorStations.constFind(sensorId);
+    if (it != sensorStations.constEnd()) return it.value();
+
+    int stationId = -1;
+    QDir dir(getDatabasePath());
+    QRegularExpression pattern(QString("^measurements_station(\\d+)_sensor%1\\.").arg(sensorId));
+    for (const QString& name : dir.entryList({QString("measurements_station*_sensor%1.*").arg(sensorId)}, QDir::Files)) {
+        QRegularExpressionMatch match = pattern.match(name);
+        if (match.hasMatch()) {
+            stationId = match.captured(1).toInt();
+            break;
+        }
+    }
+    sensorStations.insert(sensorId, stationId);
+    return stationId;
+}
+
+/**
+ * @brief Publikuje serię czujnika z pamięci podręcznej w lokalnym API (jeśli jest uruchomione).
+ *
+ * Puste serie nie są publikowane; publikacja kopiuje tylko wskaźniki do danych serii.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::publishSeries(int stationId, int sensorId)
+{
+    if (!localApi) return;
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    if (!series.isEmpty()) localApi->publishSeries(stationId, sensorId, series);
+}
+
+/**
+ * @brief Przenosi serię bieżącego czujnika na regularną siatkę czasu i wyświetla ją.
+ *
+ * Anomalie z okna siatki i prognoza są wyświetlane ponownie razem z wyrównaną serią.
+ * @param step Krok siatki ("hour" lub "day").
+ * @param policy Polityka wypełniania luk ("null", "linear" lub "carry").
+ * @param maxGap Maksymalna długość wypełnianej luki w krokach siatki (0 bez ograniczeń).
+ * @return QVariantMap z pokryciem siatki danymi (coverage) i liczbą punktów (count).
+ */
+QVariantMap MainWindow::resampleMeasurements(const QString& step, const QString& policy, int maxGap)
+{
+    QVariantMap result;
+    if (!seriesCache.contains(currentSensorId)) {
+        result["error"] = "Brak danych do wyrównania";
+        return result;
+    }
+
+    Resampler::Options options;
+    options.step = Resampler::stepFromName(step);
+    options.policy = Resampler::policyFromName(policy);
+    options.maxGap = maxGap;
+
+    double coverage = 0.0;
+    MeasurementSeries resampled = Resampler::resample(seriesCache[currentSensorId], options, &coverage);
+
+    emit measurementsUpdateRequested(resampled.key, seriesToVariantList(resampled));
+    countUiUpdate("measurementsUpdateRequested", resampled.size());
+
+    // setMeasurements czyści na wykresie anomalie i prognozę - nanosimy je ponownie w oknie siatki.
+    QVector<AnomalyDetector::Anomaly> anomalies;
+    if (!resampled.isEmpty()) {
+        const qint64 start = resampled.timestamps.first();
+        const qint64 end = resampled.timestamps.last() + Resampler::stepMs(options.step);
+        for (const AnomalyDetector::Anomaly& anomaly : anomaliesMap.value(currentSensorId)) {
+            if (anomaly.timestamp >= start && anomaly.timestamp < end) anomalies.append(anomaly);
+        }
+    }
+    showAnomalies(currentSensorId, anomalies, false);
+    emitCurrentForecast();
+
+    result["coverage"] = QString::number(coverage, 'f', 1);
+    result["count"] = resampled.size();
+    return result;
+}
+
+/**
+ * @brief Wyrównuje serie wielu czujników do wspólnej siatki czasu.
+ * @param sensorIds Lista identyfikatorów czujników (serie muszą być już pobrane).
+ * @param step Krok siatki ("hour" lub "day").
+ * @param policy Polityka wypełniania luk ("null", "linear" lub "carry").
+ * @param maxGap Maksymalna długość wypełnianej luki w krokach siatki (0 bez ograniczeń).
+ * @return QVariantMap z siatką (timestamps) i listą serii (series: sensorId, key, values, coverage).
+ */
+QVariantMap MainWindow::alignSensors(const QVariantList& sensorIds, const QString& step,
+                                     const QString& policy, int maxGap)
+{
+    QVector<int> ids;
+    QVector<MeasurementSeries> series;
+    for (const QVariant& id : sensorIds) {
+        int sensorId = id.toInt();
+        if (!seriesCache.contains(sensorId)) continue;
+        ids.append(sensorId);
+        series.append(seriesCache[sensorId]);
+    }
+
+    Resampler::Options options;
+    options.step = Resampler::stepFromName(step);
+    options.policy = Resampler::policyFromName(policy);
+    options.maxGap = maxGap;
+    Resampler::AlignedSet aligned = Resampler::align(series, options);
+
+    QVariantList timestamps;
+    timestamps.reserve(aligned.grid.size());
+    for (qint64 timestamp : aligned.grid) {
+        timestamps.append(static_cast<double>(timestamp));
+    }
+
+    QVariantList columns;
+    for (int i = 0; i < aligned.columns.size(); ++i) {
+        QVariantList values;
+        values.reserve(aligned.columns[i].size());
+        for (double value : aligned.columns[i]) {
+            values.append(std::isnan(value) ? QVariant() : QVariant(value));
+        }
+
+        QVariantMap column;
+        column["sensorId"] = ids[i];
+        column["key"] = series[i].key;
+        column["values"] = values;
+        column["coverage"] = aligned.coverage[i];
+        columns.append(column);
+    }
+
+    QVariantMap result;
+    result["timestamps"] = timestamps;
+    result["series"] = columns;
+    return result;
+}
+
+/**
+ * @brief Zwraca etykietę czujnika (parametr i nazwa stacji).
+ * @param sensorId Identyfikator czujnika.
+ * @return Etykieta czujnika.
+ */
+QString MainWindow::sensorLabel(int sensorId)
+{
+    if (sensorId >= LOCAL_SENSOR_BASE) {
+        const int local = sensorId - LOCAL_SENSOR_BASE;
+        return QString("%1 - czujnik lokalny %2")
+            .arg(LocalIngestor::parameterCode(local % LocalIngestor::ParameterCount))
+            .arg(local / LocalIngestor::ParameterCount);
+    }
+    QString code = catalog.sensorParamCode(sensorId);
+    if (code.isEmpty()) code = seriesCache.value(sensorId).key;
+    QString stationName = catalog.stationName(catalog.sensorStation(sensorId));
+    return stationName.isEmpty() ? code : QString("%1 - %2").arg(code, stationName);
+}
+
+/**
+ * @brief Oblicza macierz korelacji wszystkich czujników stacji.
+ * @param stationId Identyfikator stacji.
+ * @param method Metoda korelacji ("pearson" lub "spearman").
+ */
+void MainWindow::computeStationCorrelation(int stationId, const QString& method)
+{
+    QVariantList sensorIds;
+    for (int sensorId : catalog.sensorsOfStation(stationId)) {
+        sensorIds.append(sensorId);
+    }
+    computeCorrelation(sensorIds, method);
+}
+
+/**
+ * @brief Oblicza macierz korelacji jednego parametru na wszystkich stacjach katalogu.
+ *
+ * Katalog zna tylko czujniki stacji, których listy były już pobierane, więc brakujące
+ * listy są najpierw pobierane z API; korelacja startuje po nadejściu wszystkich odpowiedzi.
+ * @param paramCode Kod parametru (np. PM10).
+ * @param method Metoda korelacji ("pearson" lub "spearman").
+ */
+void MainWindow::computeParameterCorrelation(const QString& paramCode, const QString& method)
+{
+    correlationSensorIds.clear();
+    correlationWaiting.clear();
+    correlationStationsWaiting.clear();
+    correlationParam = paramCode;
+    correlationMethod = method;
+
+    for (const StationRecord& station : catalog.stationRecords()) {
+        if (catalog.sensorsOfStation(station.id).isEmpty()) {
+            correlationStationsWaiting.insert(station.id);
+            fetchSensors(station.id);
+        }
+    }
+
+    if (correlationStationsWaiting.isEmpty()) {
+        resolvePendingCorrelationStation(-1);
+    } else {
+        emit correlationUpdateRequested(QString("Pobieranie list czujników: %1 stacji")
+                                            .arg(correlationStationsWaiting.size()));
+    }
+}
+
+/**
+ * @brief Oznacza listę czujników stacji jako pobraną dla oczekującej korelacji parametru.
+ * @param stationId Identyfikator stacji (-1, aby tylko sprawdzić, czy można zacząć).
+ */
+void MainWindow::resolvePendingCorrelationStation(int stationId)
+{
+    if (stationId >= 0 && !correlationStationsWaiting.remove(stationId)) return;
+
+    if (!correlationStationsWaiting.isEmpty()) {
+        emit correlationUpdateRequested(QString("Pobieranie list czujników: %1 stacji")
+                                            .arg(correlationStationsWaiting.size()));
+        return;
+    }
+    QVariantList sensorIds;
+    for (int sensorId : catalog.sensorsWithParam(correlationParam)) {
+        sensorIds.append(sensorId);
+    }
+    computeCorrelation(sensorIds, correlationMethod);
+}
+
+/**
+ * @brief Oblicza macierz korelacji dla podanego zestawu czujników.
+ *
+ * Brakujące serie są pobierane z API, a obliczenia startują po nadejściu wszystkich odpowiedzi.
+ * @param sensorIds Lista identyfikatorów czujników.
+ * @param method Metoda korelacji ("pearson" lub "spearman").
+ */
+void MainWindow::computeCorrelation(const QVariantList& sensorIds, const QString& method)
+{
+    correlationSensorIds.clear();
+    correlationWaiting.clear();
+    correlationStationsWaiting.clear();
+    correlationMethod = method;
+
+    for (const QVariant& id : sensorIds) {
+        int sensorId = id.toInt();
+        if (sensorId <= 0 || correlationSensorIds.contains(sensorId)) continue;
+        correlationSensorIds.append(sensorId);
+        if (!seriesCache.contains(sensorId)) {
+            correlationWaiting.insert(sensorId);
+            fetchMeasurements(sensorId);
+        }
+    }
+
+    if (correlationWaiting.isEmpty()) {
+        runCorrelation();
+    } else {
+        emit correlationUpdateRequested(QString("Pobieranie serii: %1").arg(correlationWaiting.size()));
+    }
+}
+
+/**
+ * @brief Oznacza serię czujnika jako dostępną dla oczekującego obliczenia korelacji.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::resolvePendingCorrelation(int sensorId)
+{
+    if (!correlationWaiting.remove(sensorId)) return;
+
+    if (correlationWaiting.isEmpty()) {
+        runCorrelation();
+    } else {
+        emit correlationUpdateRequested(QString("Pobieranie serii: %1").arg(correlationWaiting.size()));
+    }
+}
+
+/**
+ * @brief Wyrównuje serie i uruchamia obliczenie macierzy korelacji w puli wątków.
+ *
+ * Serie są wyrównywane do siatki godzinowej bez wypełniania luk, aby korelacja
+ * obejmowała wyłącznie rzeczywiste obserwacje.
+ */
+void MainWindow::runCorrelation()
+{
+    QVector<MeasurementSeries> series;
+    correlationLabels.clear();
+    for (int sensorId : correlationSensorIds) {
+        if (!seriesCache.contains(sensorId)) continue;
+        series.append(seriesCache[sensorId]);
+        correlationLabels.append(sensorLabel(sensorId));
+    }
+
+    Resampler::Options options;
+    options.policy = Resampler::LeaveNull;
+    QVector<QVector<double>> columns = Resampler::align(series, options).columns;
+    CorrelationEngine::Method method = CorrelationEngine::methodFromName(correlationMethod);
+
+    emit correlationUpdateRequested(QString("Obliczanie macierzy %1x%1...").arg(columns.size()));
+    correlationWatcher->setFuture(QtConcurrent::run([columns, method]() {
+        return CorrelationEngine::correlationMatrix(columns, method);
+    }));
+}
+
+/**
+ * @brief Oblicza korelację wzajemną dwóch czujników z przesunięciem czasowym.
+ * @param sensorA Identyfikator pierwszego czujnika.
+ * @param sensorB Identyfikator drugiego czujnika.
+ * @param maxLag Maksymalne przesunięcie w godzinach.
+ * @return Lista map z polami lag (godziny) i coefficient.
+ */
+QVariantList MainWindow::crossCorrelation(int sensorA, int sensorB, int maxLag)
+{
+    QVariantList result;
+    if (!seriesCache.contains(sensorA) || !seriesCache.contains(sensorB)) return result;
+
+    Resampler::AlignedSet aligned = Resampler::align({seriesCache[sensorA], seriesCache[sensorB]}, Resampler::Options());
+    if (aligned.columns.size() < 2) return result;
+
+    QVector<double> coefficients = CorrelationEngine::crossCorrelation(aligned.columns[0], aligned.columns[1], maxLag);
+
+    for (int i = 0; i < coefficients.size(); ++i) {
+        QVariantMap point;
+        point["lag"] = i - maxLag;
+        point["coefficient"] = std::isnan(coefficients[i]) ? QVariant() : QVariant(coefficients[i]);
+        result.append(point);
+    }
+    return result;
+}
+
+/**
+ * @brief Tworzy raport zgodności z normami UE dla wszystkich czujników.
+ *
+ * Obejmuje pełną zapisaną historię (pliki lokalnej bazy danych) połączoną z seriami
+ * pobranymi w bieżącej sesji. Obliczenia wykonywane są równolegle poza wątkiem interfejsu;
+ * wynik przekazywany jest sygnałem complianceReportUpdateRequested.
+ */
+void MainWindow::generateComplianceReport()
+{
+    QDir dir(getDatabasePath());
+    QMap<int, QString> files;
+    QRegularExpression pattern("_sensor(\\d+)\\.jsonl?$");
+    for (const QString& name : dir.entryList({"measurements_station*_sensor*.json", "measurements_station*_sensor*.jsonl"}, QDir::Files)) {
+        QRegularExpressionMatch match = pattern.match(name);
+        if (!match.hasMatch()) continue;
+        QString path = dir.filePath(name);
+        files[match.captured(1).toInt()] = path.left(path.lastIndexOf('.'));
+    }
+
+    QHash<int, QString> paramCodes;
+    for (int sensorId : catalog.sensorIds()) {
+        paramCodes[sensorId] = catalog.sensorParamCode(sensorId);
+    }
+    QHash<int, MeasurementSeries> cached = seriesCache;
+
+    complianceWatcher->setFuture(QtConcurrent::run([files, paramCodes, cached]() {
+        QHash<int, MeasurementSeries> history = cached;
+
+        for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+            MeasurementSeries stored = MeasurementSeries::readStored(it.value() + ".json", it.value() + ".jsonl");
+            history[it.key()] = MeasurementSeries::merged(stored, history.value(it.key()));
+        }
+
+        QVector<RegulatoryMetrics::SensorInput> inputs;
+        for (auto it = history.constBegin(); it != history.constEnd(); ++it) {
+            RegulatoryMetrics::SensorInput input;
+            input.sensorId = it.key();
+            input.paramCode = paramCodes.value(it.key(), it.value().key);
+            input.series = it.value();
+            inputs.append(input);
+        }
+        return RegulatoryMetrics::reportAll(inputs);
+    }));
+}
+
+/**
+ * @brief Zamienia raporty czujników na wiersze raportu zgodności.
+ * @param reports Raporty czujników.
+ * @return Lista wierszy posortowana według stacji, parametru i roku.
+ */
+QVariantList MainWindow::complianceRows(const QVector<RegulatoryMetrics::SensorReport>& reports)
+{
+    QVector<QVariantMap> rows;
+    for (const RegulatoryMetrics::SensorReport& report : reports) {
+        int stationId = catalog.sensorStation(report.sensorId);
+        QString stationName = catalog.stationName(stationId);
+
+        for (const RegulatoryMetrics::YearSummary& year : report.years) {
+            QVariantMap row;
+            row["stationId"] = stationId;
+            row["station"] = stationName.isEmpty() ? QString("Czujnik %1").arg(report.sensorId) : stationName;
+            row["sensorId"] = report.sensorId;
+            row["paramCode"] = report.limit.paramCode;
+            row["metric"] = report.limit.eightHour ? "maks. średnia 8 h" : "średnia 24 h";
+            row["threshold"] = report.limit.threshold;
+            row["allowedDays"] = report.limit.allowedDays;
+            row["year"] = year.year;
+            row["validDays"] = year.validDays;
+            row["exceedanceDays"] = year.exceedanceDays;
+            row["maxValue"] = QString::number(year.maxValue, 'f', 1);
+            row["meanValue"] = QString::number(year.meanValue, 'f', 1);
+            row["compliant"] = year.exceedanceDays <= report.limit.allowedDays;
+            rows.append(row);
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const QVariantMap& a, const QVariantMap& b) {
+        if (a["station"] != b["station"]) return a["station"].toString() < b["station"].toString();
+        if (a["paramCode"] != b["paramCode"]) return a["paramCode"].toString() < b["paramCode"].toString();
+        return a["year"].toInt() < b["year"].toInt();
+    });
+
+    QVariantList result;
+    for (const QVariantMap& row : rows) {
+        result.append(row);
+    }
+    return result;
+}
+
+/**
+ * @brief Wczytuje w tle całe archiwum lokalnej bazy danych.
+ */
+void MainWindow::loadArchive()
+{
+    if (archiveWatcher->isRunning()) return;
+    const QString directory = getDatabasePath();
+    archiveWatcher->setFuture(QtConcurrent::run([directory]() {
+        return HistoryArchive::load(directory);
+    }));
+}
+
+/**
+ * @brief Zwraca punkty archiwum z zakresu czasu.
+ * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+ * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+ * @param from Początek zakresu (ms od epoki).
+ * @param to Koniec zakresu (ms od epoki).
+ * @return Lista map z polami stationId, sensorId, timestamp i value.
+ */
+QVariantList MainWindow::queryArchive(int stationId, const QString& paramCode, double from, double to) const
+{
+    const QVector<HistoryArchive::Point> points = archive.query(stationId, paramCode, static_cast<qint64>(from),
+                                                                static_cast<qint64>(to));
+    QVariantList result;
+    result.reserve(points.size());
+    for (const HistoryArchive::Point& point : points) {
+        QVariantMap map;
+        map["stationId"] = point.stationId;
+        map["sensorId"] = point.sensorId;
+        map["timestamp"] = point.timestamp;
+        map["value"] = point.value;
+        result.append(map);
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca statystyki wartości archiwum z zakresu czasu.
+ * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+ * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+ * @param from Początek zakresu (ms od epoki).
+ * @param to Koniec zakresu (ms od epoki).
+ * @return Mapa z polami count, series, mean, min i max.
+ */
+QVariantMap MainWindow::summarizeArchive(int stationId, const QString& paramCode, double from, double to) const
+{
+    const HistoryArchive::Summary summary = archive.summarize(stationId, paramCode, static_cast<qint64>(from),
+                                                              static_cast<qint64>(to));
+    QVariantMap result;
+    result["count"] = summary.count;
+    result["series"] = summary.series;
+    result["mean"] = summary.mean;
+    result["min"] = summary.min;
+    result["max"] = summary.max;
+    return result;
+}
+
+/**
+ * @brief Opisuje całą zapisaną historię stacji (po jednej linii na parametr).
+ * @param stationId Identyfikator stacji.
+ * @return Opis lub informacja o braku danych.
+ */
+QString MainWindow::archiveStationSummary(int stationId) const
+{
+    QStringList lines;
+    for (const QString& paramCode : archive.parameters()) {
+        const QVector<const HistoryArchive::Entry*> entries = archive.entries(stationId, paramCode);
+        if (entries.isEmpty()) continue;
+
+        qint64 first = std::numeric_limits<qint64>::max();
+        for (const HistoryArchive::Entry* entry : entries) {
+            first = std::min(first, entry->series.timestamps.first());
+        }
+        const HistoryArchive::Summary summary = archive.summarize(stationId, paramCode, first,
+                                                                  std::numeric_limits<qint64>::max());
+        if (summary.count == 0) continue;
+        lines.append(QString("%1: %2 pomiarów od %3, średnia %4, maks. %5")
+                         .arg(paramCode)
+                         .arg(summary.count)
+                         .arg(QDateTime::fromMSecsSinceEpoch(first).toString("dd.MM.yyyy"))
+                         .arg(summary.mean, 0, 'f', 1)
+                         .arg(summary.max, 0, 'f', 1));
+    }
+
+    const HistoryArchive::AirQualityEntry airQuality = archive.airQuality(stationId);
+    if (airQuality.stationId >= 0) {
+        lines.append(QString("Ostatni zapisany indeks: %1 (%2)")
+                         .arg(airQuality.indexLevelName,
+                              QDateTime::fromMSecsSinceEpoch(airQuality.calcTimestamp).toString("dd.MM.yyyy HH:mm")));
+    }
+    return lines.isEmpty() ? QString("Brak danych stacji w archiwum") : lines.join('\n');
+}
+
+/**
+ * @brief Włącza lub wyłącza odświeżanie danych w tle.
+ * @param enabled True, aby włączyć.
+ */
+void MainWindow::setAutoRefresh(bool enabled)
+{
+    scheduler->setEnabled(enabled);
+}
+
+/**
+ * @brief Włącza lub wyłącza wstępne pobieranie danych prawdopodobnie wybieranych stacji.
+ * @param enabled True, aby włączyć.
+ */
+void MainWindow::setPrefetchEnabled(bool enabled)
+{
+    prefetcher->setEnabled(enabled);
+}
+
+/**
+ * @brief Zwraca skuteczność wstępnego pobierania i czasy od kliknięcia do wykresu.
+ * @return QVariantMap z polami lookups, hits, hitRate, charts, chartMedianMs, chartP95Ms,
+ *         requests, failed i bytes.
+ */
+QVariantMap MainWindow::prefetchStats() const
+{
+    const Prefetcher::Stats stats = prefetcher->stats();
+    QVariantMap result;
+    result["lookups"] = stats.lookups;
+    result["hits"] = stats.hits;
+    result["hitRate"] = stats.lookups > 0 ? static_cast<double>(stats.hits) / stats.lookups : 0.0;
+    result["charts"] = clickToChart.count();
+    result["chartMedianMs"] = clickToChart.percentile(0.5);
+    result["chartP95Ms"] = clickToChart.percentile(0.95);
+    result["requests"] = stats.issued;
+    result["failed"] = stats.failed;
+    result["bytes"] = stats.bytes;
+    return result;
+}
+
+/**
+ * @brief Przekazuje do wstępnego pobierania otoczenie stacji (sąsiedzi na liście, najbliższe stacje).
+ *
+ * Sąsiedzi są brani z bieżącej, przefiltrowanej listy - w takiej kolejności użytkownik
+ * przegląda stacje strzałkami lub kolejnymi kliknięciami.
+ * @param stationId Identyfikator stacji.
+ */
+void MainWindow::updatePrefetchContext(int stationId)
+{
+    QVector<int> listNeighbours;
+    const int row = stationProxy->rowOf(stationId);
+    if (row >= 0) {
+        for (int distance = 1; distance <= PREFETCH_LIST_NEIGHBOURS; ++distance) {
+            for (int neighbourRow : { row + distance, row - distance }) {
+                const int neighbour = neighbourRow >= 0 ? stationProxy->stationIdAt(neighbourRow) : -1;
+                if (neighbour >= 0) listNeighbours.append(neighbour);
+            }
+        }
+    }
+    prefetcher->setContext(listNeighbours, catalog.nearestStations(stationId, PREFETCH_NEARBY_STATIONS));
+}
+
+/**
+ * @brief Przekazuje do wstępnego pobierania stacje obserwowanych czujników.
+ */
+void MainWindow::updateFavouriteStations()
+{
+    QVector<int> stationIds;
+    for (int sensorId : watchedSensors) {
+        const int stationId = stationOfSensor(sensorId);
+        if (stationId >= 0 && !stationIds.contains(stationId)) stationIds.append(stationId);
+    }
+    prefetcher->setFavouriteStations(stationIds);
+}
+
+/**
+ * @brief Zapisuje czas od wyboru czujnika do pokazania wykresu z aktualnymi danymi.
+ *
+ * Liczy się tylko pierwszy wykres po wyborze; kolejne odświeżenia w tle nie są mierzone.
+ * @param sensorId Identyfikator czujnika, którego wykres został pokazany.
+ */
+void MainWindow::noteChartShown(int sensorId)
+{
+    if (sensorId != chartClockSensor || !chartClock.isValid()) return;
+    clickToChart.add(chartClock.nsecsElapsed() / 1.0e6);
+    chartClockSensor = -1;
+}
+
+/**
+ * @brief Dodaje czujnik do listy obserwowanych lub go z niej usuwa.
+ * @param sensorId Identyfikator czujnika.
+ * @param watched True, aby obserwować.
+ */
+void MainWindow::setSensorWatched(int sensorId, bool watched)
+{
+    if (sensorId <= 0 || watchedSensors.contains(sensorId) == watched) return;
+
+    if (watched) {
+        watchedSensors.insert(sensorId);
+    } else {
+        watchedSensors.remove(sensorId);
+    }
+    scheduler->setMembers(PollingScheduler::Measurements, PollingScheduler::Watched,
+                          QVector<int>(watchedSensors.constBegin(), watchedSensors.constEnd()));
+    updateFavouriteStations();
+    saveWatchList();
+}
+
+/**
+ * @brief Sprawdza, czy czujnik jest obserwowany.
+ * @param sensorId Identyfikator czujnika.
+ * @return True, jeśli czujnik jest na liście obserwowanych.
+ */
+bool MainWindow::isSensorWatched(int sensorId) const
+{
+    return watchedSensors.contains(sensorId);
+}
+
+/**
+ * @brief Ustawia stacje widoczne na mapie (odświeżane z wyższym priorytetem niż obserwowane).
+ * @param stationIds Identyfikatory stacji.
+ */
+void MainWindow::setVisibleStations(const QVariantList& stationIds)
+{
+    QVector<int> ids;
+    ids.reserve(stationIds.size());
+    for (const QVariant& id : stationIds) {
+        ids.append(id.toInt());
+    }
+    scheduler->setMembers(PollingScheduler::AirQualityIndex, PollingScheduler::Visible, ids);
+}
+
+/**
+ * @brief Zwraca statystyki zapytań do API (ponowienia, zapytania zabezpieczające, percentyle czasów) i synchronizacji.
+ * @return Raport tekstowy, jedna linia na punkt końcowy i linia synchronizacji.
+ */
+QString MainWindow::networkMetrics() const
+{
+    SyncEngine::Stats stats = sync.stats();
+    Prefetcher::Stats prefetch = prefetcher->stats();
+    return api->metricsReport()
+           + QString("\nSynchronizacja: %1 odpowiedzi, odebrano %2 punktów, nowe %3, poprawione %4, "
+                     "zapisano %5, przekazano do wykresu %6")
+                 .arg(stats.responses).arg(stats.pointsReceived).arg(stats.pointsAdded)
+                 .arg(stats.pointsCorrected).arg(syncPointsWritten.load()).arg(chartPointsEmitted())
+           + QString("\nZapytania analityczne: %1 z pamięci, %2 obliczonych, %3 serii")
+                 .arg(queryEngine.cacheHits()).arg(queryEngine.cacheMisses()).arg(queryEngine.seriesCount())
+           + QString("\nWstępne pobieranie: %1 zapytań (%2 kB), trafienia %3/%4, wykres po kliknięciu: mediana %5 ms, p95 %6 ms")
+                 .arg(prefetch.issued).arg(prefetch.bytes / 1024.0, 0, 'f', 1)
+                 .arg(prefetch.hits).arg(prefetch.lookups)
+                 .arg(clickToChart.percentile(0.5), 0, 'f', 1).arg(clickToChart.percentile(0.95), 0, 'f', 1)
+           + "\n" + uiUpdateMetrics();
+}
+
+/**
+ * @brief Zwraca liczniki elementów przekazanych do interfejsu.
+ * @return Raport tekstowy, jedna linia na sygnał lub model.
+ */
+QString MainWindow::uiUpdateMetrics() const
+{
+    QStringList lines;
+    for (auto it = uiUpdates.constBegin(); it != uiUpdates.constEnd(); ++it) {
+        const UiUpdateCounter& counter = it.value();
+        lines.append(QString("%1: %2 aktualizacji, %3 elementów (ostatnio %4, maks. %5)")
+                         .arg(it.key()).arg(counter.updates).arg(counter.items)
+                         .arg(counter.lastItems).arg(counter.maxItems));
+    }
+    return lines.isEmpty() ? QString("Brak aktualizacji interfejsu") : lines.join("\n");
+}
+
+/**
+ * @brief Zlicza elementy przekazane do interfejsu jedną emisją sygnału lub zmianą modelu.
+ * @param channel Nazwa sygnału lub modelu.
+ * @param items Liczba przekazanych elementów (punktów, wierszy, anomalii).
+ */
+void MainWindow::countUiUpdate(const QString& channel, int items)
+{
+    UiUpdateCounter& counter = uiUpdates[channel];
+    counter.updates++;
+    counter.items += items;
+    counter.lastItems = items;
+    counter.maxItems = std::max(counter.maxItems, items);
+}
+
+/**
+ * @brief Zwraca liczbę punktów przekazanych do wykresu (seria główna i nałożone).
+ * @return Liczba punktów.
+ */
+qint64 MainWindow::chartPointsEmitted() const
+{
+    qint64 points = 0;
+    for (auto it = uiUpdates.constBegin(); it != uiUpdates.constEnd(); ++it) {
+        if (it.key().startsWith("measurements") || it.key().startsWith("overlaySeries")) {
+            points += it.value().items;
+        }
+    }
+    return points;
+}
+
+/**
+ * @brief Nakłada serię czujnika na wykres (porównanie parametrów lub stacji).
+ *
+ * Seria jest od razu wysyłana z pamięci podręcznej lub danych lokalnych, a następnie
+ * pobierana z API niezależnie od pozostałych serii; odpowiedź trafia na wykres jako zmiany.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::addOverlaySensor(int sensorId)
+{
+    if (sensorId <= 0 || overlaySensors.contains(sensorId)) return;
+
+    overlaySensors.append(sensorId);
+    if (!seriesCache.contains(sensorId)) {
+        MeasurementSeries stored = loadStoredSeries(stationOfSensor(sensorId), sensorId);
+        if (!stored.isEmpty()) seriesCache[sensorId] = stored;
+    }
+
+    const MeasurementSeries series = seriesCache.value(sensorId);
+    QString paramCode = catalog.sensorParamCode(sensorId);
+    emit overlaySeriesAdded(sensorId, sensorLabel(sensorId), paramCode.isEmpty() ? series.key : paramCode,
+                            seriesToVariantList(series));
+    countUiUpdate("overlaySeriesAdded", series.size());
+
+    scheduler->setMembers(PollingScheduler::Measurements, PollingScheduler::Visible, overlaySensors);
+    fetchMeasurements(sensorId, true);
+}
+
+/**
+ * @brief Zdejmuje nałożoną serię czujnika z wykresu.
+ * @param sensorId Identyfikator czujnika.
+ */
+void MainWindow::removeOverlaySensor(int sensorId)
+{
+    if (!overlaySensors.removeOne(sensorId)) return;
+
+    scheduler->setMembers(PollingScheduler::Measurements, PollingScheduler::Visible, overlaySensors);
+    emit overlaySeriesRemoved(sensorId);
+}
+
+/**
+ * @brief Zdejmuje z wykresu wszystkie nałożone serie.
+ */
+void MainWindow::clearOverlaySensors()
+{
+    const QVector<int> removed = overlaySensors;
+    overlaySensors.clear();
+    scheduler->setMembers(PollingScheduler::Measurements, PollingScheduler::Visible, overlaySensors);
+    for (int sensorId : removed) {
+        emit overlaySeriesRemoved(sensorId);
+    }
+}
+
+/**
+ * @brief Wczytuje listę obserwowanych czujników z lokalnej bazy danych.
+ */
+void MainWindow::loadWatchList()
+{
+    QString filePath = getDatabasePath() + "/watchlist.json";
+    if (!QFile::exists(filePath)) return;
+
+    QJsonDocument jsonDoc = loadJsonFromFile(filePath);
+    for (const QJsonValue& value : jsonDoc.object().value("sensors").toArray()) {
+        watchedSensors.insert(value.toInt());
+    }
+    scheduler->setMembers(PollingScheduler::Measurements, PollingScheduler::Watched,
+                          QVector<int>(watchedSensors.constBegin(), watchedSensors.constEnd()));
+    updateFavouriteStations();
+}
+
+/**
+ * @brief Zapisuje listę obserwowanych czujników do lokalnej bazy danych.
+ */
+void MainWindow::saveWatchList()
+{
+    QJsonArray sensors;
+    for (int sensorId : watchedSensors) {
+        sensors.append(sensorId);
+    }
+    QJsonObject root;
+    root["sensors"] = sensors;
+    saveJsonToFile(getDatabasePath() + "/watchlist.json", QJsonDocument(root));
+}
+
+/**
+ * @brief Wczytuje wyuczony profil wstępnego pobierania z lokalnej bazy danych.
+ */
+void MainWindow::loadPrefetchProfile()
+{
+    QString filePath = getDatabasePath() + "/prefetch_profile.json";
+    if (!QFile::exists(filePath)) return;
+
+    prefetcher->setProfile(loadJsonFromFile(filePath).object());
+}
+
+/**
+ * @brief Zapisuje wyuczony profil wstępnego pobierania do lokalnej bazy danych.
+ */
+void MainWindow::savePrefetchProfile()
+{
+    saveJsonToFile(getDatabasePath() + "/prefetch_profile.json", QJsonDocument(prefetcher->profile()));
+}
+
+/**
+ * @brief Uruchamia odbiór odczytów z własnych czujników przez UDP.
+ * @param port Numer portu UDP.
+ * @return True, jeśli gniazdo zostało związane z portem.
+ */
+bool MainWindow::startLocalIngestion(int port)
+{
+    if (port <= 0 || port > 65535 || !ingestor->listenUdp(static_cast<quint16>(port))) return false;
+    localFlushTimer->start();
+    return true;
+}
+
+/**
+ * @brief Odtwarza plik z zapisanymi odczytami własnych czujników.
+ * @param path Ścieżka do pliku.
+ * @param speed Przyspieszenie odtwarzania (<= 0 bez przerw).
+ * @return True, jeśli odtwarzanie zostało uruchomione.
+ */
+bool MainWindow::replayLocalFile(const QString& path, double speed)
+{
+    QString filePath = path.startsWith("file:") ? QUrl(path).toLocalFile() : path;
+    if (!ingestor->replayFile(filePath, speed)) return false;
+    localFlushTimer->start();
+    return true;
+}
+
+/**
+ * @brief Wyświetla na wykresie serię czujnika lokalnego.
+ * @param sensorId Identyfikator czujnika lokalnego.
+ */
+void MainWindow::showLocalSensor(int sensorId)
+{
+    if (!localSensors.contains(sensorId)) return;
+
+    currentSensorId = -1;
+    detectAnomalies(sensorId);
+    showSeries(sensorId, sensorLabel(sensorId));
+}
+
+/**
+ * @brief Zwraca stan odbioru odczytów lokalnych.
+ * @return Opis stanu odbioru.
+ */
+QString MainWindow::localIngestionStatus() const
+{
+    LocalIngestor::Stats stats = ingestor->stats();
+    return QString("Czujniki lokalne: %1, odczyty %2 (utracone %3, błędne %4), kolejka %5 (maks. %6), "
+                   "najdłuższa klatka %7 ms")
+        .arg(localSensors.size()).arg(stats.received).arg(stats.dropped).arg(stats.parseErrors)
+        .arg(ingestor->queueDepth()).arg(stats.maxQueueDepth).arg(stats.maxFrameMs, 0, 'f', 2);
+}
+
+/**
+ * @brief Uruchamia lokalne API HTTP/JSON z danymi z pamięci podręcznej i lokalnej bazy danych.
+ *
+ * Po uruchomieniu serwer dostaje bieżący katalog stacji, serie z pamięci podręcznej,
+ * indeksy jakości powietrza i archiwum (jeśli zostało wczytane); kolejne zmiany są
+ * publikowane w miejscach, w których trafiają do pamięci podręcznej.
+ * @param port Numer portu TCP (0 wybiera wolny port).
+ * @return True, jeśli serwer nasłuchuje.
+ */
+bool MainWindow::startLocalApi(int port)
+{
+    if (port < 0 || port > 65535) return false;
+    if (localApi) return localApi->isListening();
+
+    localApi = new LocalApiServer(this);
+    if (!localApi->listen(static_cast<quint16>(port))) {
+        delete localApi;
+        localApi = nullptr;
+        return false;
+    }
+    localApi->publishStations(catalog.stationRecords());
+    for (auto it = seriesCache.constBegin(); it != seriesCache.constEnd(); ++it) {
+        publishSeries(stationOfSensor(it.key()), it.key());
+    }
+    for (auto it = airQualityCache.constBegin(); it != airQualityCache.constEnd(); ++it) {
+        localApi->publishAirQuality(it.key(), it.value());
+    }
+    if (archiveReady) localApi->publishArchive(archive);
+    qDebug() << "Local API listening on" << localApi->baseUrl();
+    return true;
+}
+
+/**
+ * @brief Zwraca stan lokalnego API.
+ * @return Opis stanu serwera.
+ */
+QString MainWindow::localApiStatus() const
+{
+    if (!localApi) return "Lokalne API: wyłączone";
+    LocalApiServer::Stats stats = localApi->stats();
+    return QString("Lokalne API %1: %2 zapytań (304: %3, gzip: %4, błędy: %5), %6 MB wysłanych, "
+                   "obsługa mediana %7 us, p99 %8 us")
+        .arg(localApi->baseUrl()).arg(stats.requests).arg(stats.notModified).arg(stats.compressed)
+        .arg(stats.errors).arg(stats.bytesSent / 1048576.0, 0, 'f', 1)
+        .arg(stats.medianUs, 0, 'f', 0).arg(stats.p99Us, 0, 'f', 0);
+}
+
+/**
+ * @brief Zwraca identyfikator czujnika lokalnego.
+ * @param deviceId Identyfikator urządzenia.
+ * @param parameter Parametr (LocalIngestor::Parameter).
+ * @return Identyfikator czujnika.
+ */
+int MainWindow::localSensorId(int deviceId, int parameter)
+{
+    return LOCAL_SENSOR_BASE + deviceId * LocalIngestor::ParameterCount + parameter;
+}
+
+/**
+ * @brief Dopisuje paczkę odczytów lokalnych do serii i wykresu (raz na klatkę).
+ *
+ * Odczyty są grupowane według czujnika, więc każda seria i wykres dostają jedną paczkę
+ * na klatkę; zapis na dysk i odtworzenie listy bieżących pomiarów odbywają się
+ * w flushLocalReadings().
+ * @param readings Odczyty zebrane od poprzedniej klatki.
+ */
+void MainWindow::onLocalReadings(const QVector<LocalReading>& readings)
+{
+    QHash<int, MeasurementSeries> batches;
+    QVariantList added;
+    for (const LocalReading& reading : readings) {
+        if (reading.deviceId > (std::numeric_limits<int>::max() - LOCAL_SENSOR_BASE) / LocalIngestor::ParameterCount) {
+            continue;
+        }
+        const int sensorId = localSensorId(reading.deviceId, reading.parameter);
+        MeasurementSeries& batch = batches[sensorId];
+        if (batch.isEmpty()) {
+            batch.key = LocalIngestor::parameterCode(reading.parameter);
+            if (!sensorStations.contains(sensorId)) {
+                sensorStations.insert(sensorId, LOCAL_STATION_ID);
+                localSensors.append(sensorId);
+                QVariantMap sensor;
+                sensor["sensorId"] = sensorId;
+                sensor["label"] = sensorLabel(sensorId);
+                added.append(sensor);
+            }
+        }
+        batch.timestamps.append(reading.timestamp);
+        batch.values.append(reading.value);
+    }
+    if (!added.isEmpty()) {
+        emit localSensorsUpdated(added);
+        countUiUpdate("localSensorsUpdated", added.size());
+    }
+
+    for (auto it = batches.begin(); it != batches.end(); ++it) {
+        MeasurementSeries& batch = it.value();
+        if (!std::is_sorted(batch.timestamps.cbegin(), batch.timestamps.cend())) {
+            QVector<int> order(batch.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&batch](int a, int b) {
+                return batch.timestamps[a] < batch.timestamps[b];
+            });
+            MeasurementSeries sorted;
+            sorted.key = batch.key;
+            for (int index : order) {
+                sorted.timestamps.append(batch.timestamps[index]);
+                sorted.values.append(batch.values[index]);
+            }
+            batch = sorted;
+        }
+
+        const int sensorId = it.key();
+        MeasurementSeries& series = seriesCache[sensorId];
+        series.append(batch);
+        series.keepLast(LOCAL_RETENTION_MS);
+        localPending[sensorId].append(batch);
+
+        if (sensorId == chartSensorId) {
+            QVariantList points = seriesToVariantList(batch);
+            emit measurementsAppended(sensorLabel(sensorId), points);
+            countUiUpdate("measurementsAppended", batch.size());
+        }
+        if (overlaySensors.contains(sensorId)) {
+            emit overlaySeriesUpdated(sensorId, seriesToVariantList(batch));
+            countUiUpdate("overlaySeriesUpdated", batch.size());
+        }
+    }
+}
+
+/**
+ * @brief Przekazuje zebrane odczyty lokalne do zapisu w tle i uruchamia detekcję anomalii wyświetlanej serii.
+ *
+ * Dzienniki są dopisywane w jednowątkowej puli localStoragePool, więc zapis tysięcy
+ * plików na sekundę nie blokuje wątku interfejsu, a zapisy jednego czujnika nie przeplatają się.
+ * Lista bieżących pomiarów jest odtwarzana z seriesCache, a wykres i nałożone serie lokalne
+ * są przycinane do początku serii w seriesCache, czyli do LOCAL_RETENTION_MS przed najnowszym
+ * odczytem czujnika (a nie przed bieżącą chwilą, aby odtwarzane starsze nagrania nie były
+ * usuwane w trakcie odbioru).
+ */
+void MainWindow::flushLocalReadings()
+{
+    if (!localPending.isEmpty()) {
+        QHash<int, MeasurementSeries> pending;
+        pending.swap(localPending);
+        for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+            queryEngine.addPoints(LOCAL_STATION_ID, it.key(), it.value().key, it.value());
+            publishSeries(LOCAL_STATION_ID, it.key());
+        }
+        QtConcurrent::run(&localStoragePool, [this, pending]() {
+            for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+                appendMeasurementsToDatabase(LOCAL_STATION_ID, it.key(), it.value());
+            }
+        });
+
+        if (localSensors.contains(chartSensorId) && pending.contains(chartSensorId)) {
+            refreshLocalMeasurements(chartSensorId);
+            const QVector<qint64> fresh = pending.value(chartSensorId).timestamps;
+            if (!fresh.isEmpty()) detectAnomalies(chartSensorId, *std::min_element(fresh.cbegin(), fresh.cend()));
+        }
+        for (int sensorId : overlaySensors) {
+            const MeasurementSeries overlay = seriesCache.value(sensorId);
+            if (pending.contains(sensorId) && !overlay.isEmpty()) {
+                emit overlaySeriesTrimmed(sensorId, overlay.timestamps.first());
+            }
+        }
+    }
+    emit localIngestionStatusUpdated(localIngestionStatus());
+}
@@ -13,6 +13,35 @@
 #include <QDir>
 #include <QFile>
 #include <QDateTime>
+#include <QHash>
+#include "measurementseries.h"
+#include "anomalydetector.h"
+#include "forecaster.h"
+#include "resampler.h"
+#include "correlationengine.h"
+#include "correlationmatrixmodel.h"
+#include "regulatorymetrics.h"
+#include "stationlistmodel.h"
+#include "stationfilterproxymodel.h"
+#include "sensorlistmodel.h"
+#include "pollingscheduler.h"
+#include "apiclient.h"
+#include "syncengine.h"
+#include "stationcatalog.h"
+#include "localingestor.h"
+#include "historyarchive.h"
+#include "queryengine.h"
+#include "stationdashboard.h"
+#include "prefetcher.h"
+#include "latencytracker.h"
+#include "localapiserver.h"
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <limits>
 
 /**
  * @brief Klasa główna aplikacji do monitorowania jakości powietrza.
@@ -29,14 +58,50 @@ public:
     /**
      * @brief Konstruktor klasy MainWindow.
      * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     * @param deferredStartup True, aby pokazać katalog stacji z pamięci podręcznej i odłożyć
+     *        wczytanie danych lokalnych oraz zapytania do API do wywołania warmUp().
      */
-    explicit MainWindow(QObject *parent = nullptr);
+    explicit MainWindow(QObject *parent = nullptr, bool deferredStartup = false);
+
+    /**
+     * @brief Wczytuje listę obserwowanych czujników i pobiera katalog stacji z API.
+     *
+     * Przy zwykłym uruchomieniu wywoływane w konstruktorze; w trybie odroczonym po pierwszej
+     * klatce okna.
+     */
+    void warmUp();
+
+    /**
+     * @brief Zmienia adres bazowy API (np. na lokalny serwer z danymi syntetycznymi).
+     *
+     * Dotyczy kolejnych zapytań; wywoływane przed warmUp() w trybie odroczonym.
+     * @param url Adres bazowy zakończony ukośnikiem.
+     */
+    void setApiBaseUrl(const QString& url);
 
     /**
      * @brief Destruktor klasy MainWindow.
      */
     ~MainWindow();
 
+    /**
+     * @brief Zwraca model macierzy korelacji udostępniany w QML.
+     * @return Wskaźnik na model (własność obiektu MainWindow).
+     */
+    CorrelationMatrixModel* correlationMatrixModel() const;
+
+    /**
+     * @brief Zwraca przefiltrowany model listy stacji udostępniany w QML.
+     * @return Wskaźnik na model pośredniczący (własność obiektu MainWindow).
+     */
+    StationFilterProxyModel* stationListModel() const;
+
+    /**
+     * @brief Zwraca model listy czujników wybranej stacji udostępniany w QML.
+     * @return Wskaźnik na model (własność obiektu MainWindow).
+     */
+    SensorListModel* sensorListModel() const;
+
     /**
      * @brief Wyszukuje stacje pomiarowe na podstawie tekstu.
      * @param searchText Tekst wyszukiwania (nazwa miejscowości).
@@ -54,6 +119,13 @@ public:
      */
     Q_INVOKABLE void stationSelected(int stationId);
 
+    /**
+     * @brief Zwraca podstawowe dane stacji (pola jak w roli station modelu listy).
+     * @param stationId Identyfikator stacji.
+     * @return Mapa z danymi stacji lub pusta mapa.
+     */
+    Q_INVOKABLE QVariantMap stationData(int stationId) const;
+
     /**
      * @brief Obsługuje wybór czujnika dla wybranej stacji.
      * @param sensorId Identyfikator wybranego czujnika.
@@ -102,13 +174,273 @@ public:
      */
     Q_INVOKABLE QVariantMap analyzeMeasurements();
 
-signals:
     /**
-     * @brief Emitowany, gdy lista stacji wymaga aktualizacji.
-     * @param stations Lista stacji w formacie QVariantList.
+     * @brief Wykonuje zapytanie analityczne po zapisanej historii czujników.
+     *
+     * Pola zapytania: stationIds, sensorIds, paramCodes (listy, puste oznaczają wszystkie),
+     * from i to (ms od epoki), groupBy ("hour", "weekday", "month" lub brak) oraz aggregates
+     * (np. "mean", "min", "max", "count", "p50", "p95"). Zapytanie obejmuje archiwum lokalnej
+     * bazy danych (wczytywane przy pierwszym zapytaniu) i punkty zapisane w bieżącej sesji.
+     * Powtórzone zapytanie zwraca zapamiętany wynik, dopóki wybrane serie się nie zmienią.
+     * Zapytanie jest wykonywane w tle; wynik (mapa z polami rows, series, scannedPoints,
+     * elapsedMs, cached i complete - false, dopóki archiwum nie zostało wczytane) jest jedynym
+     * elementem listy przekazanej sygnałem queryResultsReady().
+     * @param query Zapytanie.
+     * @return Identyfikator żądania.
+     */
+    Q_INVOKABLE int runQuery(const QVariantMap& query);
+
+    /**
+     * @brief Wykonuje w tle listę zapytań analitycznych (np. wszystkie kafelki panelu naraz).
+     * @param queries Zapytania w formacie runQuery().
+     * @return Identyfikator żądania; wyniki w kolejności zapytań przekazuje sygnał queryResultsReady().
+     */
+    Q_INVOKABLE int runQueries(const QVariantList& queries);
+
+    /**
+     * @brief Zwraca anomalie wykryte we wszystkich pobranych seriach.
+     * @param type Rodzaj anomalii ("zscore", "mad", "flatline", "spike"); pusty dla wszystkich.
+     * @param stationId Identyfikator stacji do zawężenia wyników (domyślnie -1 dla wszystkich stacji).
+     * @return Lista anomalii posortowana malejąco po czasie.
+     */
+    Q_INVOKABLE QVariantList queryAnomalies(const QString& type = QString(), int stationId = -1);
+
+    /**
+     * @brief Ustawia horyzont prognozy i odświeża prognozę bieżącego czujnika.
+     * @param hours Liczba godzin prognozy (6-24).
+     */
+    Q_INVOKABLE void setForecastHorizon(int hours);
+
+    /**
+     * @brief Ponownie dopasowuje modele prognoz wszystkich pobranych czujników (równolegle, w tle).
+     */
+    Q_INVOKABLE void refreshForecasts();
+
+    /**
+     * @brief Przenosi serię bieżącego czujnika na regularną siatkę czasu i wyświetla ją.
+     * @param step Krok siatki ("hour" lub "day").
+     * @param policy Polityka wypełniania luk ("null", "linear" lub "carry").
+     * @param maxGap Maksymalna długość wypełnianej luki w krokach siatki (0 bez ograniczeń).
+     * @return QVariantMap z pokryciem siatki danymi (coverage) i liczbą punktów (count).
+     */
+    Q_INVOKABLE QVariantMap resampleMeasurements(const QString& step, const QString& policy, int maxGap = 3);
+
+    /**
+     * @brief Wyrównuje serie wielu czujników do wspólnej siatki czasu.
+     * @param sensorIds Lista identyfikatorów czujników (serie muszą być już pobrane).
+     * @param step Krok siatki ("hour" lub "day").
+     * @param policy Polityka wypełniania luk ("null", "linear" lub "carry").
+     * @param maxGap Maksymalna długość wypełnianej luki w krokach siatki (0 bez ograniczeń).
+     * @return QVariantMap z siatką (timestamps) i listą serii (series: sensorId, key, values, coverage).
+     */
+    Q_INVOKABLE QVariantMap alignSensors(const QVariantList& sensorIds, const QString& step,
+                                         const QString& policy, int maxGap = 3);
+
+    /**
+     * @brief Oblicza macierz korelacji wszystkich czujników stacji.
+     * @param stationId Identyfikator stacji.
+     * @param method Metoda korelacji ("pearson" lub "spearman").
+     */
+    Q_INVOKABLE void computeStationCorrelation(int stationId, const QString& method = "pearson");
+
+    /**
+     * @brief Oblicza macierz korelacji jednego parametru na wszystkich stacjach katalogu.
+     *
+     * Listy czujników stacji, które nie były jeszcze pobierane, są najpierw pobierane z API,
+     * aby macierz obejmowała całą sieć, a nie tylko odwiedzone stacje.
+     * @param paramCode Kod parametru (np. PM10).
+     * @param method Metoda korelacji ("pearson" lub "spearman").
+     */
+    Q_INVOKABLE void computeParameterCorrelation(const QString& paramCode, const QString& method = "pearson");
+
+    /**
+     * @brief Oblicza macierz korelacji dla podanego zestawu czujników.
+     *
+     * Brakujące serie są pobierane z API, a obliczenia startują po nadejściu wszystkich odpowiedzi.
+     * @param sensorIds Lista identyfikatorów czujników.
+     * @param method Metoda korelacji ("pearson" lub "spearman").
+     */
+    Q_INVOKABLE void computeCorrelation(const QVariantList& sensorIds, const QString& method = "pearson");
+
+    /**
+     * @brief Oblicza korelację wzajemną dwóch czujników z przesunięciem czasowym.
+     * @param sensorA Identyfikator pierwszego czujnika.
+     * @param sensorB Identyfikator drugiego czujnika.
+     * @param maxLag Maksymalne przesunięcie w godzinach.
+     * @return Lista map z polami lag (godziny) i coefficient.
+     */
+    Q_INVOKABLE QVariantList crossCorrelation(int sensorA, int sensorB, int maxLag = 24);
+
+    /**
+     * @brief Tworzy raport zgodności z normami UE dla wszystkich czujników.
+     *
+     * Obejmuje pełną zapisaną historię (pliki lokalnej bazy danych) połączoną z seriami
+     * pobranymi w bieżącej sesji. Obliczenia wykonywane są równolegle poza wątkiem interfejsu;
+     * wynik przekazywany jest sygnałem complianceReportUpdateRequested.
      */
-    void stationsUpdateRequested(const QVariantList& stations);
+    Q_INVOKABLE void generateComplianceReport();
 
+    /**
+     * @brief Wczytuje w tle całe archiwum lokalnej bazy danych (wszystkie stacje i czujniki).
+     *
+     * Pliki parsowane są równolegle w puli wątków; po wczytaniu emitowany jest sygnał archiveLoaded,
+     * a zapytania queryArchive() i summarizeArchive() obejmują całe archiwum.
+     */
+    Q_INVOKABLE void loadArchive();
+
+    /**
+     * @brief Zwraca punkty archiwum z zakresu czasu.
+     * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+     * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+     * @param from Początek zakresu (ms od epoki).
+     * @param to Koniec zakresu (ms od epoki).
+     * @return Lista map z polami stationId, sensorId, timestamp i value.
+     */
+    Q_INVOKABLE QVariantList queryArchive(int stationId, const QString& paramCode, double from, double to) const;
+
+    /**
+     * @brief Zwraca statystyki wartości archiwum z zakresu czasu.
+     * @param stationId Identyfikator stacji (-1 oznacza wszystkie stacje).
+     * @param paramCode Kod parametru (pusty oznacza wszystkie parametry).
+     * @param from Początek zakresu (ms od epoki).
+     * @param to Koniec zakresu (ms od epoki).
+     * @return Mapa z polami count, series, mean, min i max.
+     */
+    Q_INVOKABLE QVariantMap summarizeArchive(int stationId, const QString& paramCode, double from, double to) const;
+
+    /**
+     * @brief Opisuje całą zapisaną historię stacji (po jednej linii na parametr).
+     * @param stationId Identyfikator stacji.
+     * @return Opis lub informacja o braku danych.
+     */
+    Q_INVOKABLE QString archiveStationSummary(int stationId) const;
+
+    /**
+     * @brief Włącza lub wyłącza odświeżanie danych w tle.
+     * @param enabled True, aby włączyć.
+     */
+    Q_INVOKABLE void setAutoRefresh(bool enabled);
+
+    /**
+     * @brief Włącza lub wyłącza wstępne pobieranie danych prawdopodobnie wybieranych stacji.
+     * @param enabled True, aby włączyć.
+     */
+    Q_INVOKABLE void setPrefetchEnabled(bool enabled);
+
+    /**
+     * @brief Zwraca skuteczność wstępnego pobierania i czasy od kliknięcia do wykresu.
+     * @return QVariantMap z liczbą danych potrzebnych po kliknięciach (lookups), trafień (hits),
+     *         odsetkiem trafień (hitRate), liczbą wykresów (charts), medianą i 95. percentylem
+     *         czasu od wyboru czujnika do wykresu (chartMedianMs, chartP95Ms) oraz liczbą
+     *         i rozmiarem zapytań wstępnych (requests, failed, bytes).
+     */
+    Q_INVOKABLE QVariantMap prefetchStats() const;
+
+    /**
+     * @brief Dodaje czujnik do listy obserwowanych lub go z niej usuwa.
+     *
+     * Obserwowane czujniki są odświeżane w tle także wtedy, gdy nie są wybrane;
+     * lista jest zapisywana w lokalnej bazie danych.
+     * @param sensorId Identyfikator czujnika.
+     * @param watched True, aby obserwować.
+     */
+    Q_INVOKABLE void setSensorWatched(int sensorId, bool watched);
+
+    /**
+     * @brief Sprawdza, czy czujnik jest obserwowany.
+     * @param sensorId Identyfikator czujnika.
+     * @return True, jeśli czujnik jest na liście obserwowanych.
+     */
+    Q_INVOKABLE bool isSensorWatched(int sensorId) const;
+
+    /**
+     * @brief Ustawia stacje widoczne na mapie (odświeżane z wyższym priorytetem niż obserwowane).
+     * @param stationIds Identyfikatory stacji.
+     */
+    Q_INVOKABLE void setVisibleStations(const QVariantList& stationIds);
+
+    /**
+     * @brief Zwraca statystyki zapytań do API (ponowienia, zapytania zabezpieczające, percentyle czasów) i synchronizacji.
+     * @return Raport tekstowy, jedna linia na punkt końcowy i linia synchronizacji.
+     */
+    Q_INVOKABLE QString networkMetrics() const;
+
+    /**
+     * @brief Zwraca liczniki elementów przekazanych do interfejsu.
+     *
+     * Dla każdego sygnału z danymi i każdego modelu listy podaje liczbę aktualizacji, łączną
+     * liczbę przekazanych elementów oraz liczbę elementów w ostatniej i największej aktualizacji;
+     * w stanie ustalonym odświeżenia powinny przekazywać tylko nowe dane.
+     * @return Raport tekstowy, jedna linia na sygnał lub model.
+     */
+    Q_INVOKABLE QString uiUpdateMetrics() const;
+
+    /**
+     * @brief Nakłada serię czujnika na wykres (porównanie parametrów lub stacji).
+     *
+     * Seria jest od razu wysyłana z pamięci podręcznej lub danych lokalnych, a następnie
+     * pobierana z API niezależnie od pozostałych serii; odpowiedź trafia na wykres jako zmiany.
+     * @param sensorId Identyfikator czujnika.
+     */
+    Q_INVOKABLE void addOverlaySensor(int sensorId);
+
+    /**
+     * @brief Zdejmuje nałożoną serię czujnika z wykresu.
+     * @param sensorId Identyfikator czujnika.
+     */
+    Q_INVOKABLE void removeOverlaySensor(int sensorId);
+
+    /**
+     * @brief Zdejmuje z wykresu wszystkie nałożone serie.
+     */
+    Q_INVOKABLE void clearOverlaySensors();
+
+    /**
+     * @brief Uruchamia odbiór odczytów z własnych czujników przez UDP.
+     *
+     * Każdy datagram zawiera jedną lub więcej linii "urządzenie;parametr;czas_ms;wartość".
+     * @param port Numer portu UDP.
+     * @return True, jeśli gniazdo zostało związane z portem.
+     */
+    Q_INVOKABLE bool startLocalIngestion(int port);
+
+    /**
+     * @brief Odtwarza plik z zapisanymi odczytami własnych czujników.
+     * @param path Ścieżka do pliku (format jak w datagramach, jedna linia na odczyt).
+     * @param speed Przyspieszenie odtwarzania (<= 0 bez przerw).
+     * @return True, jeśli odtwarzanie zostało uruchomione.
+     */
+    Q_INVOKABLE bool replayLocalFile(const QString& path, double speed = 1.0);
+
+    /**
+     * @brief Wyświetla na wykresie serię czujnika lokalnego (bieżące okno LOCAL_RETENTION_MS).
+     * @param sensorId Identyfikator czujnika lokalnego.
+     */
+    Q_INVOKABLE void showLocalSensor(int sensorId);
+
+    /**
+     * @brief Zwraca stan odbioru odczytów lokalnych.
+     * @return Opis (liczba odczytów, straty, zapełnienie kolejki, najdłuższa klatka).
+     */
+    Q_INVOKABLE QString localIngestionStatus() const;
+
+    /**
+     * @brief Uruchamia lokalne API HTTP/JSON z danymi z pamięci podręcznej i lokalnej bazy danych.
+     *
+     * Serwer nasłuchuje tylko na 127.0.0.1 i działa we własnym wątku; dane są mu
+     * publikowane przy każdej zmianie serii, katalogu stacji, indeksów i archiwum.
+     * @param port Numer portu TCP (0 wybiera wolny port).
+     * @return True, jeśli serwer nasłuchuje.
+     */
+    Q_INVOKABLE bool startLocalApi(int port);
+
+    /**
+     * @brief Zwraca stan lokalnego API.
+     * @return Opis (adres, liczba zapytań, odpowiedzi 304 i gzip, czasy obsługi).
+     */
+    Q_INVOKABLE QString localApiStatus() const;
+
+signals:
     /**
      * @brief Emitowany, gdy informacje o stacji wymagają aktualizacji.
      * @param info Informacje o stacji w formacie HTML.
@@ -116,10 +448,11 @@ signals:
     void stationInfoUpdateRequested(const QString& info);
 
     /**
-     * @brief Emitowany, gdy lista czujników wymaga aktualizacji.
-     * @param sensors Lista czujników w formacie QVariantList.
+     * @brief Emitowany po odebraniu indeksu jakości powietrza stacji.
+     * @param stationId Identyfikator stacji.
+     * @param level Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak indeksu).
      */
-    void sensorsUpdateRequested(const QVariantList& sensors);
+    void stationLevelUpdated(int stationId, int level);
 
     /**
      * @brief Emitowany, gdy pomiary wymagają aktualizacji.
@@ -128,6 +461,54 @@ signals:
      */
     void measurementsUpdateRequested(const QString& key, const QVariantList& values);
 
+    /**
+     * @brief Emitowany, gdy do wyświetlanej serii dochodzą nowsze pomiary (aktualizacja przyrostowa).
+     * @param title Tytuł wykresu (klucz parametru, ewentualnie z opisem źródła danych).
+     * @param values Nowe pomiary (nowsze niż ostatni wyświetlony) w formacie QVariantList.
+     */
+    void measurementsAppended(const QString& title, const QVariantList& values);
+
+    /**
+     * @brief Emitowany, gdy API poprawiło lub uzupełniło już wyświetlone godziny.
+     * @param values Poprawione pomiary w formacie QVariantList.
+     */
+    void measurementsCorrected(const QVariantList& values);
+
+    /**
+     * @brief Emitowany, gdy z wyświetlanej serii lokalnej usunięto pomiary starsze niż okno przechowywania.
+     * @param cutoff Znacznik czasu w milisekundach; punkty wcześniejsze są usuwane z wykresu.
+     */
+    void measurementsTrimmed(qint64 cutoff);
+
+    /**
+     * @brief Emitowany po nałożeniu serii czujnika na wykres.
+     * @param sensorId Identyfikator czujnika.
+     * @param label Etykieta serii (parametr i nazwa stacji).
+     * @param paramCode Kod parametru (serie o tym samym kodzie mogą dzielić oś Y).
+     * @param values Znane pomiary w formacie QVariantList (mogą być puste do czasu odpowiedzi API).
+     */
+    void overlaySeriesAdded(int sensorId, const QString& label, const QString& paramCode, const QVariantList& values);
+
+    /**
+     * @brief Emitowany, gdy nałożona seria otrzymała nowe lub poprawione pomiary.
+     * @param sensorId Identyfikator czujnika.
+     * @param values Nowe i poprawione pomiary w formacie QVariantList.
+     */
+    void overlaySeriesUpdated(int sensorId, const QVariantList& values);
+
+    /**
+     * @brief Emitowany po zdjęciu nałożonej serii z wykresu.
+     * @param sensorId Identyfikator czujnika.
+     */
+    void overlaySeriesRemoved(int sensorId);
+
+    /**
+     * @brief Emitowany, gdy z nałożonej serii lokalnej usunięto pomiary starsze niż okno przechowywania.
+     * @param sensorId Identyfikator czujnika.
+     * @param cutoff Znacznik czasu w milisekundach; punkty wcześniejsze są usuwane z wykresu.
+     */
+    void overlaySeriesTrimmed(int sensorId, qint64 cutoff);
+
     /**
      * @brief Emitowany, gdy indeks jakości powietrza wymaga aktualizacji.
      * @param text Tekst opisujący indeks (np. "Dobry").
@@ -147,6 +528,89 @@ signals:
      */
     void analysisUpdateRequested(const QVariantMap& analysis);
 
+    /**
+     * @brief Emitowany, gdy zmieniają się anomalie wyświetlanej serii.
+     * @param anomalies Lista oznaczonych punktów (timestamp, value, type).
+     */
+    void anomaliesUpdateRequested(const QVariantList& anomalies);
+
+    /**
+     * @brief Emitowany, gdy zmieniły się anomalie wyświetlanej serii.
+     * @param added Nowe lub zmienione anomalie (format jak w anomaliesUpdateRequested).
+     * @param removed Znaczniki czasu anomalii do usunięcia z wykresu.
+     */
+    void anomaliesChanged(const QVariantList& added, const QVariantList& removed);
+
+    /**
+     * @brief Emitowany, gdy prognoza wyświetlanej serii wymaga aktualizacji.
+     * @param values Lista prognozowanych punktów (timestamp, value).
+     */
+    void forecastUpdateRequested(const QVariantList& values);
+
+    /**
+     * @brief Emitowany, gdy zmienia się stan obliczeń macierzy korelacji.
+     * @param status Opis stanu (np. liczba oczekujących serii lub czas obliczeń).
+     */
+    void correlationUpdateRequested(const QString& status);
+
+    /**
+     * @brief Emitowany, gdy raport zgodności z normami jest gotowy.
+     * @param rows Wiersze raportu (stacja, parametr, rok, liczba dni z przekroczeniem i inne).
+     */
+    void complianceReportUpdateRequested(const QVariantList& rows);
+
+    /**
+     * @brief Emitowany po wczytaniu archiwum lokalnej bazy danych.
+     * @param status Opis archiwum (liczba plików, serii i punktów, czas wczytywania).
+     */
+    void archiveLoaded(const QString& status);
+
+    /**
+     * @brief Emitowany po wykonaniu zapytań analitycznych.
+     * @param requestId Identyfikator żądania zwrócony przez runQuery() lub runQueries().
+     * @param results Wyniki w kolejności zapytań.
+     */
+    void queryResultsReady(int requestId, const QVariantList& results);
+
+    /**
+     * @brief Emitowany po wyborze stacji, gdy zaczyna się budowa przeglądu jej czujników.
+     * @param stationId Identyfikator stacji.
+     * @param sensorCount Liczba znanych czujników stacji (0, jeśli lista czujników jest jeszcze pobierana).
+     */
+    void dashboardReset(int stationId, int sensorCount);
+
+    /**
+     * @brief Emitowany po obliczeniu podsumowania kolejnego czujnika przeglądu stacji.
+     * @param summary Mapa z polami sensorId, paramCode, paramName, count, latest, latestDate, mean, min, max,
+     *        trend, trendName, sparkline, anomalies, error (brak danych), warning (błąd pobrania przy
+     *        danych lokalnych) oraz stanem przeglądu (ready, total, elapsedMs).
+     */
+    void dashboardSensorUpdated(const QVariantMap& summary);
+
+    /**
+     * @brief Emitowany po wysłaniu zapytań przez harmonogram odświeżania w tle.
+     * @param status Opis stanu (liczba zapytań i śledzonych elementów).
+     */
+    void pollingStatusUpdated(const QString& status);
+
+    /**
+     * @brief Emitowany, gdy wyłącznik zapytań do API otwiera się lub zamyka.
+     * @param status Opis stanu (pusty, gdy API odpowiada normalnie).
+     */
+    void apiStatusUpdated(const QString& status);
+
+    /**
+     * @brief Emitowany, gdy pojawią się nowe czujniki lokalne.
+     * @param sensors Lista map z polami sensorId i label.
+     */
+    void localSensorsUpdated(const QVariantList& sensors);
+
+    /**
+     * @brief Emitowany okresowo w trakcie odbioru odczytów lokalnych.
+     * @param status Opis stanu odbioru.
+     */
+    void localIngestionStatusUpdated(const QString& status);
+
 private slots:
     /**
      * @brief Obsługuje odpowiedź API z danymi o stacjach.
@@ -171,9 +635,13 @@ private slots:
 private:
     /// @brief Menedżer sieciowy do żądań HTTP.
     QNetworkAccessManager* networkManager;
+    /// @brief Odporna warstwa zapytań (limity czasu, ponowienia, zapytania zabezpieczające, wyłącznik).
+    ApiClient* api;
 
     /// @brief Bazowy URL API GIOŚ.
     const QString API_BASE_URL = "https://api.gios.gov.pl/pjp-api/rest/";
+    /// @brief Używany adres bazowy API (domyślnie API_BASE_URL).
+    QString apiBaseUrl = API_BASE_URL;
     /// @brief Endpoint do pobierania wszystkich stacji.
     const QString API_STATIONS_ENDPOINT = "station/findAll";
     /// @brief Endpoint do pobierania czujników dla stacji.
@@ -183,12 +651,21 @@ private:
     /// @brief Endpoint do pobierania indeksu jakości powietrza.
     const QString API_AIR_QUALITY_ENDPOINT = "aqindex/getIndex/";
 
-    /// @brief Tablica JSON ze wszystkimi stacjami.
-    QJsonArray allStations;
-    /// @brief Mapa stacji według ich ID.
-    QMap<int, QJsonObject> stationsMap;
-    /// @brief Mapa czujników według ich ID.
-    QMap<int, QJsonObject> sensorsMap;
+    /// @brief Zwarty katalog stacji i czujników (struktura tablic z pulą napisów).
+    StationCatalog catalog;
+    /// @brief Model listy stacji (pełny katalog).
+    StationListModel* stationModel;
+    /// @brief Model pośredniczący filtrujący stacje po nazwie miejscowości.
+    StationFilterProxyModel* stationProxy;
+    /// @brief Model listy czujników wybranej stacji.
+    SensorListModel* sensorModel;
+
+    /// @brief Harmonogram odświeżania danych w tle.
+    PollingScheduler* scheduler;
+    /// @brief Identyfikatory obserwowanych czujników.
+    QSet<int> watchedSensors;
+    /// @brief Czy interfejs wyświetla dane historyczne.
+    bool usingHistoricalData = false;
 
     /// @brief ID aktualnie wybranej stacji.
     int currentStationId = -1;
@@ -201,6 +678,130 @@ private:
     /// @brief Obiekt JSON z bieżącym indeksem jakości powietrza.
     QJsonObject currentAirQuality;
 
+    /// @brief Typowane serie pomiarowe według ID czujnika (historia lokalna połączona z danymi z API).
+    QHash<int, MeasurementSeries> seriesCache;
+    /// @brief ID czujnika, którego połączona seria jest wyświetlana na wykresie (-1, jeśli żadna).
+    int chartSensorId = -1;
+    /// @brief Czujniki nałożone na wykres w kolejności dodania (stan serii w seriesCache).
+    QVector<int> overlaySensors;
+    /// @brief Synchronizacja przyrostowa pomiarów (znaczniki najnowszych zapisanych wartości).
+    SyncEngine sync;
+    /// @brief Stacje czujników spoza bieżącej listy czujników, ustalone z nazw plików (-1, jeśli nieznana).
+    QHash<int, int> sensorStations;
+    /// @brief Liczba punktów dopisanych do dzienników pomiarów (także z wątku zapisu odczytów lokalnych).
+    std::atomic<qint64> syncPointsWritten{0};
+    /// @brief Anomalie ostatnio przekazane do wykresu (podstawa aktualizacji przyrostowych).
+    QVector<AnomalyDetector::Anomaly> shownAnomalies;
+
+    /**
+     * @brief Licznik elementów przekazywanych do interfejsu jednym sygnałem lub modelem.
+     */
+    struct UiUpdateCounter {
+        /// @brief Liczba aktualizacji.
+        qint64 updates = 0;
+        /// @brief Łączna liczba przekazanych elementów.
+        qint64 items = 0;
+        /// @brief Liczba elementów w ostatniej aktualizacji.
+        int lastItems = 0;
+        /// @brief Największa liczba elementów w jednej aktualizacji.
+        int maxItems = 0;
+    };
+    /// @brief Liczniki przekazanych elementów według nazwy sygnału lub modelu.
+    QMap<QString, UiUpdateCounter> uiUpdates;
+
+    /// @brief Najmniejszy rozmiar dziennika pomiarów scalanego z plikiem głównym (bajty).
+    static constexpr qint64 JOURNAL_COMPACT_BYTES = 256 * 1024;
+    /// @brief Anomalie wykryte w seriach według ID czujnika.
+    QHash<int, QVector<AnomalyDetector::Anomaly>> anomaliesMap;
+    /// @brief Obserwatory detekcji anomalii w puli wątków według ID czujnika.
+    QHash<int, QFutureWatcher<QVector<AnomalyDetector::Anomaly>>*> anomalyJobs;
+    /// @brief Początek zmian (znacznik czasu) do ponownej detekcji po zakończeniu trwającej, według ID czujnika.
+    QHash<int, qint64> anomalyRescans;
+    /// @brief Stany modeli prognoz według ID czujnika.
+    QHash<int, Forecaster::State> forecastStates;
+    /// @brief Obserwatory dopasowań modeli prognoz w puli wątków według ID czujnika.
+    QHash<int, QFutureWatcher<Forecaster::State>*> forecastFits;
+    /// @brief Obserwator ponownego dopasowania modeli prognoz wszystkich czujników.
+    QFutureWatcher<QHash<int, Forecaster::State>>* forecastRefreshWatcher;
+    /// @brief Horyzont prognozy w godzinach.
+    int forecastHorizon = 24;
+
+    /// @brief Model macierzy korelacji udostępniany w QML.
+    CorrelationMatrixModel* correlationModel;
+    /// @brief Obserwator obliczeń macierzy korelacji w puli wątków.
+    QFutureWatcher<CorrelationEngine::Result>* correlationWatcher;
+    /// @brief Czujniki oczekującego obliczenia korelacji.
+    QVector<int> correlationSensorIds;
+    /// @brief Czujniki, na których serie czeka obliczenie korelacji.
+    QSet<int> correlationWaiting;
+    /// @brief Stacje, na których listy czujników czeka korelacja parametru.
+    QSet<int> correlationStationsWaiting;
+    /// @brief Kod parametru oczekującej korelacji parametru.
+    QString correlationParam;
+    /// @brief Metoda oczekującego obliczenia korelacji.
+    QString correlationMethod;
+    /// @brief Etykiety serii bieżącego obliczenia korelacji.
+    QStringList correlationLabels;
+    /// @brief Obserwator obliczeń raportu zgodności w puli wątków.
+    QFutureWatcher<QVector<RegulatoryMetrics::SensorReport>>* complianceWatcher;
+    /// @brief Archiwum lokalnej bazy danych (puste do pierwszego wywołania loadArchive()).
+    HistoryArchive archive;
+    /// @brief Obserwator wczytywania archiwum w puli wątków.
+    QFutureWatcher<HistoryArchive>* archiveWatcher;
+    /// @brief Czy archiwum zostało wczytane co najmniej raz.
+    bool archiveReady = false;
+    /// @brief Zapytania analityczne po archiwum i punktach zapisanych w sesji.
+    QueryEngine queryEngine;
+    /// @brief Identyfikator ostatniego żądania zapytań analitycznych.
+    int queryRequests = 0;
+    /// @brief Stacja, dla której budowany jest przegląd czujników (-1, jeśli żadna).
+    int dashboardStationId = -1;
+    /// @brief Czujniki przeglądu z zapytaniem o pomiary w toku.
+    QSet<int> dashboardRequests;
+    /// @brief Czujniki przeglądu, których podsumowanie zostało już wysłane.
+    QSet<int> dashboardReady;
+    /// @brief Błędy pobierania pomiarów czujników przeglądu według ID czujnika.
+    QHash<int, QString> dashboardErrors;
+    /// @brief Numer ostatnio uruchomionego obliczenia podsumowania według ID czujnika.
+    QHash<int, int> dashboardVersions;
+    /// @brief Czas od wyboru stacji przeglądu.
+    QElapsedTimer dashboardTimer;
+    /// @brief Wstępne pobieranie danych prawdopodobnie wybieranych stacji.
+    Prefetcher* prefetcher;
+    /// @brief Liczba sąsiadów na liście (w każdą stronę) przekazywanych do wstępnego pobierania.
+    static constexpr int PREFETCH_LIST_NEIGHBOURS = 2;
+    /// @brief Liczba najbliższych geograficznie stacji przekazywanych do wstępnego pobierania.
+    static constexpr int PREFETCH_NEARBY_STATIONS = 4;
+    /// @brief Ostatnie indeksy jakości powietrza według ID stacji.
+    QHash<int, QJsonObject> airQualityCache;
+    /// @brief Czas od wyboru czujnika, którego wykres nie został jeszcze pokazany.
+    QElapsedTimer chartClock;
+    /// @brief Czujnik mierzony przez chartClock (-1, jeśli żaden).
+    int chartClockSensor = -1;
+    /// @brief Czasy od wyboru czujnika do wykresu z aktualnymi danymi.
+    LatencyTracker clickToChart{1024};
+
+    /// @brief Identyfikator stacji, pod którym zapisywane są czujniki lokalne.
+    static constexpr int LOCAL_STATION_ID = 0;
+    /// @brief Pierwszy identyfikator czujnika lokalnego (poza zakresem identyfikatorów GIOŚ).
+    static constexpr int LOCAL_SENSOR_BASE = 1000000000;
+    /// @brief Okno odczytów lokalnych przechowywane w pamięci (starsze są tylko na dysku, ms).
+    static constexpr qint64 LOCAL_RETENTION_MS = 15 * 60 * 1000;
+    /// @brief Odstęp zapisu odczytów lokalnych do dzienników i odświeżania ich stanu (ms).
+    static constexpr int LOCAL_FLUSH_MS = 1000;
+    /// @brief Odbiór odczytów z własnych czujników (UDP lub odtwarzany plik).
+    LocalIngestor* ingestor;
+    /// @brief Czujniki lokalne w kolejności pierwszego odczytu.
+    QVector<int> localSensors;
+    /// @brief Odczyty lokalne oczekujące na zapis do dziennika, według ID czujnika.
+    QHash<int, MeasurementSeries> localPending;
+    /// @brief Zegar zapisu odczytów lokalnych.
+    QTimer* localFlushTimer;
+    /// @brief Jednowątkowa pula zapisu odczytów lokalnych (zapisy wykonywane po kolei, poza wątkiem interfejsu).
+    QThreadPool localStoragePool;
+    /// @brief Lokalne API HTTP/JSON (nullptr do wywołania startLocalApi()).
+    LocalApiServer* localApi = nullptr;
+
     /**
      * @brief Zwraca ścieżkę do lokalnej bazy danych.
      * @return Ścieżka do katalogu bazy danych.
@@ -215,6 +816,14 @@ private:
      */
     QString getMeasurementsFilePath(int stationId, int sensorId);
 
+    /**
+     * @brief Generuje ścieżkę do dziennika przyrostowych zmian pomiarów.
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     * @return Ścieżka do pliku JSON Lines z dopisywanymi pomiarami.
+     */
+    QString getMeasurementsJournalPath(int stationId, int sensorId);
+
     /**
      * @brief Generuje ścieżkę do pliku z indeksem jakości powietrza.
      * @param stationId Identyfikator stacji.
@@ -222,6 +831,18 @@ private:
      */
     QString getAirQualityFilePath(int stationId);
 
+    /**
+     * @brief Zwraca ścieżkę do pamięci podręcznej katalogu stacji.
+     * @return Ścieżka do pliku JSON z ostatnią odpowiedzią station/findAll.
+     */
+    QString getStationsCachePath();
+
+    /**
+     * @brief Wypełnia katalog i listę stacji z pamięci podręcznej (bez zapytania do API).
+     * @return True, jeśli wczytano stacje.
+     */
+    bool loadCachedStations();
+
     /**
      * @brief Zapisuje dokument JSON do pliku.
      * @param filePath Ścieżka do pliku.
@@ -245,33 +866,297 @@ private:
     /**
      * @brief Pobiera dane o czujnikach dla stacji z API.
      * @param stationId Identyfikator stacji.
+     * @param prefetch True dla zapytania wstępnego (bez zmiany listy czujników w interfejsie).
      */
-    void fetchSensors(int stationId);
+    void fetchSensors(int stationId, bool prefetch = false);
 
     /**
      * @brief Pobiera pomiary dla czujnika z API.
      * @param sensorId Identyfikator czujnika.
+     * @param background True dla zapytania z harmonogramu odświeżania w tle.
+     * @param prefetch True dla zapytania wstępnego.
      */
-    void fetchMeasurements(int sensorId);
+    void fetchMeasurements(int sensorId, bool background = false, bool prefetch = false);
 
     /**
      * @brief Pobiera indeks jakości powietrza dla stacji z API.
      * @param stationId Identyfikator stacji.
+     * @param background True dla zapytania z harmonogramu odświeżania w tle.
+     * @param prefetch True dla zapytania wstępnego.
+     */
+    void fetchAirQualityIndex(int stationId, bool background = false, bool prefetch = false);
+
+    /**
+     * @brief Wyświetla indeks jakości powietrza bieżącej stacji.
+     * @param airQuality Obiekt JSON indeksu w formacie API.
+     */
+    void showAirQuality(const QJsonObject& airQuality);
+
+    /**
+     * @brief Przekazuje do wstępnego pobierania otoczenie stacji (sąsiedzi na liście, najbliższe stacje).
+     * @param stationId Identyfikator stacji.
+     */
+    void updatePrefetchContext(int stationId);
+
+    /**
+     * @brief Przekazuje do wstępnego pobierania stacje obserwowanych czujników.
+     */
+    void updateFavouriteStations();
+
+    /**
+     * @brief Zapisuje czas od wyboru czujnika do pokazania wykresu z aktualnymi danymi.
+     * @param sensorId Identyfikator czujnika, którego wykres został pokazany.
+     */
+    void noteChartShown(int sensorId);
+
+    /**
+     * @brief Wczytuje wyuczony profil wstępnego pobierania z lokalnej bazy danych.
+     */
+    void loadPrefetchProfile();
+
+    /**
+     * @brief Zapisuje wyuczony profil wstępnego pobierania do lokalnej bazy danych.
+     */
+    void savePrefetchProfile();
+
+    /**
+     * @brief Wczytuje listę obserwowanych czujników z lokalnej bazy danych.
      */
-    void fetchAirQualityIndex(int stationId);
+    void loadWatchList();
 
     /**
-     * @brief Wyświetla listę stacji w interfejsie.
-     * @param stations Tablica JSON z danymi stacji.
+     * @brief Zapisuje listę obserwowanych czujników do lokalnej bazy danych.
      */
-    void displayStations(const QJsonArray& stations);
+    void saveWatchList();
 
     /**
      * @brief Generuje informacje o stacji w formacie HTML.
-     * @param station Obiekt JSON z danymi stacji.
+     * @param stationId Identyfikator stacji w katalogu.
      * @return Tekst HTML z informacjami o stacji.
      */
-    QString generateStationInfo(const QJsonObject& station);
+    QString generateStationInfo(int stationId);
+
+    /**
+     * @brief Pobiera równolegle pomiary czujników przeglądu stacji.
+     *
+     * Czujniki z serią w pamięci podręcznej są podsumowywane od razu, a po odpowiedzi API ponownie.
+     * @param sensorIds Czujniki stacji przeglądu.
+     */
+    void startDashboard(const QVector<int>& sensorIds);
+
+    /**
+     * @brief Uruchamia w puli wątków obliczenie podsumowania czujnika przeglądu stacji.
+     * @param sensorId Identyfikator czujnika (pomijany, jeśli nie należy do stacji przeglądu).
+     */
+    void updateDashboard(int sensorId);
+
+    /**
+     * @brief Zamienia podsumowanie czujnika na mapę dla interfejsu.
+     * @param summary Podsumowanie czujnika.
+     * @return Mapa w formacie sygnału dashboardSensorUpdated.
+     */
+    QVariantMap dashboardSummaryMap(const StationDashboard::Summary& summary);
+
+    /**
+     * @brief Uruchamia w tle detekcję anomalii dla serii czujnika zapisanej w pamięci podręcznej.
+     * @param sensorId Identyfikator czujnika.
+     * @param changedFrom Znacznik czasu pierwszego zmienionego punktu (domyślnie cała seria).
+     */
+    void detectAnomalies(int sensorId, qint64 changedFrom = std::numeric_limits<qint64>::min());
+
+    /**
+     * @brief Zamienia anomalie na listę do wyświetlenia w interfejsie.
+     * @param sensorId Identyfikator czujnika.
+     * @param anomalies Lista anomalii.
+     * @return Lista map z polami timestamp, date, value, type, sensorId i stationId.
+     */
+    QVariantList anomaliesToVariantList(int sensorId, const QVector<AnomalyDetector::Anomaly>& anomalies);
+
+    /**
+     * @brief Aktualizuje przyrostowo model prognozy czujnika nowymi punktami serii.
+     * @param sensorId Identyfikator czujnika.
+     */
+    void updateForecast(int sensorId);
+
+    /**
+     * @brief Emituje prognozę dla bieżącego czujnika.
+     */
+    void emitCurrentForecast();
+
+    /**
+     * @brief Zamienia typowaną serię na listę punktów w formacie interfejsu.
+     * @param series Seria pomiarowa.
+     * @return Lista map z polami "date" i "value" (null dla braków).
+     */
+    QVariantList seriesToVariantList(const MeasurementSeries& series);
+
+    /**
+     * @brief Wczytuje zapisaną historię pomiarów czujnika z lokalnej bazy danych.
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     * @return Seria pomiarowa (pusta, jeśli brak zapisanych danych).
+     */
+    MeasurementSeries loadStoredSeries(int stationId, int sensorId);
+
+    /**
+     * @brief Wyświetla całą połączoną serię czujnika wraz z anomaliami i prognozą.
+     * @param sensorId Identyfikator czujnika.
+     * @param title Tytuł wykresu (klucz parametru z ewentualnym opisem źródła).
+     */
+    void showSeries(int sensorId, const QString& title);
+
+    /**
+     * @brief Przekazuje do wykresu wyłącznie nowe i poprawione punkty serii.
+     * @param sensorId Identyfikator czujnika.
+     * @param delta Zmiany wydzielone z odpowiedzi API.
+     */
+    void showDelta(int sensorId, const SyncEngine::Delta& delta);
+
+    /**
+     * @brief Wstawia punkty do listy bieżących pomiarów lub zastępuje punkty o tej samej dacie.
+     * @param points Punkty w formacie interfejsu.
+     */
+    void upsertCurrentMeasurements(const QVariantList& points);
+
+    /**
+     * @brief Odtwarza listę bieżących pomiarów z serii czujnika lokalnego i przycina wykres do jej początku.
+     * @param sensorId Identyfikator czujnika lokalnego.
+     */
+    void refreshLocalMeasurements(int sensorId);
+
+    /**
+     * @brief Przekazuje anomalie serii wyświetlanej na wykresie.
+     * @param sensorId Identyfikator czujnika.
+     * @param anomalies Aktualne anomalie serii (rosnąco po czasie).
+     * @param incremental True, aby emitować tylko zmiany względem ostatnio wyświetlonych.
+     */
+    void showAnomalies(int sensorId, const QVector<AnomalyDetector::Anomaly>& anomalies, bool incremental);
+
+    /**
+     * @brief Zlicza elementy przekazane do interfejsu jedną emisją sygnału lub zmianą modelu.
+     * @param channel Nazwa sygnału lub modelu.
+     * @param items Liczba przekazanych elementów.
+     */
+    void countUiUpdate(const QString& channel, int items);
+
+    /**
+     * @brief Zwraca liczbę punktów przekazanych do wykresu (seria główna i nałożone).
+     * @return Liczba punktów.
+     */
+    qint64 chartPointsEmitted() const;
+
+    /**
+     * @brief Wydziela zmiany z odpowiedzi API, dopisuje je do serii w pamięci i do dziennika na dysku.
+     * @param sensorId Identyfikator czujnika.
+     * @param live Seria z odpowiedzi API.
+     * @return Punkty nowe i poprawione.
+     */
+    SyncEngine::Delta syncMeasurements(int sensorId, const MeasurementSeries& live);
+
+    /**
+     * @brief Zwraca stację czujnika (z listy czujników lub z nazw zapisanych plików).
+     * @param sensorId Identyfikator czujnika.
+     * @return Identyfikator stacji lub -1, jeśli nieznany.
+     */
+    int stationOfSensor(int sensorId);
+
+    /**
+     * @brief Publikuje serię czujnika z pamięci podręcznej w lokalnym API (jeśli jest uruchomione).
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     */
+    void publishSeries(int stationId, int sensorId);
+
+    /**
+     * @brief Dopisuje punkty do dziennika pomiarów czujnika.
+     *
+     * Dziennik jest scalany z plikiem głównym, gdy przekroczy JOURNAL_COMPACT_BYTES i połowę
+     * rozmiaru pliku głównego (koszt przepisywania historii rozłożony liniowo).
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     * @param points Dopisywane punkty.
+     * @return True, jeśli zapis się powiódł.
+     */
+    bool appendMeasurementsToDatabase(int stationId, int sensorId, const MeasurementSeries& points);
+
+    /**
+     * @brief Zapisuje pełną serię do pliku głównego i usuwa dziennik czujnika.
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     * @param series Pełna seria (historia wraz z dziennikiem).
+     * @return True, jeśli zapis się powiódł.
+     */
+    bool writeMeasurementsSnapshot(int stationId, int sensorId, const MeasurementSeries& series);
+
+    /**
+     * @brief Oznacza serię czujnika jako dostępną dla oczekującego obliczenia korelacji.
+     * @param sensorId Identyfikator czujnika.
+     */
+    void resolvePendingCorrelation(int sensorId);
+
+    /**
+     * @brief Oznacza listę czujników stacji jako pobraną dla oczekującej korelacji parametru.
+     *
+     * Po pobraniu (lub nieudanym pobraniu) list wszystkich stacji uruchamia korelację
+     * czujników parametru correlationParam.
+     * @param stationId Identyfikator stacji.
+     */
+    void resolvePendingCorrelationStation(int stationId);
+
+    /**
+     * @brief Wyrównuje serie i uruchamia obliczenie macierzy korelacji w puli wątków.
+     */
+    void runCorrelation();
+
+    /**
+     * @brief Zwraca etykietę czujnika (parametr i nazwa stacji).
+     * @param sensorId Identyfikator czujnika.
+     * @return Etykieta czujnika.
+     */
+    QString sensorLabel(int sensorId);
+
+    /**
+     * @brief Zamienia raporty czujników na wiersze raportu zgodności.
+     * @param reports Raporty czujników.
+     * @return Lista wierszy posortowana według stacji, parametru i roku.
+     */
+    QVariantList complianceRows(const QVector<RegulatoryMetrics::SensorReport>& reports);
+
+    /**
+     * @brief Zamienia zapytanie z QML na zapytanie silnika.
+     * @param query Mapa w formacie runQuery().
+     * @return Zapytanie silnika.
+     */
+    static QueryEngine::Query toEngineQuery(const QVariantMap& query);
+
+    /**
+     * @brief Zamienia wynik zapytania na mapę dla QML.
+     * @param result Wynik silnika.
+     * @param aggregates Żądane agregaty (w kolejności percentyli zapytania silnika).
+     * @param grouping Grupowanie (do opisu grup).
+     * @return Mapa w formacie runQuery().
+     */
+    QVariantMap queryResultMap(const QueryEngine::Result& result, const QStringList& aggregates,
+                               QueryEngine::Grouping grouping) const;
+
+    /**
+     * @brief Zwraca identyfikator czujnika lokalnego.
+     * @param deviceId Identyfikator urządzenia.
+     * @param parameter Parametr (LocalIngestor::Parameter).
+     * @return Identyfikator czujnika.
+     */
+    static int localSensorId(int deviceId, int parameter);
+
+    /**
+     * @brief Dopisuje paczkę odczytów lokalnych do serii i wykresu (raz na klatkę).
+     * @param readings Odczyty zebrane od poprzedniej klatki.
+     */
+    void onLocalReadings(const QVector<LocalReading>& readings);
+
+    /**
+     * @brief Przekazuje zebrane odczyty lokalne do zapisu w tle i uruchamia detekcję anomalii wyświetlanej serii.
+     */
+    void flushLocalReadings();
 };
 
 #endif // MAINWINDOW_H
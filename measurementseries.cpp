@@ -0,0 +1,235 @@
+#include "measurementseries.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QVariantMap>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief Sortuje serię rosnąco po czasie i usuwa punkty bez poprawnej daty.
+ * @param series Seria do uporządkowania.
+ */
+void normalizeSeries(MeasurementSeries& series)
+{
+    const int n = series.timestamps.size();
+    QVector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&series](int a, int b) {
+        return series.timestamps[a] < series.timestamps[b];
+    });
+
+    QVector<qint64> timestamps;
+    QVector<double> values;
+    timestamps.reserve(n);
+    values.reserve(n);
+    for (int index : order) {
+        if (series.timestamps[index] < 0) continue;
+        timestamps.append(series.timestamps[index]);
+        values.append(series.values[index]);
+    }
+    series.timestamps = timestamps;
+    series.values = values;
+}
+
+}
+
+/**
+ * @brief Zwraca znacznik czasu najnowszej wartości (z pominięciem braków).
+ * @return Liczba milisekund od epoki lub -1, jeśli seria nie ma wartości.
+ */
+qint64 MeasurementSeries::newestValidTimestamp() const
+{
+    for (int i = values.size() - 1; i >= 0; --i) {
+        if (!std::isnan(values[i])) return timestamps[i];
+    }
+    return -1;
+}
+
+/**
+ * @brief Zamienia datę w formacie API GIOŚ na znacznik czasu.
+ * @param date Data w formacie "yyyy-MM-dd HH:mm:ss" lub ISO 8601.
+ * @return Liczba milisekund od epoki lub -1, jeśli daty nie da się odczytać.
+ */
+qint64 MeasurementSeries::parseTimestamp(const QString& date)
+{
+    QDateTime dateTime = QDateTime::fromString(date, "yyyy-MM-dd HH:mm:ss");
+    if (!dateTime.isValid()) {
+        dateTime = QDateTime::fromString(date, Qt::ISODate);
+    }
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : -1;
+}
+
+/**
+ * @brief Tworzy serię z listy punktów w formacie używanym przez interfejs.
+ * @param key Klucz parametru.
+ * @param points Lista map z polami "date" i "value".
+ * @return Seria posortowana rosnąco po czasie.
+ */
+MeasurementSeries MeasurementSeries::fromVariantList(const QString& key, const QVariantList& points)
+{
+    MeasurementSeries series;
+    series.key = key;
+    series.timestamps.reserve(points.size());
+    series.values.reserve(points.size());
+
+    for (const QVariant& point : points) {
+        QVariantMap map = point.toMap();
+        QVariant value = map["value"];
+        series.timestamps.append(parseTimestamp(map["date"].toString()));
+        series.values.append(value.isValid() && !value.isNull()
+                                 ? value.toDouble()
+                                 : std::numeric_limits<double>::quiet_NaN());
+    }
+
+    normalizeSeries(series);
+    return series;
+}
+
+/**
+ * @brief Tworzy serię z tablicy JSON w formacie API GIOŚ lub lokalnej bazy danych.
+ * @param key Klucz parametru.
+ * @param points Tablica obiektów z polami "date" i "value".
+ * @return Seria posortowana rosnąco po czasie.
+ */
+MeasurementSeries MeasurementSeries::fromJsonArray(const QString& key, const QJsonArray& points)
+{
+    MeasurementSeries series;
+    series.key = key;
+    series.timestamps.reserve(points.size());
+    series.values.reserve(points.size());
+
+    for (const QJsonValue& point : points) {
+        QJsonObject object = point.toObject();
+        QJsonValue value = object["value"];
+        series.timestamps.append(parseTimestamp(object["date"].toString()));
+        series.values.append(value.isDouble() ? value.toDouble()
+                                              : std::numeric_limits<double>::quiet_NaN());
+    }
+
+    normalizeSeries(series);
+    return series;
+}
+
+/**
+ * @brief Łączy dwie serie w jedną, uporządkowaną rosnąco po czasie.
+ *
+ * Dla powtarzających się znaczników czasu pierwszeństwo ma wartość z serii nowszej,
+ * o ile nie jest brakiem danych.
+ * @param older Seria starsza (np. z lokalnej bazy danych).
+ * @param newer Seria nowsza (np. świeżo pobrana z API).
+ * @return Połączona seria z kluczem serii nowszej (lub starszej, jeśli nowsza go nie ma).
+ */
+MeasurementSeries MeasurementSeries::merged(const MeasurementSeries& older, const MeasurementSeries& newer)
+{
+    MeasurementSeries result;
+    result.key = newer.key.isEmpty() ? older.key : newer.key;
+    result.timestamps.reserve(older.size() + newer.size());
+    result.values.reserve(older.size() + newer.size());
+
+    int i = 0;
+    int j = 0;
+    while (i < older.size() || j < newer.size()) {
+        if (j >= newer.size() || (i < older.size() && older.timestamps[i] < newer.timestamps[j])) {
+            result.timestamps.append(older.timestamps[i]);
+            result.values.append(older.values[i]);
+            ++i;
+        } else if (i >= older.size() || newer.timestamps[j] < older.timestamps[i]) {
+            result.timestamps.append(newer.timestamps[j]);
+            result.values.append(newer.values[j]);
+            ++j;
+        } else {
+            result.timestamps.append(newer.timestamps[j]);
+            result.values.append(std::isnan(newer.values[j]) ? older.values[i] : newer.values[j]);
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Dopisuje nowsze punkty na koniec serii.
+ * @param newer Punkty posortowane rosnąco po czasie.
+ */
+void MeasurementSeries::append(const MeasurementSeries& newer)
+{
+    if (newer.isEmpty()) return;
+    if (!isEmpty() && newer.timestamps.first() <= timestamps.last()) {
+        *this = merged(*this, newer);
+        return;
+    }
+    if (key.isEmpty()) key = newer.key;
+    timestamps += newer.timestamps;
+    values += newer.values;
+}
+
+/**
+ * @brief Usuwa punkty starsze niż podany znacznik czasu.
+ * @param timestamp Najstarszy zachowywany znacznik czasu (ms od epoki).
+ */
+void MeasurementSeries::removeBefore(qint64 timestamp)
+{
+    const int count = static_cast<int>(std::lower_bound(timestamps.cbegin(), timestamps.cend(), timestamp)
+                                       - timestamps.cbegin());
+    if (count == 0) return;
+    timestamps.remove(0, count);
+    values.remove(0, count);
+}
+
+/**
+ * @brief Usuwa punkty starsze o więcej niż podany czas od najnowszego punktu serii.
+ * @param duration Długość zachowywanego okna (ms).
+ */
+void MeasurementSeries::keepLast(qint64 duration)
+{
+    if (timestamps.isEmpty()) return;
+    removeBefore(timestamps.last() - duration);
+}
+
+/**
+ * @brief Odczytuje serię z pliku głównego i odtwarza na niej dziennik zmian.
+ *
+ * Dziennik to plik JSON Lines: pierwsza linia zawiera klucz parametru, kolejne pojedyncze
+ * punkty; późniejszy wpis dla tej samej godziny zastępuje wcześniejszy. Niekompletna
+ * ostatnia linia (przerwany zapis) jest pomijana.
+ * @param snapshotPath Ścieżka do pliku głównego.
+ * @param journalPath Ścieżka do dziennika.
+ * @return Seria pomiarowa (pusta, jeśli brak obu plików).
+ */
+MeasurementSeries MeasurementSeries::readStored(const QString& snapshotPath, const QString& journalPath)
+{
+    MeasurementSeries stored;
+    QFile snapshot(snapshotPath);
+    if (snapshot.open(QIODevice::ReadOnly)) {
+        QJsonObject data = QJsonDocument::fromJson(snapshot.readAll()).object();
+        stored = fromJsonArray(data.value("key").toString(), data.value("measurements").toArray());
+    }
+
+    QFile journal(journalPath);
+    if (!journal.open(QIODevice::ReadOnly)) return stored;
+
+    MeasurementSeries appended;
+    QMap<qint64, double> points;
+    while (!journal.atEnd()) {
+        QJsonObject line = QJsonDocument::fromJson(journal.readLine()).object();
+        if (line.contains("key")) {
+            appended.key = line.value("key").toString();
+            continue;
+        }
+        qint64 timestamp = parseTimestamp(line.value("date").toString());
+        if (timestamp < 0) continue;
+        QJsonValue value = line.value("value");
+        points[timestamp] = value.isDouble() ? value.toDouble() : std::numeric_limits<double>::quiet_NaN();
+    }
+    for (auto it = points.constBegin(); it != points.constEnd(); ++it) {
+        appended.timestamps.append(it.key());
+        appended.values.append(it.value());
+    }
+    return merged(stored, appended);
+}
@@ -0,0 +1,113 @@
+#ifndef MEASUREMENTSERIES_H
+#define MEASUREMENTSERIES_H
+
+#include <QString>
+#include <QVector>
+#include <QVariantList>
+#include <QJsonArray>
+#include <QDateTime>
+
+/**
+ * @brief Typowana seria pomiarowa jednego czujnika.
+ *
+ * Przechowuje znaczniki czasu i wartości w dwóch ciągłych tablicach (układ kolumnowy),
+ * posortowanych rosnąco po czasie. Brakujące wartości (null w API) są zapisywane jako NaN,
+ * dzięki czemu jądra obliczeniowe mogą przetwarzać dane bez rozgałęzień na QVariant.
+ */
+struct MeasurementSeries
+{
+    /// @brief Klucz parametru (np. PM10).
+    QString key;
+    /// @brief Znaczniki czasu w milisekundach od epoki, rosnąco.
+    QVector<qint64> timestamps;
+    /// @brief Wartości pomiarów; NaN oznacza brak danych.
+    QVector<double> values;
+
+    /**
+     * @brief Zwraca liczbę punktów serii.
+     * @return Liczba punktów (łącznie z brakującymi).
+     */
+    int size() const { return timestamps.size(); }
+
+    /**
+     * @brief Sprawdza, czy seria jest pusta.
+     * @return True, jeśli seria nie zawiera punktów.
+     */
+    bool isEmpty() const { return timestamps.isEmpty(); }
+
+    /**
+     * @brief Zwraca znacznik czasu najnowszej wartości (z pominięciem braków).
+     * @return Liczba milisekund od epoki lub -1, jeśli seria nie ma wartości.
+     */
+    qint64 newestValidTimestamp() const;
+
+    /**
+     * @brief Zamienia datę w formacie API GIOŚ na znacznik czasu.
+     * @param date Data w formacie "yyyy-MM-dd HH:mm:ss" lub ISO 8601.
+     * @return Liczba milisekund od epoki lub -1, jeśli daty nie da się odczytać.
+     */
+    static qint64 parseTimestamp(const QString& date);
+
+    /**
+     * @brief Tworzy serię z listy punktów w formacie używanym przez interfejs.
+     * @param key Klucz parametru.
+     * @param points Lista map z polami "date" i "value".
+     * @return Seria posortowana rosnąco po czasie.
+     */
+    static MeasurementSeries fromVariantList(const QString& key, const QVariantList& points);
+
+    /**
+     * @brief Tworzy serię z tablicy JSON w formacie API GIOŚ lub lokalnej bazy danych.
+     * @param key Klucz parametru.
+     * @param points Tablica obiektów z polami "date" i "value".
+     * @return Seria posortowana rosnąco po czasie.
+     */
+    static MeasurementSeries fromJsonArray(const QString& key, const QJsonArray& points);
+
+    /**
+     * @brief Łączy dwie serie w jedną, uporządkowaną rosnąco po czasie.
+     *
+     * Dla powtarzających się znaczników czasu pierwszeństwo ma wartość z serii nowszej,
+     * o ile nie jest brakiem danych.
+     * @param older Seria starsza (np. z lokalnej bazy danych).
+     * @param newer Seria nowsza (np. świeżo pobrana z API).
+     * @return Połączona seria z kluczem serii nowszej (lub starszej, jeśli nowsza go nie ma).
+     */
+    static MeasurementSeries merged(const MeasurementSeries& older, const MeasurementSeries& newer);
+
+    /**
+     * @brief Odczytuje serię z pliku głównego lokalnej bazy danych i odtwarza na niej dziennik zmian.
+     *
+     * Nie korzysta ze stanu współdzielonego, więc może być wywoływana równolegle z wielu wątków.
+     * @param snapshotPath Ścieżka do pliku głównego (measurements_station*_sensor*.json).
+     * @param journalPath Ścieżka do dziennika (JSON Lines).
+     * @return Seria pomiarowa (pusta, jeśli brak obu plików).
+     */
+    static MeasurementSeries readStored(const QString& snapshotPath, const QString& journalPath);
+
+    /**
+     * @brief Dopisuje nowsze punkty na koniec serii.
+     *
+     * Jeśli wszystkie punkty są nowsze od ostatniego punktu serii, są dopisywane bez kopiowania
+     * całej serii; w przeciwnym razie serie są łączone jak w merged().
+     * @param newer Punkty posortowane rosnąco po czasie.
+     */
+    void append(const MeasurementSeries& newer);
+
+    /**
+     * @brief Usuwa punkty starsze niż podany znacznik czasu.
+     * @param timestamp Najstarszy zachowywany znacznik czasu (ms od epoki).
+     */
+    void removeBefore(qint64 timestamp);
+
+    /**
+     * @brief Usuwa punkty starsze o więcej niż podany czas od najnowszego punktu serii.
+     *
+     * Okno jest liczone od czasu danych, a nie zegara systemowego, więc odtwarzane nagrania
+     * ze starszymi znacznikami czasu zachowują swoje ostatnie okno.
+     * @param duration Długość zachowywanego okna (ms).
+     */
+    void keepLast(qint64 duration);
+};
+
+#endif // MEASUREMENTSERIES_H
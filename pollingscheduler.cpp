@@ -0,0 +1,387 @@
+#include "pollingscheduler.h"
+#include <QDateTime>
+#include <QSet>
+#include <QRandomGenerator>
+#include <algorithm>
+
+namespace {
+
+/// @brief Interwał przeglądu terminów (ms).
+const int TICK_MS = 1000;
+/// @brief Czas, po którym zapytanie bez odpowiedzi uznawane jest za utracone (ms).
+const qint64 REQUEST_TIMEOUT_MS = 2 * 60 * 1000;
+/// @brief Maksymalny odstęp między dwoma zapytaniami, przy którym wykrycie publikacji uczy opóźnienia (ms).
+const qint64 LEARNING_RESOLUTION_MS = 10 * 60 * 1000;
+/// @brief Waga nowej próbki w średniej wykładniczej opóźnienia publikacji.
+const double LEARNING_RATE = 0.25;
+/// @brief Minimalne wyuczone opóźnienie publikacji (ms).
+const qint64 MIN_OFFSET_MS = 5 * 60 * 1000;
+/// @brief Maksymalne wyuczone opóźnienie publikacji (ms).
+const qint64 MAX_OFFSET_MS = 55 * 60 * 1000;
+
+}
+
+/**
+ * @brief Konstruktor harmonogramu.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+PollingScheduler::PollingScheduler(QObject *parent)
+    : QObject(parent)
+{
+    offsetMs = config.publicationOffsetMs;
+    timer = new QTimer(this);
+    timer->setInterval(TICK_MS);
+    connect(timer, &QTimer::timeout, this, &PollingScheduler::dispatch);
+    timer->start();
+}
+
+/**
+ * @brief Zwraca ustawienia harmonogramu.
+ * @return Bieżące ustawienia.
+ */
+PollingScheduler::Settings PollingScheduler::settings() const
+{
+    return config;
+}
+
+/**
+ * @brief Zmienia ustawienia harmonogramu.
+ * @param settings Nowe ustawienia.
+ */
+void PollingScheduler::setSettings(const Settings& settings)
+{
+    config = settings;
+    offsetMs = config.publicationOffsetMs;
+    tokens = std::min(tokens, static_cast<double>(config.burst));
+}
+
+/**
+ * @brief Sprawdza, czy odpytywanie w tle jest włączone.
+ * @return True, jeśli harmonogram wysyła zapytania.
+ */
+bool PollingScheduler::isEnabled() const
+{
+    return enabled;
+}
+
+/**
+ * @brief Włącza lub wyłącza odpytywanie w tle.
+ * @param enabled True, aby włączyć.
+ */
+void PollingScheduler::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+/**
+ * @brief Ustawia wybrany element danego rodzaju.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator czujnika lub stacji (-1 czyści wybór).
+ */
+void PollingScheduler::setSelected(Kind kind, int id)
+{
+    QVector<int> previous;
+    for (auto it = items.constBegin(); it != items.constEnd(); ++it) {
+        if (it->kind == kind && (it->roles & Selected) && it->id != id) previous.append(it->id);
+    }
+    for (int oldId : previous) {
+        setRole(kind, oldId, Selected, false);
+    }
+    if (id > 0) setRole(kind, id, Selected, true);
+}
+
+/**
+ * @brief Zastępuje zbiór elementów o podanej roli.
+ * @param kind Rodzaj danych.
+ * @param role Rola (Visible lub Watched).
+ * @param ids Identyfikatory czujników lub stacji.
+ */
+void PollingScheduler::setMembers(Kind kind, Role role, const QVector<int>& ids)
+{
+    QSet<int> wanted(ids.constBegin(), ids.constEnd());
+    QVector<int> removed;
+    for (auto it = items.constBegin(); it != items.constEnd(); ++it) {
+        if (it->kind == kind && (it->roles & role) && !wanted.contains(it->id)) removed.append(it->id);
+    }
+    for (int id : removed) {
+        setRole(kind, id, role, false);
+    }
+    for (int id : wanted) {
+        setRole(kind, id, role, true);
+    }
+}
+
+/**
+ * @brief Odnotowuje wysłanie zapytania (także spoza harmonogramu).
+ *
+ * Zapytanie wysłane przez użytkownika dla śledzonego elementu zastępuje zapytanie
+ * z harmonogramu, więc ten sam element nie jest pobierany dwukrotnie.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator czujnika lub stacji.
+ */
+void PollingScheduler::noteRequested(Kind kind, int id)
+{
+    auto it = items.find(keyOf(kind, id));
+    if (it == items.end() || it->inFlight) return;
+
+    it->inFlight = true;
+    it->previousRequest = it->lastRequest;
+    it->lastRequest = QDateTime::currentMSecsSinceEpoch();
+}
+
+/**
+ * @brief Przekazuje wynik zapytania.
+ *
+ * Czas obliczenia indeksu jest zaokrąglany w dół do pełnej godziny, tak aby oba rodzaje
+ * danych porównywać z tą samą siatką publikacji; opóźnienie publikacji uczone jest tylko z pomiarów.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator czujnika lub stacji.
+ * @param newestTimestamp Znacznik czasu najnowszej wartości (-1, jeśli brak danych).
+ * @return True, jeśli dane są nowsze niż poprzednio znane (zawsze dla elementów nieśledzonych).
+ */
+bool PollingScheduler::reportResult(Kind kind, int id, qint64 newestTimestamp)
+{
+    auto it = items.find(keyOf(kind, id));
+    if (it == items.end()) return true;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    Item& item = it.value();
+    item.inFlight = false;
+    if (kind == AirQualityIndex && newestTimestamp > 0) {
+        newestTimestamp -= newestTimestamp % HOUR_MS;
+    }
+
+    const bool advanced = newestTimestamp > item.newest;
+    if (advanced) {
+        if (kind == Measurements && item.newest >= 0) learnOffset(item, newestTimestamp);
+        item.newest = newestTimestamp;
+        item.misses = 0;
+    }
+    schedule(item, now);
+    return advanced;
+}
+
+/**
+ * @brief Przekazuje informację o nieudanym zapytaniu.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator czujnika lub stacji.
+ */
+void PollingScheduler::reportFailure(Kind kind, int id)
+{
+    auto it = items.find(keyOf(kind, id));
+    if (it == items.end()) return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    Item& item = it.value();
+    item.inFlight = false;
+    item.misses++;
+    const qint64 interval = std::min(config.maxIntervalMs, baseInterval(item.roles) << std::min(item.misses, 10));
+    item.nextDue = now + interval + jitter();
+}
+
+/**
+ * @brief Zwraca liczbę zapytań wysłanych przez harmonogram.
+ * @return Liczba zapytań od uruchomienia.
+ */
+int PollingScheduler::requestsIssued() const
+{
+    return issued;
+}
+
+/**
+ * @brief Zwraca liczbę śledzonych elementów.
+ * @return Liczba elementów.
+ */
+int PollingScheduler::trackedCount() const
+{
+    return items.size();
+}
+
+/**
+ * @brief Zwraca wyuczone opóźnienie publikacji względem pełnej godziny.
+ * @return Opóźnienie w milisekundach.
+ */
+qint64 PollingScheduler::publicationOffset() const
+{
+    return static_cast<qint64>(offsetMs);
+}
+
+/**
+ * @brief Wysyła zapytania dla elementów z minionym terminem w ramach limitu.
+ *
+ * Żetony odnawiane są z szybkością requestsPerSecond do pojemności burst. W każdej
+ * iteracji wybierany jest element o najwyższym priorytecie roli, a przy równym
+ * priorytecie - o najdawniejszym terminie.
+ */
+void PollingScheduler::dispatch()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const double capacity = static_cast<double>(config.burst);
+    tokens = lastRefill < 0 ? capacity
+                            : std::min(capacity, tokens + (now - lastRefill) / 1000.0 * config.requestsPerSecond);
+    lastRefill = now;
+    if (!enabled) return;
+
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        if (it->inFlight && now - it->lastRequest > REQUEST_TIMEOUT_MS) {
+            it->inFlight = false;
+            it->nextDue = now;
+        }
+    }
+
+    int sent = 0;
+    while (tokens >= 1.0) {
+        const Item* best = nullptr;
+        int bestPriority = 0;
+        for (auto it = items.constBegin(); it != items.constEnd(); ++it) {
+            if (it->inFlight || it->nextDue > now) continue;
+            const int priority = it->roles & -it->roles;
+            if (!best || priority < bestPriority || (priority == bestPriority && it->nextDue < best->nextDue)) {
+                best = &it.value();
+                bestPriority = priority;
+            }
+        }
+        if (!best) break;
+
+        const Kind kind = best->kind;
+        const int id = best->id;
+        noteRequested(kind, id);
+        tokens -= 1.0;
+        ++issued;
+        ++sent;
+        emit fetchRequested(kind, id);
+    }
+
+    if (sent > 0) emit statusChanged(issued, items.size());
+}
+
+/**
+ * @brief Wyznacza termin kolejnego zapytania po otrzymaniu wyniku.
+ *
+ * Element aktualny czeka na okno kolejnej publikacji. Element zaległy jest odpytywany
+ * w podstawowym odstępie przez czas tolerancji po spodziewanej publikacji, a potem
+ * z odstępem podwajanym przy każdym zapytaniu bez nowych danych.
+ * @param item Element.
+ * @param now Bieżący czas.
+ */
+void PollingScheduler::schedule(Item& item, qint64 now)
+{
+    const qint64 expected = expectedNewest(now);
+    const qint64 base = baseInterval(item.roles);
+
+    if (item.newest >= expected) {
+        const qint64 windowStart = expected + HOUR_MS + static_cast<qint64>(offsetMs) - config.leadMs;
+        item.nextDue = std::max(windowStart + jitter(), now + base);
+        return;
+    }
+
+    const qint64 overdue = item.newest < 0 ? config.graceMs + 1
+                                           : now - (item.newest + HOUR_MS + static_cast<qint64>(offsetMs));
+    if (overdue <= config.graceMs) {
+        item.nextDue = now + base + jitter() / 4;
+        return;
+    }
+
+    item.misses++;
+    item.nextDue = now + std::min(config.maxIntervalMs, base << std::min(item.misses, 10)) + jitter();
+}
+
+/**
+ * @brief Zwraca znacznik czasu ostatniej godziny, która powinna być już opublikowana.
+ * @param now Bieżący czas.
+ * @return Początek godziny w milisekundach od epoki.
+ */
+qint64 PollingScheduler::expectedNewest(qint64 now) const
+{
+    const qint64 shifted = now - static_cast<qint64>(offsetMs);
+    return shifted - shifted % HOUR_MS;
+}
+
+/**
+ * @brief Zwraca podstawowy odstęp odpytywania zaległego elementu.
+ * @param roles Maska ról elementu.
+ * @return Odstęp w milisekundach.
+ */
+qint64 PollingScheduler::baseInterval(int roles) const
+{
+    if (roles & Selected) return config.selectedIntervalMs;
+    if (roles & Visible) return config.visibleIntervalMs;
+    return config.watchedIntervalMs;
+}
+
+/**
+ * @brief Zwraca losowe przesunięcie terminu.
+ * @return Przesunięcie w milisekundach.
+ */
+qint64 PollingScheduler::jitter() const
+{
+    return config.jitterMs > 0 ? QRandomGenerator::global()->bounded(config.jitterMs) : 0;
+}
+
+/**
+ * @brief Aktualizuje wyuczone opóźnienie publikacji.
+ *
+ * Próbka jest brana tylko wtedy, gdy dwa ostatnie zapytania były blisko siebie
+ * i poprzednie nastąpiło już po godzinie nowej wartości, więc chwila publikacji leży między nimi.
+ * @param item Element, dla którego wykryto nową godzinę.
+ * @param newestTimestamp Znacznik czasu nowej wartości.
+ */
+void PollingScheduler::learnOffset(const Item& item, qint64 newestTimestamp)
+{
+    if (item.previousRequest < newestTimestamp || item.lastRequest - item.previousRequest > LEARNING_RESOLUTION_MS) return;
+
+    const double sample = (item.previousRequest + item.lastRequest) / 2.0 - newestTimestamp;
+    if (sample > MAX_OFFSET_MS) return;
+    offsetMs = std::max<double>(MIN_OFFSET_MS, std::min<double>(MAX_OFFSET_MS, (1.0 - LEARNING_RATE) * offsetMs + LEARNING_RATE * sample));
+}
+
+/**
+ * @brief Dodaje lub usuwa rolę elementu.
+ *
+ * Nowy element jest od razu gotowy do pobrania; element, który zyskał rolę o wyższym
+ * priorytecie, a ma zaległe dane, otrzymuje termin najpóźniej po podstawowym odstępie nowej roli.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator.
+ * @param role Rola.
+ * @param present True, aby dodać rolę.
+ */
+void PollingScheduler::setRole(Kind kind, int id, Role role, bool present)
+{
+    const quint64 key = keyOf(kind, id);
+    auto it = items.find(key);
+
+    if (!present) {
+        if (it == items.end()) return;
+        it->roles &= ~role;
+        if (it->roles == 0) items.erase(it);
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (it == items.end()) {
+        Item item;
+        item.kind = kind;
+        item.id = id;
+        item.roles = role;
+        item.nextDue = now;
+        items.insert(key, item);
+        return;
+    }
+
+    if (it->roles & role) return;
+    it->roles |= role;
+    if (it->newest < expectedNewest(now)) {
+        it->nextDue = std::min(it->nextDue, now + baseInterval(it->roles));
+    }
+}
+
+/**
+ * @brief Zwraca klucz elementu.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator.
+ * @return Klucz w mapie elementów.
+ */
+quint64 PollingScheduler::keyOf(Kind kind, int id)
+{
+    return (static_cast<quint64>(kind) << 32) | static_cast<quint32>(id);
+}
@@ -0,0 +1,275 @@
+#ifndef POLLINGSCHEDULER_H
+#define POLLINGSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief Harmonogram odświeżania danych w tle dopasowany do godzinowych publikacji GIOŚ.
+ *
+ * Śledzi wybraną stację i czujnik, stacje widoczne na mapie oraz listę obserwowanych
+ * czujników. Element aktualny (najnowszy znacznik czasu obejmuje ostatnią opublikowaną
+ * godzinę) jest odpytywany dopiero w oknie kolejnej publikacji, z losowym przesunięciem.
+ * Element zaległy jest odpytywany w stałym odstępie zależnym od priorytetu, a po
+ * przekroczeniu okna tolerancji z wykładniczo rosnącym odstępem. Wszystkie zapytania
+ * podlegają wspólnemu limitowi (kubełek żetonów), a elementy wybrane mają pierwszeństwo
+ * przed widocznymi, a te przed obserwowanymi.
+ *
+ * Harmonogram nie wykonuje zapytań sam - emituje fetchRequested i oczekuje wyników
+ * przez reportResult lub reportFailure.
+ */
+class PollingScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Rodzaj odpytywanych danych.
+     */
+    enum Kind {
+        Measurements,    ///< Pomiary czujnika (ID czujnika).
+        AirQualityIndex  ///< Indeks jakości powietrza (ID stacji).
+    };
+    Q_ENUM(Kind)
+
+    /**
+     * @brief Rola elementu (priorytet rośnie wraz z mniejszą wartością).
+     */
+    enum Role {
+        Selected = 1, ///< Element wybrany przez użytkownika.
+        Visible = 2,  ///< Element widoczny na mapie.
+        Watched = 4   ///< Element z listy obserwowanych.
+    };
+
+    /**
+     * @brief Ustawienia harmonogramu.
+     */
+    struct Settings {
+        /// @brief Limit zapytań na sekundę (wszystkie elementy łącznie).
+        double requestsPerSecond = 0.5;
+        /// @brief Maksymalna liczba zapytań wysłanych naraz po okresie bezczynności.
+        int burst = 3;
+        /// @brief Początkowe opóźnienie publikacji względem pełnej godziny (ms).
+        qint64 publicationOffsetMs = 20 * 60 * 1000;
+        /// @brief Wyprzedzenie rozpoczęcia odpytywania przed spodziewaną publikacją (ms).
+        qint64 leadMs = 5 * 60 * 1000;
+        /// @brief Maksymalne losowe przesunięcie terminu zapytania (ms).
+        qint64 jitterMs = 20 * 1000;
+        /// @brief Czas po spodziewanej publikacji, po którym zaczyna się wycofywanie (ms).
+        qint64 graceMs = 30 * 60 * 1000;
+        /// @brief Odstęp odpytywania zaległego elementu wybranego (ms).
+        qint64 selectedIntervalMs = 50 * 1000;
+        /// @brief Odstęp odpytywania zaległego elementu widocznego (ms).
+        qint64 visibleIntervalMs = 5 * 60 * 1000;
+        /// @brief Odstęp odpytywania zaległego elementu obserwowanego (ms).
+        qint64 watchedIntervalMs = 5 * 60 * 1000;
+        /// @brief Maksymalny odstęp po wycofaniu (ms).
+        qint64 maxIntervalMs = 60 * 60 * 1000;
+    };
+
+    /**
+     * @brief Konstruktor harmonogramu.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit PollingScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca ustawienia harmonogramu.
+     * @return Bieżące ustawienia.
+     */
+    Settings settings() const;
+
+    /**
+     * @brief Zmienia ustawienia harmonogramu.
+     * @param settings Nowe ustawienia.
+     */
+    void setSettings(const Settings& settings);
+
+    /**
+     * @brief Sprawdza, czy odpytywanie w tle jest włączone.
+     * @return True, jeśli harmonogram wysyła zapytania.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Włącza lub wyłącza odpytywanie w tle.
+     * @param enabled True, aby włączyć.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Ustawia wybrany element danego rodzaju.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator czujnika lub stacji (-1 czyści wybór).
+     */
+    void setSelected(Kind kind, int id);
+
+    /**
+     * @brief Zastępuje zbiór elementów o podanej roli.
+     * @param kind Rodzaj danych.
+     * @param role Rola (Visible lub Watched).
+     * @param ids Identyfikatory czujników lub stacji.
+     */
+    void setMembers(Kind kind, Role role, const QVector<int>& ids);
+
+    /**
+     * @brief Odnotowuje wysłanie zapytania (także spoza harmonogramu).
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator czujnika lub stacji.
+     */
+    void noteRequested(Kind kind, int id);
+
+    /**
+     * @brief Przekazuje wynik zapytania.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator czujnika lub stacji.
+     * @param newestTimestamp Znacznik czasu najnowszej wartości (-1, jeśli brak danych).
+     * @return True, jeśli dane są nowsze niż poprzednio znane.
+     */
+    bool reportResult(Kind kind, int id, qint64 newestTimestamp);
+
+    /**
+     * @brief Przekazuje informację o nieudanym zapytaniu.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator czujnika lub stacji.
+     */
+    void reportFailure(Kind kind, int id);
+
+    /**
+     * @brief Zwraca liczbę zapytań wysłanych przez harmonogram.
+     * @return Liczba zapytań od uruchomienia.
+     */
+    int requestsIssued() const;
+
+    /**
+     * @brief Zwraca liczbę śledzonych elementów.
+     * @return Liczba elementów.
+     */
+    int trackedCount() const;
+
+    /**
+     * @brief Zwraca wyuczone opóźnienie publikacji względem pełnej godziny.
+     * @return Opóźnienie w milisekundach.
+     */
+    qint64 publicationOffset() const;
+
+signals:
+    /**
+     * @brief Emitowany, gdy element należy odświeżyć.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator czujnika lub stacji.
+     */
+    void fetchRequested(PollingScheduler::Kind kind, int id);
+
+    /**
+     * @brief Emitowany po wysłaniu partii zapytań.
+     * @param issued Łączna liczba wysłanych zapytań.
+     * @param tracked Liczba śledzonych elementów.
+     */
+    void statusChanged(int issued, int tracked);
+
+private:
+    /**
+     * @brief Stan odpytywania jednego elementu.
+     */
+    struct Item {
+        /// @brief Rodzaj danych.
+        Kind kind = Measurements;
+        /// @brief Identyfikator czujnika lub stacji.
+        int id = -1;
+        /// @brief Maska ról (Role).
+        int roles = 0;
+        /// @brief Znacznik czasu najnowszej znanej wartości.
+        qint64 newest = -1;
+        /// @brief Termin kolejnego zapytania.
+        qint64 nextDue = 0;
+        /// @brief Liczba zapytań bez nowych danych po oknie tolerancji.
+        int misses = 0;
+        /// @brief Czy zapytanie jest w toku.
+        bool inFlight = false;
+        /// @brief Czas wysłania poprzedniego zapytania.
+        qint64 lastRequest = -1;
+        /// @brief Czas wysłania przedostatniego zapytania.
+        qint64 previousRequest = -1;
+    };
+
+    /// @brief Milisekundy w godzinie.
+    static constexpr qint64 HOUR_MS = 60 * 60 * 1000;
+
+    /// @brief Ustawienia.
+    Settings config;
+    /// @brief Śledzone elementy według klucza (rodzaj, ID).
+    QHash<quint64, Item> items;
+    /// @brief Zegar przeglądu terminów.
+    QTimer* timer;
+    /// @brief Czy odpytywanie jest włączone.
+    bool enabled = true;
+    /// @brief Dostępne żetony limitu zapytań.
+    double tokens = 0.0;
+    /// @brief Czas ostatniego uzupełnienia żetonów.
+    qint64 lastRefill = -1;
+    /// @brief Liczba wysłanych zapytań.
+    int issued = 0;
+    /// @brief Wyuczone opóźnienie publikacji (ms).
+    double offsetMs = 0.0;
+
+    /**
+     * @brief Wysyła zapytania dla elementów z minionym terminem w ramach limitu.
+     */
+    void dispatch();
+
+    /**
+     * @brief Wyznacza termin kolejnego zapytania po otrzymaniu wyniku.
+     * @param item Element.
+     * @param now Bieżący czas.
+     */
+    void schedule(Item& item, qint64 now);
+
+    /**
+     * @brief Zwraca znacznik czasu ostatniej godziny, która powinna być już opublikowana.
+     * @param now Bieżący czas.
+     * @return Początek godziny w milisekundach od epoki.
+     */
+    qint64 expectedNewest(qint64 now) const;
+
+    /**
+     * @brief Zwraca podstawowy odstęp odpytywania zaległego elementu.
+     * @param roles Maska ról elementu.
+     * @return Odstęp w milisekundach.
+     */
+    qint64 baseInterval(int roles) const;
+
+    /**
+     * @brief Zwraca losowe przesunięcie terminu.
+     * @return Przesunięcie w milisekundach.
+     */
+    qint64 jitter() const;
+
+    /**
+     * @brief Aktualizuje wyuczone opóźnienie publikacji.
+     * @param item Element, dla którego wykryto nową godzinę.
+     * @param newestTimestamp Znacznik czasu nowej wartości.
+     */
+    void learnOffset(const Item& item, qint64 newestTimestamp);
+
+    /**
+     * @brief Dodaje lub usuwa rolę elementu.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator.
+     * @param role Rola.
+     * @param present True, aby dodać rolę.
+     */
+    void setRole(Kind kind, int id, Role role, bool present);
+
+    /**
+     * @brief Zwraca klucz elementu.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator.
+     * @return Klucz w mapie elementów.
+     */
+    static quint64 keyOf(Kind kind, int id);
+};
+
+#endif // POLLINGSCHEDULER_H
@@ -0,0 +1,438 @@
+#include "prefetcher.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// @brief Waga sąsiada na liście stacji (maleje z odległością na liście).
+const double LIST_NEIGHBOUR_WEIGHT = 0.5;
+/// @brief Waga najbliższej geograficznie stacji (maleje z kolejnością).
+const double NEARBY_WEIGHT = 0.4;
+/// @brief Waga poprzednio oglądanej stacji.
+const double RECENT_WEIGHT = 0.6;
+/// @brief Współczynnik zaniku wagi starszych pozycji listy ostatnio oglądanych stacji.
+const double RECENT_DECAY = 0.7;
+/// @brief Waga stacji obserwowanego czujnika.
+const double FAVOURITE_WEIGHT = 0.7;
+/// @brief Waga wyuczonego przejścia (mnożona przez udział przejścia wśród wszystkich wyjść ze stacji).
+const double TRANSITION_WEIGHT = 1.5;
+/// @brief Waga nowej próbki w średniej wykładniczej rozmiaru odpowiedzi.
+const double SIZE_LEARNING_RATE = 0.2;
+/// @brief Domyślnie preferowane parametry, zanim użytkownik wybierze jakikolwiek czujnik.
+const QStringList DEFAULT_PARAMS = { "PM10", "PM2.5" };
+
+}
+
+/**
+ * @brief Konstruktor.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+Prefetcher::Prefetcher(QObject *parent)
+    : QObject(parent)
+{
+    idleTimer.setSingleShot(true);
+    connect(&idleTimer, &QTimer::timeout, this, &Prefetcher::dispatch);
+    sinceActivity.start();
+}
+
+/**
+ * @brief Zwraca ustawienia.
+ * @return Bieżące ustawienia.
+ */
+Prefetcher::Settings Prefetcher::settings() const
+{
+    return config;
+}
+
+/**
+ * @brief Zmienia ustawienia.
+ * @param settings Nowe ustawienia.
+ */
+void Prefetcher::setSettings(const Settings& settings)
+{
+    config = settings;
+    replan();
+}
+
+/**
+ * @brief Sprawdza, czy wstępne pobieranie jest włączone.
+ * @return True, jeśli włączone.
+ */
+bool Prefetcher::isEnabled() const
+{
+    return enabled;
+}
+
+/**
+ * @brief Włącza lub wyłącza wstępne pobieranie (liczniki trafień działają zawsze).
+ * @param enabled True, aby włączyć.
+ */
+void Prefetcher::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    if (enabled) replan();
+    else idleTimer.stop();
+}
+
+/**
+ * @brief Odnotowuje wybór stacji (uczy przejść i listy ostatnio oglądanych).
+ * @param stationId Identyfikator stacji.
+ */
+void Prefetcher::noteStationSelected(int stationId)
+{
+    if (stationId == currentStation) return;
+    if (currentStation != -1) transitions[currentStation][stationId]++;
+    currentStation = stationId;
+
+    recentStations.removeAll(stationId);
+    recentStations.prepend(stationId);
+    if (recentStations.size() > RECENT_STATIONS) recentStations.resize(RECENT_STATIONS);
+
+    // Otoczenie poprzedniej stacji jest nieaktualne do czasu wywołania setContext.
+    listNeighbours.clear();
+    nearbyStations.clear();
+    noteUserActivity();
+    replan();
+}
+
+/**
+ * @brief Odnotowuje wybór czujnika (uczy preferowanych parametrów).
+ * @param paramCode Kod parametru czujnika.
+ */
+void Prefetcher::noteSensorSelected(const QString& paramCode)
+{
+    if (!paramCode.isEmpty()) paramCounts[paramCode]++;
+    noteUserActivity();
+    replan();
+}
+
+/**
+ * @brief Odnotowuje aktywność użytkownika (odkłada pobieranie do kolejnej bezczynności).
+ */
+void Prefetcher::noteUserActivity()
+{
+    sinceActivity.restart();
+    if (enabled && !plan.isEmpty()) idleTimer.start(config.idleMs);
+}
+
+/**
+ * @brief Ustawia otoczenie bieżącej stacji.
+ * @param listNeighbours Stacje sąsiadujące na liście, od najbliższej pozycji.
+ * @param nearby Najbliższe geograficznie stacje, od najbliższej.
+ */
+void Prefetcher::setContext(const QVector<int>& listNeighbours, const QVector<int>& nearby)
+{
+    this->listNeighbours = listNeighbours;
+    nearbyStations = nearby;
+    replan();
+}
+
+/**
+ * @brief Ustawia stacje obserwowanych czujników.
+ * @param stationIds Identyfikatory stacji.
+ */
+void Prefetcher::setFavouriteStations(const QVector<int>& stationIds)
+{
+    favouriteStations = stationIds;
+    replan();
+}
+
+/**
+ * @brief Przekazuje czujniki stacji (pozwala planować pobieranie ich pomiarów).
+ * @param stationId Identyfikator stacji.
+ * @param sensors Pary (ID czujnika, kod parametru).
+ */
+void Prefetcher::noteSensors(int stationId, const QVector<QPair<int, QString>>& sensors)
+{
+    stationSensors.insert(stationId, sensors);
+    replan();
+}
+
+/**
+ * @brief Sprawdza, czy dane zostały pobrane niedawno (wstępnie lub zwykłym zapytaniem).
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator stacji lub czujnika.
+ * @return True, jeśli dane są aktualne.
+ */
+bool Prefetcher::isFresh(Kind kind, int id) const
+{
+    const auto it = entries.constFind(keyOf(kind, id));
+    if (it == entries.constEnd() || it->fetchedAt < 0) return false;
+    return QDateTime::currentMSecsSinceEpoch() - it->fetchedAt < config.freshMs;
+}
+
+/**
+ * @brief Sprawdza aktualność danych potrzebnych po kliknięciu i liczy trafienia.
+ *
+ * Trafieniem jest tylko pierwsze wykorzystanie danych pobranych wstępnie; dane pobrane
+ * wcześniej zwykłym zapytaniem również pozwalają pominąć zapytanie, ale nie są liczone.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator stacji lub czujnika.
+ * @return True, jeśli dane są aktualne i zapytanie można pominąć.
+ */
+bool Prefetcher::consume(Kind kind, int id)
+{
+    counters.lookups++;
+    const bool fresh = isFresh(kind, id);
+    Entry& entry = entries[keyOf(kind, id)];
+    if (fresh && entry.prefetched) {
+        counters.hits++;
+        entry.prefetched = false;
+    }
+    return fresh;
+}
+
+/**
+ * @brief Przekazuje wynik zapytania (wstępnego lub zwykłego).
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator stacji lub czujnika.
+ * @param bytes Rozmiar odpowiedzi.
+ * @param prefetched True dla zapytania wysłanego na żądanie prefetchRequested.
+ */
+void Prefetcher::reportFetched(Kind kind, int id, qint64 bytes, bool prefetched)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    Entry& entry = entries[keyOf(kind, id)];
+    entry.fetchedAt = now;
+
+    if (prefetched) {
+        entry.prefetched = true;
+        if (entry.inFlight) {
+            entry.inFlight = false;
+            inFlight = std::max(0, inFlight - 1);
+        }
+        counters.bytes += bytes;
+
+        // Limit był rozliczony szacunkiem - korekta o rzeczywisty rozmiar odpowiedzi.
+        double& average = averageBytes[kind];
+        spent.append({ now, bytes - static_cast<qint64>(average) });
+        average = (1.0 - SIZE_LEARNING_RATE) * average + SIZE_LEARNING_RATE * bytes;
+    } else {
+        entry.prefetched = false;
+    }
+    dispatch();
+}
+
+/**
+ * @brief Przekazuje informację o nieudanym zapytaniu.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator stacji lub czujnika.
+ * @param prefetched True dla zapytania wstępnego.
+ */
+void Prefetcher::reportFailure(Kind kind, int id, bool prefetched)
+{
+    if (!prefetched) return;
+    Entry& entry = entries[keyOf(kind, id)];
+    if (entry.inFlight) {
+        entry.inFlight = false;
+        inFlight = std::max(0, inFlight - 1);
+    }
+    counters.failed++;
+
+    // Nieudany element nie wraca do planu aż do kolejnego przeliczenia.
+    plan.removeAll(qMakePair(kind, id));
+    dispatch();
+}
+
+/**
+ * @brief Zwraca liczniki skuteczności.
+ * @return Liczniki.
+ */
+Prefetcher::Stats Prefetcher::stats() const
+{
+    return counters;
+}
+
+/**
+ * @brief Zwraca wyuczony profil (ostatnie stacje, przejścia, preferowane parametry).
+ * @return Profil do zapisania w lokalnej bazie danych.
+ */
+QJsonObject Prefetcher::profile() const
+{
+    QJsonArray recent;
+    for (int stationId : recentStations) recent.append(stationId);
+
+    QJsonObject transitionsJson;
+    for (auto from = transitions.constBegin(); from != transitions.constEnd(); ++from) {
+        QJsonObject targets;
+        for (auto to = from->constBegin(); to != from->constEnd(); ++to) {
+            targets.insert(QString::number(to.key()), to.value());
+        }
+        transitionsJson.insert(QString::number(from.key()), targets);
+    }
+
+    QJsonObject params;
+    for (auto it = paramCounts.constBegin(); it != paramCounts.constEnd(); ++it) {
+        params.insert(it.key(), it.value());
+    }
+
+    QJsonObject result;
+    result["recentStations"] = recent;
+    result["transitions"] = transitionsJson;
+    result["params"] = params;
+    return result;
+}
+
+/**
+ * @brief Przywraca wyuczony profil zapisany przez profile().
+ * @param profile Profil.
+ */
+void Prefetcher::setProfile(const QJsonObject& profile)
+{
+    recentStations.clear();
+    for (const QJsonValue& value : profile["recentStations"].toArray()) {
+        if (recentStations.size() < RECENT_STATIONS) recentStations.append(value.toInt());
+    }
+
+    transitions.clear();
+    const QJsonObject transitionsJson = profile["transitions"].toObject();
+    for (auto from = transitionsJson.constBegin(); from != transitionsJson.constEnd(); ++from) {
+        const QJsonObject targets = from.value().toObject();
+        for (auto to = targets.constBegin(); to != targets.constEnd(); ++to) {
+            transitions[from.key().toInt()][to.key().toInt()] = to.value().toInt();
+        }
+    }
+
+    paramCounts.clear();
+    const QJsonObject params = profile["params"].toObject();
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        paramCounts.insert(it.key(), it.value().toInt());
+    }
+    replan();
+}
+
+/**
+ * @brief Zwraca klucz elementu.
+ * @param kind Rodzaj danych.
+ * @param id Identyfikator.
+ * @return Klucz w entries.
+ */
+qint64 Prefetcher::keyOf(Kind kind, int id)
+{
+    return (static_cast<qint64>(kind) << 32) | static_cast<quint32>(id);
+}
+
+/**
+ * @brief Buduje plan pobrań z bieżącego otoczenia i wyuczonych preferencji.
+ *
+ * Ocena stacji jest sumą wkładów wszystkich źródeł, więc stacja będąca jednocześnie
+ * sąsiadem na liście i częstym celem przejścia wyprzedza pozostałe. Dla każdej wybranej
+ * stacji planowany jest indeks jakości powietrza oraz lista czujników (gdy nie jest znana)
+ * albo pomiary czujników najczęściej wybieranych parametrów.
+ */
+void Prefetcher::replan()
+{
+    plan.clear();
+    if (!enabled) return;
+
+    QHash<int, double> scores;
+    auto addScore = [&](int stationId, double score) {
+        if (stationId != currentStation && stationId >= 0) scores[stationId] += score;
+    };
+    for (int i = 0; i < listNeighbours.size(); ++i) {
+        addScore(listNeighbours[i], LIST_NEIGHBOUR_WEIGHT / (1.0 + i / 2));
+    }
+    for (int i = 0; i < nearbyStations.size(); ++i) {
+        addScore(nearbyStations[i], NEARBY_WEIGHT / (1.0 + i));
+    }
+    for (int i = 1; i < recentStations.size(); ++i) {
+        addScore(recentStations[i], RECENT_WEIGHT * std::pow(RECENT_DECAY, i - 1));
+    }
+    for (int stationId : favouriteStations) {
+        addScore(stationId, FAVOURITE_WEIGHT);
+    }
+    const QHash<int, int> outgoing = transitions.value(currentStation);
+    int totalTransitions = 0;
+    for (int count : outgoing) totalTransitions += count;
+    for (auto it = outgoing.constBegin(); it != outgoing.constEnd(); ++it) {
+        addScore(it.key(), TRANSITION_WEIGHT * it.value() / totalTransitions);
+    }
+
+    QVector<QPair<double, int>> ranked;
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        if (it.value() >= config.minScore) ranked.append({ it.value(), it.key() });
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<double, int>& a, const QPair<double, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    if (ranked.size() > config.maxStations) ranked.resize(config.maxStations);
+
+    QStringList preferred = paramCounts.keys();
+    std::sort(preferred.begin(), preferred.end(), [this](const QString& a, const QString& b) {
+        const int countA = paramCounts.value(a), countB = paramCounts.value(b);
+        return countA != countB ? countA > countB : a < b;
+    });
+    for (const QString& param : DEFAULT_PARAMS) {
+        if (!preferred.contains(param)) preferred.append(param);
+    }
+
+    for (const auto& candidate : ranked) {
+        const int stationId = candidate.second;
+        plan.append({ AirQualityIndex, stationId });
+
+        const auto sensors = stationSensors.constFind(stationId);
+        if (sensors == stationSensors.constEnd()) {
+            plan.append({ Sensors, stationId });
+            continue;
+        }
+        int planned = 0;
+        for (const QString& param : preferred) {
+            if (planned >= config.sensorsPerStation) break;
+            for (const auto& sensor : *sensors) {
+                if (sensor.second == param) {
+                    plan.append({ Measurements, sensor.first });
+                    planned++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!plan.isEmpty() && !idleTimer.isActive()) idleTimer.start(0);
+}
+
+/**
+ * @brief Wysyła kolejne pobrania z planu w ramach limitów (tylko podczas bezczynności).
+ */
+void Prefetcher::dispatch()
+{
+    if (!enabled || plan.isEmpty()) return;
+
+    const qint64 idleLeft = config.idleMs - sinceActivity.elapsed();
+    if (idleLeft > 0) {
+        idleTimer.start(static_cast<int>(idleLeft));
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    spent.erase(std::remove_if(spent.begin(), spent.end(), [now](const QPair<qint64, qint64>& item) {
+        return now - item.first >= BUDGET_WINDOW_MS;
+    }), spent.end());
+    qint64 used = 0;
+    for (const auto& item : spent) used += item.second;
+
+    for (int i = 0; i < plan.size() && inFlight < config.maxInFlight; ++i) {
+        const Kind kind = plan[i].first;
+        const int id = plan[i].second;
+        const Entry& entry = entries.value(keyOf(kind, id));
+        if (entry.inFlight || isFresh(kind, id)) continue;
+
+        const qint64 estimate = static_cast<qint64>(averageBytes[kind]);
+        if (used + estimate > config.budgetBytesPerMinute) {
+            // Kolejna próba, gdy najstarszy wpis wypadnie z okna limitu.
+            if (!spent.isEmpty()) {
+                idleTimer.start(static_cast<int>(spent.first().first + BUDGET_WINDOW_MS - now + 1));
+            }
+            return;
+        }
+
+        entries[keyOf(kind, id)].inFlight = true;
+        inFlight++;
+        counters.issued++;
+        used += estimate;
+        spent.append({ now, estimate });
+        emit prefetchRequested(kind, id);
+    }
+}
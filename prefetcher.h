@@ -0,0 +1,277 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QPair>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+/**
+ * @brief Wstępne pobieranie danych stacji i czujników, które użytkownik prawdopodobnie wybierze.
+ *
+ * Kandydaci są oceniani na podstawie sąsiadów bieżącej stacji na liście, najbliższych
+ * stacji, ostatnio oglądanych stacji, stacji obserwowanych czujników oraz wyuczonych
+ * przejść między stacjami. Dla najlepszych kandydatów pobierane są czujniki, indeks
+ * jakości powietrza i pomiary najczęściej wybieranych parametrów - tylko po okresie
+ * bezczynności użytkownika, z ograniczoną liczbą równoczesnych zapytań i w ramach
+ * limitu przesłanych bajtów na minutę.
+ *
+ * Podobnie jak PollingScheduler, obiekt nie wykonuje zapytań sam - emituje
+ * prefetchRequested i oczekuje wyników przez reportFetched lub reportFailure.
+ */
+class Prefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Rodzaj pobieranych danych.
+     */
+    enum Kind {
+        Sensors,        ///< Lista czujników stacji (ID stacji).
+        Measurements,   ///< Pomiary czujnika (ID czujnika).
+        AirQualityIndex ///< Indeks jakości powietrza (ID stacji).
+    };
+    Q_ENUM(Kind)
+
+    /**
+     * @brief Ustawienia wstępnego pobierania.
+     */
+    struct Settings {
+        /// @brief Czas bezczynności użytkownika, po którym zaczyna się pobieranie (ms).
+        int idleMs = 300;
+        /// @brief Limit bajtów pobranych wstępnie w ciągu minuty.
+        qint64 budgetBytesPerMinute = 512 * 1024;
+        /// @brief Maksymalna liczba równoczesnych zapytań wstępnych.
+        int maxInFlight = 2;
+        /// @brief Czas, przez który pobrane dane uznawane są za aktualne (ms).
+        qint64 freshMs = 5 * 60 * 1000;
+        /// @brief Liczba stacji kandydujących.
+        int maxStations = 4;
+        /// @brief Liczba czujników stacji kandydującej z wstępnie pobieranymi pomiarami.
+        int sensorsPerStation = 2;
+        /// @brief Minimalna ocena stacji kandydującej.
+        double minScore = 0.2;
+    };
+
+    /**
+     * @brief Liczniki skuteczności.
+     */
+    struct Stats {
+        /// @brief Liczba danych potrzebnych po kliknięciu użytkownika.
+        int lookups = 0;
+        /// @brief Liczba danych obsłużonych z wstępnie pobranych.
+        int hits = 0;
+        /// @brief Liczba wysłanych zapytań wstępnych.
+        int issued = 0;
+        /// @brief Liczba zapytań wstępnych zakończonych błędem.
+        int failed = 0;
+        /// @brief Łączny rozmiar odpowiedzi na zapytania wstępne (bajty).
+        qint64 bytes = 0;
+    };
+
+    /**
+     * @brief Konstruktor.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit Prefetcher(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca ustawienia.
+     * @return Bieżące ustawienia.
+     */
+    Settings settings() const;
+
+    /**
+     * @brief Zmienia ustawienia.
+     * @param settings Nowe ustawienia.
+     */
+    void setSettings(const Settings& settings);
+
+    /**
+     * @brief Sprawdza, czy wstępne pobieranie jest włączone.
+     * @return True, jeśli włączone.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Włącza lub wyłącza wstępne pobieranie (liczniki trafień działają zawsze).
+     * @param enabled True, aby włączyć.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Odnotowuje wybór stacji (uczy przejść i listy ostatnio oglądanych).
+     * @param stationId Identyfikator stacji.
+     */
+    void noteStationSelected(int stationId);
+
+    /**
+     * @brief Odnotowuje wybór czujnika (uczy preferowanych parametrów).
+     * @param paramCode Kod parametru czujnika.
+     */
+    void noteSensorSelected(const QString& paramCode);
+
+    /**
+     * @brief Odnotowuje aktywność użytkownika (odkłada pobieranie do kolejnej bezczynności).
+     */
+    void noteUserActivity();
+
+    /**
+     * @brief Ustawia otoczenie bieżącej stacji.
+     * @param listNeighbours Stacje sąsiadujące na liście, od najbliższej pozycji.
+     * @param nearby Najbliższe geograficznie stacje, od najbliższej.
+     */
+    void setContext(const QVector<int>& listNeighbours, const QVector<int>& nearby);
+
+    /**
+     * @brief Ustawia stacje obserwowanych czujników.
+     * @param stationIds Identyfikatory stacji.
+     */
+    void setFavouriteStations(const QVector<int>& stationIds);
+
+    /**
+     * @brief Przekazuje czujniki stacji (pozwala planować pobieranie ich pomiarów).
+     * @param stationId Identyfikator stacji.
+     * @param sensors Pary (ID czujnika, kod parametru).
+     */
+    void noteSensors(int stationId, const QVector<QPair<int, QString>>& sensors);
+
+    /**
+     * @brief Sprawdza, czy dane zostały pobrane niedawno (wstępnie lub zwykłym zapytaniem).
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator stacji lub czujnika.
+     * @return True, jeśli dane są aktualne.
+     */
+    bool isFresh(Kind kind, int id) const;
+
+    /**
+     * @brief Sprawdza aktualność danych potrzebnych po kliknięciu i liczy trafienia.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator stacji lub czujnika.
+     * @return True, jeśli dane są aktualne i zapytanie można pominąć.
+     */
+    bool consume(Kind kind, int id);
+
+    /**
+     * @brief Przekazuje wynik zapytania (wstępnego lub zwykłego).
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator stacji lub czujnika.
+     * @param bytes Rozmiar odpowiedzi.
+     * @param prefetched True dla zapytania wysłanego na żądanie prefetchRequested.
+     */
+    void reportFetched(Kind kind, int id, qint64 bytes, bool prefetched);
+
+    /**
+     * @brief Przekazuje informację o nieudanym zapytaniu.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator stacji lub czujnika.
+     * @param prefetched True dla zapytania wstępnego.
+     */
+    void reportFailure(Kind kind, int id, bool prefetched);
+
+    /**
+     * @brief Zwraca liczniki skuteczności.
+     * @return Liczniki.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Zwraca wyuczony profil (ostatnie stacje, przejścia, preferowane parametry).
+     * @return Profil do zapisania w lokalnej bazie danych.
+     */
+    QJsonObject profile() const;
+
+    /**
+     * @brief Przywraca wyuczony profil zapisany przez profile().
+     * @param profile Profil.
+     */
+    void setProfile(const QJsonObject& profile);
+
+signals:
+    /**
+     * @brief Emitowany, gdy dane należy pobrać wstępnie.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator stacji lub czujnika.
+     */
+    void prefetchRequested(Prefetcher::Kind kind, int id);
+
+private:
+    /**
+     * @brief Stan pobrania jednego elementu.
+     */
+    struct Entry {
+        /// @brief Czas ostatniego pobrania (ms od epoki, -1 jeśli nigdy).
+        qint64 fetchedAt = -1;
+        /// @brief Czy ostatnie pobranie było wstępne i nie zostało jeszcze wykorzystane.
+        bool prefetched = false;
+        /// @brief Czy zapytanie wstępne jest w toku.
+        bool inFlight = false;
+    };
+
+    /// @brief Długość listy ostatnio oglądanych stacji.
+    static constexpr int RECENT_STATIONS = 10;
+    /// @brief Okno rozliczania limitu bajtów (ms).
+    static constexpr qint64 BUDGET_WINDOW_MS = 60 * 1000;
+
+    /// @brief Ustawienia.
+    Settings config;
+    /// @brief Czy wstępne pobieranie jest włączone.
+    bool enabled = true;
+    /// @brief Stan pobrań według klucza (rodzaj, identyfikator).
+    QHash<qint64, Entry> entries;
+    /// @brief Zaplanowane pobrania w kolejności malejącej oceny.
+    QVector<QPair<Kind, int>> plan;
+    /// @brief Bieżąca stacja.
+    int currentStation = -1;
+    /// @brief Ostatnio oglądane stacje (od najnowszej).
+    QVector<int> recentStations;
+    /// @brief Liczba przejść między stacjami (poprzednia -> następna -> liczba).
+    QHash<int, QHash<int, int>> transitions;
+    /// @brief Liczba wyborów czujników według kodu parametru.
+    QHash<QString, int> paramCounts;
+    /// @brief Stacje sąsiadujące na liście.
+    QVector<int> listNeighbours;
+    /// @brief Najbliższe geograficznie stacje.
+    QVector<int> nearbyStations;
+    /// @brief Stacje obserwowanych czujników.
+    QVector<int> favouriteStations;
+    /// @brief Znane czujniki stacji (ID czujnika, kod parametru).
+    QHash<int, QVector<QPair<int, QString>>> stationSensors;
+    /// @brief Rozmiary odpowiedzi wstępnych w oknie limitu (czas, bajty).
+    QVector<QPair<qint64, qint64>> spent;
+    /// @brief Średni rozmiar odpowiedzi według rodzaju (szacunek przed zapytaniem).
+    double averageBytes[3] = { 2048.0, 12288.0, 1024.0 };
+    /// @brief Liczba zapytań wstępnych w toku.
+    int inFlight = 0;
+    /// @brief Czas od ostatniej aktywności użytkownika.
+    QElapsedTimer sinceActivity;
+    /// @brief Zegar bezczynności.
+    QTimer idleTimer;
+    /// @brief Liczniki skuteczności.
+    Stats counters;
+
+    /**
+     * @brief Zwraca klucz elementu.
+     * @param kind Rodzaj danych.
+     * @param id Identyfikator.
+     * @return Klucz w entries.
+     */
+    static qint64 keyOf(Kind kind, int id);
+
+    /**
+     * @brief Buduje plan pobrań z bieżącego otoczenia i wyuczonych preferencji.
+     */
+    void replan();
+
+    /**
+     * @brief Wysyła kolejne pobrania z planu w ramach limitów (tylko podczas bezczynności).
+     */
+    void dispatch();
+};
+
+#endif // PREFETCHER_H
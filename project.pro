@@ -8,27 +8,97 @@
 #/**
 # * @brief Moduły Qt używane w projekcie.
 # *
-# * Włącza moduły do obsługi QML, sieci, wykresów i widżetów.
+# * Włącza moduły do obsługi QML, sieci, wykresów, widżetów i obliczeń równoległych.
 # */
-QT += quick qml network charts widgets
+QT += quick qml network charts widgets concurrent
 
 #/**
 # * @brief Włączenie standardu C++17 dla kompilatora.
 # */
 CONFIG += c++17
 
+#/**
+# * @brief Pełna optymalizacja w trybie Release.
+# *
+# * Poziom -O3 włącza automatyczną wektoryzację pętli w jądrach obliczeniowych
+# * (detekcja anomalii, wyrównywanie serii, korelacje).
+# */
+gcc|clang: QMAKE_CXXFLAGS_RELEASE += -O3
+
+#/**
+# * @brief Biblioteka PSAPI do odczytu pamięci rezydentnej w trybie pomiaru (Windows).
+# */
+win32: LIBS += -lpsapi
+
 #/**
 # * @brief Lista plików źródłowych projektu.
 # */
 SOURCES += \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    measurementseries.cpp \
+    anomalydetector.cpp \
+    forecaster.cpp \
+    resampler.cpp \
+    correlationengine.cpp \
+    correlationmatrixmodel.cpp \
+    regulatorymetrics.cpp \
+    stationlistmodel.cpp \
+    stationfilterproxymodel.cpp \
+    sensorlistmodel.cpp \
+    stationmapindex.cpp \
+    stationmapitem.cpp \
+    pollingscheduler.cpp \
+    latencytracker.cpp \
+    circuitbreaker.cpp \
+    apiclient.cpp \
+    faultinjectingserver.cpp \
+    syncengine.cpp \
+    stationcatalog.cpp \
+    startuptrace.cpp \
+    localingestor.cpp \
+    historyarchive.cpp \
+    queryengine.cpp \
+    syntheticdata.cpp \
+    stationdashboard.cpp \
+    prefetcher.cpp \
+    localapiserver.cpp \
+    benchmark.cpp
 
 #/**
 # * @brief Lista plików nagłówkowych projektu.
 # */
 HEADERS += \
-    mainwindow.h
+    mainwindow.h \
+    measurementseries.h \
+    anomalydetector.h \
+    forecaster.h \
+    resampler.h \
+    correlationengine.h \
+    correlationmatrixmodel.h \
+    regulatorymetrics.h \
+    stationlistmodel.h \
+    stationfilterproxymodel.h \
+    sensorlistmodel.h \
+    stationmapindex.h \
+    stationmapitem.h \
+    pollingscheduler.h \
+    latencytracker.h \
+    circuitbreaker.h \
+    apiclient.h \
+    faultinjectingserver.h \
+    syncengine.h \
+    stationcatalog.h \
+    startuptrace.h \
+    ringbuffer.h \
+    localingestor.h \
+    historyarchive.h \
+    queryengine.h \
+    syntheticdata.h \
+    stationdashboard.h \
+    prefetcher.h \
+    localapiserver.h \
+    benchmark.h
 
 #/**
 # * @brief Plik zasobów zawierający QML i inne zasoby (np. ikony).
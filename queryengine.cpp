@@ -0,0 +1,515 @@
+#include "queryengine.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSet>
+#include <QTimeZone>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// @brief Liczba milisekund w godzinie.
+constexpr qint64 HOUR_MS = 3600 * 1000;
+/// @brief Liczba milisekund w dobie.
+constexpr qint64 DAY_MS = 24 * HOUR_MS;
+
+/**
+ * @brief Dzielenie całkowite zaokrąglane w dół (także dla liczb ujemnych).
+ * @param value Dzielna.
+ * @param divisor Dzielnik (dodatni).
+ * @return Iloraz.
+ */
+qint64 floorDiv(qint64 value, qint64 divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+/**
+ * @brief Zwraca miesiąc dnia liczonego od epoki (kalendarz gregoriański, bez QDate).
+ * @param days Liczba dni od 1970-01-01.
+ * @return Miesiąc 1-12.
+ */
+int monthOfDay(qint64 days)
+{
+    days += 719468;
+    const qint64 era = floorDiv(days, 146097);
+    const qint64 dayOfEra = days - era * 146097;
+    const qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int monthIndex = static_cast<int>((5 * dayOfYear + 2) / 153);
+    return monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+}
+
+/**
+ * @brief Przesunięcia czasu lokalnego względem UTC w zakresie zapytania.
+ *
+ * Zmiany czasu są wyznaczane raz na zapytanie, a skan serii przesuwa się po nich liniowo,
+ * więc grupowanie nie wymaga konwersji QDateTime dla każdego punktu.
+ */
+struct OffsetTable {
+    /// @brief Początki kolejnych okresów (ms od epoki, UTC), rosnąco.
+    QVector<qint64> starts;
+    /// @brief Przesunięcia okresów w milisekundach.
+    QVector<qint64> offsets;
+
+    /**
+     * @brief Wyznacza przesunięcia strefy systemowej w zakresie.
+     * @param from Początek zakresu.
+     * @param to Koniec zakresu.
+     */
+    OffsetTable(qint64 from, qint64 to)
+    {
+        const QTimeZone zone = QTimeZone::systemTimeZone();
+        starts.append(std::numeric_limits<qint64>::min());
+        offsets.append(zone.offsetFromUtc(QDateTime::fromMSecsSinceEpoch(from, QTimeZone::UTC)) * 1000LL);
+        if (!zone.hasTransitions() || from >= to) return;
+
+        const QTimeZone::OffsetDataList transitions = zone.transitions(QDateTime::fromMSecsSinceEpoch(from, QTimeZone::UTC),
+                                                                       QDateTime::fromMSecsSinceEpoch(to, QTimeZone::UTC));
+        for (const QTimeZone::OffsetData& transition : transitions) {
+            starts.append(transition.atUtc.toMSecsSinceEpoch());
+            offsets.append(transition.offsetFromUtc * 1000LL);
+        }
+    }
+};
+
+/**
+ * @brief Częściowy agregat jednej komórki (parametr, grupa).
+ */
+struct Cell {
+    /// @brief Liczba wartości.
+    qint64 count = 0;
+    /// @brief Suma wartości.
+    double sum = 0.0;
+    /// @brief Minimum.
+    double min = std::numeric_limits<double>::infinity();
+    /// @brief Maksimum.
+    double max = -std::numeric_limits<double>::infinity();
+    /// @brief Wartości do percentyli (zbierane tylko, gdy zapytanie ich wymaga).
+    QVector<double> values;
+};
+
+/**
+ * @brief Częściowy wynik skanu jednej lub kilku serii.
+ */
+struct Partial {
+    /// @brief Komórki indeksowane: parametr * liczba grup + grupa.
+    QVector<Cell> cells;
+    /// @brief Liczba przeskanowanych punktów.
+    qint64 scanned = 0;
+};
+
+/**
+ * @brief Grupa bez grupowania (zawsze 0).
+ */
+struct NoGroup {
+    int operator()(qint64) const { return 0; }
+};
+
+/**
+ * @brief Godzina doby czasu lokalnego (0-23).
+ */
+struct HourGroup {
+    int operator()(qint64 local) const { return static_cast<int>(floorDiv(local, HOUR_MS) % 24); }
+};
+
+/**
+ * @brief Dzień tygodnia czasu lokalnego (0 - poniedziałek ... 6 - niedziela).
+ */
+struct WeekdayGroup {
+    int operator()(qint64 local) const { return static_cast<int>((floorDiv(local, DAY_MS) % 7 + 10) % 7); }
+};
+
+/**
+ * @brief Miesiąc czasu lokalnego (0-11).
+ */
+struct MonthGroup {
+    int operator()(qint64 local) const { return monthOfDay(floorDiv(local, DAY_MS)) - 1; }
+};
+
+/**
+ * @brief Agreguje punkty zakresu serii w komórkach grup.
+ *
+ * Grupowanie jest parametrem szablonu, więc pętla po punktach nie zawiera wyboru grupowania.
+ * @param timestamps Znaczniki czasu serii.
+ * @param values Wartości serii.
+ * @param first Indeks pierwszego punktu zakresu.
+ * @param last Indeks za ostatnim punktem zakresu.
+ * @param zone Przesunięcia czasu lokalnego.
+ * @param cells Komórki grup parametru serii.
+ * @param keepValues Czy zbierać wartości do percentyli.
+ * @param groupOf Funkcja grupy czasu lokalnego.
+ */
+template <typename GroupOf>
+void scanRange(const qint64* timestamps, const double* values, int first, int last, const OffsetTable& zone,
+               Cell* cells, bool keepValues, GroupOf groupOf)
+{
+    int period = static_cast<int>(std::upper_bound(zone.starts.cbegin(), zone.starts.cend(), timestamps[first])
+                                  - zone.starts.cbegin()) - 1;
+    for (int i = first; i < last; ++i) {
+        const double value = values[i];
+        if (std::isnan(value)) continue;
+
+        const qint64 timestamp = timestamps[i];
+        while (period + 1 < zone.starts.size() && zone.starts[period + 1] <= timestamp) ++period;
+
+        Cell& cell = cells[groupOf(timestamp + zone.offsets[period])];
+        cell.count++;
+        cell.sum += value;
+        cell.min = std::min(cell.min, value);
+        cell.max = std::max(cell.max, value);
+        if (keepValues) cell.values.append(value);
+    }
+}
+
+/**
+ * @brief Zwraca liczbę grup dla grupowania.
+ * @param grouping Grupowanie.
+ * @return Liczba grup.
+ */
+int groupCount(QueryEngine::Grouping grouping)
+{
+    switch (grouping) {
+    case QueryEngine::HourOfDay: return 24;
+    case QueryEngine::Weekday: return 7;
+    case QueryEngine::Month: return 12;
+    default: return 1;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Zwraca klucz zapytania niezależny od kolejności elementów list.
+ * @return Klucz do zapamiętywania wyników.
+ */
+QString QueryEngine::Query::cacheKey() const
+{
+    QVector<int> stations = stationIds;
+    QVector<int> sensors = sensorIds;
+    QStringList params = paramCodes;
+    std::sort(stations.begin(), stations.end());
+    std::sort(sensors.begin(), sensors.end());
+    params.sort();
+
+    QStringList parts;
+    QStringList list;
+    for (int id : stations) list.append(QString::number(id));
+    parts.append(list.join(','));
+    list.clear();
+    for (int id : sensors) list.append(QString::number(id));
+    parts.append(list.join(','));
+    parts.append(params.join(','));
+    parts.append(QString::number(from));
+    parts.append(QString::number(to));
+    parts.append(QString::number(grouping));
+    list.clear();
+    for (double fraction : percentiles) list.append(QString::number(fraction));
+    parts.append(list.join(','));
+    return parts.join('|');
+}
+
+/**
+ * @brief Łączy serie z archiwum z seriami dostępnymi w silniku.
+ *
+ * Punkty dołączone przez addPoints() w trakcie wczytywania archiwum są zachowywane
+ * i mają pierwszeństwo przed zapisanymi wartościami tych samych godzin.
+ * @param archive Wczytane archiwum lokalnej bazy danych.
+ */
+void QueryEngine::setArchive(const HistoryArchive& archive)
+{
+    for (const HistoryArchive::Entry* entry : archive.entries(-1, QString())) {
+        auto row = sourceRows.constFind(entry->sensorId);
+        if (row != sourceRows.constEnd()) {
+            Source& existing = sources[row.value()];
+            existing.series = MeasurementSeries::merged(entry->series, existing.series);
+            if (existing.paramCode.isEmpty()) existing.paramCode = entry->series.key;
+            existing.version = nextVersion++;
+            continue;
+        }
+        Source source;
+        source.stationId = entry->stationId;
+        source.sensorId = entry->sensorId;
+        source.paramCode = entry->series.key;
+        source.series = entry->series;
+        source.version = nextVersion++;
+        sourceRows.insert(source.sensorId, sources.size());
+        sources.append(source);
+    }
+}
+
+/**
+ * @brief Dołącza nowe lub poprawione punkty serii czujnika.
+ * @param stationId Identyfikator stacji.
+ * @param sensorId Identyfikator czujnika.
+ * @param paramCode Kod parametru.
+ * @param points Punkty posortowane rosnąco po czasie.
+ */
+void QueryEngine::addPoints(int stationId, int sensorId, const QString& paramCode, const MeasurementSeries& points)
+{
+    if (points.isEmpty()) return;
+
+    auto row = sourceRows.constFind(sensorId);
+    if (row == sourceRows.constEnd()) {
+        Source source;
+        source.stationId = stationId;
+        source.sensorId = sensorId;
+        source.paramCode = paramCode.isEmpty() ? points.key : paramCode;
+        source.series = points;
+        source.version = nextVersion++;
+        sourceRows.insert(sensorId, sources.size());
+        sources.append(source);
+        return;
+    }
+
+    Source& source = sources[row.value()];
+    source.series.append(points);
+    source.version = nextVersion++;
+}
+
+/**
+ * @brief Wykonuje zapytanie lub zwraca zapamiętany wynik.
+ *
+ * Wywoływana w puli wątków; blokada pamięci wyników nie jest trzymana podczas obliczeń.
+ * @param memo Pamięć wyników.
+ * @param job Przygotowane zapytanie.
+ * @return Wynik.
+ */
+QueryEngine::Result QueryEngine::run(Memo& memo, const Job& job)
+{
+    {
+        QMutexLocker locker(&memo.mutex);
+        auto cached = memo.entries.constFind(job.key);
+        if (cached != memo.entries.constEnd() && cached->version == job.version && cached->sources == job.sources.size()) {
+            memo.hits++;
+            Result result = cached->result;
+            result.cached = true;
+            return result;
+        }
+        memo.misses++;
+    }
+
+    CacheEntry entry;
+    entry.version = job.version;
+    entry.sources = job.sources.size();
+    entry.result = compute(job.query, job.sources);
+
+    QMutexLocker locker(&memo.mutex);
+    if (memo.entries.size() >= MAX_CACHED_RESULTS && !memo.entries.contains(job.key)) memo.entries.clear();
+    memo.entries.insert(job.key, entry);
+    return entry.result;
+}
+
+/**
+ * @brief Wykonuje listę zapytań w puli wątków (powtórzenia są liczone raz).
+ *
+ * Wybór serii i ich kopie powstają w wątku wywołującym; w puli wątków wykonywane są
+ * tylko sprawdzenie pamięci wyników i skany.
+ * @param queries Zapytania.
+ * @return Przyszłe wyniki w kolejności zapytań.
+ */
+QFuture<QVector<QueryEngine::Result>> QueryEngine::runAsync(const QVector<Query>& queries)
+{
+    QVector<Job> jobs;
+    QVector<int> jobOfQuery;
+    QHash<QString, int> jobOfKey;
+    jobOfQuery.reserve(queries.size());
+    for (const Query& query : queries) {
+        const QString key = query.cacheKey();
+        auto known = jobOfKey.constFind(key);
+        if (known != jobOfKey.constEnd()) {
+            jobOfQuery.append(known.value());
+            continue;
+        }
+
+        Job job;
+        job.query = query;
+        job.key = key;
+        const QVector<int> selected = select(query);
+        job.sources.reserve(selected.size());
+        for (int index : selected) {
+            job.version = std::max(job.version, sources[index].version);
+            job.sources.append(sources[index]);
+        }
+        jobOfKey.insert(key, jobs.size());
+        jobOfQuery.append(jobs.size());
+        jobs.append(job);
+    }
+
+    const QSharedPointer<Memo> shared = memo;
+    return QtConcurrent::run([shared, jobs, jobOfQuery]() {
+        QVector<Result> computed;
+        computed.reserve(jobs.size());
+        for (const Job& job : jobs) computed.append(run(*shared, job));
+
+        QVector<Result> results;
+        results.reserve(jobOfQuery.size());
+        for (int job : jobOfQuery) results.append(computed[job]);
+        return results;
+    });
+}
+
+/**
+ * @brief Zwraca liczbę serii dostępnych dla zapytań.
+ * @return Liczba serii.
+ */
+int QueryEngine::seriesCount() const
+{
+    return sources.size();
+}
+
+/**
+ * @brief Zwraca liczbę zapytań obsłużonych z pamięci.
+ * @return Liczba trafień.
+ */
+qint64 QueryEngine::cacheHits() const
+{
+    QMutexLocker locker(&memo->mutex);
+    return memo->hits;
+}
+
+/**
+ * @brief Zwraca liczbę zapytań obliczonych od nowa.
+ * @return Liczba chybień.
+ */
+qint64 QueryEngine::cacheMisses() const
+{
+    QMutexLocker locker(&memo->mutex);
+    return memo->misses;
+}
+
+/**
+ * @brief Zamienia nazwę grupowania na wartość wyliczenia.
+ * @param name Nazwa: "hour", "weekday", "month" lub inna (bez grupowania).
+ * @return Grupowanie.
+ */
+QueryEngine::Grouping QueryEngine::groupingFromName(const QString& name)
+{
+    if (name == "hour") return HourOfDay;
+    if (name == "weekday") return Weekday;
+    if (name == "month") return Month;
+    return NoGrouping;
+}
+
+/**
+ * @brief Zwraca indeksy serii wybranych przez zapytanie.
+ * @param query Zapytanie.
+ * @return Indeksy w sources.
+ */
+QVector<int> QueryEngine::select(const Query& query) const
+{
+    const QSet<int> stations(query.stationIds.cbegin(), query.stationIds.cend());
+    const QSet<int> sensors(query.sensorIds.cbegin(), query.sensorIds.cend());
+    const QSet<QString> params(query.paramCodes.cbegin(), query.paramCodes.cend());
+    const bool allSeries = stations.isEmpty() && sensors.isEmpty();
+
+    QVector<int> selected;
+    for (int i = 0; i < sources.size(); ++i) {
+        const Source& source = sources[i];
+        if (!allSeries && !stations.contains(source.stationId) && !sensors.contains(source.sensorId)) continue;
+        if (!params.isEmpty() && !params.contains(source.paramCode)) continue;
+        selected.append(i);
+    }
+    return selected;
+}
+
+/**
+ * @brief Oblicza wynik zapytania dla wybranych serii.
+ *
+ * Każda seria jest skanowana osobnym zadaniem: zakres czasu wyznacza wyszukiwanie binarne,
+ * a pętla po punktach (scanRange() ze stałym grupowaniem) wylicza grupę z przesunięcia strefy
+ * i znacznika czasu arytmetyką całkowitoliczbową. Wyniki częściowe są łączone po zakończeniu skanów.
+ * @param query Zapytanie.
+ * @param sources Wybrane serie.
+ * @return Wynik.
+ */
+QueryEngine::Result QueryEngine::compute(const Query& query, const QVector<Source>& sources)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList params;
+    qint64 dataFrom = std::numeric_limits<qint64>::max();
+    qint64 dataTo = std::numeric_limits<qint64>::min();
+    for (const Source& source : sources) {
+        if (!params.contains(source.paramCode)) params.append(source.paramCode);
+        if (source.series.isEmpty()) continue;
+        dataFrom = std::min(dataFrom, std::max(query.from, source.series.timestamps.first()));
+        dataTo = std::max(dataTo, std::min(query.to, source.series.timestamps.last()));
+    }
+    params.sort();
+    if (dataFrom > dataTo) dataFrom = dataTo = 0;
+
+    const int groups = groupCount(query.grouping);
+    const int cellCount = params.size() * groups;
+    const bool keepValues = !query.percentiles.isEmpty();
+    const OffsetTable zone(dataFrom, dataTo);
+
+    auto scan = [&](const Source& source) {
+        const QVector<qint64>& timestamps = source.series.timestamps;
+        const QVector<double>& values = source.series.values;
+        const int first = static_cast<int>(std::lower_bound(timestamps.cbegin(), timestamps.cend(), query.from) - timestamps.cbegin());
+        const int last = static_cast<int>(std::upper_bound(timestamps.cbegin(), timestamps.cend(), query.to) - timestamps.cbegin());
+
+        Partial partial;
+        partial.cells.resize(cellCount);
+        if (first >= last) return partial;
+        partial.scanned = last - first;
+        Cell* cells = partial.cells.data() + params.indexOf(source.paramCode) * groups;
+
+        const qint64* times = timestamps.constData();
+        const double* data = values.constData();
+        switch (query.grouping) {
+        case HourOfDay: scanRange(times, data, first, last, zone, cells, keepValues, HourGroup()); break;
+        case Weekday: scanRange(times, data, first, last, zone, cells, keepValues, WeekdayGroup()); break;
+        case Month: scanRange(times, data, first, last, zone, cells, keepValues, MonthGroup()); break;
+        default: scanRange(times, data, first, last, zone, cells, keepValues, NoGroup()); break;
+        }
+        return partial;
+    };
+    auto combine = [](Partial& total, const Partial& partial) {
+        if (total.cells.isEmpty()) {
+            total = partial;
+            return;
+        }
+        total.scanned += partial.scanned;
+        for (int i = 0; i < partial.cells.size(); ++i) {
+            const Cell& cell = partial.cells[i];
+            if (cell.count == 0) continue;
+            Cell& target = total.cells[i];
+            target.count += cell.count;
+            target.sum += cell.sum;
+            target.min = std::min(target.min, cell.min);
+            target.max = std::max(target.max, cell.max);
+            target.values += cell.values;
+        }
+    };
+    Partial total = QtConcurrent::blockingMappedReduced<Partial>(sources, scan, combine, QtConcurrent::UnorderedReduce);
+
+    Result result;
+    result.series = sources.size();
+    result.scannedPoints = total.scanned;
+    for (int i = 0; i < total.cells.size(); ++i) {
+        Cell& cell = total.cells[i];
+        if (cell.count == 0) continue;
+
+        Row row;
+        row.paramCode = params[i / groups];
+        row.group = query.grouping == Month ? i % groups + 1 : i % groups;
+        row.count = cell.count;
+        row.mean = cell.sum / cell.count;
+        row.min = cell.min;
+        row.max = cell.max;
+        for (double fraction : query.percentiles) {
+            const int rank = std::clamp(static_cast<int>(std::ceil(fraction * cell.values.size())) - 1, 0,
+                                        static_cast<int>(cell.values.size()) - 1);
+            std::nth_element(cell.values.begin(), cell.values.begin() + rank, cell.values.end());
+            row.percentiles.append(cell.values[rank]);
+        }
+        result.rows.append(row);
+    }
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
@@ -0,0 +1,244 @@
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <limits>
+#include "measurementseries.h"
+#include "historyarchive.h"
+
+/**
+ * @brief Zapytania analityczne po zapisanych seriach z zapamiętywaniem wyników.
+ *
+ * Zapytanie wybiera serie (stacje, czujniki, kody parametrów), zakres czasu, grupowanie
+ * (godzina doby, dzień tygodnia, miesiąc) i agregaty (średnia, minimum, maksimum, liczba,
+ * percentyle). Zapytania są wykonywane w puli wątków na kopii wybranych serii (dane
+ * współdzielone niejawnie), a serie są skanowane równolegle, każda w jednej pętli po tablicach
+ * znaczników czasu i wartości. Wynik jest zapamiętywany razem z wersją wybranych danych,
+ * więc powtórzone zapytanie jest obsługiwane z pamięci, dopóki do wybranych serii nie trafią
+ * nowe punkty.
+ */
+class QueryEngine
+{
+public:
+    /**
+     * @brief Grupowanie wyników.
+     */
+    enum Grouping {
+        NoGrouping, ///< Jedna grupa dla każdego parametru.
+        HourOfDay,  ///< Godzina doby (0-23, czas lokalny).
+        Weekday,    ///< Dzień tygodnia (0 - poniedziałek ... 6 - niedziela).
+        Month       ///< Miesiąc roku (1-12).
+    };
+
+    /**
+     * @brief Zapytanie analityczne.
+     */
+    struct Query {
+        /// @brief Stacje (puste razem z sensorIds oznacza wszystkie serie).
+        QVector<int> stationIds;
+        /// @brief Czujniki (dodawane do czujników wybranych stacji).
+        QVector<int> sensorIds;
+        /// @brief Kody parametrów (puste oznacza wszystkie).
+        QStringList paramCodes;
+        /// @brief Początek zakresu (ms od epoki, włącznie).
+        qint64 from = std::numeric_limits<qint64>::min();
+        /// @brief Koniec zakresu (ms od epoki, włącznie).
+        qint64 to = std::numeric_limits<qint64>::max();
+        /// @brief Grupowanie.
+        Grouping grouping = NoGrouping;
+        /// @brief Percentyle jako ułamki (np. 0.5, 0.95).
+        QVector<double> percentiles;
+
+        /**
+         * @brief Zwraca klucz zapytania niezależny od kolejności elementów list.
+         * @return Klucz do zapamiętywania wyników.
+         */
+        QString cacheKey() const;
+    };
+
+    /**
+     * @brief Wiersz wyniku (jeden parametr w jednej grupie).
+     */
+    struct Row {
+        /// @brief Kod parametru.
+        QString paramCode;
+        /// @brief Numer grupy (godzina, dzień tygodnia, miesiąc lub 0 bez grupowania).
+        int group = 0;
+        /// @brief Liczba wartości.
+        qint64 count = 0;
+        /// @brief Średnia.
+        double mean = 0.0;
+        /// @brief Minimum.
+        double min = 0.0;
+        /// @brief Maksimum.
+        double max = 0.0;
+        /// @brief Percentyle w kolejności z zapytania.
+        QVector<double> percentiles;
+    };
+
+    /**
+     * @brief Wynik zapytania.
+     */
+    struct Result {
+        /// @brief Wiersze posortowane według parametru i grupy.
+        QVector<Row> rows;
+        /// @brief Liczba przeskanowanych serii.
+        int series = 0;
+        /// @brief Liczba przeskanowanych punktów.
+        qint64 scannedPoints = 0;
+        /// @brief Czas obliczenia w ms (dla wyniku z pamięci: czas pierwotnego obliczenia).
+        double elapsedMs = 0.0;
+        /// @brief Czy wynik pochodzi z pamięci.
+        bool cached = false;
+    };
+
+    /// @brief Największa liczba zapamiętanych wyników.
+    static constexpr int MAX_CACHED_RESULTS = 256;
+
+    /**
+     * @brief Łączy serie z archiwum z seriami dostępnymi w silniku.
+     * @param archive Wczytane archiwum lokalnej bazy danych.
+     */
+    void setArchive(const HistoryArchive& archive);
+
+    /**
+     * @brief Dołącza nowe lub poprawione punkty serii czujnika.
+     * @param stationId Identyfikator stacji.
+     * @param sensorId Identyfikator czujnika.
+     * @param paramCode Kod parametru.
+     * @param points Punkty posortowane rosnąco po czasie.
+     */
+    void addPoints(int stationId, int sensorId, const QString& paramCode, const MeasurementSeries& points);
+
+    /**
+     * @brief Wykonuje listę zapytań w puli wątków (powtórzenia są liczone raz).
+     *
+     * Wybrane serie są kopiowane przed uruchomieniem zadania, więc addPoints() i setArchive()
+     * mogą być wywoływane w trakcie obliczeń.
+     * @param queries Zapytania.
+     * @return Przyszłe wyniki w kolejności zapytań.
+     */
+    QFuture<QVector<Result>> runAsync(const QVector<Query>& queries);
+
+    /**
+     * @brief Zwraca liczbę serii dostępnych dla zapytań.
+     * @return Liczba serii.
+     */
+    int seriesCount() const;
+
+    /**
+     * @brief Zwraca liczbę zapytań obsłużonych z pamięci.
+     * @return Liczba trafień.
+     */
+    qint64 cacheHits() const;
+
+    /**
+     * @brief Zwraca liczbę zapytań obliczonych od nowa.
+     * @return Liczba chybień.
+     */
+    qint64 cacheMisses() const;
+
+    /**
+     * @brief Zamienia nazwę grupowania na wartość wyliczenia.
+     * @param name Nazwa: "hour", "weekday", "month" lub inna (bez grupowania).
+     * @return Grupowanie.
+     */
+    static Grouping groupingFromName(const QString& name);
+
+private:
+    /**
+     * @brief Seria dostępna dla zapytań.
+     */
+    struct Source {
+        /// @brief Identyfikator stacji.
+        int stationId = -1;
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Kod parametru.
+        QString paramCode;
+        /// @brief Seria pomiarowa.
+        MeasurementSeries series;
+        /// @brief Wersja danych serii (rośnie przy każdej zmianie).
+        quint64 version = 0;
+    };
+
+    /**
+     * @brief Zapamiętany wynik wraz z wersją danych, z których powstał.
+     */
+    struct CacheEntry {
+        /// @brief Największa wersja wybranych serii.
+        quint64 version = 0;
+        /// @brief Liczba wybranych serii.
+        int sources = 0;
+        /// @brief Wynik.
+        Result result;
+    };
+
+    /**
+     * @brief Pamięć wyników współdzielona z zadaniami w puli wątków.
+     */
+    struct Memo {
+        /// @brief Chroni pola pamięci wyników.
+        QMutex mutex;
+        /// @brief Zapamiętane wyniki według klucza zapytania.
+        QHash<QString, CacheEntry> entries;
+        /// @brief Liczba trafień w pamięci wyników.
+        qint64 hits = 0;
+        /// @brief Liczba chybień w pamięci wyników.
+        qint64 misses = 0;
+    };
+
+    /**
+     * @brief Zapytanie przygotowane do wykonania w puli wątków.
+     */
+    struct Job {
+        /// @brief Zapytanie.
+        Query query;
+        /// @brief Klucz zapytania.
+        QString key;
+        /// @brief Największa wersja wybranych serii.
+        quint64 version = 0;
+        /// @brief Kopie wybranych serii.
+        QVector<Source> sources;
+    };
+
+    /// @brief Serie dostępne dla zapytań.
+    QVector<Source> sources;
+    /// @brief Mapa ID czujnika na indeks w sources.
+    QHash<int, int> sourceRows;
+    /// @brief Licznik wersji danych.
+    quint64 nextVersion = 1;
+    /// @brief Pamięć wyników (przeżywa silnik, dopóki trwają zadania).
+    QSharedPointer<Memo> memo = QSharedPointer<Memo>::create();
+
+    /**
+     * @brief Zwraca indeksy serii wybranych przez zapytanie.
+     * @param query Zapytanie.
+     * @return Indeksy w sources.
+     */
+    QVector<int> select(const Query& query) const;
+
+    /**
+     * @brief Wykonuje zapytanie lub zwraca zapamiętany wynik.
+     * @param memo Pamięć wyników.
+     * @param job Przygotowane zapytanie.
+     * @return Wynik.
+     */
+    static Result run(Memo& memo, const Job& job);
+
+    /**
+     * @brief Oblicza wynik zapytania dla wybranych serii.
+     * @param query Zapytanie.
+     * @param sources Wybrane serie.
+     * @return Wynik.
+     */
+    static Result compute(const Query& query, const QVector<Source>& sources);
+};
+
+#endif // QUERYENGINE_H
@@ -0,0 +1,272 @@
+#include "regulatorymetrics.h"
+#include "resampler.h"
+#include <QMap>
+#include <QtConcurrent>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/// @brief Liczba milisekund w godzinie.
+const qint64 HOUR_MS = 3600000;
+
+/**
+ * @brief Przenosi serię na siatkę godzinową obejmującą pełne doby.
+ * @param series Seria pomiarów godzinowych.
+ * @return Seria na siatce od początku pierwszej do końca ostatniej doby.
+ */
+MeasurementSeries fullDayGrid(const MeasurementSeries& series)
+{
+    Resampler::Options options;
+    options.step = Resampler::Hourly;
+    options.policy = Resampler::LeaveNull;
+    options.start = QDateTime::fromMSecsSinceEpoch(series.timestamps.first()).date().startOfDay().toMSecsSinceEpoch();
+    options.end = QDateTime::fromMSecsSinceEpoch(series.timestamps.last()).date().addDays(1).startOfDay().toMSecsSinceEpoch() - HOUR_MS;
+    return Resampler::resample(series, options);
+}
+
+}
+
+/**
+ * @brief Zwraca normę UE dla parametru.
+ *
+ * PM10: średnia dobowa 50 µg/m³, 35 dni w roku (dyrektywa 2008/50/WE).
+ * PM2.5: średnia dobowa 25 µg/m³, 18 dni w roku (dyrektywa (UE) 2024/2881).
+ * O3: maksymalna dobowa średnia 8-godzinna 120 µg/m³, 25 dni w roku (poziom docelowy).
+ * @param paramCode Kod parametru (np. PM10, PM2.5, O3).
+ * @param limit Wskaźnik na strukturę uzupełnianą normą.
+ * @return True, jeśli dla parametru zdefiniowano normę.
+ */
+bool RegulatoryMetrics::limitFor(const QString& paramCode, Limit* limit)
+{
+    Limit result;
+    result.paramCode = paramCode;
+    const QString code = paramCode.toUpper();
+
+    if (code == "PM10") {
+        result.threshold = 50.0;
+        result.allowedDays = 35;
+    } else if (code == "PM2.5") {
+        result.threshold = 25.0;
+        result.allowedDays = 18;
+    } else if (code == "O3") {
+        result.threshold = 120.0;
+        result.allowedDays = 25;
+        result.eightHour = true;
+    } else {
+        return false;
+    }
+
+    if (limit) *limit = result;
+    return true;
+}
+
+/**
+ * @brief Oblicza średnie kroczące z wymaganą liczbą ważnych wartości.
+ * @param values Wartości na siatce (NaN dla braków).
+ * @param window Długość okna.
+ * @param minValid Minimalna liczba ważnych wartości w oknie.
+ * @return Średnie kroczące.
+ */
+QVector<double> RegulatoryMetrics::runningMean(const QVector<double>& values, int window, int minValid)
+{
+    const int n = values.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double* data = values.constData();
+    QVector<double> result(n);
+
+    double sum = 0.0;
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        const bool entering = data[i] == data[i];
+        sum += entering ? data[i] : 0.0;
+        count += entering ? 1 : 0;
+        if (i >= window) {
+            const double old = data[i - window];
+            const bool leaving = old == old;
+            sum -= leaving ? old : 0.0;
+            count -= leaving ? 1 : 0;
+        }
+        result[i] = count >= minValid && count > 0 ? sum / count : nan;
+    }
+    return result;
+}
+
+/**
+ * @brief Liczy ważne wartości w oknach kroczących.
+ * @param values Wartości (NaN dla braków).
+ * @param window Długość okna.
+ * @return Liczby ważnych wartości w oknach kończących się na kolejnych indeksach.
+ */
+QVector<int> RegulatoryMetrics::runningCount(const QVector<double>& values, int window)
+{
+    const int n = values.size();
+    const double* data = values.constData();
+    QVector<int> result(n);
+
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        count += data[i] == data[i] ? 1 : 0;
+        if (i >= window) {
+            count -= data[i - window] == data[i - window] ? 1 : 0;
+        }
+        result[i] = count;
+    }
+    return result;
+}
+
+/**
+ * @brief Oblicza maksima kroczące z pominięciem braków (kolejka monotoniczna).
+ *
+ * Kolejka przechowuje indeksy wartości malejących; każdy indeks jest dodawany i usuwany
+ * co najwyżej raz, więc koszt zamortyzowany na krok jest stały.
+ * @param values Wartości (NaN dla braków).
+ * @param window Długość okna.
+ * @return Element i to maksimum z wartości i - window + 1 ... i (NaN, jeśli wszystkie są brakami).
+ */
+QVector<double> RegulatoryMetrics::slidingMax(const QVector<double>& values, int window)
+{
+    const int n = values.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    QVector<double> result(n);
+    std::deque<int> candidates;
+
+    for (int i = 0; i < n; ++i) {
+        const double value = values[i];
+        if (!std::isnan(value)) {
+            while (!candidates.empty() && values[candidates.back()] <= value) {
+                candidates.pop_back();
+            }
+            candidates.push_back(i);
+        }
+        while (!candidates.empty() && candidates.front() <= i - window) {
+            candidates.pop_front();
+        }
+        result[i] = candidates.empty() ? nan : values[candidates.front()];
+    }
+    return result;
+}
+
+/**
+ * @brief Próbkuje wartości kroczące na ostatniej godzinie każdej doby.
+ * @param grid Siatka godzinowa.
+ * @param values Wartości kroczące na siatce.
+ * @param counts Liczby ważnych wartości w oknie (lub pusty wektor, jeśli bez warunku).
+ * @param minCount Minimalna liczba ważnych wartości.
+ * @return Seria dobowa.
+ */
+MeasurementSeries RegulatoryMetrics::sampleDays(const QVector<qint64>& grid, const QVector<double>& values,
+                                                const QVector<int>& counts, int minCount)
+{
+    MeasurementSeries daily;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    QDate current = grid.isEmpty() ? QDate() : QDateTime::fromMSecsSinceEpoch(grid.first()).date();
+    for (int i = 0; i < grid.size(); ++i) {
+        const QDate next = i + 1 < grid.size() ? QDateTime::fromMSecsSinceEpoch(grid[i + 1]).date() : QDate();
+        if (next == current) continue;
+
+        const bool enough = counts.isEmpty() || counts[i] >= minCount;
+        daily.timestamps.append(current.startOfDay().toMSecsSinceEpoch());
+        daily.values.append(enough ? values[i] : nan);
+        current = next;
+    }
+    return daily;
+}
+
+/**
+ * @brief Oblicza średnie 24-godzinne dla kolejnych dób.
+ * @param series Seria pomiarów godzinowych.
+ * @return Seria dobowa (znacznik czasu = początek doby, NaN przy niepełnych danych).
+ */
+MeasurementSeries RegulatoryMetrics::dailyMeans(const MeasurementSeries& series)
+{
+    if (series.isEmpty()) return MeasurementSeries();
+
+    MeasurementSeries hourly = fullDayGrid(series);
+    QVector<double> means = runningMean(hourly.values, 24, MIN_DAILY_HOURS);
+    MeasurementSeries daily = sampleDays(hourly.timestamps, means, QVector<int>(), 0);
+    daily.key = series.key;
+    return daily;
+}
+
+/**
+ * @brief Oblicza maksymalne dobowe średnie 8-godzinne.
+ *
+ * Dla każdej doby wybierane jest maksimum z 24 średnich 8-godzinnych kończących się
+ * w tej dobie; doba jest ważna, jeśli co najmniej 18 z nich jest ważnych.
+ * @param series Seria pomiarów godzinowych.
+ * @return Seria dobowa (znacznik czasu = początek doby, NaN przy niepełnych danych).
+ */
+MeasurementSeries RegulatoryMetrics::dailyMaxEightHourMeans(const MeasurementSeries& series)
+{
+    if (series.isEmpty()) return MeasurementSeries();
+
+    MeasurementSeries hourly = fullDayGrid(series);
+    QVector<double> eightHourMeans = runningMean(hourly.values, 8, MIN_EIGHT_HOUR_VALUES);
+    QVector<double> maxima = slidingMax(eightHourMeans, 24);
+    QVector<int> counts = runningCount(eightHourMeans, 24);
+    MeasurementSeries daily = sampleDays(hourly.timestamps, maxima, counts, MIN_DAILY_HOURS);
+    daily.key = series.key;
+    return daily;
+}
+
+/**
+ * @brief Tworzy raport roczny przekroczeń dla czujnika.
+ * @param input Dane wejściowe czujnika.
+ * @return Raport (bez lat, jeśli dla parametru nie zdefiniowano normy).
+ */
+RegulatoryMetrics::SensorReport RegulatoryMetrics::report(const SensorInput& input)
+{
+    SensorReport report;
+    report.sensorId = input.sensorId;
+    if (!limitFor(input.paramCode, &report.limit)) return report;
+
+    MeasurementSeries daily = report.limit.eightHour ? dailyMaxEightHourMeans(input.series)
+                                                     : dailyMeans(input.series);
+
+    QMap<int, YearSummary> years;
+    QMap<int, double> sums;
+    for (int i = 0; i < daily.size(); ++i) {
+        const double value = daily.values[i];
+        if (std::isnan(value)) continue;
+
+        const int year = QDateTime::fromMSecsSinceEpoch(daily.timestamps[i]).date().year();
+        YearSummary& summary = years[year];
+        summary.year = year;
+        summary.maxValue = summary.validDays == 0 ? value : std::max(summary.maxValue, value);
+        summary.validDays++;
+        summary.exceedanceDays += value > report.limit.threshold ? 1 : 0;
+        sums[year] += value;
+    }
+
+    for (auto it = years.begin(); it != years.end(); ++it) {
+        it.value().meanValue = sums[it.key()] / it.value().validDays;
+        report.years.append(it.value());
+    }
+    return report;
+}
+
+/**
+ * @brief Tworzy raporty dla wielu czujników równolegle w puli wątków.
+ * @param inputs Dane wejściowe czujników.
+ * @return Raporty czujników, dla których zdefiniowano normę.
+ */
+QVector<RegulatoryMetrics::SensorReport> RegulatoryMetrics::reportAll(const QVector<SensorInput>& inputs)
+{
+    QVector<SensorReport> reports(inputs.size());
+    QVector<int> jobs(inputs.size());
+    std::iota(jobs.begin(), jobs.end(), 0);
+
+    QtConcurrent::blockingMap(jobs, [&](int job) {
+        reports[job] = report(inputs.at(job));
+    });
+
+    QVector<SensorReport> result;
+    for (const SensorReport& report : reports) {
+        if (!report.years.isEmpty()) result.append(report);
+    }
+    return result;
+}
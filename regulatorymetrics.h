@@ -0,0 +1,154 @@
+#ifndef REGULATORYMETRICS_H
+#define REGULATORYMETRICS_H
+
+#include <QString>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @brief Wskaźniki regulacyjne liczone oknami kroczącymi.
+ *
+ * Oblicza średnie 24-godzinne (PM10, PM2.5), maksymalne dobowe średnie 8-godzinne (O3)
+ * oraz roczne liczby dni z przekroczeniem norm UE. Średnie kroczące korzystają z sum
+ * bieżących, a maksima z kolejki monotonicznej, więc koszt na krok jest stały (zamortyzowany).
+ */
+class RegulatoryMetrics
+{
+public:
+    /**
+     * @brief Norma dla parametru.
+     */
+    struct Limit {
+        /// @brief Kod parametru (np. PM10).
+        QString paramCode;
+        /// @brief Wartość progowa w µg/m³.
+        double threshold = 0.0;
+        /// @brief Dopuszczalna liczba dni z przekroczeniem w roku.
+        int allowedDays = 0;
+        /// @brief Czy norma dotyczy maksymalnej dobowej średniej 8-godzinnej (w przeciwnym razie średniej dobowej).
+        bool eightHour = false;
+    };
+
+    /**
+     * @brief Podsumowanie jednego roku dla czujnika.
+     */
+    struct YearSummary {
+        /// @brief Rok kalendarzowy.
+        int year = 0;
+        /// @brief Liczba dni z ważną wartością dobową.
+        int validDays = 0;
+        /// @brief Liczba dni z przekroczeniem normy.
+        int exceedanceDays = 0;
+        /// @brief Najwyższa wartość dobowa w roku.
+        double maxValue = 0.0;
+        /// @brief Średnia z wartości dobowych w roku.
+        double meanValue = 0.0;
+    };
+
+    /**
+     * @brief Raport zgodności dla jednego czujnika.
+     */
+    struct SensorReport {
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Zastosowana norma.
+        Limit limit;
+        /// @brief Podsumowania kolejnych lat.
+        QVector<YearSummary> years;
+    };
+
+    /**
+     * @brief Dane wejściowe raportu dla jednego czujnika.
+     */
+    struct SensorInput {
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Kod parametru.
+        QString paramCode;
+        /// @brief Pełna historia pomiarów.
+        MeasurementSeries series;
+    };
+
+    /// @brief Minimalna liczba ważnych godzin w dobie dla średniej 24-godzinnej (75%).
+    static const int MIN_DAILY_HOURS = 18;
+    /// @brief Minimalna liczba ważnych godzin dla średniej 8-godzinnej (75%).
+    static const int MIN_EIGHT_HOUR_VALUES = 6;
+
+    /**
+     * @brief Zwraca normę UE dla parametru.
+     * @param paramCode Kod parametru (np. PM10, PM2.5, O3).
+     * @param limit Wskaźnik na strukturę uzupełnianą normą.
+     * @return True, jeśli dla parametru zdefiniowano normę.
+     */
+    static bool limitFor(const QString& paramCode, Limit* limit);
+
+    /**
+     * @brief Oblicza średnie kroczące z wymaganą liczbą ważnych wartości.
+     *
+     * Element i wyniku to średnia z wartości i - window + 1 ... i; NaN, jeśli ważnych wartości
+     * jest mniej niż minValid.
+     * @param values Wartości na siatce (NaN dla braków).
+     * @param window Długość okna.
+     * @param minValid Minimalna liczba ważnych wartości w oknie.
+     * @return Średnie kroczące.
+     */
+    static QVector<double> runningMean(const QVector<double>& values, int window, int minValid);
+
+    /**
+     * @brief Oblicza maksima kroczące z pominięciem braków (kolejka monotoniczna).
+     * @param values Wartości (NaN dla braków).
+     * @param window Długość okna.
+     * @return Element i to maksimum z wartości i - window + 1 ... i (NaN, jeśli wszystkie są brakami).
+     */
+    static QVector<double> slidingMax(const QVector<double>& values, int window);
+
+    /**
+     * @brief Oblicza średnie 24-godzinne dla kolejnych dób.
+     * @param series Seria pomiarów godzinowych.
+     * @return Seria dobowa (znacznik czasu = początek doby, NaN przy niepełnych danych).
+     */
+    static MeasurementSeries dailyMeans(const MeasurementSeries& series);
+
+    /**
+     * @brief Oblicza maksymalne dobowe średnie 8-godzinne.
+     * @param series Seria pomiarów godzinowych.
+     * @return Seria dobowa (znacznik czasu = początek doby, NaN przy niepełnych danych).
+     */
+    static MeasurementSeries dailyMaxEightHourMeans(const MeasurementSeries& series);
+
+    /**
+     * @brief Tworzy raport roczny przekroczeń dla czujnika.
+     * @param input Dane wejściowe czujnika.
+     * @return Raport (bez lat, jeśli dla parametru nie zdefiniowano normy).
+     */
+    static SensorReport report(const SensorInput& input);
+
+    /**
+     * @brief Tworzy raporty dla wielu czujników równolegle w puli wątków.
+     * @param inputs Dane wejściowe czujników.
+     * @return Raporty czujników, dla których zdefiniowano normę.
+     */
+    static QVector<SensorReport> reportAll(const QVector<SensorInput>& inputs);
+
+private:
+    /**
+     * @brief Próbkuje wartości kroczące na ostatniej godzinie każdej doby.
+     * @param grid Siatka godzinowa.
+     * @param values Wartości kroczące na siatce.
+     * @param counts Liczby ważnych wartości w oknie (lub pusty wektor, jeśli bez warunku).
+     * @param minCount Minimalna liczba ważnych wartości.
+     * @return Seria dobowa.
+     */
+    static MeasurementSeries sampleDays(const QVector<qint64>& grid, const QVector<double>& values,
+                                        const QVector<int>& counts, int minCount);
+
+    /**
+     * @brief Liczy ważne wartości w oknach kroczących.
+     * @param values Wartości (NaN dla braków).
+     * @param window Długość okna.
+     * @return Liczby ważnych wartości w oknach kończących się na kolejnych indeksach.
+     */
+    static QVector<int> runningCount(const QVector<double>& values, int window);
+};
+
+#endif // REGULATORYMETRICS_H
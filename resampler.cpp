@@ -0,0 +1,271 @@
+#include "resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// @brief Liczba milisekund w godzinie.
+const qint64 HOUR_MS = 3600000;
+/// @brief Liczba milisekund w dobie.
+const qint64 DAY_MS = 24 * HOUR_MS;
+
+/**
+ * @brief Zwraca datę lokalną odpowiadającą znacznikowi czasu.
+ * @param timestamp Znacznik czasu (ms od epoki).
+ * @return Data w czasie lokalnym.
+ */
+QDate localDate(qint64 timestamp)
+{
+    return QDateTime::fromMSecsSinceEpoch(timestamp).date();
+}
+
+}
+
+/**
+ * @brief Zwraca długość kroku siatki w milisekundach.
+ * @param step Krok siatki.
+ * @return Długość kroku w ms.
+ */
+qint64 Resampler::stepMs(Step step)
+{
+    return step == Daily ? DAY_MS : HOUR_MS;
+}
+
+/**
+ * @brief Zamienia nazwę kroku na wartość wyliczenia.
+ * @param name Nazwa ("hour" lub "day").
+ * @return Krok siatki (domyślnie godzinowy).
+ */
+Resampler::Step Resampler::stepFromName(const QString& name)
+{
+    return name.toLower() == "day" ? Daily : Hourly;
+}
+
+/**
+ * @brief Zamienia nazwę polityki wypełniania na wartość wyliczenia.
+ * @param name Nazwa ("null", "linear" lub "carry").
+ * @return Polityka wypełniania (domyślnie bez wypełniania).
+ */
+Resampler::GapPolicy Resampler::policyFromName(const QString& name)
+{
+    const QString lower = name.toLower();
+    if (lower == "linear") return Linear;
+    if (lower == "carry") return CarryForward;
+    return LeaveNull;
+}
+
+/**
+ * @brief Zaokrągla znacznik czasu w dół do początku przedziału siatki.
+ * @param timestamp Znacznik czasu (ms od epoki).
+ * @param step Krok siatki.
+ * @return Początek przedziału (ms od epoki).
+ */
+qint64 Resampler::floorToStep(qint64 timestamp, Step step)
+{
+    if (step == Daily) {
+        return localDate(timestamp).startOfDay().toMSecsSinceEpoch();
+    }
+    return timestamp - timestamp % HOUR_MS;
+}
+
+/**
+ * @brief Uśrednia wartości serii w przedziałach siatki.
+ * @param series Seria źródłowa.
+ * @param start Początek siatki.
+ * @param count Liczba przedziałów siatki.
+ * @param step Krok siatki.
+ * @return Wartości na siatce (NaN dla przedziałów bez danych).
+ */
+QVector<double> Resampler::bucketize(const MeasurementSeries& series, qint64 start, int count, Step step)
+{
+    QVector<double> sums(count, 0.0);
+    QVector<int> counts(count, 0);
+    const QDate startDate = localDate(start);
+
+    for (int i = 0; i < series.size(); ++i) {
+        const double value = series.values[i];
+        if (std::isnan(value)) continue;
+        const qint64 index = step == Daily
+                                 ? startDate.daysTo(localDate(series.timestamps[i]))
+                                 : (series.timestamps[i] - start) / HOUR_MS;
+        if (index < 0 || index >= count) continue;
+        sums[index] += value;
+        counts[index]++;
+    }
+
+    QVector<double> values(count);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int i = 0; i < count; ++i) {
+        values[i] = counts[i] > 0 ? sums[i] / counts[i] : nan;
+    }
+    return values;
+}
+
+/**
+ * @brief Wypełnia luki przeniesieniem ostatniej wartości (bez rozgałęzień).
+ * @param values Wartości na siatce, modyfikowane w miejscu.
+ * @param maxGap Maksymalna długość wypełnianej luki (0 bez ograniczeń).
+ */
+void Resampler::fillCarryForward(QVector<double>& values, int maxGap)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const int n = values.size();
+    double* data = values.data();
+
+    double last = nan;
+    int age = 0;
+    for (int i = 0; i < n; ++i) {
+        const double value = data[i];
+        const bool valid = value == value;
+        age = valid ? 0 : age + 1;
+        last = valid ? value : last;
+        const bool within = maxGap <= 0 || age <= maxGap;
+        data[i] = within ? last : nan;
+    }
+}
+
+/**
+ * @brief Wypełnia luki interpolacją liniową (bez rozgałęzień).
+ *
+ * Najpierw wyznaczane są indeksy poprzedniej i następnej znanej wartości dla każdego
+ * przedziału, a następnie interpolacja liczona jest w jednej pętli bez zależności
+ * między iteracjami, którą kompilator może zwektoryzować.
+ * @param values Wartości na siatce, modyfikowane w miejscu.
+ * @param maxGap Maksymalna długość wypełnianej luki (0 bez ograniczeń).
+ */
+void Resampler::fillLinear(QVector<double>& values, int maxGap)
+{
+    const int n = values.size();
+    if (n == 0) return;
+
+    QVector<int> previous(n);
+    QVector<int> next(n);
+    const double* data = values.constData();
+
+    int last = -1;
+    for (int i = 0; i < n; ++i) {
+        last = data[i] == data[i] ? i : last;
+        previous[i] = last;
+    }
+    last = -1;
+    for (int i = n - 1; i >= 0; --i) {
+        last = data[i] == data[i] ? i : last;
+        next[i] = last;
+    }
+
+    QVector<double> filled(n);
+    double* out = filled.data();
+    const int* p = previous.constData();
+    const int* q = next.constData();
+    for (int i = 0; i < n; ++i) {
+        const bool bounded = p[i] >= 0 && q[i] >= 0;
+        const bool within = maxGap <= 0 || q[i] - p[i] - 1 <= maxGap;
+        const int lo = std::max(p[i], 0);
+        const int hi = std::max(q[i], 0);
+        const double t = double(i - lo) / double(std::max(hi - lo, 1));
+        const double interpolated = data[lo] + t * (data[hi] - data[lo]);
+        out[i] = (bounded && within) ? interpolated : data[i];
+    }
+    values = filled;
+}
+
+/**
+ * @brief Oblicza procent przedziałów zawierających wartość.
+ * @param values Wartości na siatce.
+ * @return Pokrycie w procentach (0-100).
+ */
+double Resampler::coverageOf(const QVector<double>& values)
+{
+    if (values.isEmpty()) return 0.0;
+
+    const double* data = values.constData();
+    int valid = 0;
+    for (int i = 0; i < values.size(); ++i) {
+        valid += data[i] == data[i] ? 1 : 0;
+    }
+    return 100.0 * valid / values.size();
+}
+
+/**
+ * @brief Przenosi pojedynczą serię na siatkę czasu.
+ * @param series Seria źródłowa posortowana rosnąco po czasie.
+ * @param options Opcje wyrównywania.
+ * @param coverage Opcjonalny wskaźnik na pokrycie siatki danymi źródłowymi (0-100%).
+ * @return Seria na regularnej siatce.
+ */
+MeasurementSeries Resampler::resample(const MeasurementSeries& series, const Options& options, double* coverage)
+{
+    MeasurementSeries result;
+    result.key = series.key;
+    if (coverage) *coverage = 0.0;
+
+    const qint64 first = options.start >= 0 ? options.start : (series.isEmpty() ? -1 : series.timestamps.first());
+    const qint64 last = options.end >= 0 ? options.end : (series.isEmpty() ? -1 : series.timestamps.last());
+    if (first < 0 || last < first) return result;
+
+    const qint64 start = floorToStep(first, options.step);
+    const qint64 end = floorToStep(last, options.step);
+    const int count = options.step == Daily
+                          ? static_cast<int>(localDate(start).daysTo(localDate(end))) + 1
+                          : static_cast<int>((end - start) / HOUR_MS) + 1;
+
+    result.timestamps.resize(count);
+    const QDate startDate = localDate(start);
+    for (int i = 0; i < count; ++i) {
+        result.timestamps[i] = options.step == Daily
+                                   ? startDate.addDays(i).startOfDay().toMSecsSinceEpoch()
+                                   : start + i * HOUR_MS;
+    }
+
+    result.values = bucketize(series, start, count, options.step);
+    if (coverage) *coverage = coverageOf(result.values);
+
+    switch (options.policy) {
+    case Linear:
+        fillLinear(result.values, options.maxGap);
+        break;
+    case CarryForward:
+        fillCarryForward(result.values, options.maxGap);
+        break;
+    case LeaveNull:
+        break;
+    }
+    return result;
+}
+
+/**
+ * @brief Wyrównuje zestaw serii do wspólnej siatki obejmującej wszystkie serie.
+ * @param series Serie źródłowe.
+ * @param options Opcje wyrównywania.
+ * @return Wyrównany zestaw serii.
+ */
+Resampler::AlignedSet Resampler::align(const QVector<MeasurementSeries>& series, const Options& options)
+{
+    AlignedSet result;
+
+    Options common = options;
+    if (common.start < 0 || common.end < 0) {
+        qint64 first = std::numeric_limits<qint64>::max();
+        qint64 last = -1;
+        for (const MeasurementSeries& s : series) {
+            if (s.isEmpty()) continue;
+            first = std::min(first, s.timestamps.first());
+            last = std::max(last, s.timestamps.last());
+        }
+        if (last < 0) return result;
+        if (common.start < 0) common.start = first;
+        if (common.end < 0) common.end = last;
+    }
+
+    result.columns.reserve(series.size());
+    result.coverage.reserve(series.size());
+    for (const MeasurementSeries& s : series) {
+        double coverage = 0.0;
+        MeasurementSeries resampled = resample(s, common, &coverage);
+        if (result.grid.isEmpty()) result.grid = resampled.timestamps;
+        result.columns.append(resampled.values);
+        result.coverage.append(coverage);
+    }
+    return result;
+}
@@ -0,0 +1,142 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <QString>
+#include <QVector>
+#include "measurementseries.h"
+
+/**
+ * @brief Wyrównywanie serii pomiarowych do wspólnej siatki czasu.
+ *
+ * Serie o nieregularnych odstępach i brakach są przenoszone na siatkę godzinową lub dobową
+ * (wartości w jednym przedziale są uśredniane), a luki wypełniane zgodnie z wybraną polityką.
+ * Jądra wypełniania nie zawierają rozgałęzień zależnych od danych.
+ */
+class Resampler
+{
+public:
+    /**
+     * @brief Krok siatki czasu.
+     */
+    enum Step {
+        Hourly, ///< Siatka godzinowa.
+        Daily   ///< Siatka dobowa (doby w czasie lokalnym).
+    };
+
+    /**
+     * @brief Polityka wypełniania luk.
+     */
+    enum GapPolicy {
+        LeaveNull,   ///< Luki pozostają puste (NaN).
+        Linear,      ///< Interpolacja liniowa między sąsiednimi wartościami.
+        CarryForward ///< Przeniesienie ostatniej znanej wartości.
+    };
+
+    /**
+     * @brief Opcje wyrównywania.
+     */
+    struct Options {
+        /// @brief Krok siatki.
+        Step step = Hourly;
+        /// @brief Polityka wypełniania luk.
+        GapPolicy policy = LeaveNull;
+        /// @brief Maksymalna długość wypełnianej luki w krokach siatki (0 bez ograniczeń).
+        int maxGap = 3;
+        /// @brief Początek siatki w ms od epoki (-1 dla najwcześniejszego pomiaru).
+        qint64 start = -1;
+        /// @brief Koniec siatki w ms od epoki (-1 dla najpóźniejszego pomiaru).
+        qint64 end = -1;
+    };
+
+    /**
+     * @brief Zestaw serii wyrównanych do wspólnej siatki.
+     */
+    struct AlignedSet {
+        /// @brief Wspólna siatka czasu (ms od epoki).
+        QVector<qint64> grid;
+        /// @brief Wartości kolejnych serii na siatce (NaN dla luk).
+        QVector<QVector<double>> columns;
+        /// @brief Pokrycie siatki danymi źródłowymi dla każdej serii (0-100%).
+        QVector<double> coverage;
+    };
+
+    /**
+     * @brief Przenosi pojedynczą serię na siatkę czasu.
+     * @param series Seria źródłowa posortowana rosnąco po czasie.
+     * @param options Opcje wyrównywania.
+     * @param coverage Opcjonalny wskaźnik na pokrycie siatki danymi źródłowymi (0-100%).
+     * @return Seria na regularnej siatce.
+     */
+    static MeasurementSeries resample(const MeasurementSeries& series, const Options& options, double* coverage = nullptr);
+
+    /**
+     * @brief Wyrównuje zestaw serii do wspólnej siatki obejmującej wszystkie serie.
+     * @param series Serie źródłowe.
+     * @param options Opcje wyrównywania.
+     * @return Wyrównany zestaw serii.
+     */
+    static AlignedSet align(const QVector<MeasurementSeries>& series, const Options& options);
+
+    /**
+     * @brief Zwraca długość kroku siatki w milisekundach.
+     * @param step Krok siatki.
+     * @return Długość kroku w ms.
+     */
+    static qint64 stepMs(Step step);
+
+    /**
+     * @brief Zamienia nazwę kroku na wartość wyliczenia.
+     * @param name Nazwa ("hour" lub "day").
+     * @return Krok siatki (domyślnie godzinowy).
+     */
+    static Step stepFromName(const QString& name);
+
+    /**
+     * @brief Zamienia nazwę polityki wypełniania na wartość wyliczenia.
+     * @param name Nazwa ("null", "linear" lub "carry").
+     * @return Polityka wypełniania (domyślnie bez wypełniania).
+     */
+    static GapPolicy policyFromName(const QString& name);
+
+private:
+    /**
+     * @brief Zaokrągla znacznik czasu w dół do początku przedziału siatki.
+     * @param timestamp Znacznik czasu (ms od epoki).
+     * @param step Krok siatki.
+     * @return Początek przedziału (ms od epoki).
+     */
+    static qint64 floorToStep(qint64 timestamp, Step step);
+
+    /**
+     * @brief Uśrednia wartości serii w przedziałach siatki.
+     * @param series Seria źródłowa.
+     * @param start Początek siatki.
+     * @param count Liczba przedziałów siatki.
+     * @param step Krok siatki.
+     * @return Wartości na siatce (NaN dla przedziałów bez danych).
+     */
+    static QVector<double> bucketize(const MeasurementSeries& series, qint64 start, int count, Step step);
+
+    /**
+     * @brief Wypełnia luki przeniesieniem ostatniej wartości (bez rozgałęzień).
+     * @param values Wartości na siatce, modyfikowane w miejscu.
+     * @param maxGap Maksymalna długość wypełnianej luki (0 bez ograniczeń).
+     */
+    static void fillCarryForward(QVector<double>& values, int maxGap);
+
+    /**
+     * @brief Wypełnia luki interpolacją liniową (bez rozgałęzień).
+     * @param values Wartości na siatce, modyfikowane w miejscu.
+     * @param maxGap Maksymalna długość wypełnianej luki (0 bez ograniczeń).
+     */
+    static void fillLinear(QVector<double>& values, int maxGap);
+
+    /**
+     * @brief Oblicza procent przedziałów zawierających wartość.
+     * @param values Wartości na siatce.
+     * @return Pokrycie w procentach (0-100).
+     */
+    static double coverageOf(const QVector<double>& values);
+};
+
+#endif // RESAMPLER_H
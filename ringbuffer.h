@@ -0,0 +1,124 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Ograniczona kolejka bez blokad dla wielu producentów i jednego konsumenta.
+ *
+ * Bufor cykliczny o pojemności będącej potęgą dwójki; każda komórka ma własny numer
+ * sekwencyjny, więc producenci rezerwują miejsce jedną operacją compare-exchange,
+ * a konsument odczytuje komórki bez operacji atomowych typu read-modify-write.
+ * Gdy bufor jest pełny, tryPush() zwraca false zamiast czekać.
+ * @tparam T Typ elementu (powinien być tani w kopiowaniu).
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+    /**
+     * @brief Tworzy bufor o pojemności zaokrąglonej w górę do potęgi dwójki.
+     * @param capacity Minimalna pojemność (co najmniej 2).
+     */
+    explicit RingBuffer(int capacity)
+    {
+        quint64 size = 2;
+        while (size < static_cast<quint64>(capacity)) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (quint64 i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Dodaje element (bezpieczne dla wielu producentów jednocześnie).
+     * @param item Element.
+     * @return False, jeśli bufor jest pełny.
+     */
+    bool tryPush(const T& item)
+    {
+        quint64 position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            const quint64 sequence = cell->sequence.load(std::memory_order_acquire);
+            const qint64 difference = static_cast<qint64>(sequence) - static_cast<qint64>(position);
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pobiera najstarszy element (wyłącznie z wątku konsumenta).
+     * @param item Miejsce na pobrany element.
+     * @return False, jeśli bufor jest pusty.
+     */
+    bool tryPop(T& item)
+    {
+        const quint64 position = head.load(std::memory_order_relaxed);
+        Cell& cell = cells[position & mask];
+        const quint64 sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<qint64>(sequence) - static_cast<qint64>(position + 1) < 0) return false;
+
+        item = cell.item;
+        cell.sequence.store(position + mask + 1, std::memory_order_release);
+        head.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Zwraca przybliżoną liczbę elementów w buforze.
+     * @return Liczba elementów (może być nieaktualna przy równoległych zapisach).
+     */
+    int sizeApprox() const
+    {
+        const quint64 produced = tail.load(std::memory_order_relaxed);
+        const quint64 consumed = head.load(std::memory_order_relaxed);
+        return produced > consumed ? static_cast<int>(produced - consumed) : 0;
+    }
+
+    /**
+     * @brief Zwraca pojemność bufora.
+     * @return Liczba komórek.
+     */
+    int capacity() const
+    {
+        return static_cast<int>(mask + 1);
+    }
+
+private:
+    /**
+     * @brief Komórka bufora z numerem sekwencyjnym.
+     */
+    struct Cell {
+        /// @brief Numer sekwencyjny określający, czy komórka czeka na zapis czy na odczyt.
+        std::atomic<quint64> sequence;
+        /// @brief Przechowywany element.
+        T item;
+    };
+
+    /// @brief Komórki bufora.
+    std::unique_ptr<Cell[]> cells;
+    /// @brief Maska indeksu (pojemność - 1).
+    quint64 mask = 0;
+    /// @brief Pozycja zapisu (wspólna dla producentów), w osobnej linii pamięci podręcznej.
+    alignas(64) std::atomic<quint64> tail{0};
+    /// @brief Pozycja odczytu (tylko konsument), w osobnej linii pamięci podręcznej.
+    alignas(64) std::atomic<quint64> head{0};
+};
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,161 @@
+#include "sensorlistmodel.h"
+#include <QSet>
+
+/**
+ * @brief Tworzy rekord z obiektu JSON w formacie API GIOŚ.
+ * @param sensor Obiekt JSON czujnika.
+ * @return Rekord czujnika.
+ */
+SensorRecord SensorRecord::fromJson(const QJsonObject& sensor)
+{
+    SensorRecord record;
+    QJsonObject param = sensor["param"].toObject();
+    record.id = sensor["id"].toInt();
+    record.stationId = sensor["stationId"].toInt();
+    record.paramName = param["paramName"].toString();
+    record.paramFormula = param["paramFormula"].toString();
+    record.paramCode = param["paramCode"].toString();
+    return record;
+}
+
+/**
+ * @brief Porównuje rekordy.
+ * @param other Drugi rekord.
+ * @return True, jeśli wszystkie pola są równe.
+ */
+bool SensorRecord::operator==(const SensorRecord& other) const
+{
+    return id == other.id && stationId == other.stationId && paramName == other.paramName
+           && paramFormula == other.paramFormula && paramCode == other.paramCode;
+}
+
+/**
+ * @brief Konstruktor modelu.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+SensorListModel::SensorListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+/**
+ * @brief Zwraca liczbę czujników.
+ * @param parent Indeks rodzica (nieużywany).
+ * @return Liczba wierszy.
+ */
+int SensorListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : records.size();
+}
+
+/**
+ * @brief Zwraca dane czujnika dla podanej roli.
+ * @param index Indeks wiersza.
+ * @param role Rola danych.
+ * @return Wartość lub pusty QVariant.
+ */
+QVariant SensorListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= records.size()) return QVariant();
+
+    const SensorRecord& sensor = records[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("%1 (%2)").arg(sensor.paramName, sensor.paramFormula);
+    case SensorIdRole:
+        return sensor.id;
+    case StationIdRole:
+        return sensor.stationId;
+    case ParamNameRole:
+        return sensor.paramName;
+    case ParamCodeRole:
+        return sensor.paramCode;
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Zwraca nazwy ról dostępne w QML.
+ * @return Mapa ról na nazwy.
+ */
+QHash<int, QByteArray> SensorListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles[SensorIdRole] = "sensorId";
+    roles[StationIdRole] = "stationId";
+    roles[ParamNameRole] = "paramName";
+    roles[ParamCodeRole] = "paramCode";
+    return roles;
+}
+
+/**
+ * @brief Aktualizuje listę czujników, emitując tylko zmiany wierszy.
+ *
+ * Czujniki nieobecne na nowej liście są usuwane, zmienione aktualizowane w miejscu,
+ * a nowe dopisywane na końcu.
+ * @param sensors Nowa lista czujników.
+ * @return Liczba usuniętych, zmienionych i dodanych wierszy.
+ */
+int SensorListModel::setSensors(const QVector<SensorRecord>& sensors)
+{
+    int touched = 0;
+    QHash<int, int> incoming;
+    for (int i = 0; i < sensors.size(); ++i) {
+        incoming.insert(sensors[i].id, i);
+    }
+
+    for (int row = records.size() - 1; row >= 0; --row) {
+        if (incoming.contains(records[row].id)) continue;
+        int last = row;
+        while (row > 0 && !incoming.contains(records[row - 1].id)) --row;
+        beginRemoveRows(QModelIndex(), row, last);
+        touched += last - row + 1;
+        records.remove(row, last - row + 1);
+        endRemoveRows();
+    }
+
+    QSet<int> present;
+    for (int row = 0; row < records.size(); ++row) {
+        present.insert(records[row].id);
+        const SensorRecord& updated = sensors[incoming.value(records[row].id)];
+        if (updated == records[row]) continue;
+        records[row] = updated;
+        ++touched;
+        emit dataChanged(index(row), index(row));
+    }
+
+    QVector<SensorRecord> added;
+    for (const SensorRecord& sensor : sensors) {
+        if (!present.contains(sensor.id)) added.append(sensor);
+    }
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), records.size(), records.size() + added.size() - 1);
+        records += added;
+        endInsertRows();
+    }
+    return touched + added.size();
+}
+
+/**
+ * @brief Zwraca identyfikator czujnika w podanym wierszu.
+ * @param row Numer wiersza.
+ * @return Identyfikator czujnika lub -1.
+ */
+int SensorListModel::sensorIdAt(int row) const
+{
+    return row >= 0 && row < records.size() ? records[row].id : -1;
+}
+
+/**
+ * @brief Zwraca numer wiersza czujnika.
+ * @param sensorId Identyfikator czujnika.
+ * @return Numer wiersza lub -1.
+ */
+int SensorListModel::rowOf(int sensorId) const
+{
+    for (int row = 0; row < records.size(); ++row) {
+        if (records[row].id == sensorId) return row;
+    }
+    return -1;
+}
@@ -0,0 +1,112 @@
+#ifndef SENSORLISTMODEL_H
+#define SENSORLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QJsonObject>
+#include <QVector>
+
+/**
+ * @brief Rekord czujnika (stanowiska pomiarowego) stacji.
+ */
+struct SensorRecord
+{
+    /// @brief Identyfikator czujnika.
+    int id = -1;
+    /// @brief Identyfikator stacji, do której należy czujnik.
+    int stationId = -1;
+    /// @brief Nazwa parametru (np. pył zawieszony PM10).
+    QString paramName;
+    /// @brief Symbol parametru (np. PM10).
+    QString paramFormula;
+    /// @brief Kod parametru (np. PM10).
+    QString paramCode;
+
+    /**
+     * @brief Tworzy rekord z obiektu JSON w formacie API GIOŚ.
+     * @param sensor Obiekt JSON czujnika.
+     * @return Rekord czujnika.
+     */
+    static SensorRecord fromJson(const QJsonObject& sensor);
+
+    /**
+     * @brief Porównuje rekordy.
+     * @param other Drugi rekord.
+     * @return True, jeśli wszystkie pola są równe.
+     */
+    bool operator==(const SensorRecord& other) const;
+};
+
+/**
+ * @brief Model listy czujników wybranej stacji z typowanymi rolami.
+ *
+ * Zasila listę rozwijaną czujników; odświeżenie emituje wyłącznie zmiany wierszy.
+ */
+class SensorListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Role danych czujnika.
+     */
+    enum Roles {
+        SensorIdRole = Qt::UserRole + 1, ///< Identyfikator czujnika.
+        StationIdRole,                   ///< Identyfikator stacji.
+        ParamNameRole,                   ///< Nazwa parametru.
+        ParamCodeRole                    ///< Kod parametru.
+    };
+
+    /**
+     * @brief Konstruktor modelu.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit SensorListModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca liczbę czujników.
+     * @param parent Indeks rodzica (nieużywany).
+     * @return Liczba wierszy.
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Zwraca dane czujnika dla podanej roli.
+     * @param index Indeks wiersza.
+     * @param role Rola danych.
+     * @return Wartość lub pusty QVariant.
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Zwraca nazwy ról dostępne w QML.
+     * @return Mapa ról na nazwy.
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Aktualizuje listę czujników, emitując tylko zmiany wierszy.
+     * @param sensors Nowa lista czujników.
+     * @return Liczba usuniętych, zmienionych i dodanych wierszy.
+     */
+    int setSensors(const QVector<SensorRecord>& sensors);
+
+    /**
+     * @brief Zwraca identyfikator czujnika w podanym wierszu.
+     * @param row Numer wiersza.
+     * @return Identyfikator czujnika lub -1.
+     */
+    Q_INVOKABLE int sensorIdAt(int row) const;
+
+    /**
+     * @brief Zwraca numer wiersza czujnika.
+     * @param sensorId Identyfikator czujnika.
+     * @return Numer wiersza lub -1.
+     */
+    Q_INVOKABLE int rowOf(int sensorId) const;
+
+private:
+    /// @brief Rekordy czujników w kolejności wyświetlania.
+    QVector<SensorRecord> records;
+};
+
+#endif // SENSORLISTMODEL_H
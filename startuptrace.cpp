@@ -0,0 +1,116 @@
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QPair>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// @brief Zegar uruchomiony na początku main().
+QElapsedTimer clock;
+/// @brief Czas od utworzenia procesu do wejścia do main() (ms).
+double preMainMs = 0.0;
+/// @brief Osiągnięte punkty w kolejności (nazwa, ms od utworzenia procesu).
+QVector<QPair<QString, double>> points;
+/// @brief Czy wypisywać punkty w chwili ich osiągnięcia.
+bool printing = false;
+
+/**
+ * @brief Szacuje czas od utworzenia procesu do bieżącej chwili (dynamiczne ładowanie bibliotek,
+ * inicjalizacja statyczna).
+ * @return Milisekundy lub 0, jeśli nie da się ich ustalić na tej platformie.
+ */
+double processAgeMs()
+{
+#if defined(Q_OS_LINUX)
+    QFile stat("/proc/self/stat");
+    QFile uptime("/proc/uptime");
+    if (!stat.open(QIODevice::ReadOnly) || !uptime.open(QIODevice::ReadOnly)) return 0.0;
+
+    // Pole 22 (starttime, w taktach zegara) następuje po nazwie procesu w nawiasach.
+    const QByteArray line = stat.readAll();
+    const QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 20) return 0.0;
+    const double startTicks = fields[19].toDouble();
+    const double uptimeSeconds = uptime.readAll().split(' ').value(0).toDouble();
+    const double age = (uptimeSeconds - startTicks / sysconf(_SC_CLK_TCK)) * 1000.0;
+    return age > 0.0 ? age : 0.0;
+#else
+    return 0.0;
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Rozpoczyna pomiar; wywoływane na początku main().
+ */
+void StartupTrace::start()
+{
+    clock.start();
+    preMainMs = processAgeMs();
+    points.clear();
+    mark("main");
+}
+
+/**
+ * @brief Włącza lub wyłącza wypisywanie punktów na standardowe wyjście.
+ * @param print True, aby wypisywać punkty.
+ */
+void StartupTrace::setPrinting(bool print)
+{
+    if (print && !printing) {
+        QTextStream(stdout) << report() << "\n";
+    }
+    printing = print;
+}
+
+/**
+ * @brief Zapisuje punkt pomiarowy, jeśli nie został jeszcze osiągnięty.
+ * @param point Nazwa punktu.
+ */
+void StartupTrace::mark(const QString& point)
+{
+    if (!clock.isValid() || elapsed(point) >= 0.0) return;
+
+    const double at = preMainMs + clock.nsecsElapsed() / 1e6;
+    points.append(qMakePair(point, at));
+    if (printing) {
+        QTextStream(stdout) << "Uruchamianie: " << point << " " << QString::number(at, 'f', 1) << " ms" << Qt::endl;
+    }
+    if ((point == "first frame" || point == "catalog ready")
+        && elapsed("first frame") >= 0.0 && elapsed("catalog ready") >= 0.0) {
+        mark("interactive");
+    }
+}
+
+/**
+ * @brief Zwraca czas osiągnięcia punktu.
+ * @param point Nazwa punktu.
+ * @return Milisekundy od utworzenia procesu lub -1, jeśli punkt nie został osiągnięty.
+ */
+double StartupTrace::elapsed(const QString& point)
+{
+    for (const auto& entry : points) {
+        if (entry.first == point) return entry.second;
+    }
+    return -1.0;
+}
+
+/**
+ * @brief Zwraca raport wszystkich punktów w kolejności ich osiągnięcia.
+ * @return Raport tekstowy, jedna linia na punkt.
+ */
+QString StartupTrace::report()
+{
+    QStringList lines;
+    for (const auto& entry : points) {
+        lines.append(QString("Uruchamianie: %1 %2 ms").arg(entry.first).arg(entry.second, 0, 'f', 1));
+    }
+    return lines.join("\n");
+}
@@ -0,0 +1,50 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QString>
+
+/**
+ * @brief Punkty pomiarowe czasu uruchamiania aplikacji.
+ *
+ * Czasy liczone są od utworzenia procesu (na Linuksie odczytanego z /proc, w przeciwnym razie
+ * od wejścia do main()). Każdy punkt jest zapisywany tylko przy pierwszym wywołaniu mark(),
+ * więc można go umieścić w kodzie wykonywanym wielokrotnie. Gdy osiągnięte są oba punkty
+ * "first frame" i "catalog ready", zapisywany jest punkt "interactive" (okno z listą stacji).
+ */
+class StartupTrace
+{
+public:
+    /**
+     * @brief Rozpoczyna pomiar; wywoływane na początku main().
+     */
+    static void start();
+
+    /**
+     * @brief Włącza lub wyłącza wypisywanie punktów na standardowe wyjście.
+     *
+     * Po włączeniu wypisywane są także punkty osiągnięte wcześniej.
+     * @param print True, aby wypisywać punkty.
+     */
+    static void setPrinting(bool print);
+
+    /**
+     * @brief Zapisuje punkt pomiarowy, jeśli nie został jeszcze osiągnięty.
+     * @param point Nazwa punktu (np. "first frame").
+     */
+    static void mark(const QString& point);
+
+    /**
+     * @brief Zwraca czas osiągnięcia punktu.
+     * @param point Nazwa punktu.
+     * @return Milisekundy od utworzenia procesu lub -1, jeśli punkt nie został osiągnięty.
+     */
+    static double elapsed(const QString& point);
+
+    /**
+     * @brief Zwraca raport wszystkich punktów w kolejności ich osiągnięcia.
+     * @return Raport tekstowy, jedna linia na punkt.
+     */
+    static QString report();
+};
+
+#endif // STARTUPTRACE_H
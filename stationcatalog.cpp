@@ -0,0 +1,346 @@
+#include "stationcatalog.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Zwraca identyfikator napisu, dodając go do puli przy pierwszym wystąpieniu.
+ * @param text Napis.
+ * @return Identyfikator napisu w puli.
+ */
+quint32 StringPool::intern(const QString& text)
+{
+    auto it = ids.constFind(text);
+    if (it != ids.constEnd()) return it.value();
+
+    const quint32 id = static_cast<quint32>(strings.size());
+    strings.append(text);
+    ids.insert(strings.last(), id);
+    return id;
+}
+
+/**
+ * @brief Zwraca napis o podanym identyfikatorze.
+ * @param id Identyfikator napisu.
+ * @return Napis z puli.
+ */
+const QString& StringPool::at(quint32 id) const
+{
+    return strings.at(static_cast<int>(id));
+}
+
+/**
+ * @brief Zwraca liczbę unikalnych napisów w puli.
+ * @return Liczba napisów.
+ */
+int StringPool::size() const
+{
+    return strings.size();
+}
+
+/**
+ * @brief Zastępuje stacje katalogu stacjami z odpowiedzi API GIOŚ.
+ *
+ * Czujniki pozostają w katalogu; stacje nieobecne w nowej liście nie są już dostępne.
+ * @param stations Tablica JSON ze stacjami.
+ */
+void StationCatalog::setStations(const QJsonArray& stations)
+{
+    const int count = stations.size();
+    ids.clear();
+    names.clear();
+    streets.clear();
+    cities.clear();
+    communes.clear();
+    districts.clear();
+    provinces.clear();
+    latitudes.clear();
+    longitudes.clear();
+    rows.clear();
+
+    ids.reserve(count);
+    names.reserve(count);
+    streets.reserve(count);
+    cities.reserve(count);
+    communes.reserve(count);
+    districts.reserve(count);
+    provinces.reserve(count);
+    latitudes.reserve(count);
+    longitudes.reserve(count);
+    rows.reserve(count);
+
+    for (const QJsonValue& value : stations) {
+        QJsonObject station = value.toObject();
+        QJsonObject city = station["city"].toObject();
+        QJsonObject commune = city["commune"].toObject();
+        const int id = station["id"].toInt();
+        if (rows.contains(id)) continue;
+
+        rows.insert(id, ids.size());
+        ids.append(id);
+        names.append(station["stationName"].toString());
+        streets.append(strings.intern(station["addressStreet"].toString()));
+        cities.append(strings.intern(city["name"].toString()));
+        communes.append(strings.intern(commune["communeName"].toString()));
+        districts.append(strings.intern(commune["districtName"].toString()));
+        provinces.append(strings.intern(commune["provinceName"].toString()));
+        latitudes.append(station["gegrLat"].toString().toDouble());
+        longitudes.append(station["gegrLon"].toString().toDouble());
+    }
+}
+
+/**
+ * @brief Dodaje czujnik z odpowiedzi API GIOŚ lub aktualizuje istniejący.
+ * @param sensor Obiekt JSON czujnika.
+ */
+void StationCatalog::addSensor(const QJsonObject& sensor)
+{
+    QJsonObject param = sensor["param"].toObject();
+    SensorEntry entry;
+    entry.id = sensor["id"].toInt();
+    entry.stationId = sensor["stationId"].toInt();
+    entry.paramName = strings.intern(param["paramName"].toString());
+    entry.paramFormula = strings.intern(param["paramFormula"].toString());
+    entry.paramCode = strings.intern(param["paramCode"].toString());
+
+    auto it = sensorRows.constFind(entry.id);
+    if (it != sensorRows.constEnd()) {
+        sensors[it.value()] = entry;
+    } else {
+        sensorRows.insert(entry.id, sensors.size());
+        sensors.append(entry);
+    }
+}
+
+/**
+ * @brief Zwraca liczbę stacji.
+ * @return Liczba stacji.
+ */
+int StationCatalog::stationCount() const
+{
+    return ids.size();
+}
+
+/**
+ * @brief Zwraca liczbę czujników.
+ * @return Liczba czujników.
+ */
+int StationCatalog::sensorCount() const
+{
+    return sensors.size();
+}
+
+/**
+ * @brief Zwraca liczbę unikalnych napisów w puli.
+ * @return Liczba napisów.
+ */
+int StationCatalog::internedStrings() const
+{
+    return strings.size();
+}
+
+/**
+ * @brief Sprawdza, czy stacja jest w katalogu.
+ * @param stationId Identyfikator stacji.
+ * @return True, jeśli stacja jest w katalogu.
+ */
+bool StationCatalog::containsStation(int stationId) const
+{
+    return rows.contains(stationId);
+}
+
+/**
+ * @brief Zwraca numer wiersza stacji.
+ * @param stationId Identyfikator stacji.
+ * @return Numer wiersza lub -1, jeśli stacji nie ma w katalogu.
+ */
+int StationCatalog::stationRow(int stationId) const
+{
+    return rows.value(stationId, -1);
+}
+
+/**
+ * @brief Zwraca rekord stacji w podanym wierszu (napisy współdzielone z katalogiem).
+ * @param row Numer wiersza.
+ * @return Rekord stacji.
+ */
+StationRecord StationCatalog::stationRecord(int row) const
+{
+    StationRecord record;
+    record.id = ids[row];
+    record.name = names[row];
+    record.city = strings.at(cities[row]);
+    record.street = strings.at(streets[row]);
+    record.province = strings.at(provinces[row]);
+    record.latitude = latitudes[row];
+    record.longitude = longitudes[row];
+    return record;
+}
+
+/**
+ * @brief Zwraca rekordy wszystkich stacji w kolejności katalogu.
+ * @return Rekordy stacji.
+ */
+QVector<StationRecord> StationCatalog::stationRecords() const
+{
+    QVector<StationRecord> records;
+    records.reserve(ids.size());
+    for (int row = 0; row < ids.size(); ++row) {
+        records.append(stationRecord(row));
+    }
+    return records;
+}
+
+/**
+ * @brief Zwraca nazwę stacji.
+ * @param stationId Identyfikator stacji.
+ * @return Nazwa lub pusty napis, jeśli stacji nie ma w katalogu.
+ */
+QString StationCatalog::stationName(int stationId) const
+{
+    const int row = stationRow(stationId);
+    return row < 0 ? QString() : names[row];
+}
+
+/**
+ * @brief Zwraca nazwę gminy stacji.
+ * @param row Numer wiersza stacji.
+ * @return Nazwa gminy.
+ */
+QString StationCatalog::commune(int row) const
+{
+    return strings.at(communes[row]);
+}
+
+/**
+ * @brief Zwraca nazwę powiatu stacji.
+ * @param row Numer wiersza stacji.
+ * @return Nazwa powiatu.
+ */
+QString StationCatalog::district(int row) const
+{
+    return strings.at(districts[row]);
+}
+
+/**
+ * @brief Sprawdza, czy czujnik jest w katalogu.
+ * @param sensorId Identyfikator czujnika.
+ * @return True, jeśli czujnik jest w katalogu.
+ */
+bool StationCatalog::containsSensor(int sensorId) const
+{
+    return sensorRows.contains(sensorId);
+}
+
+/**
+ * @brief Zwraca stację czujnika.
+ * @param sensorId Identyfikator czujnika.
+ * @return Identyfikator stacji lub -1, jeśli czujnika nie ma w katalogu.
+ */
+int StationCatalog::sensorStation(int sensorId) const
+{
+    auto it = sensorRows.constFind(sensorId);
+    return it == sensorRows.constEnd() ? -1 : sensors[it.value()].stationId;
+}
+
+/**
+ * @brief Zwraca kod parametru czujnika.
+ * @param sensorId Identyfikator czujnika.
+ * @return Kod parametru lub pusty napis.
+ */
+QString StationCatalog::sensorParamCode(int sensorId) const
+{
+    auto it = sensorRows.constFind(sensorId);
+    return it == sensorRows.constEnd() ? QString() : strings.at(sensors[it.value()].paramCode);
+}
+
+/**
+ * @brief Zwraca rekord czujnika (napisy współdzielone z katalogiem).
+ * @param sensorId Identyfikator czujnika.
+ * @return Rekord czujnika (z id = -1, jeśli czujnika nie ma w katalogu).
+ */
+SensorRecord StationCatalog::sensorRecord(int sensorId) const
+{
+    SensorRecord record;
+    auto it = sensorRows.constFind(sensorId);
+    if (it == sensorRows.constEnd()) return record;
+
+    const SensorEntry& entry = sensors[it.value()];
+    record.id = entry.id;
+    record.stationId = entry.stationId;
+    record.paramName = strings.at(entry.paramName);
+    record.paramFormula = strings.at(entry.paramFormula);
+    record.paramCode = strings.at(entry.paramCode);
+    return record;
+}
+
+/**
+ * @brief Zwraca identyfikatory wszystkich czujników.
+ * @return Identyfikatory w kolejności dodania.
+ */
+QVector<int> StationCatalog::sensorIds() const
+{
+    QVector<int> result;
+    result.reserve(sensors.size());
+    for (const SensorEntry& entry : sensors) {
+        result.append(entry.id);
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca czujniki stacji.
+ * @param stationId Identyfikator stacji.
+ * @return Identyfikatory czujników.
+ */
+QVector<int> StationCatalog::sensorsOfStation(int stationId) const
+{
+    QVector<int> result;
+    for (const SensorEntry& entry : sensors) {
+        if (entry.stationId == stationId) result.append(entry.id);
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca stacje położone najbliżej podanej stacji.
+ * @param stationId Identyfikator stacji.
+ * @param count Maksymalna liczba zwracanych stacji.
+ * @return Identyfikatory stacji od najbliższej (bez podanej stacji).
+ */
+QVector<int> StationCatalog::nearestStations(int stationId, int count) const
+{
+    const int origin = rows.value(stationId, -1);
+    if (origin < 0 || count <= 0) return QVector<int>();
+
+    const double latitude = latitudes[origin];
+    const double longitudeScale = std::cos(latitude * 3.14159265358979323846 / 180.0);
+    QVector<QPair<double, int>> distances;
+    distances.reserve(ids.size());
+    for (int row = 0; row < ids.size(); ++row) {
+        if (row == origin) continue;
+        const double dLat = latitudes[row] - latitude;
+        const double dLon = (longitudes[row] - longitudes[origin]) * longitudeScale;
+        distances.append({ dLat * dLat + dLon * dLon, ids[row] });
+    }
+
+    const int k = std::min(count, static_cast<int>(distances.size()));
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+    QVector<int> result;
+    result.reserve(k);
+    for (int i = 0; i < k; ++i) result.append(distances[i].second);
+    return result;
+}
+
+/**
+ * @brief Zwraca czujniki mierzące podany parametr.
+ * @param paramCode Kod parametru (np. PM10).
+ * @return Identyfikatory czujników.
+ */
+QVector<int> StationCatalog::sensorsWithParam(const QString& paramCode) const
+{
+    QVector<int> result;
+    for (const SensorEntry& entry : sensors) {
+        if (strings.at(entry.paramCode) == paramCode) result.append(entry.id);
+    }
+    return result;
+}
@@ -0,0 +1,245 @@
+#ifndef STATIONCATALOG_H
+#define STATIONCATALOG_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include "stationlistmodel.h"
+#include "sensorlistmodel.h"
+
+/**
+ * @brief Pula napisów przechowująca każdy powtarzający się napis tylko raz.
+ *
+ * Napisy są identyfikowane indeksem; kopie QString zwracane przez at() współdzielą
+ * dane z pulą (niejawne współdzielenie), więc nie zajmują dodatkowej pamięci.
+ */
+class StringPool
+{
+public:
+    /**
+     * @brief Zwraca identyfikator napisu, dodając go do puli przy pierwszym wystąpieniu.
+     * @param text Napis.
+     * @return Identyfikator napisu w puli.
+     */
+    quint32 intern(const QString& text);
+
+    /**
+     * @brief Zwraca napis o podanym identyfikatorze.
+     * @param id Identyfikator napisu.
+     * @return Napis z puli.
+     */
+    const QString& at(quint32 id) const;
+
+    /**
+     * @brief Zwraca liczbę unikalnych napisów w puli.
+     * @return Liczba napisów.
+     */
+    int size() const;
+
+private:
+    /// @brief Unikalne napisy w kolejności dodania.
+    QVector<QString> strings;
+    /// @brief Mapa napisu na jego identyfikator.
+    QHash<QString, quint32> ids;
+};
+
+/**
+ * @brief Zwarty katalog stacji i czujników.
+ *
+ * Zastępuje trzymanie katalogu jako obiektów JSON (tablica stacji, mapy stacji i czujników).
+ * Stacje są zapisane jako struktura tablic (osobny wektor dla każdego pola), a nazwy gmin,
+ * powiatów, województw, miejscowości i parametrów trafiają do wspólnej puli napisów.
+ * Czujniki to płaskie rekordy wskazujące identyfikator swojej stacji.
+ */
+class StationCatalog
+{
+public:
+    /**
+     * @brief Płaski rekord czujnika.
+     */
+    struct SensorEntry {
+        /// @brief Identyfikator czujnika.
+        int id = -1;
+        /// @brief Identyfikator stacji czujnika.
+        int stationId = -1;
+        /// @brief Nazwa parametru (identyfikator w puli napisów).
+        quint32 paramName = 0;
+        /// @brief Symbol parametru (identyfikator w puli napisów).
+        quint32 paramFormula = 0;
+        /// @brief Kod parametru (identyfikator w puli napisów).
+        quint32 paramCode = 0;
+    };
+
+    /**
+     * @brief Zastępuje stacje katalogu stacjami z odpowiedzi API GIOŚ.
+     *
+     * Czujniki pozostają w katalogu; stacje nieobecne w nowej liście nie są już dostępne.
+     * @param stations Tablica JSON ze stacjami.
+     */
+    void setStations(const QJsonArray& stations);
+
+    /**
+     * @brief Dodaje czujnik z odpowiedzi API GIOŚ lub aktualizuje istniejący.
+     * @param sensor Obiekt JSON czujnika.
+     */
+    void addSensor(const QJsonObject& sensor);
+
+    /**
+     * @brief Zwraca liczbę stacji.
+     * @return Liczba stacji.
+     */
+    int stationCount() const;
+
+    /**
+     * @brief Zwraca liczbę czujników.
+     * @return Liczba czujników.
+     */
+    int sensorCount() const;
+
+    /**
+     * @brief Zwraca liczbę unikalnych napisów w puli.
+     * @return Liczba napisów.
+     */
+    int internedStrings() const;
+
+    /**
+     * @brief Sprawdza, czy stacja jest w katalogu.
+     * @param stationId Identyfikator stacji.
+     * @return True, jeśli stacja jest w katalogu.
+     */
+    bool containsStation(int stationId) const;
+
+    /**
+     * @brief Zwraca numer wiersza stacji.
+     * @param stationId Identyfikator stacji.
+     * @return Numer wiersza lub -1, jeśli stacji nie ma w katalogu.
+     */
+    int stationRow(int stationId) const;
+
+    /**
+     * @brief Zwraca rekord stacji w podanym wierszu (napisy współdzielone z katalogiem).
+     * @param row Numer wiersza.
+     * @return Rekord stacji.
+     */
+    StationRecord stationRecord(int row) const;
+
+    /**
+     * @brief Zwraca rekordy wszystkich stacji w kolejności katalogu.
+     * @return Rekordy stacji.
+     */
+    QVector<StationRecord> stationRecords() const;
+
+    /**
+     * @brief Zwraca nazwę stacji.
+     * @param stationId Identyfikator stacji.
+     * @return Nazwa lub pusty napis, jeśli stacji nie ma w katalogu.
+     */
+    QString stationName(int stationId) const;
+
+    /**
+     * @brief Zwraca nazwę gminy stacji.
+     * @param row Numer wiersza stacji.
+     * @return Nazwa gminy.
+     */
+    QString commune(int row) const;
+
+    /**
+     * @brief Zwraca nazwę powiatu stacji.
+     * @param row Numer wiersza stacji.
+     * @return Nazwa powiatu.
+     */
+    QString district(int row) const;
+
+    /**
+     * @brief Sprawdza, czy czujnik jest w katalogu.
+     * @param sensorId Identyfikator czujnika.
+     * @return True, jeśli czujnik jest w katalogu.
+     */
+    bool containsSensor(int sensorId) const;
+
+    /**
+     * @brief Zwraca stację czujnika.
+     * @param sensorId Identyfikator czujnika.
+     * @return Identyfikator stacji lub -1, jeśli czujnika nie ma w katalogu.
+     */
+    int sensorStation(int sensorId) const;
+
+    /**
+     * @brief Zwraca kod parametru czujnika.
+     * @param sensorId Identyfikator czujnika.
+     * @return Kod parametru lub pusty napis.
+     */
+    QString sensorParamCode(int sensorId) const;
+
+    /**
+     * @brief Zwraca rekord czujnika (napisy współdzielone z katalogiem).
+     * @param sensorId Identyfikator czujnika.
+     * @return Rekord czujnika (z id = -1, jeśli czujnika nie ma w katalogu).
+     */
+    SensorRecord sensorRecord(int sensorId) const;
+
+    /**
+     * @brief Zwraca identyfikatory wszystkich czujników.
+     * @return Identyfikatory w kolejności dodania.
+     */
+    QVector<int> sensorIds() const;
+
+    /**
+     * @brief Zwraca czujniki stacji.
+     * @param stationId Identyfikator stacji.
+     * @return Identyfikatory czujników.
+     */
+    QVector<int> sensorsOfStation(int stationId) const;
+
+    /**
+     * @brief Zwraca czujniki mierzące podany parametr.
+     * @param paramCode Kod parametru (np. PM10).
+     * @return Identyfikatory czujników.
+     */
+    QVector<int> sensorsWithParam(const QString& paramCode) const;
+
+    /**
+     * @brief Zwraca stacje położone najbliżej podanej stacji.
+     *
+     * Odległość liczona jest w przybliżeniu równoodległościowym (wystarczającym dla
+     * porównań w skali kraju) jednym przejściem po tablicach współrzędnych.
+     * @param stationId Identyfikator stacji.
+     * @param count Maksymalna liczba zwracanych stacji.
+     * @return Identyfikatory stacji od najbliższej (bez podanej stacji).
+     */
+    QVector<int> nearestStations(int stationId, int count) const;
+
+private:
+    /// @brief Pula powtarzających się napisów.
+    StringPool strings;
+
+    /// @brief Identyfikatory stacji.
+    QVector<int> ids;
+    /// @brief Nazwy stacji (unikalne, poza pulą).
+    QVector<QString> names;
+    /// @brief Ulice (identyfikatory w puli).
+    QVector<quint32> streets;
+    /// @brief Miejscowości (identyfikatory w puli).
+    QVector<quint32> cities;
+    /// @brief Gminy (identyfikatory w puli).
+    QVector<quint32> communes;
+    /// @brief Powiaty (identyfikatory w puli).
+    QVector<quint32> districts;
+    /// @brief Województwa (identyfikatory w puli).
+    QVector<quint32> provinces;
+    /// @brief Szerokości geograficzne.
+    QVector<double> latitudes;
+    /// @brief Długości geograficzne.
+    QVector<double> longitudes;
+    /// @brief Mapa ID stacji na numer wiersza.
+    QHash<int, int> rows;
+
+    /// @brief Płaskie rekordy czujników.
+    QVector<SensorEntry> sensors;
+    /// @brief Mapa ID czujnika na indeks w sensors.
+    QHash<int, int> sensorRows;
+};
+
+#endif // STATIONCATALOG_H
@@ -0,0 +1,81 @@
+#include "stationdashboard.h"
+#include "anomalydetector.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Oblicza podsumowanie serii czujnika.
+ *
+ * Trend to nachylenie prostej najmniejszych kwadratów przez ważne punkty z ostatnich
+ * TREND_HOURS godzin przed ostatnim pomiarem serii.
+ * @param sensorId Identyfikator czujnika.
+ * @param series Seria pomiarowa posortowana rosnąco po czasie.
+ * @return Podsumowanie.
+ */
+StationDashboard::Summary StationDashboard::summarize(int sensorId, const MeasurementSeries& series)
+{
+    const qint64 HOUR_MS = 3600 * 1000;
+    Summary summary;
+    summary.sensorId = sensorId;
+    summary.paramCode = series.key;
+    if (series.isEmpty()) return summary;
+
+    const qint64 newest = series.timestamps.last();
+    const qint64 trendFrom = newest - TREND_HOURS * HOUR_MS;
+    const qint64 sparklineFrom = newest - (SPARKLINE_HOURS - 1) * HOUR_MS;
+
+    double sum = 0.0;
+    double minValue = std::numeric_limits<double>::infinity();
+    double maxValue = -std::numeric_limits<double>::infinity();
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    int trendPoints = 0;
+
+    for (int i = 0; i < series.size(); ++i) {
+        const qint64 timestamp = series.timestamps[i];
+        const double value = series.values[i];
+        if (timestamp >= sparklineFrom) summary.sparkline.append(value);
+        if (std::isnan(value)) continue;
+
+        sum += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+        summary.count++;
+        summary.latest = value;
+        summary.latestTimestamp = timestamp;
+
+        if (timestamp >= trendFrom) {
+            const double x = static_cast<double>(timestamp - trendFrom) / HOUR_MS;
+            sumX += x;
+            sumY += value;
+            sumXX += x * x;
+            sumXY += x * value;
+            trendPoints++;
+        }
+    }
+
+    if (summary.count == 0) return summary;
+    summary.mean = sum / summary.count;
+    summary.min = minValue;
+    summary.max = maxValue;
+
+    const double denominator = trendPoints * sumXX - sumX * sumX;
+    if (trendPoints >= MIN_TREND_POINTS && denominator > 0.0) {
+        summary.trendPerHour = (trendPoints * sumXY - sumX * sumY) / denominator;
+    }
+    summary.anomalies = AnomalyDetector::detect(series).size();
+    return summary;
+}
+
+/**
+ * @brief Zwraca opis kierunku trendu względem średniej.
+ * @param summary Podsumowanie czujnika.
+ * @return "rośnie", "maleje", "stabilnie" lub pusty napis przy braku trendu.
+ */
+QString StationDashboard::trendName(const Summary& summary)
+{
+    if (std::isnan(summary.trendPerHour)) return QString();
+    const double threshold = 0.01 * std::abs(summary.mean);
+    if (summary.trendPerHour > threshold) return "rośnie";
+    if (summary.trendPerHour < -threshold) return "maleje";
+    return "stabilnie";
+}
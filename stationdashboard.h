@@ -0,0 +1,72 @@
+#ifndef STATIONDASHBOARD_H
+#define STATIONDASHBOARD_H
+
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "measurementseries.h"
+
+/**
+ * @brief Podsumowanie czujnika dla przeglądu stacji.
+ *
+ * Oblicza w jednym przejściu po serii statystyki, ostatnią wartość, trend i próbki do wykresu
+ * miniaturowego. Funkcja nie korzysta ze stanu współdzielonego, więc podsumowania wszystkich
+ * czujników stacji mogą być liczone równolegle w puli wątków.
+ */
+class StationDashboard
+{
+public:
+    /// @brief Liczba ostatnich godzin pokazywanych na wykresie miniaturowym.
+    static constexpr int SPARKLINE_HOURS = 48;
+    /// @brief Liczba ostatnich godzin, z których liczony jest trend.
+    static constexpr int TREND_HOURS = 24;
+    /// @brief Minimalna liczba ważnych punktów potrzebna do wyznaczenia trendu.
+    static constexpr int MIN_TREND_POINTS = 6;
+
+    /**
+     * @brief Podsumowanie jednego czujnika.
+     */
+    struct Summary {
+        /// @brief Identyfikator czujnika.
+        int sensorId = -1;
+        /// @brief Kod parametru (klucz serii).
+        QString paramCode;
+        /// @brief Liczba ważnych wartości.
+        int count = 0;
+        /// @brief Ostatnia ważna wartość.
+        double latest = std::numeric_limits<double>::quiet_NaN();
+        /// @brief Znacznik czasu ostatniej ważnej wartości (ms od epoki, -1 przy braku).
+        qint64 latestTimestamp = -1;
+        /// @brief Średnia.
+        double mean = std::numeric_limits<double>::quiet_NaN();
+        /// @brief Minimum.
+        double min = std::numeric_limits<double>::quiet_NaN();
+        /// @brief Maksimum.
+        double max = std::numeric_limits<double>::quiet_NaN();
+        /// @brief Nachylenie prostej regresji z ostatnich TREND_HOURS godzin (jednostki na godzinę, NaN przy braku).
+        double trendPerHour = std::numeric_limits<double>::quiet_NaN();
+        /// @brief Wartości ostatnich SPARKLINE_HOURS godzin serii (NaN dla braków).
+        QVector<double> sparkline;
+        /// @brief Liczba anomalii w serii.
+        int anomalies = 0;
+    };
+
+    /**
+     * @brief Oblicza podsumowanie serii czujnika.
+     * @param sensorId Identyfikator czujnika.
+     * @param series Seria pomiarowa posortowana rosnąco po czasie.
+     * @return Podsumowanie.
+     */
+    static Summary summarize(int sensorId, const MeasurementSeries& series);
+
+    /**
+     * @brief Zwraca opis kierunku trendu względem średniej.
+     *
+     * Zmiana mniejsza niż 1% średniej na godzinę uznawana jest za stabilną.
+     * @param summary Podsumowanie czujnika.
+     * @return "rośnie", "maleje", "stabilnie" lub pusty napis przy braku trendu.
+     */
+    static QString trendName(const Summary& summary);
+};
+
+#endif // STATIONDASHBOARD_H
@@ -0,0 +1,74 @@
+#include "stationfilterproxymodel.h"
+#include "stationlistmodel.h"
+
+/**
+ * @brief Konstruktor modelu.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+StationFilterProxyModel::StationFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+}
+
+/**
+ * @brief Zwraca bieżący tekst wyszukiwania.
+ * @return Tekst wyszukiwania.
+ */
+QString StationFilterProxyModel::filterText() const
+{
+    return searchText;
+}
+
+/**
+ * @brief Ustawia tekst wyszukiwania i ponownie filtruje wiersze.
+ * @param text Tekst wyszukiwania (pusty pokazuje wszystkie stacje).
+ */
+void StationFilterProxyModel::setFilterText(const QString& text)
+{
+    QString lower = text.trimmed().toLower();
+    if (lower == searchText) return;
+
+    searchText = lower;
+    invalidateFilter();
+    emit filterTextChanged();
+}
+
+/**
+ * @brief Zwraca identyfikator stacji w wierszu modelu pośredniczącego.
+ * @param row Numer wiersza.
+ * @return Identyfikator stacji lub -1.
+ */
+int StationFilterProxyModel::stationIdAt(int row) const
+{
+    QModelIndex proxyIndex = index(row, 0);
+    return proxyIndex.isValid() ? proxyIndex.data(StationListModel::StationIdRole).toInt() : -1;
+}
+
+/**
+ * @brief Zwraca numer wiersza stacji w modelu pośredniczącym.
+ * @param stationId Identyfikator stacji.
+ * @return Numer wiersza lub -1, jeśli stacja jest odfiltrowana lub nieznana.
+ */
+int StationFilterProxyModel::rowOf(int stationId) const
+{
+    StationListModel* stations = qobject_cast<StationListModel*>(sourceModel());
+    if (!stations) return -1;
+
+    const int sourceRow = stations->rowOf(stationId);
+    if (sourceRow < 0) return -1;
+    return mapFromSource(stations->index(sourceRow, 0)).row();
+}
+
+/**
+ * @brief Sprawdza, czy wiersz modelu źródłowego spełnia warunek wyszukiwania.
+ * @param sourceRow Numer wiersza w modelu źródłowym.
+ * @param sourceParent Indeks rodzica w modelu źródłowym.
+ * @return True, jeśli wiersz ma być widoczny.
+ */
+bool StationFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    if (searchText.isEmpty()) return true;
+
+    QModelIndex sourceIndex = sourceModel()->index(sourceRow, 0, sourceParent);
+    return sourceIndex.data(StationListModel::SearchKeyRole).toString().contains(searchText);
+}
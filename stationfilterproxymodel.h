@@ -0,0 +1,71 @@
+#ifndef STATIONFILTERPROXYMODEL_H
+#define STATIONFILTERPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+
+/**
+ * @brief Model pośredniczący filtrujący stacje po nazwie miejscowości.
+ *
+ * Porównuje tekst wyszukiwania z kluczem wyszukiwania (nazwa miejscowości małymi literami)
+ * przygotowanym w modelu źródłowym. Zmiana filtra emituje wyłącznie wstawienia i usunięcia
+ * wierszy, więc widok nie jest przebudowywany od zera.
+ */
+class StationFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+public:
+    /**
+     * @brief Konstruktor modelu.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit StationFilterProxyModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca bieżący tekst wyszukiwania.
+     * @return Tekst wyszukiwania.
+     */
+    QString filterText() const;
+
+    /**
+     * @brief Ustawia tekst wyszukiwania i ponownie filtruje wiersze.
+     * @param text Tekst wyszukiwania (pusty pokazuje wszystkie stacje).
+     */
+    void setFilterText(const QString& text);
+
+    /**
+     * @brief Zwraca identyfikator stacji w wierszu modelu pośredniczącego.
+     * @param row Numer wiersza.
+     * @return Identyfikator stacji lub -1.
+     */
+    Q_INVOKABLE int stationIdAt(int row) const;
+
+    /**
+     * @brief Zwraca numer wiersza stacji w modelu pośredniczącym.
+     * @param stationId Identyfikator stacji.
+     * @return Numer wiersza lub -1, jeśli stacja jest odfiltrowana lub nieznana.
+     */
+    Q_INVOKABLE int rowOf(int stationId) const;
+
+signals:
+    /**
+     * @brief Emitowany po zmianie tekstu wyszukiwania.
+     */
+    void filterTextChanged();
+
+protected:
+    /**
+     * @brief Sprawdza, czy wiersz modelu źródłowego spełnia warunek wyszukiwania.
+     * @param sourceRow Numer wiersza w modelu źródłowym.
+     * @param sourceParent Indeks rodzica w modelu źródłowym.
+     * @return True, jeśli wiersz ma być widoczny.
+     */
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    /// @brief Tekst wyszukiwania małymi literami.
+    QString searchText;
+};
+
+#endif // STATIONFILTERPROXYMODEL_H
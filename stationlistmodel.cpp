@@ -0,0 +1,210 @@
+#include "stationlistmodel.h"
+
+/**
+ * @brief Tworzy rekord z obiektu JSON w formacie API GIOŚ.
+ * @param station Obiekt JSON stacji.
+ * @return Rekord stacji.
+ */
+StationRecord StationRecord::fromJson(const QJsonObject& station)
+{
+    StationRecord record;
+    QJsonObject city = station["city"].toObject();
+    record.id = station["id"].toInt();
+    record.name = station["stationName"].toString();
+    record.city = city["name"].toString();
+    record.street = station["addressStreet"].toString();
+    record.province = city["commune"].toObject()["provinceName"].toString();
+    record.latitude = station["gegrLat"].toString().toDouble();
+    record.longitude = station["gegrLon"].toString().toDouble();
+    return record;
+}
+
+/**
+ * @brief Porównuje rekordy.
+ * @param other Drugi rekord.
+ * @return True, jeśli wszystkie pola są równe.
+ */
+bool StationRecord::operator==(const StationRecord& other) const
+{
+    return id == other.id && name == other.name && city == other.city && street == other.street
+           && province == other.province && latitude == other.latitude && longitude == other.longitude;
+}
+
+/**
+ * @brief Konstruktor modelu.
+ * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+ */
+StationListModel::StationListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+/**
+ * @brief Zwraca liczbę stacji.
+ * @param parent Indeks rodzica (nieużywany).
+ * @return Liczba wierszy.
+ */
+int StationListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : stations.size();
+}
+
+/**
+ * @brief Zwraca dane stacji dla podanej roli.
+ * @param index Indeks wiersza.
+ * @param role Rola danych.
+ * @return Wartość lub pusty QVariant.
+ */
+QVariant StationListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= stations.size()) return QVariant();
+
+    const StationRecord& station = stations[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("%1 - %2").arg(station.city, station.name);
+    case StationIdRole:
+        return station.id;
+    case NameRole:
+        return station.name;
+    case CityRole:
+        return station.city;
+    case ProvinceRole:
+        return station.province;
+    case LatitudeRole:
+        return station.latitude;
+    case LongitudeRole:
+        return station.longitude;
+    case SearchKeyRole:
+        return searchKeys[index.row()];
+    case StationRole:
+        return stationMap(index.row());
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Zwraca nazwy ról dostępne w QML.
+ * @return Mapa ról na nazwy.
+ */
+QHash<int, QByteArray> StationListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles[StationIdRole] = "stationId";
+    roles[NameRole] = "stationName";
+    roles[CityRole] = "city";
+    roles[ProvinceRole] = "province";
+    roles[LatitudeRole] = "latitude";
+    roles[LongitudeRole] = "longitude";
+    roles[SearchKeyRole] = "searchKey";
+    roles[StationRole] = "station";
+    return roles;
+}
+
+/**
+ * @brief Aktualizuje katalog, emitując tylko zmiany wierszy.
+ *
+ * Stacje nieobecne w nowym katalogu są usuwane, zmienione są aktualizowane w miejscu,
+ * a nowe dopisywane na końcu listy.
+ * @param catalog Nowa zawartość katalogu.
+ * @return Liczba usuniętych, zmienionych i dodanych wierszy.
+ */
+int StationListModel::setStations(const QVector<StationRecord>& catalog)
+{
+    int touched = 0;
+    QHash<int, int> incoming;
+    incoming.reserve(catalog.size());
+    for (int i = 0; i < catalog.size(); ++i) {
+        incoming.insert(catalog[i].id, i);
+    }
+
+    for (int row = stations.size() - 1; row >= 0; --row) {
+        if (incoming.contains(stations[row].id)) continue;
+        int last = row;
+        while (row > 0 && !incoming.contains(stations[row - 1].id)) --row;
+        beginRemoveRows(QModelIndex(), row, last);
+        touched += last - row + 1;
+        stations.remove(row, last - row + 1);
+        searchKeys.remove(row, last - row + 1);
+        endRemoveRows();
+    }
+
+    for (int row = 0; row < stations.size(); ++row) {
+        const StationRecord& updated = catalog[incoming.value(stations[row].id)];
+        if (updated == stations[row]) continue;
+        stations[row] = updated;
+        searchKeys[row] = updated.city.toLower();
+        ++touched;
+        emit dataChanged(index(row), index(row));
+    }
+
+    rebuildIndex();
+    QVector<StationRecord> added;
+    for (const StationRecord& station : catalog) {
+        if (!rows.contains(station.id)) added.append(station);
+    }
+
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), stations.size(), stations.size() + added.size() - 1);
+        for (const StationRecord& station : added) {
+            stations.append(station);
+            searchKeys.append(station.city.toLower());
+        }
+        endInsertRows();
+        rebuildIndex();
+    }
+    return touched + added.size();
+}
+
+/**
+ * @brief Zwraca rekord stacji w podanym wierszu.
+ * @param row Numer wiersza.
+ * @return Rekord stacji.
+ */
+const StationRecord& StationListModel::stationAt(int row) const
+{
+    return stations.at(row);
+}
+
+/**
+ * @brief Zwraca podstawowe dane stacji w postaci mapy (jak rola station).
+ * @param row Numer wiersza.
+ * @return Mapa z polami id, stationName, cityName, addressStreet, gegrLat, gegrLon.
+ */
+QVariantMap StationListModel::stationMap(int row) const
+{
+    QVariantMap map;
+    if (row < 0 || row >= stations.size()) return map;
+
+    const StationRecord& station = stations[row];
+    map["id"] = station.id;
+    map["stationName"] = station.name;
+    map["cityName"] = station.city;
+    map["addressStreet"] = station.street;
+    map["gegrLat"] = station.latitude;
+    map["gegrLon"] = station.longitude;
+    return map;
+}
+
+/**
+ * @brief Zwraca numer wiersza stacji.
+ * @param stationId Identyfikator stacji.
+ * @return Numer wiersza lub -1, jeśli stacji nie ma w modelu.
+ */
+int StationListModel::rowOf(int stationId) const
+{
+    return rows.value(stationId, -1);
+}
+
+/**
+ * @brief Odbudowuje mapę ID stacji na numer wiersza.
+ */
+void StationListModel::rebuildIndex()
+{
+    rows.clear();
+    rows.reserve(stations.size());
+    for (int row = 0; row < stations.size(); ++row) {
+        rows.insert(stations[row].id, row);
+    }
+}
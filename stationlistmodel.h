@@ -0,0 +1,142 @@
+#ifndef STATIONLISTMODEL_H
+#define STATIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QJsonObject>
+#include <QHash>
+#include <QVariantMap>
+#include <QVector>
+
+/**
+ * @brief Rekord stacji pomiarowej w katalogu.
+ */
+struct StationRecord
+{
+    /// @brief Identyfikator stacji.
+    int id = -1;
+    /// @brief Nazwa stacji.
+    QString name;
+    /// @brief Nazwa miejscowości.
+    QString city;
+    /// @brief Ulica.
+    QString street;
+    /// @brief Nazwa województwa.
+    QString province;
+    /// @brief Szerokość geograficzna.
+    double latitude = 0.0;
+    /// @brief Długość geograficzna.
+    double longitude = 0.0;
+
+    /**
+     * @brief Tworzy rekord z obiektu JSON w formacie API GIOŚ.
+     * @param station Obiekt JSON stacji.
+     * @return Rekord stacji.
+     */
+    static StationRecord fromJson(const QJsonObject& station);
+
+    /**
+     * @brief Porównuje rekordy.
+     * @param other Drugi rekord.
+     * @return True, jeśli wszystkie pola są równe.
+     */
+    bool operator==(const StationRecord& other) const;
+};
+
+/**
+ * @brief Model listy stacji z typowanymi rolami.
+ *
+ * Zastępuje wypełnianie ListModel w JavaScripcie. Odświeżenie katalogu emituje wyłącznie
+ * powiadomienia o wstawionych, usuniętych i zmienionych wierszach.
+ */
+class StationListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Role danych stacji.
+     */
+    enum Roles {
+        StationIdRole = Qt::UserRole + 1, ///< Identyfikator stacji.
+        NameRole,                         ///< Nazwa stacji.
+        CityRole,                         ///< Nazwa miejscowości.
+        ProvinceRole,                     ///< Nazwa województwa.
+        LatitudeRole,                     ///< Szerokość geograficzna.
+        LongitudeRole,                    ///< Długość geograficzna.
+        SearchKeyRole,                    ///< Nazwa miejscowości małymi literami (do filtrowania).
+        StationRole                       ///< Podstawowe dane stacji jako QVariantMap.
+    };
+
+    /**
+     * @brief Konstruktor modelu.
+     * @param parent Wskaźnik na obiekt nadrzędny (domyślnie nullptr).
+     */
+    explicit StationListModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Zwraca liczbę stacji.
+     * @param parent Indeks rodzica (nieużywany).
+     * @return Liczba wierszy.
+     */
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    /**
+     * @brief Zwraca dane stacji dla podanej roli.
+     * @param index Indeks wiersza.
+     * @param role Rola danych.
+     * @return Wartość lub pusty QVariant.
+     */
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Zwraca nazwy ról dostępne w QML.
+     * @return Mapa ról na nazwy.
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Aktualizuje katalog, emitując tylko zmiany wierszy.
+     *
+     * Stacje nieobecne w nowym katalogu są usuwane, zmienione są aktualizowane w miejscu,
+     * a nowe dopisywane na końcu listy.
+     * @param catalog Nowa zawartość katalogu.
+     * @return Liczba usuniętych, zmienionych i dodanych wierszy.
+     */
+    int setStations(const QVector<StationRecord>& catalog);
+
+    /**
+     * @brief Zwraca rekord stacji w podanym wierszu.
+     * @param row Numer wiersza.
+     * @return Rekord stacji.
+     */
+    const StationRecord& stationAt(int row) const;
+
+    /**
+     * @brief Zwraca podstawowe dane stacji w postaci mapy (jak rola station).
+     * @param row Numer wiersza.
+     * @return Mapa z polami id, stationName, cityName, addressStreet, gegrLat, gegrLon.
+     */
+    QVariantMap stationMap(int row) const;
+
+    /**
+     * @brief Zwraca numer wiersza stacji.
+     * @param stationId Identyfikator stacji.
+     * @return Numer wiersza lub -1, jeśli stacji nie ma w modelu.
+     */
+    int rowOf(int stationId) const;
+
+private:
+    /// @brief Rekordy stacji w kolejności wyświetlania.
+    QVector<StationRecord> stations;
+    /// @brief Nazwy miejscowości małymi literami (równolegle do stations).
+    QVector<QString> searchKeys;
+    /// @brief Mapa ID stacji na numer wiersza.
+    QHash<int, int> rows;
+
+    /**
+     * @brief Odbudowuje mapę ID stacji na numer wiersza.
+     */
+    void rebuildIndex();
+};
+
+#endif // STATIONLISTMODEL_H
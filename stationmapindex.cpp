@@ -0,0 +1,266 @@
+#include "stationmapindex.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Rzutuje współrzędne geograficzne do przestrzeni świata (Web Mercator).
+ * @param latitude Szerokość geograficzna w stopniach.
+ * @param longitude Długość geograficzna w stopniach.
+ * @return Punkt w przestrzeni 0 ... 1 (Y rośnie na południe).
+ */
+QPointF StationMapIndex::project(double latitude, double longitude)
+{
+    const double pi = 3.14159265358979323846;
+    const double clamped = std::max(-85.0, std::min(85.0, latitude)) * pi / 180.0;
+    const double x = (longitude + 180.0) / 360.0;
+    const double y = 0.5 - std::log(std::tan(pi / 4.0 + clamped / 2.0)) / (2.0 * pi);
+    return QPointF(x, y);
+}
+
+/**
+ * @brief Zastępuje zbiór stacji i przebudowuje siatkę.
+ * @param stationIds Identyfikatory stacji.
+ * @param latitudes Szerokości geograficzne.
+ * @param longitudes Długości geograficzne.
+ */
+void StationMapIndex::setStations(const QVector<int>& stationIds, const QVector<double>& latitudes,
+                                  const QVector<double>& longitudes)
+{
+    const int n = stationIds.size();
+    ids = stationIds;
+    xs.resize(n);
+    ys.resize(n);
+    levels.resize(n);
+    rows.clear();
+    rows.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+        const QPointF point = project(latitudes[i], longitudes[i]);
+        xs[i] = point.x();
+        ys[i] = point.y();
+        levels[i] = knownLevels.value(ids[i], -1);
+        rows.insert(ids[i], i);
+    }
+    buildGrid();
+}
+
+/**
+ * @brief Ustawia poziom indeksu jakości powietrza stacji.
+ * @param stationId Identyfikator stacji.
+ * @param level Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak).
+ * @return True, jeśli stacja jest w indeksie i poziom się zmienił.
+ */
+bool StationMapIndex::setLevel(int stationId, int level)
+{
+    knownLevels.insert(stationId, level);
+    auto row = rows.constFind(stationId);
+    if (row == rows.constEnd() || levels[*row] == level) return false;
+    levels[*row] = level;
+    return true;
+}
+
+/**
+ * @brief Zwraca liczbę stacji w indeksie.
+ * @return Liczba stacji.
+ */
+int StationMapIndex::size() const
+{
+    return ids.size();
+}
+
+/**
+ * @brief Zwraca prostokąt obejmujący wszystkie stacje w przestrzeni świata.
+ * @return Prostokąt (pusty, jeśli indeks jest pusty).
+ */
+QRectF StationMapIndex::bounds() const
+{
+    return worldBounds;
+}
+
+/**
+ * @brief Buduje siatkę kubełków nad bieżącym zbiorem stacji.
+ *
+ * Rozmiar siatki dobierany jest tak, by na komórkę przypadało średnio kilka stacji.
+ */
+void StationMapIndex::buildGrid()
+{
+    const int n = ids.size();
+    if (n == 0) {
+        worldBounds = QRectF();
+        gridSize = 1;
+        cellStart = QVector<int>(2, 0);
+        cellItems.clear();
+        return;
+    }
+
+    const auto [minX, maxX] = std::minmax_element(xs.constBegin(), xs.constEnd());
+    const auto [minY, maxY] = std::minmax_element(ys.constBegin(), ys.constEnd());
+    worldBounds = QRectF(QPointF(*minX, *minY), QPointF(*maxX, *maxY));
+    gridSize = std::max(1, std::min(256, static_cast<int>(std::sqrt(n / 4.0))));
+
+    const double cellWidth = std::max(worldBounds.width(), 1e-12) / gridSize;
+    const double cellHeight = std::max(worldBounds.height(), 1e-12) / gridSize;
+    QVector<int> cellOf(n);
+    cellStart = QVector<int>(gridSize * gridSize + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        const int cx = std::min(gridSize - 1, static_cast<int>((xs[i] - worldBounds.left()) / cellWidth));
+        const int cy = std::min(gridSize - 1, static_cast<int>((ys[i] - worldBounds.top()) / cellHeight));
+        cellOf[i] = cy * gridSize + cx;
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (int cell = 0; cell < gridSize * gridSize; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    QVector<int> fill = cellStart;
+    cellItems.resize(n);
+    for (int i = 0; i < n; ++i) {
+        cellItems[fill[cellOf[i]]++] = i;
+    }
+}
+
+/**
+ * @brief Wyznacza zakres komórek siatki pokrywających prostokąt świata.
+ * @param area Prostokąt w przestrzeni świata.
+ * @param x0 Pierwsza kolumna (wynik).
+ * @param y0 Pierwszy wiersz (wynik).
+ * @param x1 Ostatnia kolumna (wynik).
+ * @param y1 Ostatni wiersz (wynik).
+ * @return False, jeśli prostokąt nie przecina siatki.
+ */
+bool StationMapIndex::cellRange(const QRectF& area, int* x0, int* y0, int* x1, int* y1) const
+{
+    if (ids.isEmpty() || area.right() < worldBounds.left() || area.left() > worldBounds.right()
+        || area.bottom() < worldBounds.top() || area.top() > worldBounds.bottom()) {
+        return false;
+    }
+
+    const double cellWidth = std::max(worldBounds.width(), 1e-12) / gridSize;
+    const double cellHeight = std::max(worldBounds.height(), 1e-12) / gridSize;
+    auto clampCell = [this](double value) { return std::max(0, std::min(gridSize - 1, static_cast<int>(value))); };
+    *x0 = clampCell((area.left() - worldBounds.left()) / cellWidth);
+    *x1 = clampCell((area.right() - worldBounds.left()) / cellWidth);
+    *y0 = clampCell((area.top() - worldBounds.top()) / cellHeight);
+    *y1 = clampCell((area.bottom() - worldBounds.top()) / cellHeight);
+    return true;
+}
+
+/**
+ * @brief Zwraca widoczny prostokąt świata z marginesem.
+ * @param viewport Parametry widoku.
+ * @param marginPixels Margines w pikselach.
+ * @return Prostokąt w przestrzeni świata.
+ */
+QRectF StationMapIndex::visibleArea(const Viewport& viewport, double marginPixels)
+{
+    const double halfWidth = (viewport.width / 2.0 + marginPixels) / viewport.scale;
+    const double halfHeight = (viewport.height / 2.0 + marginPixels) / viewport.scale;
+    return QRectF(QPointF(viewport.centerX - halfWidth, viewport.centerY - halfHeight),
+                  QPointF(viewport.centerX + halfWidth, viewport.centerY + halfHeight));
+}
+
+/**
+ * @brief Wyznacza znaczniki widoczne w podanym widoku.
+ *
+ * Przy klastrowaniu stacje trafiają do komórek o boku clusterSize pikseli liczonych
+ * w układzie świata; znacznik klastra leży w środku ciężkości stacji i ma kolor
+ * najgorszego znanego poziomu indeksu.
+ * @param viewport Parametry widoku.
+ * @param clusterSize Rozmiar komórki klastra w pikselach (0 wyłącza klastrowanie).
+ * @param visibleStations Wskaźnik na licznik widocznych stacji (opcjonalny).
+ * @return Znaczniki we współrzędnych widoku.
+ */
+QVector<StationMapIndex::Marker> StationMapIndex::markers(const Viewport& viewport, double clusterSize,
+                                                          int* visibleStations) const
+{
+    QVector<Marker> result;
+    int visible = 0;
+    const double margin = std::max(clusterSize, 16.0);
+    const QRectF area = visibleArea(viewport, margin);
+    const double offsetX = viewport.width / 2.0 - viewport.centerX * viewport.scale;
+    const double offsetY = viewport.height / 2.0 - viewport.centerY * viewport.scale;
+
+    int x0, y0, x1, y1;
+    if (!cellRange(area, &x0, &y0, &x1, &y1)) {
+        if (visibleStations) *visibleStations = 0;
+        return result;
+    }
+
+    QHash<quint64, int> clusterOf;
+    QVector<double> sumX, sumY;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const int cell = cy * gridSize + cx;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                const int i = cellItems[k];
+                if (!area.contains(QPointF(xs[i], ys[i]))) continue;
+                ++visible;
+
+                if (clusterSize <= 0.0) {
+                    Marker marker;
+                    marker.x = xs[i] * viewport.scale + offsetX;
+                    marker.y = ys[i] * viewport.scale + offsetY;
+                    marker.count = 1;
+                    marker.level = levels[i];
+                    marker.stationId = ids[i];
+                    result.append(marker);
+                    continue;
+                }
+
+                const qint32 keyX = static_cast<qint32>(std::floor(xs[i] * viewport.scale / clusterSize));
+                const qint32 keyY = static_cast<qint32>(std::floor(ys[i] * viewport.scale / clusterSize));
+                const quint64 key = (static_cast<quint64>(static_cast<quint32>(keyX)) << 32) | static_cast<quint32>(keyY);
+                auto found = clusterOf.constFind(key);
+                if (found == clusterOf.constEnd()) {
+                    clusterOf.insert(key, result.size());
+                    Marker marker;
+                    marker.count = 1;
+                    marker.level = levels[i];
+                    marker.stationId = ids[i];
+                    result.append(marker);
+                    sumX.append(xs[i]);
+                    sumY.append(ys[i]);
+                } else {
+                    Marker& marker = result[*found];
+                    marker.count++;
+                    marker.level = std::max(marker.level, levels[i]);
+                    marker.stationId = -1;
+                    sumX[*found] += xs[i];
+                    sumY[*found] += ys[i];
+                }
+            }
+        }
+    }
+
+    for (int m = 0; m < sumX.size(); ++m) {
+        result[m].x = sumX[m] / result[m].count * viewport.scale + offsetX;
+        result[m].y = sumY[m] / result[m].count * viewport.scale + offsetY;
+    }
+
+    if (visibleStations) *visibleStations = visible;
+    return result;
+}
+
+/**
+ * @brief Zwraca identyfikatory stacji widocznych w podanym widoku.
+ * @param viewport Parametry widoku.
+ * @return Identyfikatory stacji.
+ */
+QVector<int> StationMapIndex::visibleStationIds(const Viewport& viewport) const
+{
+    QVector<int> result;
+    const QRectF area = visibleArea(viewport, 0.0);
+    int x0, y0, x1, y1;
+    if (!cellRange(area, &x0, &y0, &x1, &y1)) return result;
+
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const int cell = cy * gridSize + cx;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                const int i = cellItems[k];
+                if (area.contains(QPointF(xs[i], ys[i]))) result.append(ids[i]);
+            }
+        }
+    }
+    return result;
+}
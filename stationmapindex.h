@@ -0,0 +1,153 @@
+#ifndef STATIONMAPINDEX_H
+#define STATIONMAPINDEX_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * @brief Indeks przestrzenny stacji na mapie z odrzucaniem poza widokiem i klastrowaniem.
+ *
+ * Współrzędne stacji są rzutowane raz (Web Mercator, przestrzeń 0 ... 1) i przechowywane
+ * w osobnych tablicach. Siatka kubełków (CSR) pozwala odczytać tylko stacje z widocznego
+ * fragmentu mapy, a klastrowanie w komórkach zakotwiczonych w układzie świata ogranicza
+ * liczbę znaczników przy małym przybliżeniu i nie przeskakuje podczas przesuwania.
+ */
+class StationMapIndex
+{
+public:
+    /**
+     * @brief Znacznik do narysowania (pojedyncza stacja lub klaster).
+     */
+    struct Marker {
+        /// @brief Położenie X w pikselach widoku.
+        double x = 0.0;
+        /// @brief Położenie Y w pikselach widoku.
+        double y = 0.0;
+        /// @brief Liczba stacji w znaczniku.
+        int count = 0;
+        /// @brief Najgorszy znany poziom indeksu (-1, jeśli nieznany).
+        int level = -1;
+        /// @brief Identyfikator stacji (-1 dla klastra).
+        int stationId = -1;
+    };
+
+    /**
+     * @brief Parametry widoku mapy.
+     */
+    struct Viewport {
+        /// @brief Środek widoku X w przestrzeni świata (0 ... 1).
+        double centerX = 0.5;
+        /// @brief Środek widoku Y w przestrzeni świata (0 ... 1).
+        double centerY = 0.5;
+        /// @brief Liczba pikseli na jednostkę świata.
+        double scale = 256.0;
+        /// @brief Szerokość widoku w pikselach.
+        double width = 0.0;
+        /// @brief Wysokość widoku w pikselach.
+        double height = 0.0;
+    };
+
+    /**
+     * @brief Rzutuje współrzędne geograficzne do przestrzeni świata (Web Mercator).
+     * @param latitude Szerokość geograficzna w stopniach.
+     * @param longitude Długość geograficzna w stopniach.
+     * @return Punkt w przestrzeni 0 ... 1 (Y rośnie na południe).
+     */
+    static QPointF project(double latitude, double longitude);
+
+    /**
+     * @brief Zastępuje zbiór stacji i przebudowuje siatkę.
+     *
+     * Znane poziomy indeksu są zachowywane dla stacji obecnych w nowym zbiorze.
+     * @param stationIds Identyfikatory stacji.
+     * @param latitudes Szerokości geograficzne.
+     * @param longitudes Długości geograficzne.
+     */
+    void setStations(const QVector<int>& stationIds, const QVector<double>& latitudes, const QVector<double>& longitudes);
+
+    /**
+     * @brief Ustawia poziom indeksu jakości powietrza stacji.
+     * @param stationId Identyfikator stacji.
+     * @param level Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak).
+     * @return True, jeśli stacja jest w indeksie i poziom się zmienił.
+     */
+    bool setLevel(int stationId, int level);
+
+    /**
+     * @brief Zwraca liczbę stacji w indeksie.
+     * @return Liczba stacji.
+     */
+    int size() const;
+
+    /**
+     * @brief Zwraca prostokąt obejmujący wszystkie stacje w przestrzeni świata.
+     * @return Prostokąt (pusty, jeśli indeks jest pusty).
+     */
+    QRectF bounds() const;
+
+    /**
+     * @brief Wyznacza znaczniki widoczne w podanym widoku.
+     * @param viewport Parametry widoku.
+     * @param clusterSize Rozmiar komórki klastra w pikselach (0 wyłącza klastrowanie).
+     * @param visibleStations Wskaźnik na licznik widocznych stacji (opcjonalny).
+     * @return Znaczniki we współrzędnych widoku.
+     */
+    QVector<Marker> markers(const Viewport& viewport, double clusterSize, int* visibleStations = nullptr) const;
+
+    /**
+     * @brief Zwraca identyfikatory stacji widocznych w podanym widoku.
+     * @param viewport Parametry widoku.
+     * @return Identyfikatory stacji.
+     */
+    QVector<int> visibleStationIds(const Viewport& viewport) const;
+
+private:
+    /// @brief Identyfikatory stacji.
+    QVector<int> ids;
+    /// @brief Współrzędne X w przestrzeni świata.
+    QVector<double> xs;
+    /// @brief Współrzędne Y w przestrzeni świata.
+    QVector<double> ys;
+    /// @brief Poziomy indeksu stacji (-1, jeśli nieznany).
+    QVector<int> levels;
+    /// @brief Mapa ID stacji na numer w tablicach.
+    QHash<int, int> rows;
+    /// @brief Znane poziomy indeksu według ID stacji (zachowywane między przebudowami).
+    QHash<int, int> knownLevels;
+
+    /// @brief Prostokąt obejmujący stacje w przestrzeni świata.
+    QRectF worldBounds;
+    /// @brief Liczba komórek siatki w każdym wymiarze.
+    int gridSize = 1;
+    /// @brief Początki list stacji w komórkach (gridSize * gridSize + 1 elementów).
+    QVector<int> cellStart;
+    /// @brief Numery stacji uporządkowane według komórek.
+    QVector<int> cellItems;
+
+    /**
+     * @brief Buduje siatkę kubełków nad bieżącym zbiorem stacji.
+     */
+    void buildGrid();
+
+    /**
+     * @brief Wyznacza zakres komórek siatki pokrywających prostokąt świata.
+     * @param area Prostokąt w przestrzeni świata.
+     * @param x0 Pierwsza kolumna (wynik).
+     * @param y0 Pierwszy wiersz (wynik).
+     * @param x1 Ostatnia kolumna (wynik).
+     * @param y1 Ostatni wiersz (wynik).
+     * @return False, jeśli prostokąt nie przecina siatki.
+     */
+    bool cellRange(const QRectF& area, int* x0, int* y0, int* x1, int* y1) const;
+
+    /**
+     * @brief Zwraca widoczny prostokąt świata z marginesem.
+     * @param viewport Parametry widoku.
+     * @param marginPixels Margines w pikselach.
+     * @return Prostokąt w przestrzeni świata.
+     */
+    static QRectF visibleArea(const Viewport& viewport, double marginPixels);
+};
+
+#endif // STATIONMAPINDEX_H
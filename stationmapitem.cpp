@@ -0,0 +1,570 @@
+#include "stationmapitem.h"
+#include <QImage>
+#include <QLineF>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGRendererInterface>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/// @brief Liczba odcinków przybliżających okrąg znacznika.
+const int DISC_SEGMENTS = 12;
+/// @brief Rozmiar świata w pikselach przy przybliżeniu 0.
+const double TILE_SIZE = 256.0;
+/// @brief Odległość w pikselach, po której naciśnięcie staje się przesuwaniem.
+const double DRAG_THRESHOLD = 4.0;
+/// @brief Kolor obwódki znaczników.
+const QColor OUTLINE_COLOR(255, 255, 255);
+/// @brief Kolor obwódki zaznaczonej stacji.
+const QColor SELECTION_COLOR(25, 118, 210);
+
+/**
+ * @brief Dopisuje do bufora wierzchołków koło złożone z trójkątów.
+ * @param vertex Wskaźnik na bieżący wierzchołek (przesuwany).
+ * @param x Środek X.
+ * @param y Środek Y.
+ * @param radius Promień.
+ * @param color Kolor koła.
+ */
+void appendDisc(QSGGeometry::ColoredPoint2D*& vertex, float x, float y, float radius, const QColor& color)
+{
+    static float cosines[DISC_SEGMENTS + 1];
+    static float sines[DISC_SEGMENTS + 1];
+    static bool initialized = false;
+    if (!initialized) {
+        for (int s = 0; s <= DISC_SEGMENTS; ++s) {
+            const double angle = 2.0 * 3.14159265358979323846 * s / DISC_SEGMENTS;
+            cosines[s] = static_cast<float>(std::cos(angle));
+            sines[s] = static_cast<float>(std::sin(angle));
+        }
+        initialized = true;
+    }
+
+    const uchar r = static_cast<uchar>(color.red());
+    const uchar g = static_cast<uchar>(color.green());
+    const uchar b = static_cast<uchar>(color.blue());
+    for (int s = 0; s < DISC_SEGMENTS; ++s) {
+        (vertex++)->set(x, y, r, g, b, 255);
+        (vertex++)->set(x + radius * cosines[s], y + radius * sines[s], r, g, b, 255);
+        (vertex++)->set(x + radius * cosines[s + 1], y + radius * sines[s + 1], r, g, b, 255);
+    }
+}
+
+}
+
+/**
+ * @brief Konstruktor elementu mapy.
+ * @param parent Element nadrzędny (domyślnie nullptr).
+ */
+StationMapItem::StationMapItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setClip(true);
+    connect(this, &QQuickItem::widthChanged, this, &QQuickItem::polish);
+    connect(this, &QQuickItem::heightChanged, this, &QQuickItem::polish);
+}
+
+/**
+ * @brief Zwraca model stacji.
+ * @return Wskaźnik na model.
+ */
+QAbstractItemModel* StationMapItem::model() const
+{
+    return stationModel;
+}
+
+/**
+ * @brief Ustawia model stacji (role stationId, latitude, longitude).
+ * @param model Wskaźnik na model.
+ */
+void StationMapItem::setModel(QAbstractItemModel* model)
+{
+    if (stationModel == model) return;
+    if (stationModel) disconnect(stationModel, nullptr, this, nullptr);
+
+    stationModel = model;
+    if (stationModel) {
+        connect(stationModel, &QAbstractItemModel::modelReset, this, &StationMapItem::invalidateStations);
+        connect(stationModel, &QAbstractItemModel::layoutChanged, this, &StationMapItem::invalidateStations);
+        connect(stationModel, &QAbstractItemModel::rowsInserted, this, &StationMapItem::invalidateStations);
+        connect(stationModel, &QAbstractItemModel::rowsRemoved, this, &StationMapItem::invalidateStations);
+        connect(stationModel, &QAbstractItemModel::dataChanged, this, &StationMapItem::invalidateStations);
+    }
+    invalidateStations();
+    emit modelChanged();
+}
+
+/**
+ * @brief Zwraca poziom przybliżenia.
+ * @return Poziom przybliżenia (skala 256 * 2^zoom pikseli na świat).
+ */
+double StationMapItem::zoom() const
+{
+    return zoomLevel;
+}
+
+/**
+ * @brief Ustawia poziom przybliżenia względem środka widoku.
+ * @param zoom Poziom przybliżenia.
+ */
+void StationMapItem::setZoom(double zoom)
+{
+    zoomAround(zoom, QPointF(width() / 2.0, height() / 2.0));
+}
+
+/**
+ * @brief Zwraca ID zaznaczonej stacji.
+ * @return Identyfikator stacji lub -1.
+ */
+int StationMapItem::selectedStationId() const
+{
+    return selectedId;
+}
+
+/**
+ * @brief Ustawia zaznaczoną stację.
+ * @param stationId Identyfikator stacji lub -1.
+ */
+void StationMapItem::setSelectedStationId(int stationId)
+{
+    if (selectedId == stationId) return;
+    selectedId = stationId;
+    update();
+    emit selectedStationIdChanged();
+}
+
+/**
+ * @brief Zwraca rozmiar komórki klastra w pikselach.
+ * @return Rozmiar komórki.
+ */
+double StationMapItem::clusterSize() const
+{
+    return clusterCellSize;
+}
+
+/**
+ * @brief Ustawia rozmiar komórki klastra w pikselach.
+ * @param size Rozmiar komórki (0 wyłącza klastrowanie).
+ */
+void StationMapItem::setClusterSize(double size)
+{
+    size = std::max(0.0, size);
+    if (qFuzzyCompare(clusterCellSize, size)) return;
+    clusterCellSize = size;
+    polish();
+    emit clusterSizeChanged();
+}
+
+/**
+ * @brief Zwraca liczbę rysowanych znaczników.
+ * @return Liczba znaczników.
+ */
+int StationMapItem::markerCount() const
+{
+    return markers.size();
+}
+
+/**
+ * @brief Zwraca liczbę stacji w widoku.
+ * @return Liczba stacji.
+ */
+int StationMapItem::visibleStationCount() const
+{
+    return visibleStations;
+}
+
+/**
+ * @brief Ustawia poziom indeksu jakości powietrza stacji.
+ * @param stationId Identyfikator stacji.
+ * @param level Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak).
+ */
+void StationMapItem::setStationLevel(int stationId, int level)
+{
+    if (index.setLevel(stationId, level)) polish();
+}
+
+/**
+ * @brief Dopasowuje widok do wszystkich stacji.
+ */
+void StationMapItem::fitToStations()
+{
+    if (stationsDirty) reloadStations();
+    if (fitView()) polish();
+}
+
+/**
+ * @brief Zwraca identyfikatory stacji widocznych na mapie.
+ * @return Lista identyfikatorów.
+ */
+QVariantList StationMapItem::visibleStationIds() const
+{
+    QVariantList result;
+    const QVector<int> ids = index.visibleStationIds(viewport());
+    result.reserve(ids.size());
+    for (int id : ids) {
+        result.append(id);
+    }
+    return result;
+}
+
+/**
+ * @brief Zwraca kolor poziomu indeksu (skala GIOŚ).
+ * @param level Poziom indeksu (-1 dla braku indeksu).
+ * @return Kolor znacznika.
+ */
+QColor StationMapItem::levelColor(int level) const
+{
+    switch (level) {
+    case 0: return QColor(87, 177, 8);    // Bardzo dobry
+    case 1: return QColor(176, 221, 16);  // Dobry
+    case 2: return QColor(255, 217, 17);  // Umiarkowany
+    case 3: return QColor(229, 129, 0);   // Dostateczny
+    case 4: return QColor(229, 0, 0);     // Zły
+    case 5: return QColor(153, 0, 0);     // Bardzo zły
+    default: return QColor(158, 158, 158);
+    }
+}
+
+/**
+ * @brief Ustawia środek i przybliżenie tak, by widok obejmował wszystkie stacje.
+ * @return False, jeśli brak stacji lub element nie ma jeszcze rozmiaru.
+ */
+bool StationMapItem::fitView()
+{
+    const QRectF bounds = index.bounds();
+    if (index.size() == 0 || width() <= 0 || height() <= 0) return false;
+
+    const double margin = 0.9;
+    const double fitX = bounds.width() > 0 ? width() * margin / (bounds.width() * TILE_SIZE) : 4096.0;
+    const double fitY = bounds.height() > 0 ? height() * margin / (bounds.height() * TILE_SIZE) : 4096.0;
+    centerX = bounds.center().x();
+    centerY = bounds.center().y();
+    zoomLevel = std::max(MIN_ZOOM, std::min(MAX_ZOOM, std::log2(std::min(fitX, fitY))));
+    fitted = true;
+    emit zoomChanged();
+    emit viewportSettled();
+    return true;
+}
+
+/**
+ * @brief Oznacza stacje do ponownego odczytu z modelu.
+ */
+void StationMapItem::invalidateStations()
+{
+    stationsDirty = true;
+    polish();
+}
+
+/**
+ * @brief Odczytuje współrzędne stacji z modelu do indeksu.
+ *
+ * Role wyszukiwane są po nazwach, więc element działa z każdym modelem udostępniającym
+ * role stationId, latitude i longitude (także z modelem pośredniczącym wyszukiwania).
+ */
+void StationMapItem::reloadStations()
+{
+    stationsDirty = false;
+    QVector<int> ids;
+    QVector<double> latitudes, longitudes;
+
+    if (stationModel) {
+        const QHash<int, QByteArray> roles = stationModel->roleNames();
+        const int idRole = roles.key("stationId", -1);
+        const int latitudeRole = roles.key("latitude", -1);
+        const int longitudeRole = roles.key("longitude", -1);
+        const int rowCount = stationModel->rowCount();
+
+        if (idRole >= 0 && latitudeRole >= 0 && longitudeRole >= 0) {
+            ids.reserve(rowCount);
+            latitudes.reserve(rowCount);
+            longitudes.reserve(rowCount);
+            for (int row = 0; row < rowCount; ++row) {
+                const QModelIndex modelIndex = stationModel->index(row, 0);
+                ids.append(modelIndex.data(idRole).toInt());
+                latitudes.append(modelIndex.data(latitudeRole).toDouble());
+                longitudes.append(modelIndex.data(longitudeRole).toDouble());
+            }
+        }
+    }
+    index.setStations(ids, latitudes, longitudes);
+}
+
+/**
+ * @brief Zwraca parametry bieżącego widoku.
+ * @return Parametry widoku.
+ */
+StationMapIndex::Viewport StationMapItem::viewport() const
+{
+    StationMapIndex::Viewport view;
+    view.centerX = centerX;
+    view.centerY = centerY;
+    view.scale = scale();
+    view.width = width();
+    view.height = height();
+    return view;
+}
+
+/**
+ * @brief Zwraca liczbę pikseli na jednostkę świata.
+ * @return Skala widoku.
+ */
+double StationMapItem::scale() const
+{
+    return TILE_SIZE * std::exp2(zoomLevel);
+}
+
+/**
+ * @brief Zmienia przybliżenie, zachowując punkt pod podaną pozycją widoku.
+ * @param zoom Nowy poziom przybliżenia.
+ * @param anchor Pozycja w pikselach widoku.
+ */
+void StationMapItem::zoomAround(double zoom, const QPointF& anchor)
+{
+    zoom = std::max(MIN_ZOOM, std::min(MAX_ZOOM, zoom));
+    if (qFuzzyCompare(zoom, zoomLevel)) return;
+
+    const double worldX = centerX + (anchor.x() - width() / 2.0) / scale();
+    const double worldY = centerY + (anchor.y() - height() / 2.0) / scale();
+    zoomLevel = zoom;
+    centerX = worldX - (anchor.x() - width() / 2.0) / scale();
+    centerY = worldY - (anchor.y() - height() / 2.0) / scale();
+    polish();
+    emit zoomChanged();
+}
+
+/**
+ * @brief Zwraca promień znacznika.
+ * @param count Liczba stacji w znaczniku.
+ * @return Promień w pikselach.
+ */
+double StationMapItem::markerRadius(int count)
+{
+    return count <= 1 ? 5.0 : std::min(16.0, 6.0 + 2.0 * std::log2(static_cast<double>(count)));
+}
+
+/**
+ * @brief Zwraca znacznik pod podaną pozycją.
+ * @param position Pozycja w pikselach widoku.
+ * @return Numer znacznika lub -1.
+ */
+int StationMapItem::markerAt(const QPointF& position) const
+{
+    int best = -1;
+    double bestDistance = 0.0;
+    for (int m = 0; m < markers.size(); ++m) {
+        const double dx = markers[m].x - position.x();
+        const double dy = markers[m].y - position.y();
+        const double distance = dx * dx + dy * dy;
+        const double reach = markerRadius(markers[m].count) + 4.0;
+        if (distance <= reach * reach && (best < 0 || distance < bestDistance)) {
+            best = m;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Przelicza znaczniki przed synchronizacją grafu sceny.
+ *
+ * Wywoływane w wątku interfejsu raz na klatkę po zmianie widoku, modelu lub poziomów,
+ * więc odrzucanie i klastrowanie nie blokują wątku renderowania.
+ */
+void StationMapItem::updatePolish()
+{
+    if (stationsDirty) reloadStations();
+    if (!fitted) fitView();
+
+    const double cluster = zoomLevel >= DETAIL_ZOOM ? 0.0 : clusterCellSize;
+    markers = index.markers(viewport(), cluster, &visibleStations);
+    update();
+    emit markersChanged();
+}
+
+/**
+ * @brief Aktualizuje węzeł grafu sceny.
+ * @param oldNode Poprzedni węzeł lub nullptr.
+ * @param data Dane aktualizacji (nieużywane).
+ * @return Węzeł do wyrenderowania.
+ */
+QSGNode* StationMapItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+    if (width() <= 0 || height() <= 0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    if (window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software) {
+        return updateImageNode(static_cast<QSGImageNode*>(oldNode));
+    }
+    return updateGeometryNode(static_cast<QSGGeometryNode*>(oldNode));
+}
+
+/**
+ * @brief Aktualizuje węzeł geometrii (renderer sprzętowy).
+ *
+ * Każdy znacznik to koło obwódki i koło wypełnienia z trójkątów z kolorami wierzchołków,
+ * więc cała warstwa jest jedną partią rysowania niezależnie od liczby poziomów indeksu.
+ * @param node Poprzedni węzeł lub nullptr.
+ * @return Węzeł geometrii.
+ */
+QSGGeometryNode* StationMapItem::updateGeometryNode(QSGGeometryNode* node)
+{
+    if (!node) {
+        node = new QSGGeometryNode;
+        QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    int discs = 0;
+    for (const StationMapIndex::Marker& marker : markers) {
+        discs += marker.stationId >= 0 && marker.stationId == selectedId ? 3 : 2;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(discs * DISC_SEGMENTS * 3);
+    QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+    for (const StationMapIndex::Marker& marker : markers) {
+        const float x = static_cast<float>(marker.x);
+        const float y = static_cast<float>(marker.y);
+        const float radius = static_cast<float>(markerRadius(marker.count));
+        if (marker.stationId >= 0 && marker.stationId == selectedId) {
+            appendDisc(vertex, x, y, radius + 4.0f, SELECTION_COLOR);
+        }
+        appendDisc(vertex, x, y, radius + 1.5f, OUTLINE_COLOR);
+        appendDisc(vertex, x, y, radius, levelColor(marker.level));
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
+
+/**
+ * @brief Aktualizuje węzeł obrazu (renderer programowy).
+ *
+ * Renderer programowy nie obsługuje własnej geometrii, więc znaczniki rysowane są
+ * przez QPainter do jednego obrazu o rozmiarze widoku.
+ * @param node Poprzedni węzeł lub nullptr.
+ * @return Węzeł obrazu.
+ */
+QSGImageNode* StationMapItem::updateImageNode(QSGImageNode* node)
+{
+    if (!node) {
+        node = window()->createImageNode();
+        node->setOwnsTexture(true);
+    }
+
+    const qreal ratio = window()->effectiveDevicePixelRatio();
+    QImage image(QSize(qCeil(width() * ratio), qCeil(height() * ratio)), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (const StationMapIndex::Marker& marker : markers) {
+        const QPointF center(marker.x, marker.y);
+        const double radius = markerRadius(marker.count);
+        if (marker.stationId >= 0 && marker.stationId == selectedId) {
+            painter.setPen(QPen(SELECTION_COLOR, 3.0));
+        } else {
+            painter.setPen(QPen(OUTLINE_COLOR, 1.5));
+        }
+        painter.setBrush(levelColor(marker.level));
+        painter.drawEllipse(center, radius, radius);
+    }
+    painter.end();
+
+    node->setTexture(window()->createTextureFromImage(image));
+    node->setRect(boundingRect());
+    return node;
+}
+
+/**
+ * @brief Rozpoczyna przesuwanie lub kliknięcie.
+ * @param event Zdarzenie myszy.
+ */
+void StationMapItem::mousePressEvent(QMouseEvent* event)
+{
+    pressPosition = event->position();
+    lastPosition = pressPosition;
+    dragging = false;
+    event->accept();
+}
+
+/**
+ * @brief Przesuwa widok.
+ * @param event Zdarzenie myszy.
+ */
+void StationMapItem::mouseMoveEvent(QMouseEvent* event)
+{
+    const QPointF position = event->position();
+    if (!dragging && QLineF(pressPosition, position).length() < DRAG_THRESHOLD) return;
+
+    if (!dragging) {
+        dragging = true;
+        setKeepMouseGrab(true);
+    }
+    centerX -= (position.x() - lastPosition.x()) / scale();
+    centerY -= (position.y() - lastPosition.y()) / scale();
+    lastPosition = position;
+    polish();
+    event->accept();
+}
+
+/**
+ * @brief Kończy przesuwanie lub obsługuje kliknięcie znacznika.
+ *
+ * Kliknięcie pojedynczej stacji emituje stationClicked, a kliknięcie klastra
+ * przybliża widok na jego środek.
+ * @param event Zdarzenie myszy.
+ */
+void StationMapItem::mouseReleaseEvent(QMouseEvent* event)
+{
+    event->accept();
+    if (dragging) {
+        dragging = false;
+        setKeepMouseGrab(false);
+        emit viewportSettled();
+        return;
+    }
+
+    const int hit = markerAt(event->position());
+    if (hit < 0) return;
+
+    const StationMapIndex::Marker marker = markers[hit];
+    if (marker.count == 1) {
+        setSelectedStationId(marker.stationId);
+        emit stationClicked(marker.stationId);
+    } else {
+        zoomAround(zoomLevel + 2.0, QPointF(marker.x, marker.y));
+        centerX += (marker.x - width() / 2.0) / scale();
+        centerY += (marker.y - height() / 2.0) / scale();
+        emit viewportSettled();
+    }
+}
+
+/**
+ * @brief Przybliża lub oddala widok wokół kursora.
+ * @param event Zdarzenie kółka myszy.
+ */
+void StationMapItem::wheelEvent(QWheelEvent* event)
+{
+    const double steps = event->angleDelta().y() / 120.0;
+    zoomAround(zoomLevel + steps * 0.5, event->position());
+    emit viewportSettled();
+    event->accept();
+}
@@ -0,0 +1,302 @@
+#ifndef STATIONMAPITEM_H
+#define STATIONMAPITEM_H
+
+#include <QQuickItem>
+#include <QAbstractItemModel>
+#include <QPointer>
+#include <QColor>
+#include "stationmapindex.h"
+
+class QSGGeometryNode;
+class QSGImageNode;
+
+/**
+ * @brief Warstwa mapy rysująca stacje jako punkty w kolorach indeksu jakości powietrza.
+ *
+ * Element grafu sceny (QQuickItem) czyta współrzędne stacji z modelu listy, odrzuca stacje
+ * poza widokiem i łączy bliskie stacje w klastry. Przy rendererze sprzętowym wszystkie
+ * znaczniki trafiają do jednego węzła geometrii (jedno wywołanie rysowania), a przy
+ * rendererze programowym - do jednego obrazu rysowanego przez QPainter.
+ * Obsługuje przesuwanie myszą, przybliżanie kółkiem i wybór stacji kliknięciem.
+ */
+class StationMapItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QAbstractItemModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(double zoom READ zoom WRITE setZoom NOTIFY zoomChanged)
+    Q_PROPERTY(int selectedStationId READ selectedStationId WRITE setSelectedStationId NOTIFY selectedStationIdChanged)
+    Q_PROPERTY(double clusterSize READ clusterSize WRITE setClusterSize NOTIFY clusterSizeChanged)
+    Q_PROPERTY(int markerCount READ markerCount NOTIFY markersChanged)
+    Q_PROPERTY(int visibleStationCount READ visibleStationCount NOTIFY markersChanged)
+
+public:
+    /// @brief Minimalny poziom przybliżenia.
+    static constexpr double MIN_ZOOM = 2.0;
+    /// @brief Maksymalny poziom przybliżenia.
+    static constexpr double MAX_ZOOM = 18.0;
+    /// @brief Poziom przybliżenia, od którego stacje nie są łączone w klastry.
+    static constexpr double DETAIL_ZOOM = 13.0;
+
+    /**
+     * @brief Konstruktor elementu mapy.
+     * @param parent Element nadrzędny (domyślnie nullptr).
+     */
+    explicit StationMapItem(QQuickItem *parent = nullptr);
+
+    /**
+     * @brief Zwraca model stacji.
+     * @return Wskaźnik na model.
+     */
+    QAbstractItemModel* model() const;
+
+    /**
+     * @brief Ustawia model stacji (role stationId, latitude, longitude).
+     * @param model Wskaźnik na model.
+     */
+    void setModel(QAbstractItemModel* model);
+
+    /**
+     * @brief Zwraca poziom przybliżenia.
+     * @return Poziom przybliżenia (skala 256 * 2^zoom pikseli na świat).
+     */
+    double zoom() const;
+
+    /**
+     * @brief Ustawia poziom przybliżenia względem środka widoku.
+     * @param zoom Poziom przybliżenia.
+     */
+    void setZoom(double zoom);
+
+    /**
+     * @brief Zwraca ID zaznaczonej stacji.
+     * @return Identyfikator stacji lub -1.
+     */
+    int selectedStationId() const;
+
+    /**
+     * @brief Ustawia zaznaczoną stację.
+     * @param stationId Identyfikator stacji lub -1.
+     */
+    void setSelectedStationId(int stationId);
+
+    /**
+     * @brief Zwraca rozmiar komórki klastra w pikselach.
+     * @return Rozmiar komórki.
+     */
+    double clusterSize() const;
+
+    /**
+     * @brief Ustawia rozmiar komórki klastra w pikselach.
+     * @param size Rozmiar komórki (0 wyłącza klastrowanie).
+     */
+    void setClusterSize(double size);
+
+    /**
+     * @brief Zwraca liczbę rysowanych znaczników.
+     * @return Liczba znaczników.
+     */
+    int markerCount() const;
+
+    /**
+     * @brief Zwraca liczbę stacji w widoku.
+     * @return Liczba stacji.
+     */
+    int visibleStationCount() const;
+
+    /**
+     * @brief Ustawia poziom indeksu jakości powietrza stacji.
+     * @param stationId Identyfikator stacji.
+     * @param level Poziom indeksu (0 - bardzo dobry ... 5 - bardzo zły, -1 - brak).
+     */
+    Q_INVOKABLE void setStationLevel(int stationId, int level);
+
+    /**
+     * @brief Dopasowuje widok do wszystkich stacji.
+     */
+    Q_INVOKABLE void fitToStations();
+
+    /**
+     * @brief Zwraca identyfikatory stacji widocznych na mapie.
+     * @return Lista identyfikatorów.
+     */
+    Q_INVOKABLE QVariantList visibleStationIds() const;
+
+    /**
+     * @brief Zwraca kolor poziomu indeksu (skala GIOŚ).
+     * @param level Poziom indeksu (-1 dla braku indeksu).
+     * @return Kolor znacznika.
+     */
+    Q_INVOKABLE QColor levelColor(int level) const;
+
+signals:
+    /**
+     * @brief Emitowany po zmianie modelu.
+     */
+    void modelChanged();
+
+    /**
+     * @brief Emitowany po zmianie poziomu przybliżenia.
+     */
+    void zoomChanged();
+
+    /**
+     * @brief Emitowany po zmianie zaznaczonej stacji.
+     */
+    void selectedStationIdChanged();
+
+    /**
+     * @brief Emitowany po zmianie rozmiaru komórki klastra.
+     */
+    void clusterSizeChanged();
+
+    /**
+     * @brief Emitowany po przeliczeniu znaczników.
+     */
+    void markersChanged();
+
+    /**
+     * @brief Emitowany po zakończeniu przesuwania lub przybliżania widoku.
+     */
+    void viewportSettled();
+
+    /**
+     * @brief Emitowany po kliknięciu stacji.
+     * @param stationId Identyfikator klikniętej stacji.
+     */
+    void stationClicked(int stationId);
+
+protected:
+    /**
+     * @brief Przelicza znaczniki przed synchronizacją grafu sceny.
+     */
+    void updatePolish() override;
+
+    /**
+     * @brief Aktualizuje węzeł grafu sceny.
+     * @param oldNode Poprzedni węzeł lub nullptr.
+     * @param data Dane aktualizacji (nieużywane).
+     * @return Węzeł do wyrenderowania.
+     */
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+
+    /**
+     * @brief Rozpoczyna przesuwanie lub kliknięcie.
+     * @param event Zdarzenie myszy.
+     */
+    void mousePressEvent(QMouseEvent* event) override;
+
+    /**
+     * @brief Przesuwa widok.
+     * @param event Zdarzenie myszy.
+     */
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+    /**
+     * @brief Kończy przesuwanie lub obsługuje kliknięcie znacznika.
+     * @param event Zdarzenie myszy.
+     */
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+    /**
+     * @brief Przybliża lub oddala widok wokół kursora.
+     * @param event Zdarzenie kółka myszy.
+     */
+    void wheelEvent(QWheelEvent* event) override;
+
+private:
+    /// @brief Model stacji.
+    QPointer<QAbstractItemModel> stationModel;
+    /// @brief Indeks przestrzenny stacji.
+    StationMapIndex index;
+    /// @brief Znaczniki wyznaczone dla bieżącego widoku.
+    QVector<StationMapIndex::Marker> markers;
+    /// @brief Liczba stacji w bieżącym widoku.
+    int visibleStations = 0;
+
+    /// @brief Środek widoku X w przestrzeni świata.
+    double centerX = 0.5;
+    /// @brief Środek widoku Y w przestrzeni świata.
+    double centerY = 0.5;
+    /// @brief Poziom przybliżenia.
+    double zoomLevel = MIN_ZOOM;
+    /// @brief Rozmiar komórki klastra w pikselach.
+    double clusterCellSize = 28.0;
+    /// @brief ID zaznaczonej stacji.
+    int selectedId = -1;
+
+    /// @brief Czy stacje trzeba ponownie odczytać z modelu.
+    bool stationsDirty = true;
+    /// @brief Czy widok dopasowano już do stacji.
+    bool fitted = false;
+    /// @brief Położenie kursora przy naciśnięciu przycisku.
+    QPointF pressPosition;
+    /// @brief Ostatnie położenie kursora podczas przesuwania.
+    QPointF lastPosition;
+    /// @brief Czy trwa przesuwanie.
+    bool dragging = false;
+
+    /**
+     * @brief Ustawia środek i przybliżenie tak, by widok obejmował wszystkie stacje.
+     * @return False, jeśli brak stacji lub element nie ma jeszcze rozmiaru.
+     */
+    bool fitView();
+
+    /**
+     * @brief Oznacza stacje do ponownego odczytu z modelu.
+     */
+    void invalidateStations();
+
+    /**
+     * @brief Odczytuje współrzędne stacji z modelu do indeksu.
+     */
+    void reloadStations();
+
+    /**
+     * @brief Zwraca parametry bieżącego widoku.
+     * @return Parametry widoku.
+     */
+    StationMapIndex::Viewport viewport() const;
+
+    /**
+     * @brief Zwraca liczbę pikseli na jednostkę świata.
+     * @return Skala widoku.
+     */
+    double scale() const;
+
+    /**
+     * @brief Zmienia przybliżenie, zachowując punkt pod podaną pozycją widoku.
+     * @param zoom Nowy poziom przybliżenia.
+     * @param anchor Pozycja w pikselach widoku.
+     */
+    void zoomAround(double zoom, const QPointF& anchor);
+
+    /**
+     * @brief Zwraca promień znacznika.
+     * @param count Liczba stacji w znaczniku.
+     * @return Promień w pikselach.
+     */
+    static double markerRadius(int count);
+
+    /**
+     * @brief Zwraca znacznik pod podaną pozycją.
+     * @param position Pozycja w pikselach widoku.
+     * @return Numer znacznika lub -1.
+     */
+    int markerAt(const QPointF& position) const;
+
+    /**
+     * @brief Aktualizuje węzeł geometrii (renderer sprzętowy).
+     * @param node Poprzedni węzeł lub nullptr.
+     * @return Węzeł geometrii.
+     */
+    QSGGeometryNode* updateGeometryNode(QSGGeometryNode* node);
+
+    /**
+     * @brief Aktualizuje węzeł obrazu (renderer programowy).
+     * @param node Poprzedni węzeł lub nullptr.
+     * @return Węzeł obrazu.
+     */
+    QSGImageNode* updateImageNode(QSGImageNode* node);
+};
+
+#endif // STATIONMAPITEM_H
@@ -0,0 +1,112 @@
+#include "syncengine.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Zwraca wszystkie zmienione punkty jako jedną serię.
+ * @return Punkty nowe i poprawione, rosnąco po czasie.
+ */
+MeasurementSeries SyncEngine::Delta::changed() const
+{
+    MeasurementSeries result = MeasurementSeries::merged(corrected, added);
+    result.key = added.key.isEmpty() ? corrected.key : added.key;
+    return result;
+}
+
+/**
+ * @brief Sprawdza, czy stan czujnika został zainicjowany.
+ * @param sensorId Identyfikator czujnika.
+ * @return True po wywołaniu prime lub apply dla czujnika.
+ */
+bool SyncEngine::isPrimed(int sensorId) const
+{
+    return states.contains(sensorId);
+}
+
+/**
+ * @brief Inicjuje stan czujnika zapisaną historią.
+ *
+ * Zachowywane są tylko wartości z ostatnich RECENT_WINDOW_MS przed znacznikiem - starszych
+ * punktów API już nie zwraca, więc nie mogą zostać poprawione.
+ * @param sensorId Identyfikator czujnika.
+ * @param stored Seria zapisana w lokalnej bazie danych.
+ */
+void SyncEngine::prime(int sensorId, const MeasurementSeries& stored)
+{
+    SensorState state;
+    state.highWater = stored.newestValidTimestamp();
+    state.recent.key = stored.key;
+    for (int i = 0; i < stored.size(); ++i) {
+        if (std::isnan(stored.values[i]) || stored.timestamps[i] < state.highWater - RECENT_WINDOW_MS) continue;
+        state.recent.timestamps.append(stored.timestamps[i]);
+        state.recent.values.append(stored.values[i]);
+    }
+    states.insert(sensorId, state);
+}
+
+/**
+ * @brief Wydziela zmiany z odpowiedzi API i aktualizuje stan czujnika.
+ *
+ * Obie serie są posortowane, więc porównanie to jedno przejście scalające. Po przetworzeniu
+ * stan zawiera wartości z zakresu bieżącej odpowiedzi, więc jego rozmiar nie rośnie z czasem.
+ * @param sensorId Identyfikator czujnika.
+ * @param response Seria z odpowiedzi API.
+ * @return Punkty nowe i poprawione.
+ */
+SyncEngine::Delta SyncEngine::apply(int sensorId, const MeasurementSeries& response)
+{
+    SensorState& state = states[sensorId];
+    Delta delta;
+    delta.added.key = response.key;
+    delta.corrected.key = response.key;
+
+    MeasurementSeries& known = state.recent;
+    int k = 0;
+    for (int i = 0; i < response.size(); ++i) {
+        const qint64 timestamp = response.timestamps[i];
+        const double value = response.values[i];
+        if (std::isnan(value)) continue;
+
+        MeasurementSeries& target = timestamp > state.highWater ? delta.added : delta.corrected;
+        if (timestamp <= state.highWater) {
+            while (k < known.size() && known.timestamps[k] < timestamp) ++k;
+            if (k < known.size() && known.timestamps[k] == timestamp && known.values[k] == value) continue;
+        }
+        target.timestamps.append(timestamp);
+        target.values.append(value);
+    }
+
+    counters.responses++;
+    counters.pointsReceived += response.size();
+    counters.pointsAdded += delta.added.size();
+    counters.pointsCorrected += delta.corrected.size();
+
+    MeasurementSeries updated = MeasurementSeries::merged(known, delta.changed());
+    const qint64 windowStart = response.isEmpty() ? updated.timestamps.value(0) : response.timestamps.first();
+    const int first = std::lower_bound(updated.timestamps.begin(), updated.timestamps.end(), windowStart)
+                      - updated.timestamps.begin();
+    known.key = response.key.isEmpty() ? known.key : response.key;
+    known.timestamps = updated.timestamps.mid(first);
+    known.values = updated.values.mid(first);
+    if (!delta.added.isEmpty()) state.highWater = delta.added.timestamps.last();
+    return delta;
+}
+
+/**
+ * @brief Zwraca znacznik najnowszej znanej wartości czujnika.
+ * @param sensorId Identyfikator czujnika.
+ * @return Znacznik czasu w ms od epoki lub -1.
+ */
+qint64 SyncEngine::highWaterMark(int sensorId) const
+{
+    return states.value(sensorId).highWater;
+}
+
+/**
+ * @brief Zwraca statystyki synchronizacji.
+ * @return Statystyki od uruchomienia.
+ */
+SyncEngine::Stats SyncEngine::stats() const
+{
+    return counters;
+}
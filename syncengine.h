@@ -0,0 +1,112 @@
+#ifndef SYNCENGINE_H
+#define SYNCENGINE_H
+
+#include <QHash>
+#include "measurementseries.h"
+
+/**
+ * @brief Synchronizacja przyrostowa pomiarów z kroczącym oknem API.
+ *
+ * API GIOŚ zwraca dla czujnika okno kilku ostatnich dób, z którego nowa jest zwykle
+ * tylko ostatnia godzina lub dwie. Silnik pamięta dla każdego czujnika znacznik
+ * najnowszej zapisanej wartości (high-water mark) oraz wartości z ostatniego okna
+ * i z każdej odpowiedzi wydziela wyłącznie punkty nowsze od znacznika oraz
+ * wcześniejsze punkty, których wartość API poprawiło lub uzupełniło.
+ */
+class SyncEngine
+{
+public:
+    /**
+     * @brief Zmiany wydzielone z jednej odpowiedzi.
+     */
+    struct Delta {
+        /// @brief Punkty nowsze niż dotychczasowy znacznik (rosnąco po czasie).
+        MeasurementSeries added;
+        /// @brief Punkty nie nowsze niż znacznik z nową lub zmienioną wartością (rosnąco po czasie).
+        MeasurementSeries corrected;
+
+        /**
+         * @brief Sprawdza, czy odpowiedź nie wniosła zmian.
+         * @return True, jeśli brak nowych i poprawionych punktów.
+         */
+        bool isEmpty() const { return added.isEmpty() && corrected.isEmpty(); }
+
+        /**
+         * @brief Zwraca wszystkie zmienione punkty jako jedną serię.
+         * @return Punkty nowe i poprawione, rosnąco po czasie.
+         */
+        MeasurementSeries changed() const;
+    };
+
+    /**
+     * @brief Statystyki synchronizacji.
+     */
+    struct Stats {
+        /// @brief Liczba przetworzonych odpowiedzi.
+        int responses = 0;
+        /// @brief Liczba punktów w odpowiedziach.
+        qint64 pointsReceived = 0;
+        /// @brief Liczba nowych punktów.
+        qint64 pointsAdded = 0;
+        /// @brief Liczba poprawionych punktów.
+        qint64 pointsCorrected = 0;
+    };
+
+    /**
+     * @brief Sprawdza, czy stan czujnika został zainicjowany.
+     * @param sensorId Identyfikator czujnika.
+     * @return True po wywołaniu prime lub apply dla czujnika.
+     */
+    bool isPrimed(int sensorId) const;
+
+    /**
+     * @brief Inicjuje stan czujnika zapisaną historią.
+     * @param sensorId Identyfikator czujnika.
+     * @param stored Seria zapisana w lokalnej bazie danych.
+     */
+    void prime(int sensorId, const MeasurementSeries& stored);
+
+    /**
+     * @brief Wydziela zmiany z odpowiedzi API i aktualizuje stan czujnika.
+     *
+     * Braki danych (null) nie są zmianą - API zwraca je dla godzin jeszcze nieopublikowanych.
+     * @param sensorId Identyfikator czujnika.
+     * @param response Seria z odpowiedzi API.
+     * @return Punkty nowe i poprawione.
+     */
+    Delta apply(int sensorId, const MeasurementSeries& response);
+
+    /**
+     * @brief Zwraca znacznik najnowszej znanej wartości czujnika.
+     * @param sensorId Identyfikator czujnika.
+     * @return Znacznik czasu w ms od epoki lub -1.
+     */
+    qint64 highWaterMark(int sensorId) const;
+
+    /**
+     * @brief Zwraca statystyki synchronizacji.
+     * @return Statystyki od uruchomienia.
+     */
+    Stats stats() const;
+
+private:
+    /**
+     * @brief Stan synchronizacji czujnika.
+     */
+    struct SensorState {
+        /// @brief Znacznik najnowszej znanej wartości.
+        qint64 highWater = -1;
+        /// @brief Znane wartości z zakresu ostatniego okna API (bez braków).
+        MeasurementSeries recent;
+    };
+
+    /// @brief Stany czujników według ID.
+    QHash<int, SensorState> states;
+    /// @brief Statystyki synchronizacji.
+    Stats counters;
+
+    /// @brief Zakres historii zachowywany przy inicjacji stanu (ms), odpowiada oknu API.
+    static constexpr qint64 RECENT_WINDOW_MS = 4LL * 24 * 3600 * 1000;
+};
+
+#endif // SYNCENGINE_H
@@ -0,0 +1,328 @@
+#include "syntheticdata.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// @brief Liczba milisekund w godzinie.
+constexpr qint64 HOUR_MS = 3600 * 1000;
+/// @brief Liczba pi.
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Profil parametru używany przez generator historii.
+ */
+struct ParameterProfile {
+    /// @brief Kod parametru.
+    const char* code;
+    /// @brief Typowy poziom (µg/m³).
+    double base;
+    /// @brief Amplituda cyklu rocznego (dodatnia: maksimum zimą, ujemna: latem).
+    double seasonal;
+    /// @brief Czy parametr ma szczyty komunikacyjne (rano, po południu, niższy weekend).
+    bool traffic;
+};
+
+/**
+ * @brief Zwraca profil parametru.
+ * @param paramCode Kod parametru.
+ * @return Profil (dla nieznanych parametrów profil ogólny).
+ */
+ParameterProfile profileOf(const QString& paramCode)
+{
+    static const ParameterProfile profiles[] = {
+        { "PM10", 28.0, 0.6, true }, { "PM2.5", 20.0, 0.7, true }, { "NO2", 22.0, 0.3, true },
+        { "SO2", 5.0, 0.8, false }, { "O3", 55.0, -0.5, false }, { "CO", 450.0, 0.5, true },
+        { "C6H6", 1.2, 0.8, true } };
+    for (const ParameterProfile& profile : profiles) {
+        if (paramCode == QLatin1String(profile.code)) return profile;
+    }
+    return { "", 20.0, 0.3, false };
+}
+
+/**
+ * @brief Losuje liczbę z rozkładu normalnego N(0, 1) (metoda Boxa-Mullera).
+ * @param random Generator losowy.
+ * @return Wylosowana liczba.
+ */
+double gaussian(QRandomGenerator& random)
+{
+    const double u = std::max(random.generateDouble(), std::numeric_limits<double>::min());
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * random.generateDouble());
+}
+
+} // namespace
+
+/**
+ * @brief Generuje katalog stacji w formacie API GIOŚ (station/findAll).
+ * @param stationCount Liczba stacji.
+ * @return Tablica JSON ze stacjami.
+ */
+QJsonArray SyntheticData::stations(int stationCount)
+{
+    static const char* syllables[] = { "ka", "ro", "wa", "gli", "no", "szo", "bia", "le", "zie", "ków",
+                                       "dąb", "rze", "to", "lub", "mi", "sa", "po", "gór", "ny", "wo" };
+    /// Województwa w siatce 4 x 4 od północnego zachodu (w przybliżeniu zgodnie z położeniem).
+    static const char* provinces[] = { "ZACHODNIOPOMORSKIE", "POMORSKIE", "WARMIŃSKO-MAZURSKIE", "PODLASKIE",
+                                       "LUBUSKIE", "WIELKOPOLSKIE", "KUJAWSKO-POMORSKIE", "MAZOWIECKIE",
+                                       "DOLNOŚLĄSKIE", "ŁÓDZKIE", "ŚWIĘTOKRZYSKIE", "LUBELSKIE",
+                                       "OPOLSKIE", "ŚLĄSKIE", "MAŁOPOLSKIE", "PODKARPACKIE" };
+    const int syllableCount = sizeof(syllables) / sizeof(syllables[0]);
+    const double minLat = 49.0, maxLat = 54.8, minLon = 14.1, maxLon = 24.1;
+
+    QRandomGenerator random(20240101);
+    QJsonArray stations;
+    int cityIndex = -1;
+    int remaining = 0;
+    QString city;
+    double centerLat = 0.0;
+    double centerLon = 0.0;
+    QString province;
+
+    for (int i = 0; i < stationCount; ++i) {
+        if (remaining == 0) {
+            ++cityIndex;
+            remaining = cityIndex % 50 == 0 ? 8 + random.bounded(9)
+                      : cityIndex % 7 == 0 ? 3 + random.bounded(3)
+                                           : 1 + random.bounded(2);
+            city.clear();
+            for (int part = 0, seed = cityIndex; part < 3; ++part, seed /= syllableCount) {
+                city += QString::fromUtf8(syllables[(seed + part * 7) % syllableCount]);
+            }
+            city[0] = city[0].toUpper();
+            centerLat = minLat + random.generateDouble() * (maxLat - minLat);
+            centerLon = minLon + random.generateDouble() * (maxLon - minLon);
+            const int row = std::min(3, static_cast<int>((maxLat - centerLat) / (maxLat - minLat) * 4));
+            const int column = std::min(3, static_cast<int>((centerLon - minLon) / (maxLon - minLon) * 4));
+            province = QString::fromUtf8(provinces[row * 4 + column]);
+        }
+        --remaining;
+
+        QJsonObject commune;
+        commune["communeName"] = city;
+        commune["districtName"] = QString("powiat nr %1").arg(cityIndex / 5 + 1);
+        commune["provinceName"] = province;
+        QJsonObject cityObject;
+        cityObject["id"] = cityIndex;
+        cityObject["name"] = city;
+        cityObject["commune"] = commune;
+
+        const int streetNumber = i % 40 + 1;
+        QJsonObject station;
+        station["id"] = 100000 + i;
+        station["stationName"] = QString("%1, ul. Pomiarowa %2").arg(city).arg(streetNumber);
+        station["gegrLat"] = QString::number(centerLat + (random.generateDouble() - 0.5) * 0.08, 'f', 6);
+        station["gegrLon"] = QString::number(centerLon + (random.generateDouble() - 0.5) * 0.12, 'f', 6);
+        station["addressStreet"] = QString("ul. Pomiarowa %1").arg(streetNumber);
+        station["city"] = cityObject;
+        stations.append(station);
+    }
+    return stations;
+}
+
+/**
+ * @brief Generuje czujniki stacji w formacie API GIOŚ (station/sensors).
+ * @param stations Tablica JSON ze stacjami.
+ * @return Tablica JSON z czujnikami.
+ */
+QJsonArray SyntheticData::sensors(const QJsonArray& stations)
+{
+    struct Parameter { const char* name; const char* code; int id; };
+    static const Parameter parameters[] = {
+        { "pył zawieszony PM10", "PM10", 3 }, { "pył zawieszony PM2.5", "PM2.5", 69 },
+        { "dwutlenek azotu", "NO2", 6 }, { "ozon", "O3", 5 }, { "dwutlenek siarki", "SO2", 1 },
+        { "benzen", "C6H6", 10 }, { "tlenek węgla", "CO", 8 } };
+    const int parameterCount = sizeof(parameters) / sizeof(parameters[0]);
+
+    QJsonArray sensors;
+    for (const QJsonValue& value : stations) {
+        const int stationId = value.toObject()["id"].toInt();
+        const int count = 3 + stationId % 4;
+        for (int k = 0; k < count; ++k) {
+            const Parameter& parameter = parameters[(stationId + k) % parameterCount];
+            QJsonObject param;
+            param["paramName"] = QString::fromUtf8(parameter.name);
+            param["paramFormula"] = QString::fromUtf8(parameter.code);
+            param["paramCode"] = QString::fromUtf8(parameter.code);
+            param["idParam"] = parameter.id;
+
+            QJsonObject sensor;
+            sensor["id"] = stationId * 10 + k;
+            sensor["stationId"] = stationId;
+            sensor["param"] = param;
+            sensors.append(sensor);
+        }
+    }
+    return sensors;
+}
+
+/**
+ * @brief Generuje godzinową historię pomiarów czujnika.
+ * @param sensorId Identyfikator czujnika (ziarno generatora).
+ * @param paramCode Kod parametru (np. PM10).
+ * @param end Znacznik czasu ostatniej godziny (ms od epoki).
+ * @param hours Liczba godzin historii.
+ * @return Seria posortowana rosnąco po czasie (braki jako NaN).
+ */
+MeasurementSeries SyntheticData::history(int sensorId, const QString& paramCode, qint64 end, int hours)
+{
+    const ParameterProfile profile = profileOf(paramCode);
+    QRandomGenerator random(static_cast<quint32>(sensorId) * 2654435761u + 1);
+    const double stationLevel = 0.7 + 0.6 * random.generateDouble();
+
+    MeasurementSeries series;
+    series.key = paramCode;
+    series.timestamps.reserve(hours);
+    series.values.reserve(hours);
+
+    double noise = 0.0;
+    int episodeLeft = 0;
+    int episodeLength = 0;
+    double episodeStrength = 0.0;
+    int outageLeft = 0;
+
+    for (int h = 0; h < hours; ++h) {
+        const qint64 timestamp = end - static_cast<qint64>(hours - 1 - h) * HOUR_MS;
+        const qint64 localHours = (timestamp + HOUR_MS) / HOUR_MS;
+        const int hourOfDay = static_cast<int>(localHours % 24);
+        const qint64 days = localHours / 24;
+        const int weekday = static_cast<int>((days + 3) % 7);
+        const double dayOfYear = std::fmod(static_cast<double>(days), 365.2425);
+
+        const double seasonal = 1.0 + profile.seasonal * std::cos(2.0 * PI * (dayOfYear - 15.0) / 365.2425);
+        double diurnal;
+        if (profile.traffic) {
+            diurnal = 1.0 + 0.35 * std::exp(-std::pow(hourOfDay - 8, 2) / 4.0)
+                      + 0.45 * std::exp(-std::pow(hourOfDay - 18, 2) / 6.0)
+                      - 0.25 * std::exp(-std::pow(hourOfDay - 4, 2) / 6.0);
+            if (weekday >= 5) diurnal *= 0.8;
+        } else if (profile.seasonal < 0.0) {
+            diurnal = 1.0 + 0.5 * std::sin(2.0 * PI * (hourOfDay - 9) / 24.0);
+        } else {
+            diurnal = 1.0 + 0.1 * std::sin(2.0 * PI * (hourOfDay - 6) / 24.0);
+        }
+
+        noise = 0.92 * noise + 0.12 * gaussian(random);
+        double value = profile.base * stationLevel * seasonal * diurnal * std::exp(noise);
+
+        if (episodeLeft == 0 && profile.seasonal > 0.0 && seasonal > 1.0 && random.generateDouble() < 0.002) {
+            episodeLength = episodeLeft = 48 + random.bounded(73);
+            episodeStrength = 0.8 + 1.2 * random.generateDouble();
+        }
+        if (episodeLeft > 0) {
+            value *= 1.0 + episodeStrength * std::sin(PI * (episodeLength - episodeLeft) / episodeLength);
+            --episodeLeft;
+        }
+        if (random.generateDouble() < 0.0005) value *= 8.0;
+
+        if (outageLeft == 0 && random.generateDouble() < 0.0008) outageLeft = 6 + random.bounded(43);
+        const bool missing = outageLeft > 0 || random.generateDouble() < 0.015;
+        if (outageLeft > 0) --outageLeft;
+
+        series.timestamps.append(timestamp);
+        series.values.append(missing ? std::numeric_limits<double>::quiet_NaN() : std::round(value * 1e4) / 1e4);
+    }
+    return series;
+}
+
+/**
+ * @brief Zamienia serię na odpowiedź API GIOŚ (data/getData).
+ * @param series Seria pomiarowa.
+ * @return Obiekt z polami key i values (od najnowszego pomiaru, braki jako null).
+ */
+QJsonObject SyntheticData::measurementsResponse(const MeasurementSeries& series)
+{
+    QJsonArray values;
+    for (int i = series.size() - 1; i >= 0; --i) {
+        QJsonObject point;
+        point["date"] = QDateTime::fromMSecsSinceEpoch(series.timestamps[i]).toString("yyyy-MM-dd HH:mm:ss");
+        point["value"] = std::isnan(series.values[i]) ? QJsonValue() : QJsonValue(series.values[i]);
+        values.append(point);
+    }
+    QJsonObject response;
+    response["key"] = series.key;
+    response["values"] = values;
+    return response;
+}
+
+/**
+ * @brief Zapisuje syntetyczne archiwum w formacie lokalnej bazy danych.
+ * @param directory Katalog docelowy.
+ * @param fileCount Liczba plików.
+ * @return Łączny rozmiar zapisanych plików w bajtach lub -1 przy błędzie zapisu.
+ */
+qint64 SyntheticData::archive(const QString& directory, int fileCount)
+{
+    const QStringList paramCodes = {"PM10", "PM2.5", "NO2", "SO2", "O3", "CO", "C6H6"};
+    const int HOURS = 240;
+    const int JOURNAL_HOURS = 24;
+    const qint64 end = QDateTime::currentMSecsSinceEpoch() / HOUR_MS * HOUR_MS;
+    const QDir dir(directory);
+
+    qint64 bytes = 0;
+    auto write = [&bytes](const QString& path, const QByteArray& data) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) return false;
+        bytes += data.size();
+        return true;
+    };
+    auto point = [](const MeasurementSeries& series, int index) {
+        QJsonObject object;
+        object["date"] = QDateTime::fromMSecsSinceEpoch(series.timestamps[index]).toString("yyyy-MM-dd HH:mm:ss");
+        object["value"] = std::isnan(series.values[index]) ? QJsonValue() : QJsonValue(series.values[index]);
+        return object;
+    };
+
+    int written = 0;
+    for (int stationId = 1; written < fileCount; ++stationId) {
+        QJsonObject level;
+        level["id"] = stationId % 6;
+        level["indexLevelName"] = QString("Poziom %1").arg(stationId % 6);
+        QJsonObject airQuality;
+        airQuality["stIndexLevel"] = level;
+        airQuality["stCalcDate"] = QDateTime::fromMSecsSinceEpoch(end).toString("yyyy-MM-dd HH:mm:ss");
+        QJsonObject data;
+        data["stationId"] = stationId;
+        data["saveDate"] = QDateTime::fromMSecsSinceEpoch(end).toString(Qt::ISODate);
+        data["airQuality"] = airQuality;
+        if (!write(dir.filePath(QString("airquality_station%1.json").arg(stationId)), QJsonDocument(data).toJson())) return -1;
+        ++written;
+
+        for (int sensor = 0; sensor < paramCodes.size() && written < fileCount; ++sensor) {
+            const int sensorId = stationId * 100 + sensor;
+            const MeasurementSeries series = history(sensorId, paramCodes[sensor], end, HOURS + JOURNAL_HOURS);
+
+            QJsonArray measurements;
+            for (int hour = 0; hour < HOURS; ++hour) {
+                measurements.append(point(series, hour));
+            }
+            QJsonObject snapshot;
+            snapshot["stationId"] = stationId;
+            snapshot["sensorId"] = sensorId;
+            snapshot["key"] = paramCodes[sensor];
+            snapshot["saveDate"] = QDateTime::fromMSecsSinceEpoch(end).toString(Qt::ISODate);
+            snapshot["measurements"] = measurements;
+            const QString base = dir.filePath(QString("measurements_station%1_sensor%2").arg(stationId).arg(sensorId));
+            if (!write(base + ".json", QJsonDocument(snapshot).toJson())) return -1;
+            ++written;
+
+            if (sensor >= 2 || written >= fileCount) continue;
+            QJsonObject header;
+            header["key"] = paramCodes[sensor];
+            QByteArray lines = QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n';
+            for (int hour = HOURS; hour < HOURS + JOURNAL_HOURS; ++hour) {
+                lines += QJsonDocument(point(series, hour)).toJson(QJsonDocument::Compact) + '\n';
+            }
+            if (!write(base + ".jsonl", lines)) return -1;
+            ++written;
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,74 @@
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include "measurementseries.h"
+
+/**
+ * @brief Generator syntetycznych danych w formacie API GIOŚ i lokalnej bazy danych.
+ *
+ * Dane są deterministyczne (zależą tylko od parametrów i identyfikatorów), więc pomiary
+ * wydajności można powtarzać i porównywać między wersjami. Katalogi mogą być wielokrotnie
+ * większe od rzeczywistej sieci GIOŚ, a historie obejmować wiele lat pomiarów godzinowych.
+ */
+class SyntheticData
+{
+public:
+    /**
+     * @brief Generuje katalog stacji w formacie API GIOŚ (station/findAll).
+     *
+     * Nazwy miejscowości składane są z sylab, więc wiele z nich ma wspólne prefiksy, co odpowiada
+     * rzeczywistemu rozkładowi wyników podczas pisania. Miejscowości mają różną liczbę stacji
+     * (duże miasta kilkanaście, małe jedną), a stacje leżą w pobliżu środka swojej miejscowości;
+     * województwo wynika z położenia.
+     * @param stationCount Liczba stacji.
+     * @return Tablica JSON ze stacjami.
+     */
+    static QJsonArray stations(int stationCount);
+
+    /**
+     * @brief Generuje czujniki stacji w formacie API GIOŚ (station/sensors).
+     *
+     * Każda stacja dostaje od 3 do 6 czujników z typowego zestawu parametrów.
+     * @param stations Tablica JSON ze stacjami.
+     * @return Tablica JSON z czujnikami.
+     */
+    static QJsonArray sensors(const QJsonArray& stations);
+
+    /**
+     * @brief Generuje godzinową historię pomiarów czujnika.
+     *
+     * Wartości łączą poziom typowy dla parametru, cykl roczny (pył, SO2, CO i benzen zimą,
+     * ozon latem), cykl dobowy (szczyty komunikacyjne, popołudniowe maksimum ozonu), niższe
+     * wartości w weekendy, szum autokorelowany, epizody smogowe, pojedyncze skoki czujnika
+     * oraz braki danych (pojedyncze godziny i kilkugodzinne przerwy).
+     * @param sensorId Identyfikator czujnika (ziarno generatora).
+     * @param paramCode Kod parametru (np. PM10).
+     * @param end Znacznik czasu ostatniej godziny (ms od epoki).
+     * @param hours Liczba godzin historii.
+     * @return Seria posortowana rosnąco po czasie (braki jako NaN).
+     */
+    static MeasurementSeries history(int sensorId, const QString& paramCode, qint64 end, int hours);
+
+    /**
+     * @brief Zamienia serię na odpowiedź API GIOŚ (data/getData).
+     * @param series Seria pomiarowa.
+     * @return Obiekt z polami key i values (od najnowszego pomiaru, braki jako null).
+     */
+    static QJsonObject measurementsResponse(const MeasurementSeries& series);
+
+    /**
+     * @brief Zapisuje syntetyczne archiwum w formacie lokalnej bazy danych.
+     *
+     * Każda stacja ma plik indeksu jakości powietrza, siedem plików głównych pomiarów
+     * (240 godzin) i dwa dzienniki z ostatnią dobą.
+     * @param directory Katalog docelowy.
+     * @param fileCount Liczba plików.
+     * @return Łączny rozmiar zapisanych plików w bajtach lub -1 przy błędzie zapisu.
+     */
+    static qint64 archive(const QString& directory, int fileCount);
+};
+
+#endif // SYNTHETICDATA_H
@@ -4,6 +4,16 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -130,10 +140,457 @@ void displayStationDetails(CURL* curl, const json& station, double distance = -1
     std::cout << "====================================\n";
 }
 
-int main() {
+// ===== Tryb wsadowy: wiele adresow, geokodowanie rownolegle (curl_multi) =====
+
+struct BatchOptions {
+    std::string addressFile;
+    std::string outputFile = "raport.csv";
+    std::string cacheFile = "geocache.json";
+    std::string giosUrl = "https://api.gios.gov.pl/pjp-api/rest/";
+    std::string geocodeUrl = "https://nominatim.openstreetmap.org/search";
+    std::string caInfo;
+    int nearest = 1;
+    int concurrency = 4;
+    // Zasady Nominatim: najwyzej jedno zapytanie na sekunde
+    int intervalMs = 1000;
+    bool sensors = false;
+};
+
+struct HttpResult {
+    long status = 0;
+    std::string body;
+    bool ok = false;
+};
+
+struct Coordinates {
+    bool found = false;
+    double lat = 0.0;
+    double lon = 0.0;
+};
+
+struct StationEntry {
+    int id = 0;
+    std::string name;
+    std::string city;
+    double lat = 0.0;
+    double lon = 0.0;
+};
+
+struct Transfer {
+    CURL* easy = nullptr;
+    size_t index = 0;
+    int attempt = 0;
+    std::string buffer;
+};
+
+void applyCommonOptions(CURL* curl, const BatchOptions& options) {
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, "MonitorJakosciPowietrza/1.0 (testapi)");
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, 5000L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 20000L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    if (!options.caInfo.empty()) curl_easy_setopt(curl, CURLOPT_CAINFO, options.caInfo.c_str());
+}
+
+// Pobiera adresy rownolegle przez curl_multi. Kolejne zapytania startuja nie czesciej niz co
+// intervalMs, a odpowiedzi 429/5xx i bledy transportu sa ponawiane (najwyzej 3 proby).
+std::vector<HttpResult> fetchConcurrent(const std::vector<std::string>& urls, const BatchOptions& options,
+                                        int intervalMs) {
+    using Clock = std::chrono::steady_clock;
+    const int maxAttempts = 3;
+    std::vector<HttpResult> results(urls.size());
+    if (urls.empty()) return results;
+
+    CURLM* multi = curl_multi_init();
+    const int slots = std::max(1, options.concurrency);
+    std::vector<Transfer> transfers(slots);
+    std::vector<Transfer*> idle;
+    for (Transfer& transfer : transfers) {
+        transfer.easy = curl_easy_init();
+        applyCommonOptions(transfer.easy, options);
+        curl_easy_setopt(transfer.easy, CURLOPT_WRITEDATA, &transfer.buffer);
+        curl_easy_setopt(transfer.easy, CURLOPT_PRIVATE, &transfer);
+        idle.push_back(&transfer);
+    }
+
+    std::deque<std::pair<size_t, int>> queue;
+    for (size_t i = 0; i < urls.size(); ++i) queue.emplace_back(i, 1);
+    Clock::time_point nextStart = Clock::now();
+    int running = 0;
+
+    while (!queue.empty() || idle.size() < transfers.size()) {
+        while (!queue.empty() && !idle.empty() && Clock::now() >= nextStart) {
+            Transfer* transfer = idle.back();
+            idle.pop_back();
+            transfer->index = queue.front().first;
+            transfer->attempt = queue.front().second;
+            transfer->buffer.clear();
+            queue.pop_front();
+            curl_easy_setopt(transfer->easy, CURLOPT_URL, urls[transfer->index].c_str());
+            curl_multi_add_handle(multi, transfer->easy);
+            nextStart = Clock::now() + std::chrono::milliseconds(intervalMs);
+        }
+
+        curl_multi_perform(multi, &running);
+
+        int left = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &left)) {
+            if (message->msg != CURLMSG_DONE) continue;
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&transfer));
+            long status = 0;
+            curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &status);
+            curl_multi_remove_handle(multi, transfer->easy);
+
+            const bool transportError = message->data.result != CURLE_OK;
+            const bool retryable = transportError || status == 429 || status >= 500;
+            if (retryable && transfer->attempt < maxAttempts) {
+                queue.emplace_back(transfer->index, transfer->attempt + 1);
+            } else {
+                HttpResult& result = results[transfer->index];
+                result.status = status;
+                result.ok = !transportError && status == 200;
+                result.body = std::move(transfer->buffer);
+                if (transportError) {
+                    std::cerr << "Blad pobierania " << urls[transfer->index] << ": "
+                              << curl_easy_strerror(message->data.result) << "\n";
+                }
+            }
+            idle.push_back(transfer);
+        }
+
+        if (queue.empty() && idle.size() == transfers.size()) break;
+        int waitMs = 100;
+        if (!queue.empty() && !idle.empty()) {
+            auto untilStart = std::chrono::duration_cast<std::chrono::milliseconds>(nextStart - Clock::now()).count();
+            waitMs = static_cast<int>(std::max<long long>(0, std::min<long long>(waitMs, untilStart)));
+        }
+        if (running > 0) {
+            curl_multi_poll(multi, nullptr, 0, waitMs, nullptr);
+        } else if (waitMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+        }
+    }
+
+    for (Transfer& transfer : transfers) curl_easy_cleanup(transfer.easy);
+    curl_multi_cleanup(multi);
+    return results;
+}
+
+std::string normalizeAddress(const std::string& address) {
+    std::string normalized;
+    bool space = false;
+    for (char c : address) {
+        if (c == ' ' || c == '\t' || c == '\r') {
+            space = !normalized.empty();
+            continue;
+        }
+        if (space) normalized += ' ';
+        space = false;
+        normalized += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return normalized;
+}
+
+double jsonToDouble(const json& value) {
+    if (value.is_string()) return std::stod(value.get<std::string>());
+    if (value.is_number()) return value.get<double>();
+    return 0.0;
+}
+
+std::map<std::string, Coordinates> loadGeocodeCache(const std::string& path) {
+    std::map<std::string, Coordinates> cache;
+    std::ifstream file(path);
+    if (!file) return cache;
+    try {
+        json stored = json::parse(file);
+        for (auto it = stored.begin(); it != stored.end(); ++it) {
+            Coordinates coordinates;
+            coordinates.found = it.value().value("found", false);
+            coordinates.lat = it.value().value("lat", 0.0);
+            coordinates.lon = it.value().value("lon", 0.0);
+            cache[it.key()] = coordinates;
+        }
+    } catch (json::exception& e) {
+        std::cerr << "Pominieto uszkodzona pamiec geokodowania " << path << ": " << e.what() << "\n";
+    }
+    return cache;
+}
+
+void saveGeocodeCache(const std::string& path, const std::map<std::string, Coordinates>& cache) {
+    json stored = json::object();
+    for (const auto& entry : cache) {
+        stored[entry.first] = { {"found", entry.second.found}, {"lat", entry.second.lat}, {"lon", entry.second.lon} };
+    }
+    // Zapis do pliku tymczasowego i podmiana, zeby przerwany zapis nie niszczyl pamieci
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << stored.dump(1);
+        if (!file) {
+            std::cerr << "Blad zapisu pamieci geokodowania " << temporary << "\n";
+            return;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Blad zapisu pamieci geokodowania " << path << "\n";
+    }
+}
+
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(";\"\n") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int runBatch(const BatchOptions& options) {
+    auto started = std::chrono::steady_clock::now();
+
+    std::ifstream input(options.addressFile);
+    if (!input) {
+        std::cerr << "Nie mozna otworzyc pliku adresow " << options.addressFile << "\n";
+        return 1;
+    }
+    std::vector<std::string> addresses;
+    for (std::string line; std::getline(input, line);) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (normalizeAddress(line).empty() || line[0] == '#') continue;
+        addresses.push_back(line);
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        std::cerr << "Blad inicjalizacji CURL\n";
+        return 1;
+    }
+    std::string stationsBuffer;
+    applyCommonOptions(curl, options);
+    curl_easy_setopt(curl, CURLOPT_URL, (options.giosUrl + "station/findAll").c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &stationsBuffer);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    if (res != CURLE_OK) {
+        std::cerr << "Blad pobierania stacji: " << curl_easy_strerror(res) << "\n";
+        return 1;
+    }
+
+    std::vector<StationEntry> stations;
+    try {
+        for (const auto& station : json::parse(stationsBuffer)) {
+            StationEntry entry;
+            entry.id = station["id"].get<int>();
+            entry.name = station.value("stationName", "");
+            if (station.contains("city") && station["city"].is_object()) entry.city = station["city"].value("name", "");
+            entry.lat = jsonToDouble(station["gegrLat"]);
+            entry.lon = jsonToDouble(station["gegrLon"]);
+            stations.push_back(entry);
+        }
+    } catch (std::exception& e) {
+        std::cerr << "Blad parsowania stacji: " << e.what() << "\n";
+        return 1;
+    }
+    if (stations.empty()) {
+        std::cerr << "Brak stacji w odpowiedzi API\n";
+        return 1;
+    }
+
+    // Geokodowanie tylko adresow nieobecnych w pamieci (kazdy unikalny adres raz)
+    std::map<std::string, Coordinates> cache = loadGeocodeCache(options.cacheFile);
+    std::vector<std::string> missing;
+    std::vector<std::string> urls;
+    size_t cacheHits = 0;
+    for (const std::string& address : addresses) {
+        const std::string key = normalizeAddress(address);
+        if (cache.count(key)) {
+            ++cacheHits;
+            continue;
+        }
+        if (std::find(missing.begin(), missing.end(), key) != missing.end()) continue;
+        missing.push_back(key);
+        char* escaped = curl_easy_escape(nullptr, (address + ", Polska").c_str(), 0);
+        urls.push_back(options.geocodeUrl + "?q=" + escaped + "&format=json&limit=1");
+        curl_free(escaped);
+    }
+
+    std::vector<HttpResult> geocoded = fetchConcurrent(urls, options, options.intervalMs);
+    size_t geocodeErrors = 0;
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (!geocoded[i].ok) {
+            ++geocodeErrors;
+            continue;
+        }
+        Coordinates coordinates;
+        try {
+            json result = json::parse(geocoded[i].body);
+            if (!result.empty()) {
+                coordinates.found = true;
+                coordinates.lat = jsonToDouble(result[0]["lat"]);
+                coordinates.lon = jsonToDouble(result[0]["lon"]);
+            }
+            cache[missing[i]] = coordinates;
+        } catch (std::exception& e) {
+            ++geocodeErrors;
+            std::cerr << "Blad parsowania geokodowania dla " << missing[i] << ": " << e.what() << "\n";
+        }
+    }
+    saveGeocodeCache(options.cacheFile, cache);
+
+    // Najblizsze stacje dla kazdego adresu
+    const size_t nearest = std::min<size_t>(std::max(1, options.nearest), stations.size());
+    std::vector<std::vector<std::pair<double, size_t>>> matches(addresses.size());
+    std::map<int, std::string> stationParams;
+    for (size_t a = 0; a < addresses.size(); ++a) {
+        auto it = cache.find(normalizeAddress(addresses[a]));
+        if (it == cache.end() || !it->second.found) continue;
+
+        std::vector<std::pair<double, size_t>> distances(stations.size());
+        for (size_t s = 0; s < stations.size(); ++s) {
+            distances[s] = { calculateDistance(it->second.lat, it->second.lon, stations[s].lat, stations[s].lon), s };
+        }
+        std::partial_sort(distances.begin(), distances.begin() + nearest, distances.end());
+        distances.resize(nearest);
+        for (const auto& match : distances) stationParams[stations[match.second].id];
+        matches[a] = distances;
+    }
+
+    // Opcjonalnie parametry mierzone na wybranych stacjach (kazda stacja pobierana raz)
+    if (options.sensors && !stationParams.empty()) {
+        std::vector<int> ids;
+        std::vector<std::string> sensorUrls;
+        for (const auto& entry : stationParams) {
+            ids.push_back(entry.first);
+            sensorUrls.push_back(options.giosUrl + "station/sensors/" + std::to_string(entry.first));
+        }
+        std::vector<HttpResult> sensorResults = fetchConcurrent(sensorUrls, options, 0);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (!sensorResults[i].ok) continue;
+            try {
+                std::string codes;
+                for (const auto& sensor : json::parse(sensorResults[i].body)) {
+                    if (!codes.empty()) codes += ",";
+                    codes += sensor["param"].value("paramCode", "");
+                }
+                stationParams[ids[i]] = codes;
+            } catch (std::exception& e) {
+                std::cerr << "Blad parsowania sensorow stacji " << ids[i] << ": " << e.what() << "\n";
+            }
+        }
+    }
+
+    size_t notFound = 0;
+    std::ofstream output(options.outputFile, std::ios::trunc);
+    if (!output) {
+        std::cerr << "Nie mozna utworzyc raportu " << options.outputFile << "\n";
+        return 1;
+    }
+    if (endsWith(options.outputFile, ".json")) {
+        json report = json::array();
+        for (size_t a = 0; a < addresses.size(); ++a) {
+            const Coordinates coordinates = cache.count(normalizeAddress(addresses[a]))
+                                          ? cache[normalizeAddress(addresses[a])] : Coordinates();
+            json row = { {"address", addresses[a]}, {"found", coordinates.found} };
+            if (coordinates.found) {
+                row["lat"] = coordinates.lat;
+                row["lon"] = coordinates.lon;
+            } else {
+                ++notFound;
+            }
+            row["stations"] = json::array();
+            for (const auto& match : matches[a]) {
+                const StationEntry& station = stations[match.second];
+                json entry = { {"id", station.id}, {"name", station.name}, {"city", station.city},
+                               {"distanceKm", std::round(match.first * 100.0) / 100.0} };
+                if (options.sensors) entry["params"] = stationParams[station.id];
+                row["stations"].push_back(entry);
+            }
+            report.push_back(row);
+        }
+        output << report.dump(2) << "\n";
+    } else {
+        output << "adres;status;szerokosc;dlugosc;pozycja;id_stacji;nazwa_stacji;miasto;odleglosc_km";
+        output << (options.sensors ? ";parametry\n" : "\n");
+        for (size_t a = 0; a < addresses.size(); ++a) {
+            if (matches[a].empty()) {
+                ++notFound;
+                output << csvField(addresses[a]) << ";nie znaleziono;;;;;;;" << (options.sensors ? ";\n" : "\n");
+                continue;
+            }
+            const Coordinates& coordinates = cache[normalizeAddress(addresses[a])];
+            for (size_t rank = 0; rank < matches[a].size(); ++rank) {
+                const StationEntry& station = stations[matches[a][rank].second];
+                std::ostringstream line;
+                line.precision(7);
+                line << csvField(addresses[a]) << ";ok;" << coordinates.lat << ";" << coordinates.lon << ";"
+                     << rank + 1 << ";" << station.id << ";" << csvField(station.name) << ";"
+                     << csvField(station.city) << ";";
+                line.precision(3);
+                line << matches[a][rank].first;
+                if (options.sensors) line << ";" << csvField(stationParams[station.id]);
+                output << line.str() << "\n";
+            }
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Adresow: " << addresses.size() << ", z pamieci geokodowania: " << cacheHits
+              << ", zapytan geokodowania: " << urls.size() << " (bledy: " << geocodeErrors << ")\n";
+    std::cout << "Nie znaleziono: " << notFound << ", stacji w katalogu: " << stations.size()
+              << ", czas: " << seconds << " s\n";
+    std::cout << "Raport zapisano w " << options.outputFile << "\n";
+    return 0;
+}
+
+bool parseBatchOptions(int argc, char* argv[], BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--batch" && hasValue) options.addressFile = argv[++i];
+        else if (arg == "--output" && hasValue) options.outputFile = argv[++i];
+        else if (arg == "--cache" && hasValue) options.cacheFile = argv[++i];
+        else if (arg == "--gios-url" && hasValue) options.giosUrl = argv[++i];
+        else if (arg == "--geocode-url" && hasValue) options.geocodeUrl = argv[++i];
+        else if (arg == "--cainfo" && hasValue) options.caInfo = argv[++i];
+        else if (arg == "--nearest" && hasValue) options.nearest = std::atoi(argv[++i]);
+        else if (arg == "--concurrency" && hasValue) options.concurrency = std::atoi(argv[++i]);
+        else if (arg == "--interval-ms" && hasValue) options.intervalMs = std::atoi(argv[++i]);
+        else if (arg == "--sensors") options.sensors = true;
+        else {
+            std::cerr << "Nieznana opcja: " << arg << "\n"
+                      << "Uzycie: testapi --batch adresy.txt [--output raport.csv|raport.json] [--cache geocache.json]\n"
+                      << "        [--nearest 1] [--concurrency 4] [--interval-ms 1000] [--sensors]\n"
+                      << "        [--gios-url URL] [--geocode-url URL] [--cainfo plik.crt]\n";
+            return false;
+        }
+    }
+    if (!options.giosUrl.empty() && options.giosUrl.back() != '/') options.giosUrl += '/';
+    return !options.addressFile.empty();
+}
+
+int main(int argc, char* argv[]) {
     #ifdef _WIN32
         system("chcp 65001 > nul");
     #endif
+
+    if (argc > 1) {
+        BatchOptions options;
+        #ifdef _WIN32
+            options.caInfo = "C:/curl/bin/curl-ca-bundle.crt";
+        #endif
+        if (!parseBatchOptions(argc, argv, options)) return 1;
+        curl_global_init(CURL_GLOBAL_ALL);
+        int code = runBatch(options);
+        curl_global_cleanup();
+        return code;
+    }
     
     CURL* curl;
     CURLcode res;